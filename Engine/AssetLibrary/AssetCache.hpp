@@ -1,11 +1,14 @@
 #pragma once
 
 #include <BaseLibrary/Exception/Exception.hpp>
+#include <BaseLibrary/JobSystem/Scheduler.hpp>
+#include <BaseLibrary/JobSystem/SharedFuture.hpp>
 
 #include <cassert>
 #include <filesystem>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <unordered_map>
 #include <vector>
 
@@ -28,6 +31,8 @@ class AssetCache {
 	};
 
 public:
+	using AssetFuture = jobs::SharedFuture<std::shared_ptr<AssetT>>;
+
 	virtual ~AssetCache() = default;
 
 	/// <summary> Loads an asset from the file specified or from cache if already loaded. </summary>
@@ -35,6 +40,11 @@ public:
 	/// <exception cref="FileNotFoundException"> In case none of the search directories contain the file. </exception>
 	std::shared_ptr<AssetT> Load(std::filesystem::path path);
 
+	/// <summary> Starts loading the asset on the scheduler, or returns the cached asset as a ready future. </summary>
+	/// <remarks> Requests for a path that is already being loaded share the same future.
+	///		Errors, like <see cref="FileNotFoundException"/>, are thrown when the future is awaited. </remarks>
+	AssetFuture LoadAsync(std::filesystem::path path);
+
 	/// <summary> Reloads the asset from disk if the underlying file has changed. </summary>
 	/// <exception cref="KeyNotFoundException"> If the file has not been loaded at all. Call Load first. </exception>
 	std::shared_ptr<AssetT> Reload(std::filesystem::path path);
@@ -61,100 +71,154 @@ public:
 	/// <summary> Searches for assets within these directories. </summary>
 	void SetSearchDirectories(std::vector<std::filesystem::path> directories);
 
+	/// <summary> Sets where <see cref="LoadAsync"/> runs the loads. </summary>
+	/// <remarks> Loads run on the calling thread until a scheduler is set. The scheduler must outlive the cache. </remarks>
+	void SetScheduler(jobs::Scheduler& scheduler);
+
 protected:
 	/// <summary> Loads the asset specified by the absolute path. </summary>
+	/// <remarks> May be called from several threads at the same time, for different paths. </remarks>
 	virtual std::shared_ptr<AssetT> Create(const std::filesystem::path& path) = 0;
 	virtual void Reload(AssetT& asset, const std::filesystem::path& path) = 0;
 
+	/// <summary> Loads the asset as a job, override to await the assets it depends on instead of blocking. </summary>
+	/// <remarks> Calls <see cref="Create"/> by default. </remarks>
+	virtual AssetFuture CreateAsync(std::filesystem::path path);
+
+	/// <summary> The scheduler set by <see cref="SetScheduler"/>, or one that runs jobs on the calling thread. </summary>
+	jobs::Scheduler& GetScheduler() const;
+
 private:
-	std::filesystem::path FindFullPath(std::filesystem::path path);
+	std::filesystem::path FindFullPath(std::filesystem::path path) const;
+	/// <summary> Returns the cached asset, if any. Must be called with m_mutex locked. </summary>
+	std::shared_ptr<AssetT> FindLoaded(const std::filesystem::path& path);
+
+	static AssetFuture LoadJob(AssetCache* cache, std::filesystem::path path);
+	static AssetFuture LoadedJob(std::shared_ptr<AssetT> asset);
+
 	std::vector<std::filesystem::path> m_directories;
 	std::unordered_map<std::filesystem::path, std::weak_ptr<AssetT>, PathHash> m_pathMap;
 	std::map<std::weak_ptr<AssetT>, AssetParams, std::owner_less<std::weak_ptr<AssetT>>> m_cache;
+	std::unordered_map<std::filesystem::path, AssetFuture, PathHash> m_loading; // Loads in flight by path.
+	jobs::Scheduler* m_scheduler = nullptr;
+	mutable std::mutex m_mutex; // Guards the maps above.
 };
 
 
 template <class AssetT>
 std::shared_ptr<AssetT> AssetCache<AssetT>::Load(std::filesystem::path path) {
-	auto pathMapIt = m_pathMap.find(path);
-	if (pathMapIt != m_pathMap.end()) {
-		std::weak_ptr<AssetT> weakRef = pathMapIt->second;
-		std::shared_ptr<AssetT> strongRef = weakRef.lock();
-		if (strongRef) {
-			// Refresh strong reference in case it's been cleared.
-			auto cacheIt = m_cache.find(weakRef);
-			assert(cacheIt != m_cache.end());
-			cacheIt->second.strongRef = strongRef;
-
-			// Return strong reference.
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (std::shared_ptr<AssetT> strongRef = FindLoaded(path)) {
 			return strongRef;
 		}
 	}
+	return LoadAsync(std::move(path)).get();
+}
 
-	std::filesystem::path fullPath = FindFullPath(path).make_preferred();
-	std::shared_ptr<AssetT> strongRef = Create(fullPath);
-	std::weak_ptr<AssetT> weakRef = strongRef;
-	auto lastWriteTime = last_write_time(fullPath);
-	m_pathMap.insert_or_assign(path, weakRef);
-	m_cache.insert_or_assign(weakRef, AssetParams{ .strongRef = strongRef, .filePath = path, .lastWriteTime = lastWriteTime });
-	return strongRef;
+
+template <class AssetT>
+auto AssetCache<AssetT>::LoadAsync(std::filesystem::path path) -> AssetFuture {
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	if (std::shared_ptr<AssetT> strongRef = FindLoaded(path)) {
+		lock.unlock();
+		AssetFuture future = LoadedJob(std::move(strongRef));
+		future.Schedule(GetScheduler());
+		return future;
+	}
+
+	auto loadingIt = m_loading.find(path);
+	if (loadingIt != m_loading.end()) {
+		return loadingIt->second;
+	}
+
+	// Registered before scheduling, the job removes it when done, which may happen immediately.
+	AssetFuture future = LoadJob(this, path);
+	m_loading.insert({ path, future });
+	lock.unlock();
+	future.Schedule(GetScheduler());
+	return future;
 }
 
 
 template <class AssetT>
 std::shared_ptr<AssetT> AssetCache<AssetT>::Reload(std::filesystem::path path) {
-	auto pathMapIt = m_pathMap.find(path);
-	if (pathMapIt != m_pathMap) {
-		std::weak_ptr<AssetT> weakRef = pathMapIt->second;
-		std::shared_ptr<AssetT> strongRef = weakRef.lock();
-		if (strongRef) {
-			Reload(strongRef);
-			return strongRef;
-		}
-		else {
-			m_pathMap.erase(pathMapIt);
-			m_cache.erase(weakRef);
+	std::shared_ptr<AssetT> strongRef;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		auto pathMapIt = m_pathMap.find(path);
+		if (pathMapIt != m_pathMap.end()) {
+			std::weak_ptr<AssetT> weakRef = pathMapIt->second;
+			strongRef = weakRef.lock();
+			if (!strongRef) {
+				m_pathMap.erase(pathMapIt);
+				m_cache.erase(weakRef);
+			}
 		}
 	}
+	if (strongRef) {
+		Reload(strongRef);
+		return strongRef;
+	}
 	return Load(path);
 }
 
 
 template <class AssetT>
 void AssetCache<AssetT>::Reload(std::shared_ptr<AssetT> asset) {
-	auto cacheIt = m_cache.find(asset);
-	if (cacheIt != m_cache.end()) {
+	std::filesystem::path filePath;
+	std::filesystem::file_time_type lastWriteTime;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		auto cacheIt = m_cache.find(asset);
+		if (cacheIt == m_cache.end()) {
+			throw KeyNotFoundException{ "You can reload only an asset that was loaded previously by this cache." };
+		}
 		AssetParams& params = cacheIt->second;
 		params.strongRef = asset;
-		std::filesystem::path fullPath = FindFullPath(params.path);
-		auto freshWriteTime = last_write_time(fullPath);
-		if (params.lastWriteTime < freshWriteTime) {
-			Reload(*asset, fullPath);
-		}
+		filePath = params.filePath;
+		lastWriteTime = params.lastWriteTime;
 	}
-	else {
-		throw KeyNotFoundException{ "You can reload only an asset that was loaded previously by this cache." };
+
+	std::filesystem::path fullPath = FindFullPath(filePath);
+	auto freshWriteTime = last_write_time(fullPath);
+	if (lastWriteTime < freshWriteTime) {
+		Reload(*asset, fullPath);
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		auto cacheIt = m_cache.find(asset);
+		if (cacheIt != m_cache.end()) {
+			cacheIt->second.lastWriteTime = freshWriteTime;
+		}
 	}
 }
 
 
 template <class AssetT>
 void AssetCache<AssetT>::ReloadAll() {
-	for (auto& [weakRef, params] : m_cache) {
-		if (!params.strongRef) {
-			params.strongRef = weakRef.lock();
-		}
-		std::filesystem::path fullPath = FindFullPath(params.path);
-		auto freshWriteTime = last_write_time(fullPath);
-		if (params.strongRef && params.lastWriteTime < freshWriteTime) {
-			Reload(*params.strongRef, fullPath);
+	// Reloading may load other assets, so the cache is not locked meanwhile.
+	std::vector<std::shared_ptr<AssetT>> assets;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		for (auto& [weakRef, params] : m_cache) {
+			if (!params.strongRef) {
+				params.strongRef = weakRef.lock();
+			}
+			if (params.strongRef) {
+				assets.push_back(params.strongRef);
+			}
 		}
 	}
+	for (auto& asset : assets) {
+		Reload(asset);
+	}
 }
 
 
 template <class AssetT>
 void AssetCache<AssetT>::Release(std::filesystem::path path) {
+	std::lock_guard<std::mutex> lock(m_mutex);
 	auto pathMapIt = m_pathMap.find(path);
 	if (pathMapIt != m_pathMap.end()) {
 		auto cacheIt = m_cache.find(pathMapIt->second);
@@ -166,6 +230,7 @@ void AssetCache<AssetT>::Release(std::filesystem::path path) {
 
 template <class AssetT>
 void AssetCache<AssetT>::Release(std::shared_ptr<AssetT> asset) {
+	std::lock_guard<std::mutex> lock(m_mutex);
 	auto cacheIt = m_cache.find(asset);
 	if (cacheIt != m_cache.end()) {
 		cacheIt->second.strongRef.reset();
@@ -178,6 +243,7 @@ void AssetCache<AssetT>::Release(std::shared_ptr<AssetT> asset) {
 
 template <class AssetT>
 void AssetCache<AssetT>::ReleaseAll() {
+	std::lock_guard<std::mutex> lock(m_mutex);
 	for (auto& [weakRef, params] : m_cache) {
 		params.strongRef.reset();
 	}
@@ -186,13 +252,39 @@ void AssetCache<AssetT>::ReleaseAll() {
 
 template <class AssetT>
 void AssetCache<AssetT>::SetSearchDirectories(std::vector<std::filesystem::path> directories) {
+	std::lock_guard<std::mutex> lock(m_mutex);
 	m_directories = std::move(directories);
 }
 
 
 template <class AssetT>
-std::filesystem::path AssetCache<AssetT>::FindFullPath(std::filesystem::path path) {
-	for (auto& directory : m_directories) {
+void AssetCache<AssetT>::SetScheduler(jobs::Scheduler& scheduler) {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_scheduler = &scheduler;
+}
+
+
+template <class AssetT>
+auto AssetCache<AssetT>::CreateAsync(std::filesystem::path path) -> AssetFuture {
+	co_return Create(path);
+}
+
+
+template <class AssetT>
+jobs::Scheduler& AssetCache<AssetT>::GetScheduler() const {
+	static jobs::ImmediateScheduler immediateScheduler;
+	return m_scheduler ? *m_scheduler : immediateScheduler;
+}
+
+
+template <class AssetT>
+std::filesystem::path AssetCache<AssetT>::FindFullPath(std::filesystem::path path) const {
+	std::vector<std::filesystem::path> directories;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		directories = m_directories;
+	}
+	for (auto& directory : directories) {
 		std::filesystem::path fullPath = directory / path;
 		if (exists(fullPath)) {
 			return fullPath;
@@ -202,4 +294,51 @@ std::filesystem::path AssetCache<AssetT>::FindFullPath(std::filesystem::path pat
 }
 
 
-} // namespace inl::asset
\ No newline at end of file
+template <class AssetT>
+std::shared_ptr<AssetT> AssetCache<AssetT>::FindLoaded(const std::filesystem::path& path) {
+	auto pathMapIt = m_pathMap.find(path);
+	if (pathMapIt == m_pathMap.end()) {
+		return nullptr;
+	}
+	std::weak_ptr<AssetT> weakRef = pathMapIt->second;
+	std::shared_ptr<AssetT> strongRef = weakRef.lock();
+	if (strongRef) {
+		// Refresh strong reference in case it's been cleared.
+		auto cacheIt = m_cache.find(weakRef);
+		assert(cacheIt != m_cache.end());
+		cacheIt->second.strongRef = strongRef;
+	}
+	return strongRef;
+}
+
+
+template <class AssetT>
+auto AssetCache<AssetT>::LoadJob(AssetCache* cache, std::filesystem::path path) -> AssetFuture {
+	try {
+		std::filesystem::path fullPath = cache->FindFullPath(path).make_preferred();
+		auto lastWriteTime = last_write_time(fullPath);
+		std::shared_ptr<AssetT> strongRef = co_await cache->CreateAsync(fullPath);
+
+		std::lock_guard<std::mutex> lock(cache->m_mutex);
+		std::weak_ptr<AssetT> weakRef = strongRef;
+		cache->m_pathMap.insert_or_assign(path, weakRef);
+		cache->m_cache.insert_or_assign(weakRef, AssetParams{ strongRef, path, lastWriteTime });
+		cache->m_loading.erase(path);
+		co_return strongRef;
+	}
+	catch (...) {
+		// Allow retrying, e.g. after the missing file is created.
+		std::lock_guard<std::mutex> lock(cache->m_mutex);
+		cache->m_loading.erase(path);
+		throw;
+	}
+}
+
+
+template <class AssetT>
+auto AssetCache<AssetT>::LoadedJob(std::shared_ptr<AssetT> asset) -> AssetFuture {
+	co_return asset;
+}
+
+
+} // namespace inl::asset
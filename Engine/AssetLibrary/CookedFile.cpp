@@ -0,0 +1,142 @@
+#include "CookedFile.hpp"
+
+#include <BaseLibrary/Exception/Exception.hpp>
+
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+namespace inl::asset {
+
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::filesystem::path& path) {
+	HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		throw FileNotFoundException("Failed to open file for mapping.", path.generic_u8string());
+	}
+	m_file = file;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size)) {
+		Close();
+		throw RuntimeException("Failed to query file size.", path.generic_u8string());
+	}
+	m_size = size_t(size.QuadPart);
+	if (m_size == 0) {
+		return; // Empty files cannot be mapped.
+	}
+
+	m_mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	const void* view = m_mapping ? MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+	if (!view) {
+		Close();
+		throw RuntimeException("Failed to map file.", path.generic_u8string());
+	}
+	m_data = static_cast<const uint8_t*>(view);
+}
+
+
+void MappedFile::Close() {
+	if (m_data) {
+		UnmapViewOfFile(m_data);
+	}
+	if (m_mapping) {
+		CloseHandle(m_mapping);
+	}
+	if (m_file) {
+		CloseHandle(m_file);
+	}
+	m_data = nullptr;
+	m_size = 0;
+	m_mapping = nullptr;
+	m_file = nullptr;
+}
+
+#else
+
+MappedFile::MappedFile(const std::filesystem::path& path) {
+	int file = open(path.c_str(), O_RDONLY);
+	if (file < 0) {
+		throw FileNotFoundException("Failed to open file for mapping.", path.generic_u8string());
+	}
+
+	struct stat status;
+	if (fstat(file, &status) != 0) {
+		close(file);
+		throw RuntimeException("Failed to query file size.", path.generic_u8string());
+	}
+	m_size = size_t(status.st_size);
+	if (m_size == 0) {
+		close(file);
+		return; // Empty files cannot be mapped.
+	}
+
+	void* view = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, file, 0);
+	close(file); // The mapping keeps its own reference.
+	if (view == MAP_FAILED) {
+		m_size = 0;
+		throw RuntimeException("Failed to map file.", path.generic_u8string());
+	}
+	m_data = static_cast<const uint8_t*>(view);
+}
+
+
+void MappedFile::Close() {
+	if (m_data) {
+		munmap(const_cast<uint8_t*>(m_data), m_size);
+	}
+	m_data = nullptr;
+	m_size = 0;
+}
+
+#endif
+
+
+MappedFile::MappedFile(MappedFile&& rhs) noexcept {
+	*this = std::move(rhs);
+}
+
+
+MappedFile& MappedFile::operator=(MappedFile&& rhs) noexcept {
+	if (this != &rhs) {
+		Close();
+		m_data = std::exchange(rhs.m_data, nullptr);
+		m_size = std::exchange(rhs.m_size, 0);
+#ifdef _WIN32
+		m_file = std::exchange(rhs.m_file, nullptr);
+		m_mapping = std::exchange(rhs.m_mapping, nullptr);
+#endif
+	}
+	return *this;
+}
+
+
+MappedFile::~MappedFile() {
+	Close();
+}
+
+
+bool IsCookedUpToDate(const std::filesystem::path& cookedPath, const std::filesystem::path& sourcePath) {
+	std::error_code ec;
+	auto cookedTime = std::filesystem::last_write_time(cookedPath, ec);
+	if (ec) {
+		return false;
+	}
+	auto sourceTime = std::filesystem::last_write_time(sourcePath, ec);
+	return ec || cookedTime >= sourceTime;
+}
+
+
+} // namespace inl::asset
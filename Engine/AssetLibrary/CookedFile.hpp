@@ -0,0 +1,68 @@
+#pragma once
+
+#include <BaseLibrary/Exception/Exception.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+
+namespace inl::asset {
+
+
+/// <summary> Maps a whole file read-only into the address space. </summary>
+/// <remarks> Cooked assets are read straight from the mapping, the OS pages in only what is touched. </remarks>
+class MappedFile {
+public:
+	MappedFile() = default;
+	/// <exception cref="FileNotFoundException"> If the file cannot be opened. </exception>
+	/// <exception cref="RuntimeException"> If the file cannot be mapped. </exception>
+	explicit MappedFile(const std::filesystem::path& path);
+	MappedFile(MappedFile&& rhs) noexcept;
+	MappedFile& operator=(MappedFile&& rhs) noexcept;
+	~MappedFile();
+
+	const uint8_t* GetData() const { return m_data; }
+	size_t GetSize() const { return m_size; }
+
+	void Close();
+
+private:
+	const uint8_t* m_data = nullptr;
+	size_t m_size = 0;
+#ifdef _WIN32
+	void* m_file = nullptr;
+	void* m_mapping = nullptr;
+#endif
+};
+
+
+/// <summary> The cooked version of an asset is used if it's at least as new as the source file. </summary>
+/// <remarks> Returns true if only the cooked file exists. </remarks>
+bool IsCookedUpToDate(const std::filesystem::path& cookedPath, const std::filesystem::path& sourcePath);
+
+
+/// <summary> Saves an asset cooked at load time so that later loads can use the cooked file. </summary>
+/// <remarks> Best effort, failures such as a read-only asset folder are ignored. The file is written under
+///		a temporary name first, so neither this nor other processes ever pick up a partially written file. </remarks>
+template <class CookedT>
+void TrySaveCooked(const CookedT& cooked, const std::filesystem::path& cookedPath) {
+	std::filesystem::path temporaryPath = cookedPath;
+	temporaryPath += ".tmp";
+	try {
+		cooked.Save(temporaryPath);
+	}
+	catch (Exception&) {
+		std::error_code ec;
+		std::filesystem::remove(temporaryPath, ec);
+		return;
+	}
+	std::error_code ec;
+	std::filesystem::rename(temporaryPath, cookedPath, ec);
+	if (ec) {
+		std::filesystem::remove(temporaryPath, ec);
+	}
+}
+
+
+} // namespace inl::asset
@@ -1,5 +1,7 @@
 #include "GraphicsMeshCache.hpp"
 
+#include "CookedFile.hpp"
+#include "MeshCooker.hpp"
 #include "Model.hpp"
 
 
@@ -10,26 +12,105 @@ GraphicsMeshCache::GraphicsMeshCache(gxeng::IGraphicsEngine& engine)
 	: m_engine(engine) {}
 
 
+std::vector<gxeng::IMeshEntity::Lod> GraphicsMeshCache::GetLods(const std::shared_ptr<gxeng::IMesh>& mesh) const {
+	std::lock_guard<std::mutex> lock(m_lodMutex);
+	auto it = m_lods.find(mesh.get());
+	if (it == m_lods.end() || it->second.mesh.owner_before(mesh) || mesh.owner_before(it->second.mesh)) {
+		return {};
+	}
+	return it->second.lods;
+}
+
+
 std::shared_ptr<gxeng::IMesh> GraphicsMeshCache::Create(const std::filesystem::path& path) {
 	std::shared_ptr<gxeng::IMesh> mesh(m_engine.CreateMesh());
-	Reload(*mesh, path);
+	std::vector<gxeng::IMeshEntity::Lod> lods = Upload(*mesh, path, {});
+
+	std::lock_guard<std::mutex> lock(m_lodMutex);
+	for (auto it = m_lods.begin(); it != m_lods.end();) {
+		it = it->second.mesh.expired() ? m_lods.erase(it) : std::next(it);
+	}
+	m_lods[mesh.get()] = LodEntry{ mesh, std::move(lods) };
 	return mesh;
 }
 
 
 void GraphicsMeshCache::Reload(gxeng::IMesh& asset, const std::filesystem::path& path) {
-	Model model{ path };
+	std::vector<gxeng::IMeshEntity::Lod> previousLods;
+	{
+		std::lock_guard<std::mutex> lock(m_lodMutex);
+		auto it = m_lods.find(&asset);
+		if (it != m_lods.end()) {
+			previousLods = it->second.lods;
+		}
+	}
+
+	std::vector<gxeng::IMeshEntity::Lod> lods = Upload(asset, path, previousLods);
+
+	std::lock_guard<std::mutex> lock(m_lodMutex);
+	auto it = m_lods.find(&asset);
+	if (it != m_lods.end()) {
+		it->second.lods = std::move(lods);
+	}
+}
+
+
+std::vector<gxeng::IMeshEntity::Lod> GraphicsMeshCache::Upload(gxeng::IMesh& asset, const std::filesystem::path& path, const std::vector<gxeng::IMeshEntity::Lod>& previousLods) {
+	CookedMesh mesh;
+	std::filesystem::path cookedPath = path.extension() == CookedMesh::FILE_EXTENSION ? path : CookedMesh::GetCookedPath(path);
+	bool loaded = false;
+	if (IsCookedUpToDate(cookedPath, path)) {
+		try {
+			mesh.Load(cookedPath);
+			loaded = true;
+		}
+		catch (InvalidArgumentException&) {
+			// Cooked by an older version, it is cooked again from the source below.
+			if (cookedPath == path) {
+				throw;
+			}
+		}
+	}
+	if (!loaded) {
+		mesh = CookedMesh::Cook(Model{ path });
+		TrySaveCooked(mesh, cookedPath);
+	}
+
+	asset.SetCompressed(mesh.GetVertexData(), mesh.GetVertexStride(), mesh.GetVertexCount(),
+						mesh.GetElements().data(), mesh.GetElements().size(),
+						mesh.GetIndexData(), mesh.IsIndex32Bit(), mesh.GetIndexCount(), mesh.GetQuantization());
+	asset.SetBounds(mesh.GetBoundsMin(), mesh.GetBoundsMax());
 
-	CoordSysLayout csys;
-	csys.x = AxisDir::POS_X;
-	csys.y = AxisDir::POS_Z;
-	csys.z = AxisDir::NEG_Y;
+	// Entities hold the level meshes, so a reload overwrites them like the base mesh instead of replacing them.
+	auto uploadLevel = [&mesh](gxeng::IMesh& target, size_t level) {
+		const CookedLod& lod = mesh.GetLod(level);
+		target.SetCompressed(mesh.GetLodVertexData(level), mesh.GetVertexStride(), lod.vertexCount,
+							 mesh.GetElements().data(), mesh.GetElements().size(),
+							 mesh.GetLodIndexData(level), mesh.IsIndex32Bit(), lod.indexCount, mesh.GetQuantization());
+		target.SetBounds(mesh.GetBoundsMin(), mesh.GetBoundsMax());
+	};
 
-	auto vertices = model.GetVertices<gxeng::Position<0>, gxeng::Normal<0>, gxeng::TexCoord<0>, gxeng::Tangent<0>>(0, csys);
-	auto indices = model.GetIndices(0);
+	std::vector<gxeng::IMeshEntity::Lod> lods;
+	for (size_t i = 0; i < mesh.GetLodCount(); ++i) {
+		std::shared_ptr<gxeng::IMesh> lodMesh = i < previousLods.size() ? previousLods[i].mesh : std::shared_ptr<gxeng::IMesh>(m_engine.CreateMesh());
+		uploadLevel(*lodMesh, i);
+		lods.push_back({ std::move(lodMesh), mesh.GetLod(i).screenSize });
+	}
 
-	asset.Set(vertices.data(), &vertices[0].GetReader(), vertices.size(), indices.data(), indices.size());
+	// Levels the reloaded mesh no longer has get its coarsest geometry, entities still draw them until their levels are set again.
+	for (size_t i = lods.size(); i < previousLods.size(); ++i) {
+		if (mesh.GetLodCount() > 0) {
+			uploadLevel(*previousLods[i].mesh, mesh.GetLodCount() - 1);
+		}
+		else {
+			previousLods[i].mesh->SetCompressed(mesh.GetVertexData(), mesh.GetVertexStride(), mesh.GetVertexCount(),
+												 mesh.GetElements().data(), mesh.GetElements().size(),
+												 mesh.GetIndexData(), mesh.IsIndex32Bit(), mesh.GetIndexCount(), mesh.GetQuantization());
+			previousLods[i].mesh->SetBounds(mesh.GetBoundsMin(), mesh.GetBoundsMax());
+		}
+	}
+	return lods;
 }
 
 
-} // namespace inl::asset
\ No newline at end of file
+} // namespace inl::asset
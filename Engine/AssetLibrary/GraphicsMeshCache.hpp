@@ -4,6 +4,10 @@
 
 #include <GraphicsEngine/IGraphicsEngine.hpp>
 #include <GraphicsEngine/Resources/IMesh.hpp>
+#include <GraphicsEngine/Scene/IMeshEntity.hpp>
+
+#include <mutex>
+#include <unordered_map>
 
 
 namespace inl::asset {
@@ -13,12 +17,28 @@ class GraphicsMeshCache : public AssetCache<gxeng::IMesh> {
 public:
 	GraphicsMeshCache(gxeng::IGraphicsEngine& engine);
 
+	/// <summary> Returns the levels of detail the mesh cooker made for a mesh loaded by this cache. </summary>
+	/// <remarks> Empty for meshes not loaded by this cache. Reloading a mesh updates the level meshes in place.
+	///		Only the screen sizes and a changed number of levels need the levels to be set again. </remarks>
+	std::vector<gxeng::IMeshEntity::Lod> GetLods(const std::shared_ptr<gxeng::IMesh>& mesh) const;
+
 protected:
 	std::shared_ptr<gxeng::IMesh> Create(const std::filesystem::path& path) override;
 	void Reload(gxeng::IMesh& asset, const std::filesystem::path& path) override;
 
 private:
+	/// <summary> Uploads the mesh and its levels of detail, reusing the level meshes of a previous load. </summary>
+	std::vector<gxeng::IMeshEntity::Lod> Upload(gxeng::IMesh& asset, const std::filesystem::path& path, const std::vector<gxeng::IMeshEntity::Lod>& previousLods);
+
+private:
+	struct LodEntry {
+		std::weak_ptr<gxeng::IMesh> mesh; // Tells apart a new mesh that got the address of a destroyed one.
+		std::vector<gxeng::IMeshEntity::Lod> lods;
+	};
+
 	gxeng::IGraphicsEngine& m_engine;
+	std::unordered_map<const gxeng::IMesh*, LodEntry> m_lods;
+	mutable std::mutex m_lodMutex; // Meshes are loaded on several threads.
 };
 
 
@@ -1,11 +1,20 @@
 #include "ImageCache.hpp"
 
+#include "CookedFile.hpp"
 #include "Image.hpp"
+#include "TextureCooker.hpp"
+
+#include <algorithm>
+#include <optional>
 
 
 namespace inl::asset {
 
 
+// Large textures only keep the mips on the GPU that the renderer needs.
+constexpr size_t streamingThreshold = 512;
+
+
 template <gxeng::ePixelChannelType Type>
 static gxeng::IPixelReader& GetPixelReaderCh(int channelCount) {
 	switch (channelCount) {
@@ -41,7 +50,43 @@ std::shared_ptr<gxeng::IImage> ImageCache::Create(const std::filesystem::path& p
 
 
 void ImageCache::Reload(gxeng::IImage& asset, const std::filesystem::path& path) {
+	// Same options as offline cooking, so cooked files are interchangeable between the two.
+	const TextureCookOptions options;
+
+	std::filesystem::path cookedPath = path.extension() == CookedTexture::FILE_EXTENSION ? path : CookedTexture::GetCookedPath(path);
+	if (IsCookedUpToDate(cookedPath, path)) {
+		CookedTexture texture;
+		try {
+			texture.Load(cookedPath);
+		}
+		catch (InvalidArgumentException&) {
+			// Cooked by an older version, it is cooked again from the source below.
+			if (cookedPath == path) {
+				throw;
+			}
+		}
+		if (cookedPath == path || (texture.GetMipCount() > 0 && texture.IsCookedWith(options))) {
+			ReloadCooked(asset, texture);
+			return;
+		}
+	}
+
 	Image image{ path.generic_u8string() };
+
+	// Cooked in memory when there is no up to date cooked file, and saved for the next load.
+	std::optional<CookedTexture> cooked;
+	try {
+		cooked = CookedTexture::Cook(image, options);
+	}
+	catch (InvalidArgumentException&) {
+		// Sizes that are not a multiple of 4 and images of more than 8 bits per channel are not compressed.
+	}
+	if (cooked) {
+		TrySaveCooked(*cooked, cookedPath);
+		ReloadCooked(asset, *cooked);
+		return;
+	}
+
 	int channelCount = image.GetChannelCount();
 	eChannelType channelType = image.GetType();
 
@@ -57,9 +102,19 @@ void ImageCache::Reload(gxeng::IImage& asset, const std::filesystem::path& path)
 		}
 	}();
 
+	asset.SetStreaming(std::max(image.GetWidth(), image.GetHeight()) >= streamingThreshold);
 	asset.SetLayout(image.GetWidth(), (uint32_t)image.GetHeight(), gxChannelType, channelCount, gxeng::ePixelClass::LINEAR);
 	asset.Update(0, 0, image.GetWidth(), (uint32_t)image.GetHeight(), 0, image.GetData(), reader);
 }
 
 
+void ImageCache::ReloadCooked(gxeng::IImage& asset, const CookedTexture& texture) {
+	asset.SetStreaming(std::max(texture.GetWidth(), texture.GetHeight()) >= streamingThreshold);
+	asset.SetCompressedLayout(texture.GetWidth(), texture.GetHeight(), texture.GetCompression(), (int)texture.GetMipCount(), texture.IsSrgb());
+	for (size_t mipLevel = 0; mipLevel < texture.GetMipCount(); ++mipLevel) {
+		asset.UpdateCompressed((int)mipLevel, texture.GetMip(mipLevel).data());
+	}
+}
+
+
 } // namespace inl::asset
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "AssetCache.hpp"
+#include "TextureCooker.hpp"
 
 #include <GraphicsEngine/IGraphicsEngine.hpp>
 #include <GraphicsEngine/Resources/IImage.hpp>
@@ -17,6 +18,10 @@ protected:
 	std::shared_ptr<gxeng::IImage> Create(const std::filesystem::path& path) override;
 	void Reload(gxeng::IImage& asset, const std::filesystem::path& path) override;
 
+private:
+	/// <summary> Loads a texture made by <see cref="CookedTexture"/>, which is already compressed and has all its mips. </summary>
+	void ReloadCooked(gxeng::IImage& asset, const CookedTexture& texture);
+
 private:
 	gxeng::IGraphicsEngine& m_engine;
 };
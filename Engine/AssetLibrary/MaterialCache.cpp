@@ -67,6 +67,44 @@ std::shared_ptr<gxeng::IMaterial> MaterialCache::Create(const std::filesystem::p
 
 
 void MaterialCache::Reload(gxeng::IMaterial& asset, const std::filesystem::path& path) {
+	Description description = Parse(path);
+
+	std::shared_ptr<gxeng::IMaterialShader> shader = m_shaderCache.Load(description.shader);
+	asset.SetShader(shader.get());
+
+	for (const auto& input : description.inputs) {
+		SetMaterialParameter(GetParameter(asset, input), input);
+	}
+}
+
+
+auto MaterialCache::CreateAsync(std::filesystem::path path) -> AssetFuture {
+	Description description = Parse(path);
+	std::shared_ptr<gxeng::IMaterial> material(m_engine.CreateMaterial());
+
+	// The parameter types are only known once the shader is loaded.
+	std::shared_ptr<gxeng::IMaterialShader> shader = co_await m_shaderCache.LoadAsync(description.shader);
+	material->SetShader(shader.get());
+
+	std::vector<std::pair<const Input*, ImageCache::AssetFuture>> images;
+	for (const auto& input : description.inputs) {
+		gxeng::IMaterial::Parameter& param = GetParameter(*material, input);
+		if (IsImage(param, input)) {
+			images.push_back({ &input, m_imageCache.LoadAsync(std::get<std::string>(input.value)) });
+		}
+		else {
+			SetMaterialParameter(param, input);
+		}
+	}
+	for (auto& [input, image] : images) {
+		GetParameter(*material, *input) = (co_await image).get();
+	}
+
+	co_return material;
+}
+
+
+auto MaterialCache::Parse(const std::filesystem::path& path) -> Description {
 	using namespace rapidjson;
 
 	std::ifstream file(path);
@@ -89,49 +127,60 @@ void MaterialCache::Reload(gxeng::IMaterial& asset, const std::filesystem::path&
 	AssertThrow(doc.HasMember("shader") && doc["shader"].IsString(), R"(Material JSON document must have members "shader" and "inputs")");
 	AssertThrow(doc.HasMember("inputs"), R"(Material JSON document must have members "header", "shader" and "inputs")");
 
-
-	std::string shaderName = doc["shader"].GetString();
-
-	std::shared_ptr<gxeng::IMaterialShader> shader = m_shaderCache.Load(shaderName);
-	asset.SetShader(shader.get());
+	Description description;
+	description.shader = doc["shader"].GetString();
 
 	const auto& inputs = doc["inputs"];
 
-
-	auto SetParam = [this](gxeng::IMaterial::Parameter& param, const std::string& name, const Value& value) {
-		try {
-			if (value.IsString()) {
-				SetMaterialParameter(param, value.GetString());
-			}
-			else if (value.IsFloat()) {
-				SetMaterialParameter(param, value.GetFloat());
-			}
-			else {
-				throw InvalidArgumentException("Material inputs must be either of Image (string of path), Vec4 (string of Vec4) or float (string of float or float)");
-			}
+	auto ParseValue = [](const std::string& name, const Value& value) -> std::variant<std::string, float> {
+		if (value.IsString()) {
+			return std::string(value.GetString());
 		}
-		catch (InvalidArgumentException& ex) {
-			throw InvalidArgumentException(ex.Message(), std::string("While parsing input \"") + name + "\"");
+		else if (value.IsFloat()) {
+			return value.GetFloat();
 		}
+		throw InvalidArgumentException("Material inputs must be either of Image (string of path), Vec4 (string of Vec4) or float (string of float or float)",
+									   std::string("While parsing input \"") + name + "\"");
 	};
 
 	if (inputs.IsObject()) {
 		for (auto it = inputs.MemberBegin(); it != inputs.MemberEnd(); ++it) {
 			std::string name = it->name.GetString();
-			gxeng::IMaterial::Parameter& param = asset.GetParameter(name);
-			SetParam(param, name, it->value);
+			description.inputs.push_back({ name, -1, ParseValue(name, it->value) });
 		}
 	}
 	else if (inputs.IsArray()) {
 		int idx = 0;
 		for (auto it = inputs.Begin(); it != inputs.End(); ++it, ++idx) {
-			gxeng::IMaterial::Parameter& param = asset.GetParameter(idx);
-			SetParam(param, std::to_string(idx), *it);
+			description.inputs.push_back({ std::to_string(idx), idx, ParseValue(std::to_string(idx), *it) });
 		}
 	}
 	else {
 		throw InvalidArgumentException("Material JSON input list must be an object with key-value pairs or an array with the values.");
 	}
+
+	return description;
+}
+
+
+gxeng::IMaterial::Parameter& MaterialCache::GetParameter(gxeng::IMaterial& material, const Input& input) {
+	return input.index >= 0 ? material.GetParameter(size_t(input.index)) : material.GetParameter(input.name);
+}
+
+
+bool MaterialCache::IsImage(const gxeng::IMaterial::Parameter& param, const Input& input) {
+	return std::holds_alternative<std::string>(input.value)
+		   && (param.GetType() == gxeng::eMaterialShaderParamType::BITMAP_COLOR_2D || param.GetType() == gxeng::eMaterialShaderParamType::BITMAP_VALUE_2D);
+}
+
+
+void MaterialCache::SetMaterialParameter(gxeng::IMaterial::Parameter& param, const Input& input) {
+	try {
+		std::visit([&](const auto& value) { SetMaterialParameter(param, value); }, input.value);
+	}
+	catch (InvalidArgumentException& ex) {
+		throw InvalidArgumentException(ex.Message(), std::string("While parsing input \"") + input.name + "\"");
+	}
 }
 
 
@@ -5,6 +5,10 @@
 #include <GraphicsEngine/IGraphicsEngine.hpp>
 #include <GraphicsEngine/Resources/IMaterial.hpp>
 
+#include <string>
+#include <variant>
+#include <vector>
+
 
 namespace inl::asset {
 
@@ -20,7 +24,26 @@ protected:
 	std::shared_ptr<gxeng::IMaterial> Create(const std::filesystem::path& path) override;
 	void Reload(gxeng::IMaterial& asset, const std::filesystem::path& path) override;
 
+	/// <summary> Loads the shader, then all the images in parallel. </summary>
+	AssetFuture CreateAsync(std::filesystem::path path) override;
+
 private:
+	struct Input {
+		std::string name; // The index for inputs given as an array.
+		int index; // -1 for inputs given by name.
+		std::variant<std::string, float> value;
+	};
+	struct Description {
+		std::string shader;
+		std::vector<Input> inputs;
+	};
+
+	/// <summary> Reads the JSON material description. </summary>
+	static Description Parse(const std::filesystem::path& path);
+	static gxeng::IMaterial::Parameter& GetParameter(gxeng::IMaterial& material, const Input& input);
+	static bool IsImage(const gxeng::IMaterial::Parameter& param, const Input& input);
+
+	void SetMaterialParameter(gxeng::IMaterial::Parameter& param, const Input& input);
 	void SetMaterialParameter(gxeng::IMaterial::Parameter& param, std::string value);
 	void SetMaterialParameter(gxeng::IMaterial::Parameter& param, float value);
 
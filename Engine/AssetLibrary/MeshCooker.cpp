@@ -0,0 +1,367 @@
+#include "MeshCooker.hpp"
+
+#include <BaseLibrary/Exception/Exception.hpp>
+#include <GraphicsEngine_LL/VertexCompressor.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+
+namespace inl::asset {
+
+
+static size_t AlignUp(size_t value, size_t alignment) {
+	return (value + alignment - 1) / alignment * alignment;
+}
+
+
+template <class T>
+static void WriteArray(std::vector<uint8_t>& image, size_t offset, const T* data, size_t count) {
+	if (count > 0) {
+		std::memcpy(image.data() + offset, data, count * sizeof(T));
+	}
+}
+
+
+static void WriteIndices(std::vector<uint8_t>& image, size_t offset, const std::vector<uint32_t>& indices, uint32_t indexSize) {
+	if (indexSize == sizeof(uint32_t)) {
+		WriteArray(image, offset, indices.data(), indices.size());
+	}
+	else {
+		std::vector<uint16_t> narrowIndices(indices.begin(), indices.end());
+		WriteArray(image, offset, narrowIndices.data(), narrowIndices.size());
+	}
+}
+
+
+static void ExtendBounds(const Vec3& point, Vec3& boundsMin, Vec3& boundsMax) {
+	boundsMin = Min(boundsMin, point);
+	boundsMax = Max(boundsMax, point);
+}
+
+
+CookedMesh CookedMesh::Cook(const Model& model, const MeshCookOptions& options) {
+	std::vector<std::vector<Vertex>> submeshVertices;
+	std::vector<std::vector<unsigned>> submeshIndices;
+	for (unsigned submeshId = 0; submeshId < model.SubmeshCount(); ++submeshId) {
+		submeshVertices.push_back(model.GetVertices<gxeng::Position<0>, gxeng::Normal<0>, gxeng::TexCoord<0>, gxeng::Tangent<0>>(submeshId, options.coordinateSystem));
+		submeshIndices.push_back(model.GetIndices(submeshId));
+	}
+	return Cook(submeshVertices, submeshIndices, options);
+}
+
+
+CookedMesh CookedMesh::Cook(const std::vector<std::vector<Vertex>>& submeshVertices, const std::vector<std::vector<unsigned>>& submeshIndices, const MeshCookOptions& options) {
+	if (submeshVertices.size() != submeshIndices.size()) {
+		throw InvalidArgumentException("Each submesh must have both vertices and indices.");
+	}
+
+	// Merge submeshes.
+	std::vector<Vertex> vertices;
+	std::vector<uint32_t> indices;
+	std::vector<CookedSubmesh> submeshes;
+	gxeng::MeshletBuffers meshlets;
+	constexpr float inf = std::numeric_limits<float>::infinity();
+	Vec3 meshMin = { inf, inf, inf };
+	Vec3 meshMax = { -inf, -inf, -inf };
+	for (size_t submeshId = 0; submeshId < submeshVertices.size(); ++submeshId) {
+		std::vector<Vertex> subVertices = submeshVertices[submeshId];
+		std::vector<uint32_t> subIndices(submeshIndices[submeshId].begin(), submeshIndices[submeshId].end());
+		for (uint32_t index : subIndices) {
+			if (index >= subVertices.size()) {
+				throw InvalidArgumentException("Submesh index out of range.", std::to_string(submeshId));
+			}
+		}
+
+		std::vector<Vec3> positions;
+		for (const auto& vertex : subVertices) {
+			positions.push_back(vertex.position);
+		}
+		if (options.optimize) {
+			gxeng::OptimizeVertexCache(subIndices.data(), subIndices.size(), subVertices.size());
+			gxeng::OptimizeOverdraw(subIndices.data(), subIndices.size(), positions.data(), positions.size());
+			std::vector<uint32_t> remap = gxeng::OptimizeVertexFetch(subIndices.data(), subIndices.size(), subVertices.size());
+			std::vector<Vertex> reorderedVertices(subVertices.size());
+			std::vector<Vec3> reorderedPositions(positions.size());
+			for (size_t v = 0; v < subVertices.size(); ++v) {
+				reorderedVertices[remap[v]] = subVertices[v];
+				reorderedPositions[remap[v]] = positions[v];
+			}
+			subVertices = std::move(reorderedVertices);
+			positions = std::move(reorderedPositions);
+		}
+
+		CookedSubmesh submesh;
+		submesh.firstIndex = uint32_t(indices.size());
+		submesh.indexCount = uint32_t(subIndices.size());
+		submesh.baseVertex = uint32_t(vertices.size());
+		submesh.vertexCount = uint32_t(subVertices.size());
+		submesh.firstMeshlet = uint32_t(meshlets.meshlets.size());
+		submesh.meshletCount = 0;
+
+		if (options.generateMeshlets) {
+			gxeng::MeshletBuffers subMeshlets = gxeng::BuildMeshlets(subIndices.data(), subIndices.size(), positions.data(), positions.size(),
+																	 options.meshletMaxVertices, options.meshletMaxTriangles);
+			for (auto meshlet : subMeshlets.meshlets) {
+				meshlet.vertexOffset += uint32_t(meshlets.vertices.size());
+				meshlet.triangleOffset += uint32_t(meshlets.triangles.size() / 3);
+				meshlets.meshlets.push_back(meshlet);
+			}
+			for (uint32_t vertex : subMeshlets.vertices) {
+				meshlets.vertices.push_back(submesh.baseVertex + vertex);
+			}
+			meshlets.triangles.insert(meshlets.triangles.end(), subMeshlets.triangles.begin(), subMeshlets.triangles.end());
+			submesh.meshletCount = uint32_t(subMeshlets.meshlets.size());
+		}
+
+		Vec3 subMin = { inf, inf, inf };
+		Vec3 subMax = { -inf, -inf, -inf };
+		for (const auto& position : positions) {
+			ExtendBounds(position, subMin, subMax);
+		}
+		if (!subVertices.empty()) {
+			ExtendBounds(subMin, meshMin, meshMax);
+			ExtendBounds(subMax, meshMin, meshMax);
+		}
+		else {
+			subMin = subMax = { 0, 0, 0 };
+		}
+		submesh.boundsMin = subMin;
+		submesh.boundsMax = subMax;
+
+		for (uint32_t index : subIndices) {
+			indices.push_back(submesh.baseVertex + index);
+		}
+		vertices.insert(vertices.end(), subVertices.begin(), subVertices.end());
+		submeshes.push_back(submesh);
+	}
+	if (vertices.empty()) {
+		meshMin = meshMax = { 0, 0, 0 };
+	}
+
+	// Simplify the merged mesh, each level keeps only the vertices it uses.
+	std::vector<LodLevel> lods;
+	std::vector<std::vector<Vertex>> lodVertices;
+	if (options.generateLods && !indices.empty()) {
+		std::vector<Vec3> positions;
+		for (const auto& vertex : vertices) {
+			positions.push_back(vertex.position);
+		}
+		lods = GenerateLodChain(positions, indices, options.lodOptions);
+		for (auto& lod : lods) {
+			if (options.optimize) {
+				gxeng::OptimizeVertexCache(lod.indices.data(), lod.indices.size(), vertices.size());
+			}
+			// Compacted in the order of first use, which is the order vertex fetch wants.
+			lodVertices.push_back(CompactVertices(vertices, lod.indices));
+		}
+	}
+
+	// Compress vertices to the layout the mesh uploads.
+	gxeng::VertexQuantization quantization = options.quantization;
+	quantization.boundsMin = meshMin;
+	quantization.boundsMax = meshMax;
+	quantization.texCoordMin = quantization.texCoordMax = { 0, 0 };
+	if (!vertices.empty()) {
+		quantization.texCoordMin = quantization.texCoordMax = Vec2(vertices[0].texCoord);
+		for (const auto& vertex : vertices) {
+			quantization.texCoordMin = Min(quantization.texCoordMin, Vec2(vertex.texCoord));
+			quantization.texCoordMax = Max(quantization.texCoordMax, Vec2(vertex.texCoord));
+		}
+	}
+	const gxeng::IVertexReader& reader = Vertex::GetReader();
+	const auto& readerElements = reader.GetElements();
+	gxeng::VertexCompressor compressor{ &reader, std::vector<bool>(readerElements.size(), true), quantization };
+	std::vector<uint8_t> vertexData = compressor.GetCompressedStream(vertices.data(), vertices.size());
+	std::vector<int> offsets = compressor.GetCompressedOffsets();
+	std::vector<std::vector<uint8_t>> lodVertexData;
+	for (const auto& levelVertices : lodVertices) {
+		lodVertexData.push_back(compressor.GetCompressedStream(levelVertices.data(), levelVertices.size()));
+	}
+
+	std::vector<FileElement> elements;
+	for (size_t i = 0; i < readerElements.size(); ++i) {
+		if (offsets[i] >= 0) {
+			elements.push_back({ uint32_t(readerElements[i].semantic), readerElements[i].index, offsets[i] });
+		}
+	}
+
+	// Lay out the file image.
+	Header header = {};
+	header.magic = FILE_MAGIC;
+	header.version = FILE_VERSION;
+	header.vertexCount = uint32_t(vertices.size());
+	header.vertexStride = uint32_t(compressor.GetCompressedStride());
+	header.indexCount = uint32_t(indices.size());
+	header.indexSize = vertices.size() > 0xFFFFu ? sizeof(uint32_t) : sizeof(uint16_t);
+	header.elementCount = uint32_t(elements.size());
+	header.submeshCount = uint32_t(submeshes.size());
+	header.meshletCount = uint32_t(meshlets.meshlets.size());
+	header.meshletVertexCount = uint32_t(meshlets.vertices.size());
+	header.meshletTriangleCount = uint32_t(meshlets.triangles.size() / 3);
+	header.lodCount = uint32_t(lods.size());
+	header.positionEncoding = uint32_t(quantization.position);
+	header.normalEncoding = uint32_t(quantization.normal);
+	header.tangentEncoding = uint32_t(quantization.tangent);
+	header.texCoordEncoding = uint32_t(quantization.texCoord);
+	header.texCoordMin = quantization.texCoordMin;
+	header.texCoordMax = quantization.texCoordMax;
+	header.boundsMin = meshMin;
+	header.boundsMax = meshMax;
+	header.elementsOffset = AlignUp(sizeof(Header), SECTION_ALIGNMENT);
+	header.submeshesOffset = AlignUp(header.elementsOffset + elements.size() * sizeof(FileElement), SECTION_ALIGNMENT);
+	header.verticesOffset = AlignUp(header.submeshesOffset + submeshes.size() * sizeof(CookedSubmesh), SECTION_ALIGNMENT);
+	header.indicesOffset = AlignUp(header.verticesOffset + vertexData.size(), SECTION_ALIGNMENT);
+	header.meshletsOffset = AlignUp(header.indicesOffset + indices.size() * header.indexSize, SECTION_ALIGNMENT);
+	header.meshletVerticesOffset = AlignUp(header.meshletsOffset + meshlets.meshlets.size() * sizeof(gxeng::Meshlet), SECTION_ALIGNMENT);
+	header.meshletTrianglesOffset = AlignUp(header.meshletVerticesOffset + meshlets.vertices.size() * sizeof(uint32_t), SECTION_ALIGNMENT);
+	header.lodsOffset = AlignUp(header.meshletTrianglesOffset + meshlets.triangles.size(), SECTION_ALIGNMENT);
+
+	std::vector<CookedLod> cookedLods;
+	size_t imageSize = header.lodsOffset + lods.size() * sizeof(CookedLod);
+	for (size_t i = 0; i < lods.size(); ++i) {
+		CookedLod lod;
+		lod.vertexCount = uint32_t(lodVertices[i].size());
+		lod.indexCount = uint32_t(lods[i].indices.size());
+		lod.error = lods[i].error;
+		lod.screenSize = lods[i].screenSize;
+		lod.verticesOffset = AlignUp(imageSize, SECTION_ALIGNMENT);
+		lod.indicesOffset = AlignUp(lod.verticesOffset + lodVertexData[i].size(), SECTION_ALIGNMENT);
+		imageSize = lod.indicesOffset + lods[i].indices.size() * header.indexSize;
+		cookedLods.push_back(lod);
+	}
+
+	CookedMesh mesh;
+	mesh.m_buffer.resize(imageSize);
+	WriteArray(mesh.m_buffer, 0, &header, 1);
+	WriteArray(mesh.m_buffer, header.elementsOffset, elements.data(), elements.size());
+	WriteArray(mesh.m_buffer, header.submeshesOffset, submeshes.data(), submeshes.size());
+	WriteArray(mesh.m_buffer, header.verticesOffset, vertexData.data(), vertexData.size());
+	WriteIndices(mesh.m_buffer, header.indicesOffset, indices, header.indexSize);
+	WriteArray(mesh.m_buffer, header.meshletsOffset, meshlets.meshlets.data(), meshlets.meshlets.size());
+	WriteArray(mesh.m_buffer, header.meshletVerticesOffset, meshlets.vertices.data(), meshlets.vertices.size());
+	WriteArray(mesh.m_buffer, header.meshletTrianglesOffset, meshlets.triangles.data(), meshlets.triangles.size());
+	WriteArray(mesh.m_buffer, header.lodsOffset, cookedLods.data(), cookedLods.size());
+	for (size_t i = 0; i < lods.size(); ++i) {
+		WriteArray(mesh.m_buffer, cookedLods[i].verticesOffset, lodVertexData[i].data(), lodVertexData[i].size());
+		WriteIndices(mesh.m_buffer, cookedLods[i].indicesOffset, lods[i].indices, header.indexSize);
+	}
+
+	mesh.Parse(mesh.m_buffer.data(), mesh.m_buffer.size(), {});
+	return mesh;
+}
+
+
+gxeng::VertexQuantization CookedMesh::GetQuantization() const {
+	gxeng::VertexQuantization quantization;
+	quantization.position = gxeng::ePositionEncoding(m_header.positionEncoding);
+	quantization.normal = gxeng::eDirectionEncoding(m_header.normalEncoding);
+	quantization.tangent = gxeng::eDirectionEncoding(m_header.tangentEncoding);
+	quantization.texCoord = gxeng::eTexCoordEncoding(m_header.texCoordEncoding);
+	quantization.boundsMin = m_header.boundsMin;
+	quantization.boundsMax = m_header.boundsMax;
+	quantization.texCoordMin = m_header.texCoordMin;
+	quantization.texCoordMax = m_header.texCoordMax;
+	return quantization;
+}
+
+
+std::filesystem::path CookedMesh::GetCookedPath(const std::filesystem::path& sourcePath) {
+	std::filesystem::path cookedPath = sourcePath;
+	cookedPath += FILE_EXTENSION;
+	return cookedPath;
+}
+
+
+void CookedMesh::Save(const std::filesystem::path& path) const {
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	if (!file.is_open()) {
+		throw RuntimeException("Failed to open file for writing.", path.generic_u8string());
+	}
+	file.write(reinterpret_cast<const char*>(m_image), m_imageSize);
+	file.close();
+	if (!file) {
+		throw RuntimeException("Failed to write file.", path.generic_u8string());
+	}
+}
+
+
+void CookedMesh::Load(const std::filesystem::path& path) {
+	CookedMesh mesh;
+	mesh.m_file = MappedFile(path);
+	mesh.Parse(mesh.m_file.GetData(), mesh.m_file.GetSize(), path);
+	*this = std::move(mesh);
+}
+
+
+void CookedMesh::Parse(const uint8_t* data, size_t size, const std::filesystem::path& path) {
+	auto IsInside = [size](uint64_t offset, uint64_t count, size_t elementSize) {
+		return offset % SECTION_ALIGNMENT == 0 && offset <= size && count <= (size - offset) / elementSize;
+	};
+
+	Header header;
+	if (size < sizeof(Header)) {
+		throw InvalidArgumentException("File is not a cooked mesh of this version.", path.generic_u8string());
+	}
+	std::memcpy(&header, data, sizeof(Header));
+	if (header.magic != FILE_MAGIC || header.version != FILE_VERSION) {
+		throw InvalidArgumentException("File is not a cooked mesh of this version.", path.generic_u8string());
+	}
+	if ((header.indexSize != sizeof(uint16_t) && header.indexSize != sizeof(uint32_t))
+		|| header.vertexStride == 0
+		|| header.positionEncoding > uint32_t(gxeng::ePositionEncoding::UNORM16)
+		|| header.normalEncoding > uint32_t(gxeng::eDirectionEncoding::OCTAHEDRAL32)
+		|| header.tangentEncoding > uint32_t(gxeng::eDirectionEncoding::OCTAHEDRAL32)
+		|| header.texCoordEncoding > uint32_t(gxeng::eTexCoordEncoding::UNORM16)
+		|| !IsInside(header.elementsOffset, header.elementCount, sizeof(FileElement))
+		|| !IsInside(header.submeshesOffset, header.submeshCount, sizeof(CookedSubmesh))
+		|| !IsInside(header.verticesOffset, header.vertexCount, header.vertexStride)
+		|| !IsInside(header.indicesOffset, header.indexCount, header.indexSize)
+		|| !IsInside(header.meshletsOffset, header.meshletCount, sizeof(gxeng::Meshlet))
+		|| !IsInside(header.meshletVerticesOffset, header.meshletVertexCount, sizeof(uint32_t))
+		|| !IsInside(header.meshletTrianglesOffset, header.meshletTriangleCount, 3)
+		|| !IsInside(header.lodsOffset, header.lodCount, sizeof(CookedLod))) {
+		throw InvalidArgumentException("Cooked mesh is corrupt.", path.generic_u8string());
+	}
+
+	auto lods = reinterpret_cast<const CookedLod*>(data + header.lodsOffset);
+	for (uint32_t i = 0; i < header.lodCount; ++i) {
+		if (!IsInside(lods[i].verticesOffset, lods[i].vertexCount, header.vertexStride)
+			|| !IsInside(lods[i].indicesOffset, lods[i].indexCount, header.indexSize)) {
+			throw InvalidArgumentException("Cooked mesh is corrupt.", path.generic_u8string());
+		}
+	}
+
+	std::vector<gxeng::IMesh::Element> elements;
+	auto fileElements = reinterpret_cast<const FileElement*>(data + header.elementsOffset);
+	for (uint32_t i = 0; i < header.elementCount; ++i) {
+		if (fileElements[i].offset < 0 || uint32_t(fileElements[i].offset) >= header.vertexStride) {
+			throw InvalidArgumentException("Cooked mesh is corrupt.", path.generic_u8string());
+		}
+		elements.push_back({ gxeng::eVertexElementSemantic(fileElements[i].semantic), fileElements[i].index, fileElements[i].offset });
+	}
+
+	m_image = data;
+	m_imageSize = size;
+	m_header = header;
+	m_elements = std::move(elements);
+	m_submeshes = reinterpret_cast<const CookedSubmesh*>(data + header.submeshesOffset);
+	m_vertices = data + header.verticesOffset;
+	m_indices = data + header.indicesOffset;
+	m_meshlets = reinterpret_cast<const gxeng::Meshlet*>(data + header.meshletsOffset);
+	m_meshletVertices = reinterpret_cast<const uint32_t*>(data + header.meshletVerticesOffset);
+	m_meshletTriangles = data + header.meshletTrianglesOffset;
+	m_lods = lods;
+}
+
+
+void CookMesh(const std::filesystem::path& sourcePath, const MeshCookOptions& options) {
+	Model model{ sourcePath };
+	CookedMesh mesh = CookedMesh::Cook(model, options);
+	mesh.Save(CookedMesh::GetCookedPath(sourcePath));
+}
+
+
+} // namespace inl::asset
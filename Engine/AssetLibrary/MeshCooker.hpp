@@ -0,0 +1,195 @@
+#pragma once
+
+#include "CookedFile.hpp"
+#include "MeshSimplifier.hpp"
+#include "Model.hpp"
+
+#include <GraphicsEngine/Resources/IMesh.hpp>
+#include <GraphicsEngine/Resources/Vertex.hpp>
+#include <GraphicsEngine/Resources/VertexQuantization.hpp>
+#include <GraphicsEngine_LL/MeshOptimizer.hpp>
+
+#include <InlineMath.hpp>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+
+namespace inl::asset {
+
+
+struct MeshCookOptions {
+	/// <summary> Axes of the source file expressed in engine space. </summary>
+	CoordSysLayout coordinateSystem = { AxisDir::POS_X, AxisDir::POS_Z, AxisDir::NEG_Y };
+	/// <summary> Reorders each submesh for the post-transform cache, overdraw and vertex fetch. </summary>
+	bool optimize = true;
+	/// <summary> Vertex encoding of all levels. Positions are quantized within the bounds of the merged mesh,
+	///		texture coordinates within the range of its vertices. </summary>
+	gxeng::VertexQuantization quantization = {
+		gxeng::ePositionEncoding::UNORM16,
+		gxeng::eDirectionEncoding::OCTAHEDRAL32,
+		gxeng::eDirectionEncoding::OCTAHEDRAL32,
+		gxeng::eTexCoordEncoding::HALF16,
+	};
+	/// <summary> Clusters each submesh into meshlets with bounds and normal cones. </summary>
+	bool generateMeshlets = false;
+	unsigned meshletMaxVertices = 64;
+	unsigned meshletMaxTriangles = 124;
+	/// <summary> Simplifies the merged mesh into levels of detail, see <see cref="gxeng::IMeshEntity::SetLods"/>. </summary>
+	bool generateLods = true;
+	LodChainOptions lodOptions;
+};
+
+
+/// <summary> A range of the merged vertex and index buffer that was a separate mesh in the source file. </summary>
+struct CookedSubmesh {
+	uint32_t firstIndex;
+	uint32_t indexCount;
+	uint32_t baseVertex; // Indices are already offset by this.
+	uint32_t vertexCount;
+	uint32_t firstMeshlet;
+	uint32_t meshletCount;
+	Vec3_Packed boundsMin;
+	Vec3_Packed boundsMax;
+};
+
+
+/// <summary> A lower detail level of the merged mesh with its own vertices, in the same layout as the base mesh. </summary>
+/// <remarks> Submeshes are not kept, the level covers the whole mesh. </remarks>
+struct CookedLod {
+	uint32_t vertexCount;
+	uint32_t indexCount; // Same index size as the base mesh.
+	float error; // Relative to the radius of the mesh's bounds.
+	float screenSize; // See IMeshEntity::Lod.
+	uint64_t verticesOffset;
+	uint64_t indicesOffset;
+};
+
+
+/// <summary> All submeshes of a model merged into one vertex and index buffer, in the layout the GPU reads. </summary>
+/// <remarks> Cooking happens offline so that loading does not have to go through assimp.
+///		Loaded meshes are served straight from a memory mapped file. </remarks>
+class CookedMesh {
+public:
+	using Vertex = gxeng::Vertex<gxeng::Position<0>, gxeng::Normal<0>, gxeng::TexCoord<0>, gxeng::Tangent<0>>;
+
+	static constexpr const char* FILE_EXTENSION = ".cmesh";
+
+public:
+	CookedMesh() = default;
+	CookedMesh(CookedMesh&&) = default;
+	CookedMesh& operator=(CookedMesh&&) = default;
+	CookedMesh(const CookedMesh&) = delete; // Views into the storage would dangle.
+	CookedMesh& operator=(const CookedMesh&) = delete;
+
+	/// <summary> Merges and compresses all submeshes of the model. </summary>
+	static CookedMesh Cook(const Model& model, const MeshCookOptions& options = {});
+	/// <summary> Merges and compresses the submeshes, indices are relative to the submesh's own vertices. </summary>
+	/// <exception cref="InvalidArgumentException"> If the counts differ or an index is out of range. </exception>
+	static CookedMesh Cook(const std::vector<std::vector<Vertex>>& submeshVertices, const std::vector<std::vector<unsigned>>& submeshIndices, const MeshCookOptions& options = {});
+
+	/// <summary> Returns where the cooked version of the source model is stored. </summary>
+	static std::filesystem::path GetCookedPath(const std::filesystem::path& sourcePath);
+
+	void Save(const std::filesystem::path& path) const;
+	/// <summary> Maps the file, the data is not copied. </summary>
+	void Load(const std::filesystem::path& path);
+
+	const void* GetVertexData() const { return m_vertices; }
+	uint32_t GetVertexStride() const { return m_header.vertexStride; }
+	size_t GetVertexCount() const { return m_header.vertexCount; }
+
+	/// <summary> 16 bit if the vertex count fits, as the mesh buffer stores them. </summary>
+	const void* GetIndexData() const { return m_indices; }
+	bool IsIndex32Bit() const { return m_header.indexSize == sizeof(uint32_t); }
+	size_t GetIndexCount() const { return m_header.indexCount; }
+
+	const std::vector<gxeng::IMesh::Element>& GetElements() const { return m_elements; }
+	/// <summary> The encoding to pass to <see cref="gxeng::IMesh::SetCompressed"/> with the vertices of any level. </summary>
+	gxeng::VertexQuantization GetQuantization() const;
+	size_t GetSubmeshCount() const { return m_header.submeshCount; }
+	const CookedSubmesh& GetSubmesh(size_t index) const { return m_submeshes[index]; }
+	Vec3 GetBoundsMin() const { return m_header.boundsMin; }
+	Vec3 GetBoundsMax() const { return m_header.boundsMax; }
+
+	/// <summary> Meshlet vertices are indices into the merged vertex buffer. </summary>
+	size_t GetMeshletCount() const { return m_header.meshletCount; }
+	const gxeng::Meshlet& GetMeshlet(size_t index) const { return m_meshlets[index]; }
+	const uint32_t* GetMeshletVertices() const { return m_meshletVertices; }
+	const uint8_t* GetMeshletTriangles() const { return m_meshletTriangles; }
+
+	/// <summary> Levels of detail from the most to the least detailed, not including the base mesh. </summary>
+	size_t GetLodCount() const { return m_header.lodCount; }
+	const CookedLod& GetLod(size_t index) const { return m_lods[index]; }
+	const void* GetLodVertexData(size_t index) const { return m_image + m_lods[index].verticesOffset; }
+	const void* GetLodIndexData(size_t index) const { return m_image + m_lods[index].indicesOffset; }
+
+private:
+	struct Header {
+		uint32_t magic;
+		uint32_t version;
+		uint32_t vertexCount;
+		uint32_t vertexStride;
+		uint32_t indexCount;
+		uint32_t indexSize;
+		uint32_t elementCount;
+		uint32_t submeshCount;
+		uint32_t meshletCount;
+		uint32_t meshletVertexCount;
+		uint32_t meshletTriangleCount;
+		uint32_t lodCount;
+		uint32_t positionEncoding;
+		uint32_t normalEncoding;
+		uint32_t tangentEncoding;
+		uint32_t texCoordEncoding;
+		Vec2_Packed texCoordMin;
+		Vec2_Packed texCoordMax;
+		Vec3_Packed boundsMin; // Positions are quantized within these.
+		Vec3_Packed boundsMax;
+		uint64_t elementsOffset;
+		uint64_t submeshesOffset;
+		uint64_t verticesOffset;
+		uint64_t indicesOffset;
+		uint64_t meshletsOffset;
+		uint64_t meshletVerticesOffset;
+		uint64_t meshletTrianglesOffset;
+		uint64_t lodsOffset;
+	};
+
+	struct FileElement {
+		uint32_t semantic;
+		int32_t index;
+		int32_t offset;
+	};
+
+	void Parse(const uint8_t* data, size_t size, const std::filesystem::path& path);
+
+private:
+	// Either of these own the file image, the rest are views into it.
+	std::vector<uint8_t> m_buffer;
+	MappedFile m_file;
+
+	const uint8_t* m_image = nullptr;
+	size_t m_imageSize = 0;
+
+	Header m_header = {};
+	std::vector<gxeng::IMesh::Element> m_elements;
+	const CookedSubmesh* m_submeshes = nullptr;
+	const void* m_vertices = nullptr;
+	const void* m_indices = nullptr;
+	const gxeng::Meshlet* m_meshlets = nullptr;
+	const uint32_t* m_meshletVertices = nullptr;
+	const uint8_t* m_meshletTriangles = nullptr;
+	const CookedLod* m_lods = nullptr;
+
+	static constexpr uint32_t FILE_MAGIC = 0x48534D49; // "IMSH"
+	static constexpr uint32_t FILE_VERSION = 4;
+	static constexpr size_t SECTION_ALIGNMENT = 16;
+};
+
+
+/// <summary> Cooks the model file and saves the result at <see cref="CookedMesh::GetCookedPath"/>. </summary>
+void CookMesh(const std::filesystem::path& sourcePath, const MeshCookOptions& options = {});
+
+
+} // namespace inl::asset
@@ -0,0 +1,356 @@
+#include "MeshSimplifier.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <unordered_map>
+#include <unordered_set>
+
+
+namespace inl::asset {
+
+
+namespace {
+
+	// Sum of squared distances to a set of weighted planes, evaluated as pT*Q*p.
+	struct Quadric {
+		double a2 = 0, ab = 0, ac = 0, ad = 0;
+		double b2 = 0, bc = 0, bd = 0;
+		double c2 = 0, cd = 0;
+		double d2 = 0;
+		double weight = 0;
+
+		void AddPlane(const Vec3& normal, float distance, double planeWeight) {
+			const double a = normal.x, b = normal.y, c = normal.z, d = distance;
+			a2 += planeWeight * a * a, ab += planeWeight * a * b, ac += planeWeight * a * c, ad += planeWeight * a * d;
+			b2 += planeWeight * b * b, bc += planeWeight * b * c, bd += planeWeight * b * d;
+			c2 += planeWeight * c * c, cd += planeWeight * c * d;
+			d2 += planeWeight * d * d;
+			weight += planeWeight;
+		}
+
+		Quadric& operator+=(const Quadric& rhs) {
+			a2 += rhs.a2, ab += rhs.ab, ac += rhs.ac, ad += rhs.ad;
+			b2 += rhs.b2, bc += rhs.bc, bd += rhs.bd;
+			c2 += rhs.c2, cd += rhs.cd;
+			d2 += rhs.d2;
+			weight += rhs.weight;
+			return *this;
+		}
+
+		// Mean squared distance.
+		double Error(const Vec3& p) const {
+			const double x = p.x, y = p.y, z = p.z;
+			const double sum = a2 * x * x + 2 * ab * x * y + 2 * ac * x * z + 2 * ad * x
+							   + b2 * y * y + 2 * bc * y * z + 2 * bd * y
+							   + c2 * z * z + 2 * cd * z
+							   + d2;
+			return weight > 0 ? std::max(0.0, sum / weight) : 0.0;
+		}
+	};
+
+
+	struct Collapse {
+		uint32_t source;
+		uint32_t target;
+		double error;
+	};
+
+
+	uint64_t EdgeKey(uint32_t from, uint32_t to) {
+		return (uint64_t(from) << 32) | to;
+	}
+
+
+	// Border edges are used by one triangle only, identified on welded positions.
+	std::unordered_set<uint64_t> FindBorderEdges(const std::vector<uint32_t>& indices, const std::vector<uint32_t>& welded) {
+		std::unordered_set<uint64_t> directed;
+		directed.reserve(indices.size());
+		for (size_t i = 0; i < indices.size(); i += 3) {
+			for (int corner = 0; corner < 3; ++corner) {
+				directed.insert(EdgeKey(welded[indices[i + corner]], welded[indices[i + (corner + 1) % 3]]));
+			}
+		}
+		std::unordered_set<uint64_t> border;
+		for (uint64_t edge : directed) {
+			uint32_t from = uint32_t(edge >> 32), to = uint32_t(edge);
+			if (directed.count(EdgeKey(to, from)) == 0) {
+				border.insert(EdgeKey(std::min(from, to), std::max(from, to)));
+			}
+		}
+		return border;
+	}
+
+
+	Vec3 TriangleNormal(const Vec3& a, const Vec3& b, const Vec3& c) {
+		return Cross(b - a, c - a);
+	}
+
+} // namespace
+
+
+float SimplifyMesh(std::vector<uint32_t>& indices, const std::vector<Vec3>& sourcePositions, const SimplifyOptions& options) {
+	const size_t vertexCount = sourcePositions.size();
+	if (indices.size() < 3 || vertexCount == 0) {
+		return 0.0f;
+	}
+
+	// Work in a unit sized space so that errors are relative to the mesh's size.
+	Vec3 boundsMin = sourcePositions[0], boundsMax = sourcePositions[0];
+	for (const auto& position : sourcePositions) {
+		boundsMin = Min(boundsMin, position);
+		boundsMax = Max(boundsMax, position);
+	}
+	const Vec3 center = (boundsMin + boundsMax) * 0.5f;
+	const float radius = std::max(Length(boundsMax - boundsMin) * 0.5f, std::numeric_limits<float>::min());
+	std::vector<Vec3> positions(vertexCount);
+	for (size_t v = 0; v < vertexCount; ++v) {
+		positions[v] = (sourcePositions[v] - center) / radius;
+	}
+
+	// Vertices sharing a position are welded for topology, and locked as moving one would open a seam.
+	std::vector<uint32_t> welded(vertexCount);
+	std::vector<bool> locked(vertexCount, false);
+	{
+		struct PositionHash {
+			size_t operator()(const Vec3& p) const {
+				uint32_t bits[3];
+				std::memcpy(bits, &p.x, 4), std::memcpy(bits + 1, &p.y, 4), std::memcpy(bits + 2, &p.z, 4);
+				return (bits[0] * 73856093u) ^ (bits[1] * 19349663u) ^ (bits[2] * 83492791u);
+			}
+		};
+		struct PositionEqual {
+			bool operator()(const Vec3& lhs, const Vec3& rhs) const { return lhs.x == rhs.x && lhs.y == rhs.y && lhs.z == rhs.z; }
+		};
+		std::unordered_map<Vec3, uint32_t, PositionHash, PositionEqual> firstAtPosition;
+		for (uint32_t v = 0; v < vertexCount; ++v) {
+			auto [it, inserted] = firstAtPosition.insert({ positions[v], v });
+			welded[v] = it->second;
+			if (!inserted) {
+				locked[v] = locked[it->second] = true;
+			}
+		}
+	}
+
+	// Plane quadrics of the triangles, and perpendicular planes along borders to keep their shape.
+	std::vector<Quadric> quadrics(vertexCount);
+	{
+		constexpr double BorderWeight = 10.0;
+		const auto borderEdges = FindBorderEdges(indices, welded);
+		for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+			const Vec3& a = positions[indices[i]];
+			const Vec3& b = positions[indices[i + 1]];
+			const Vec3& c = positions[indices[i + 2]];
+			Vec3 normal = TriangleNormal(a, b, c);
+			const float doubleArea = Length(normal);
+			if (doubleArea <= 0.0f) {
+				continue;
+			}
+			normal /= doubleArea;
+			for (int corner = 0; corner < 3; ++corner) {
+				quadrics[welded[indices[i + corner]]].AddPlane(normal, -Dot(normal, a), doubleArea * 0.5);
+			}
+			for (int corner = 0; corner < 3; ++corner) {
+				const uint32_t from = welded[indices[i + corner]], to = welded[indices[i + (corner + 1) % 3]];
+				if (borderEdges.count(EdgeKey(std::min(from, to), std::max(from, to)))) {
+					const Vec3 edge = positions[to] - positions[from];
+					Vec3 borderNormal = Cross(edge, normal);
+					const float length = Length(borderNormal);
+					if (length > 0.0f) {
+						borderNormal /= length;
+						const double weight = BorderWeight * Dot(edge, edge);
+						quadrics[from].AddPlane(borderNormal, -Dot(borderNormal, positions[from]), weight);
+						quadrics[to].AddPlane(borderNormal, -Dot(borderNormal, positions[from]), weight);
+					}
+				}
+			}
+		}
+	}
+
+	const double maxError = double(options.maxError) * double(options.maxError);
+	const size_t targetIndexCount = std::max<size_t>(options.targetIndexCount, 3);
+	double resultError = 0.0;
+	size_t indexCount = indices.size();
+
+	std::vector<uint32_t> adjacencyOffsets(vertexCount + 1);
+	std::vector<uint32_t> adjacency;
+	std::vector<bool> touched(vertexCount);
+	std::vector<uint64_t> edges;
+	std::vector<Collapse> collapses;
+
+	// Each pass collapses the cheapest edges whose neighbourhoods do not overlap, then rebuilds the topology.
+	while (indexCount > targetIndexCount) {
+		const auto borderEdges = FindBorderEdges(indices, welded);
+		auto IsBorderEdge = [&](uint32_t a, uint32_t b) {
+			return borderEdges.count(EdgeKey(std::min(welded[a], welded[b]), std::max(welded[a], welded[b]))) != 0;
+		};
+		std::vector<bool> border(vertexCount, false);
+		for (uint64_t edge : borderEdges) {
+			border[uint32_t(edge >> 32)] = border[uint32_t(edge)] = true;
+		}
+
+		// Triangles around each vertex.
+		std::fill(adjacencyOffsets.begin(), adjacencyOffsets.end(), 0);
+		for (uint32_t index : indices) {
+			++adjacencyOffsets[index + 1];
+		}
+		for (size_t v = 0; v < vertexCount; ++v) {
+			adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+		}
+		adjacency.resize(indices.size());
+		{
+			std::vector<uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+			for (size_t i = 0; i < indices.size(); ++i) {
+				adjacency[fill[indices[i]]++] = uint32_t(i / 3);
+			}
+		}
+
+		// Cheapest direction of each edge.
+		collapses.clear();
+		auto CanMove = [&](uint32_t source, uint32_t target) {
+			if (locked[source]) {
+				return false;
+			}
+			if (border[welded[source]]) {
+				return !options.lockBorders && IsBorderEdge(source, target); // Slide along the border only.
+			}
+			return true;
+		};
+		edges.clear();
+		for (size_t i = 0; i < indices.size(); i += 3) {
+			for (int corner = 0; corner < 3; ++corner) {
+				uint32_t a = indices[i + corner], b = indices[i + (corner + 1) % 3];
+				edges.push_back(EdgeKey(std::min(a, b), std::max(a, b)));
+			}
+		}
+		std::sort(edges.begin(), edges.end());
+		edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+		for (uint64_t edge : edges) {
+			const uint32_t a = uint32_t(edge >> 32), b = uint32_t(edge);
+			Collapse collapse = { a, b, std::numeric_limits<double>::infinity() };
+			Quadric sum = quadrics[welded[a]];
+			sum += quadrics[welded[b]];
+			if (CanMove(a, b)) {
+				collapse = { a, b, sum.Error(positions[b]) };
+			}
+			if (CanMove(b, a)) {
+				double error = sum.Error(positions[a]);
+				if (error < collapse.error) {
+					collapse = { b, a, error };
+				}
+			}
+			if (collapse.error <= maxError) {
+				collapses.push_back(collapse);
+			}
+		}
+		if (collapses.empty()) {
+			break;
+		}
+		std::sort(collapses.begin(), collapses.end(), [](const Collapse& lhs, const Collapse& rhs) { return lhs.error < rhs.error; });
+
+		std::fill(touched.begin(), touched.end(), false);
+		size_t collapsedCount = 0;
+		for (const Collapse& collapse : collapses) {
+			if (indexCount <= targetIndexCount) {
+				break;
+			}
+			if (touched[collapse.source] || touched[collapse.target]) {
+				continue;
+			}
+
+			// Reject collapses that would flip a triangle.
+			const uint32_t* first = adjacency.data() + adjacencyOffsets[collapse.source];
+			const uint32_t* last = adjacency.data() + adjacencyOffsets[collapse.source + 1];
+			bool flips = false;
+			for (const uint32_t* it = first; it != last && !flips; ++it) {
+				const uint32_t* triangle = indices.data() + 3 * *it;
+				if (triangle[0] == collapse.target || triangle[1] == collapse.target || triangle[2] == collapse.target) {
+					continue; // Becomes degenerate.
+				}
+				Vec3 corners[3] = { positions[triangle[0]], positions[triangle[1]], positions[triangle[2]] };
+				const Vec3 before = TriangleNormal(corners[0], corners[1], corners[2]);
+				for (int corner = 0; corner < 3; ++corner) {
+					if (triangle[corner] == collapse.source) {
+						corners[corner] = positions[collapse.target];
+					}
+				}
+				const Vec3 after = TriangleNormal(corners[0], corners[1], corners[2]);
+				flips = Dot(before, after) <= 0.0f;
+			}
+			if (flips) {
+				continue;
+			}
+
+			// Apply it, and keep the other collapses of this pass away from the changed triangles.
+			for (const uint32_t* it = first; it != last; ++it) {
+				uint32_t* triangle = indices.data() + 3 * *it;
+				const bool degenerate = triangle[0] == collapse.target || triangle[1] == collapse.target || triangle[2] == collapse.target;
+				for (int corner = 0; corner < 3; ++corner) {
+					touched[triangle[corner]] = true;
+					if (triangle[corner] == collapse.source) {
+						triangle[corner] = collapse.target;
+					}
+				}
+				indexCount -= degenerate ? 3 : 0;
+			}
+			quadrics[welded[collapse.target]] += quadrics[welded[collapse.source]];
+			resultError = std::max(resultError, collapse.error);
+			++collapsedCount;
+		}
+		if (collapsedCount == 0) {
+			break;
+		}
+
+		// Remove the triangles that collapsed.
+		size_t write = 0;
+		for (size_t read = 0; read + 2 < indices.size(); read += 3) {
+			const uint32_t a = indices[read], b = indices[read + 1], c = indices[read + 2];
+			if (a != b && b != c && c != a) {
+				indices[write++] = a, indices[write++] = b, indices[write++] = c;
+			}
+		}
+		indices.resize(write);
+		indexCount = write;
+	}
+
+	return float(std::sqrt(resultError));
+}
+
+
+std::vector<LodLevel> GenerateLodChain(const std::vector<Vec3>& positions, const std::vector<uint32_t>& indices, const LodChainOptions& options) {
+	std::vector<LodLevel> levels;
+	std::vector<uint32_t> current = indices;
+	float error = 0.0f;
+	for (unsigned level = 1; level <= options.levelCount; ++level) {
+		SimplifyOptions simplifyOptions;
+		simplifyOptions.targetIndexCount = size_t(float(current.size() / 3) * options.reduction) * 3;
+		simplifyOptions.maxError = options.maxError - error;
+		simplifyOptions.lockBorders = options.lockBorders;
+		if (simplifyOptions.maxError <= 0.0f) {
+			break;
+		}
+
+		const size_t previousCount = current.size();
+		error += SimplifyMesh(current, positions, simplifyOptions); // Each level is measured against the previous one.
+		if (current.size() >= previousCount || current.empty()) {
+			break;
+		}
+
+		// A level that adds no error makes the previous one pointless, and the screen sizes must decrease.
+		if (!levels.empty() && error <= levels.back().error) {
+			levels.pop_back();
+		}
+
+		LodLevel lod;
+		lod.indices = current;
+		lod.error = error;
+		// The error covers error * size / 2 of the screen when the mesh's diameter covers size of it.
+		lod.screenSize = error > 0.0f ? 2.0f * options.pixelError / (error * options.screenHeight) : std::numeric_limits<float>::infinity();
+		levels.push_back(std::move(lod));
+	}
+	return levels;
+}
+
+
+} // namespace inl::asset
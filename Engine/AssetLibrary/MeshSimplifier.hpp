@@ -0,0 +1,78 @@
+#pragma once
+
+#include <InlineMath.hpp>
+#include <cstdint>
+#include <vector>
+
+
+namespace inl::asset {
+
+
+struct SimplifyOptions {
+	/// <summary> Simplification stops once the index count is at or below this. </summary>
+	size_t targetIndexCount = 0;
+	/// <summary> Largest allowed deviation from the original surface, relative to the radius of the mesh's bounds. </summary>
+	float maxError = 0.01f;
+	/// <summary> Keeps the borders of open surfaces in place, otherwise they only resist moving. </summary>
+	bool lockBorders = false;
+};
+
+
+/// <summary> Reduces the triangle count by collapsing edges in the order of least quadric error. </summary>
+/// <remarks> Collapses move a vertex onto a neighbour, so the result references a subset of the original vertices
+///		and their attributes stay valid. Vertices that share a position with another vertex, like those on UV seams,
+///		are never moved. </remarks>
+/// <returns> The largest error introduced, relative to the radius of the mesh's bounds. </returns>
+float SimplifyMesh(std::vector<uint32_t>& indices, const std::vector<Vec3>& positions, const SimplifyOptions& options);
+
+
+struct LodChainOptions {
+	/// <summary> Number of levels generated in addition to the original. </summary>
+	unsigned levelCount = 4;
+	/// <summary> Fraction of triangles each level keeps of the previous one. </summary>
+	float reduction = 0.5f;
+	/// <summary> Error limit of the coarsest level, relative to the radius of the mesh's bounds. </summary>
+	float maxError = 0.1f;
+	bool lockBorders = false;
+	/// <summary> The screen sizes are chosen so that the error stays below this many pixels at this resolution. </summary>
+	float pixelError = 1.0f;
+	float screenHeight = 1080.0f;
+};
+
+
+struct LodLevel {
+	std::vector<uint32_t> indices; // Into the original vertices.
+	float error; // Relative to the radius of the mesh's bounds.
+	float screenSize; // Fraction of the screen height below which this level can be drawn, see IMeshEntity::SetLods.
+};
+
+
+/// <summary> Simplifies the mesh progressively, each level starting from the previous one. </summary>
+/// <remarks> Stops early when a level could not be reduced within the error limit.
+///		A level that adds no error replaces the previous one, so the errors increase and the screen sizes decrease. </remarks>
+std::vector<LodLevel> GenerateLodChain(const std::vector<Vec3>& positions, const std::vector<uint32_t>& indices, const LodChainOptions& options = {});
+
+
+/// <summary> Drops the vertices a level does not reference and renumbers its indices. </summary>
+template <class VertexT>
+std::vector<VertexT> CompactVertices(const std::vector<VertexT>& vertices, std::vector<uint32_t>& indices);
+
+
+
+template <class VertexT>
+std::vector<VertexT> CompactVertices(const std::vector<VertexT>& vertices, std::vector<uint32_t>& indices) {
+	constexpr uint32_t Unused = ~uint32_t(0);
+	std::vector<uint32_t> remap(vertices.size(), Unused);
+	std::vector<VertexT> compacted;
+	for (auto& index : indices) {
+		if (remap[index] == Unused) {
+			remap[index] = uint32_t(compacted.size());
+			compacted.push_back(vertices[index]);
+		}
+		index = remap[index];
+	}
+	return compacted;
+}
+
+
+} // namespace inl::asset
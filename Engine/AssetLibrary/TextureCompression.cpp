@@ -0,0 +1,533 @@
+#include "TextureCompression.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <thread>
+#include <vector>
+
+
+namespace inl::asset {
+
+
+//------------------------------------------------------------------------------
+// Helpers
+//------------------------------------------------------------------------------
+
+// Finds the direction along which the points vary the most, using power iteration on their covariance.
+template <int N>
+static void PrincipalAxis(const float (&points)[16][N], float (&mean)[N], float (&axis)[N]) {
+	for (int c = 0; c < N; ++c) {
+		mean[c] = 0.0f;
+		for (int i = 0; i < 16; ++i) {
+			mean[c] += points[i][c];
+		}
+		mean[c] /= 16.0f;
+	}
+
+	float covariance[N][N] = {};
+	for (int i = 0; i < 16; ++i) {
+		for (int r = 0; r < N; ++r) {
+			for (int c = 0; c < N; ++c) {
+				covariance[r][c] += (points[i][r] - mean[r]) * (points[i][c] - mean[c]);
+			}
+		}
+	}
+
+	for (int c = 0; c < N; ++c) {
+		axis[c] = 1.0f;
+	}
+	for (int iteration = 0; iteration < 8; ++iteration) {
+		float next[N] = {};
+		float length = 0.0f;
+		for (int r = 0; r < N; ++r) {
+			for (int c = 0; c < N; ++c) {
+				next[r] += covariance[r][c] * axis[c];
+			}
+			length = std::max(length, std::abs(next[r]));
+		}
+		if (length < 1e-8f) {
+			break; // All points are the same.
+		}
+		for (int c = 0; c < N; ++c) {
+			axis[c] = next[c] / length;
+		}
+	}
+
+	float length = 0.0f;
+	for (int c = 0; c < N; ++c) {
+		length += axis[c] * axis[c];
+	}
+	length = std::sqrt(length);
+	for (int c = 0; c < N; ++c) {
+		axis[c] /= length;
+	}
+}
+
+
+// Returns the endpoints of the segment along the axis that covers all points.
+template <int N>
+static void FitEndpoints(const float (&points)[16][N], float (&low)[N], float (&high)[N]) {
+	float mean[N], axis[N];
+	PrincipalAxis(points, mean, axis);
+
+	float minT = 0.0f, maxT = 0.0f;
+	for (int i = 0; i < 16; ++i) {
+		float t = 0.0f;
+		for (int c = 0; c < N; ++c) {
+			t += (points[i][c] - mean[c]) * axis[c];
+		}
+		minT = std::min(minT, t);
+		maxT = std::max(maxT, t);
+	}
+
+	for (int c = 0; c < N; ++c) {
+		low[c] = std::clamp(mean[c] + axis[c] * minT, 0.0f, 255.0f);
+		high[c] = std::clamp(mean[c] + axis[c] * maxT, 0.0f, 255.0f);
+	}
+}
+
+
+static uint16_t PackRgb565(const float (&color)[3]) {
+	unsigned r = unsigned(color[0] * 31.0f / 255.0f + 0.5f);
+	unsigned g = unsigned(color[1] * 63.0f / 255.0f + 0.5f);
+	unsigned b = unsigned(color[2] * 31.0f / 255.0f + 0.5f);
+	return uint16_t((r << 11) | (g << 5) | b);
+}
+
+
+static void UnpackRgb565(uint16_t packed, int (&color)[3]) {
+	int r = (packed >> 11) & 31;
+	int g = (packed >> 5) & 63;
+	int b = packed & 31;
+	color[0] = (r << 3) | (r >> 2);
+	color[1] = (g << 2) | (g >> 4);
+	color[2] = (b << 3) | (b >> 2);
+}
+
+
+static void Bc1Palette(uint16_t c0, uint16_t c1, int (&palette)[4][3]) {
+	UnpackRgb565(c0, palette[0]);
+	UnpackRgb565(c1, palette[1]);
+	for (int c = 0; c < 3; ++c) {
+		if (c0 > c1) {
+			palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+			palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+		}
+		else {
+			palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+			palette[3][c] = 0;
+		}
+	}
+}
+
+
+static void Bc4Palette(int a0, int a1, int (&palette)[8]) {
+	palette[0] = a0;
+	palette[1] = a1;
+	if (a0 > a1) {
+		for (int i = 1; i < 7; ++i) {
+			palette[i + 1] = ((7 - i) * a0 + i * a1) / 7;
+		}
+	}
+	else {
+		for (int i = 1; i < 5; ++i) {
+			palette[i + 1] = ((5 - i) * a0 + i * a1) / 5;
+		}
+		palette[6] = 0;
+		palette[7] = 255;
+	}
+}
+
+
+static void StoreLittleEndian(uint64_t value, uint8_t* bytes, int count) {
+	for (int i = 0; i < count; ++i) {
+		bytes[i] = uint8_t(value >> (8 * i));
+	}
+}
+
+
+static uint64_t LoadLittleEndian(const uint8_t* bytes, int count) {
+	uint64_t value = 0;
+	for (int i = 0; i < count; ++i) {
+		value |= uint64_t(bytes[i]) << (8 * i);
+	}
+	return value;
+}
+
+
+// Writes and reads the bit fields of a 128 bit block, least significant bit first.
+class BlockBits {
+public:
+	explicit BlockBits(uint8_t* block) : m_block(block) { std::fill(block, block + 16, uint8_t(0)); }
+	explicit BlockBits(const uint8_t* block) : m_block(const_cast<uint8_t*>(block)) {}
+
+	void Write(unsigned value, int count) {
+		for (int i = 0; i < count; ++i, ++m_position) {
+			m_block[m_position / 8] |= uint8_t(((value >> i) & 1) << (m_position % 8));
+		}
+	}
+	unsigned Read(int count) {
+		unsigned value = 0;
+		for (int i = 0; i < count; ++i, ++m_position) {
+			value |= unsigned((m_block[m_position / 8] >> (m_position % 8)) & 1) << i;
+		}
+		return value;
+	}
+
+private:
+	uint8_t* m_block;
+	int m_position = 0;
+};
+
+
+static constexpr int BC7_WEIGHTS4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+
+
+//------------------------------------------------------------------------------
+// Encoders
+//------------------------------------------------------------------------------
+
+// Selects the closest palette entry for each pixel, returns the total squared error.
+static int Bc1SelectIndices(const uint8_t* pixels, uint16_t& c0, uint16_t& c1, uint32_t& indices) {
+	if (c0 < c1) {
+		std::swap(c0, c1);
+	}
+
+	// Equal endpoints would select the 3 color mode, where index 3 is transparent.
+	int palette[4][3];
+	Bc1Palette(c0, c1, palette);
+	const uint32_t paletteSize = c0 != c1 ? 4 : 1;
+
+	int totalError = 0;
+	indices = 0;
+	for (int i = 0; i < 16; ++i) {
+		int bestError = std::numeric_limits<int>::max();
+		uint32_t bestIndex = 0;
+		for (uint32_t k = 0; k < paletteSize; ++k) {
+			int error = 0;
+			for (int c = 0; c < 3; ++c) {
+				int d = palette[k][c] - pixels[4 * i + c];
+				error += d * d;
+			}
+			if (error < bestError) {
+				bestError = error;
+				bestIndex = k;
+			}
+		}
+		indices |= bestIndex << (2 * i);
+		totalError += bestError;
+	}
+	return totalError;
+}
+
+
+void EncodeBC1(const uint8_t* pixels, uint8_t* block) {
+	float points[16][3];
+	for (int i = 0; i < 16; ++i) {
+		for (int c = 0; c < 3; ++c) {
+			points[i][c] = pixels[4 * i + c];
+		}
+	}
+
+	float low[3], high[3];
+	FitEndpoints(points, low, high);
+	uint16_t c0 = PackRgb565(high);
+	uint16_t c1 = PackRgb565(low);
+	uint32_t indices;
+	int error = Bc1SelectIndices(pixels, c0, c1, indices);
+
+	// Refine the endpoints by least squares for the selected indices.
+	static constexpr float weights[4] = { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+	float aa = 0.0f, ab = 0.0f, bb = 0.0f;
+	float ap[3] = {}, bp[3] = {};
+	for (int i = 0; i < 16; ++i) {
+		float a = weights[(indices >> (2 * i)) & 3];
+		float b = 1.0f - a;
+		aa += a * a;
+		ab += a * b;
+		bb += b * b;
+		for (int c = 0; c < 3; ++c) {
+			ap[c] += a * points[i][c];
+			bp[c] += b * points[i][c];
+		}
+	}
+	float determinant = aa * bb - ab * ab;
+	if (std::abs(determinant) > 1e-6f) {
+		for (int c = 0; c < 3; ++c) {
+			high[c] = std::clamp((ap[c] * bb - bp[c] * ab) / determinant, 0.0f, 255.0f);
+			low[c] = std::clamp((bp[c] * aa - ap[c] * ab) / determinant, 0.0f, 255.0f);
+		}
+		uint16_t refined0 = PackRgb565(high);
+		uint16_t refined1 = PackRgb565(low);
+		uint32_t refinedIndices;
+		if (Bc1SelectIndices(pixels, refined0, refined1, refinedIndices) < error) {
+			c0 = refined0;
+			c1 = refined1;
+			indices = refinedIndices;
+		}
+	}
+
+	StoreLittleEndian(c0, block + 0, 2);
+	StoreLittleEndian(c1, block + 2, 2);
+	StoreLittleEndian(indices, block + 4, 4);
+}
+
+
+void EncodeBC3(const uint8_t* pixels, uint8_t* block) {
+	EncodeBC4(pixels + 3, 4, block);
+	EncodeBC1(pixels, block + 8);
+}
+
+
+void EncodeBC4(const uint8_t* values, size_t stride, uint8_t* block) {
+	int minValue = 255, maxValue = 0;
+	for (int i = 0; i < 16; ++i) {
+		minValue = std::min(minValue, int(values[i * stride]));
+		maxValue = std::max(maxValue, int(values[i * stride]));
+	}
+
+	uint64_t indices = 0;
+	if (minValue != maxValue) {
+		int palette[8];
+		Bc4Palette(maxValue, minValue, palette);
+		for (int i = 0; i < 16; ++i) {
+			int bestError = std::numeric_limits<int>::max();
+			uint64_t bestIndex = 0;
+			for (uint64_t k = 0; k < 8; ++k) {
+				int error = std::abs(palette[k] - int(values[i * stride]));
+				if (error < bestError) {
+					bestError = error;
+					bestIndex = k;
+				}
+			}
+			indices |= bestIndex << (3 * i);
+		}
+	}
+
+	block[0] = uint8_t(maxValue);
+	block[1] = uint8_t(minValue);
+	StoreLittleEndian(indices, block + 2, 6);
+}
+
+
+void EncodeBC5(const uint8_t* pixels, uint8_t* block) {
+	EncodeBC4(pixels + 0, 4, block);
+	EncodeBC4(pixels + 1, 4, block + 8);
+}
+
+
+void EncodeBC7(const uint8_t* pixels, uint8_t* block) {
+	float points[16][4];
+	for (int i = 0; i < 16; ++i) {
+		for (int c = 0; c < 4; ++c) {
+			points[i][c] = pixels[4 * i + c];
+		}
+	}
+
+	float endpoints[2][4];
+	FitEndpoints(points, endpoints[0], endpoints[1]);
+
+	// Mode 6 stores 7 bits per channel and a shared lowest bit per endpoint.
+	unsigned quantized[2][4];
+	unsigned pBits[2];
+	int values[2][4];
+	for (int e = 0; e < 2; ++e) {
+		float bestError = std::numeric_limits<float>::max();
+		for (unsigned p = 0; p < 2; ++p) {
+			float error = 0.0f;
+			unsigned candidate[4];
+			for (int c = 0; c < 4; ++c) {
+				candidate[c] = (unsigned)std::clamp(int(std::round((endpoints[e][c] - p) / 2.0f)), 0, 127);
+				float d = float((candidate[c] << 1) | p) - endpoints[e][c];
+				error += d * d;
+			}
+			if (error < bestError) {
+				bestError = error;
+				pBits[e] = p;
+				std::copy(candidate, candidate + 4, quantized[e]);
+			}
+		}
+		for (int c = 0; c < 4; ++c) {
+			values[e][c] = int((quantized[e][c] << 1) | pBits[e]);
+		}
+	}
+
+	unsigned indices[16];
+	for (int i = 0; i < 16; ++i) {
+		int bestError = std::numeric_limits<int>::max();
+		for (unsigned k = 0; k < 16; ++k) {
+			int error = 0;
+			for (int c = 0; c < 4; ++c) {
+				int interpolated = ((64 - BC7_WEIGHTS4[k]) * values[0][c] + BC7_WEIGHTS4[k] * values[1][c] + 32) >> 6;
+				int d = interpolated - pixels[4 * i + c];
+				error += d * d;
+			}
+			if (error < bestError) {
+				bestError = error;
+				indices[i] = k;
+			}
+		}
+	}
+
+	// The highest bit of the first index is implicitly zero.
+	if (indices[0] >= 8) {
+		std::swap(quantized[0], quantized[1]);
+		std::swap(pBits[0], pBits[1]);
+		for (auto& index : indices) {
+			index = 15 - index;
+		}
+	}
+
+	BlockBits bits(block);
+	bits.Write(1u << 6, 7);
+	for (int c = 0; c < 4; ++c) {
+		bits.Write(quantized[0][c], 7);
+		bits.Write(quantized[1][c], 7);
+	}
+	bits.Write(pBits[0], 1);
+	bits.Write(pBits[1], 1);
+	bits.Write(indices[0], 3);
+	for (int i = 1; i < 16; ++i) {
+		bits.Write(indices[i], 4);
+	}
+}
+
+
+
+//------------------------------------------------------------------------------
+// Decoders
+//------------------------------------------------------------------------------
+
+void DecodeBC1(const uint8_t* block, uint8_t* pixels) {
+	uint16_t c0 = uint16_t(LoadLittleEndian(block + 0, 2));
+	uint16_t c1 = uint16_t(LoadLittleEndian(block + 2, 2));
+	uint32_t indices = uint32_t(LoadLittleEndian(block + 4, 4));
+
+	int palette[4][3];
+	Bc1Palette(c0, c1, palette);
+	for (int i = 0; i < 16; ++i) {
+		unsigned index = (indices >> (2 * i)) & 3;
+		for (int c = 0; c < 3; ++c) {
+			pixels[4 * i + c] = uint8_t(palette[index][c]);
+		}
+		pixels[4 * i + 3] = c0 <= c1 && index == 3 ? 0 : 255;
+	}
+}
+
+
+void DecodeBC4(const uint8_t* block, uint8_t* values, size_t stride) {
+	int palette[8];
+	Bc4Palette(block[0], block[1], palette);
+	uint64_t indices = LoadLittleEndian(block + 2, 6);
+	for (int i = 0; i < 16; ++i) {
+		values[i * stride] = uint8_t(palette[(indices >> (3 * i)) & 7]);
+	}
+}
+
+
+void DecodeBC7(const uint8_t* block, uint8_t* pixels) {
+	BlockBits bits(block);
+	if (bits.Read(7) != (1u << 6)) {
+		std::fill(pixels, pixels + 64, uint8_t(0));
+		return;
+	}
+
+	int values[2][4];
+	for (int c = 0; c < 4; ++c) {
+		values[0][c] = int(bits.Read(7)) << 1;
+		values[1][c] = int(bits.Read(7)) << 1;
+	}
+	unsigned p0 = bits.Read(1);
+	unsigned p1 = bits.Read(1);
+	for (int c = 0; c < 4; ++c) {
+		values[0][c] |= p0;
+		values[1][c] |= p1;
+	}
+
+	for (int i = 0; i < 16; ++i) {
+		unsigned index = bits.Read(i == 0 ? 3 : 4);
+		for (int c = 0; c < 4; ++c) {
+			pixels[4 * i + c] = uint8_t(((64 - BC7_WEIGHTS4[index]) * values[0][c] + BC7_WEIGHTS4[index] * values[1][c] + 32) >> 6);
+		}
+	}
+}
+
+
+
+//------------------------------------------------------------------------------
+// Images
+//------------------------------------------------------------------------------
+
+size_t GetBlockSize(gxeng::eBlockCompression compression) {
+	switch (compression) {
+		case gxeng::eBlockCompression::BC1:
+		case gxeng::eBlockCompression::BC4:
+			return 8;
+		default:
+			return 16;
+	}
+}
+
+
+size_t GetCompressedSize(gxeng::eBlockCompression compression, uint32_t width, uint32_t height) {
+	size_t blocksX = (width + 3) / 4;
+	size_t blocksY = (height + 3) / 4;
+	return blocksX * blocksY * GetBlockSize(compression);
+}
+
+
+void CompressBlocks(gxeng::eBlockCompression compression, const uint8_t* pixels, uint32_t width, uint32_t height, uint8_t* blocks, unsigned threadCount) {
+	const uint32_t blocksX = (width + 3) / 4;
+	const uint32_t blocksY = (height + 3) / 4;
+	const size_t blockSize = GetBlockSize(compression);
+
+	auto EncodeRow = [&](uint32_t blockY) {
+		uint8_t blockPixels[16 * 4];
+		for (uint32_t blockX = 0; blockX < blocksX; ++blockX) {
+			for (uint32_t y = 0; y < 4; ++y) {
+				for (uint32_t x = 0; x < 4; ++x) {
+					uint32_t sourceX = std::min(blockX * 4 + x, width - 1);
+					uint32_t sourceY = std::min(blockY * 4 + y, height - 1);
+					const uint8_t* source = pixels + (size_t(sourceY) * width + sourceX) * 4;
+					std::copy(source, source + 4, blockPixels + (y * 4 + x) * 4);
+				}
+			}
+
+			uint8_t* block = blocks + (size_t(blockY) * blocksX + blockX) * blockSize;
+			switch (compression) {
+				case gxeng::eBlockCompression::BC1: EncodeBC1(blockPixels, block); break;
+				case gxeng::eBlockCompression::BC3: EncodeBC3(blockPixels, block); break;
+				case gxeng::eBlockCompression::BC4: EncodeBC4(blockPixels, 4, block); break;
+				case gxeng::eBlockCompression::BC5: EncodeBC5(blockPixels, block); break;
+				case gxeng::eBlockCompression::BC7: EncodeBC7(blockPixels, block); break;
+			}
+		}
+	};
+
+	if (threadCount == 0) {
+		threadCount = std::max(1u, std::thread::hardware_concurrency());
+	}
+	threadCount = std::min(threadCount, blocksY);
+
+	// Threads take rows of blocks one by one until all of them are encoded.
+	std::atomic_uint32_t nextRow = 0;
+	auto Worker = [&] {
+		for (uint32_t row = nextRow++; row < blocksY; row = nextRow++) {
+			EncodeRow(row);
+		}
+	};
+	std::vector<std::thread> threads;
+	for (unsigned i = 1; i < threadCount; ++i) {
+		threads.emplace_back(Worker);
+	}
+	Worker();
+	for (auto& thread : threads) {
+		thread.join();
+	}
+}
+
+
+} // namespace inl::asset
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <GraphicsEngine/Resources/Pixel.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+
+namespace inl::asset {
+
+
+/// <summary> Returns the number of bytes a 4x4 block takes in the given format. </summary>
+size_t GetBlockSize(gxeng::eBlockCompression compression);
+
+/// <summary> Returns the number of bytes an image of the given size takes in the given format. </summary>
+size_t GetCompressedSize(gxeng::eBlockCompression compression, uint32_t width, uint32_t height);
+
+
+/// <summary> Compresses an RGBA8 image into 4x4 blocks. </summary>
+/// <param name="pixels"> Tightly packed RGBA8 pixels, row by row. </param>
+/// <param name="blocks"> Receives the blocks row by row, must be <see cref="GetCompressedSize"/> bytes. </param>
+/// <param name="threadCount"> Number of threads to encode on, 0 to use every core. </param>
+/// <remarks> Blocks hanging over the edge of the image are padded by repeating the edge pixels. </remarks>
+void CompressBlocks(gxeng::eBlockCompression compression, const uint8_t* pixels, uint32_t width, uint32_t height, uint8_t* blocks, unsigned threadCount = 0);
+
+
+// Individual block encoders. Pixels are the 16 RGBA8 pixels of the block in row-major order.
+
+/// <summary> Encodes RGB as an opaque BC1 block of 8 bytes. </summary>
+void EncodeBC1(const uint8_t* pixels, uint8_t* block);
+
+/// <summary> Encodes RGBA as a BC3 block of 16 bytes. </summary>
+void EncodeBC3(const uint8_t* pixels, uint8_t* block);
+
+/// <summary> Encodes a single channel as a BC4 block of 8 bytes. </summary>
+/// <param name="stride"> Distance between the values of neighbouring pixels in bytes. </param>
+void EncodeBC4(const uint8_t* values, size_t stride, uint8_t* block);
+
+/// <summary> Encodes the red and green channels as a BC5 block of 16 bytes. </summary>
+void EncodeBC5(const uint8_t* pixels, uint8_t* block);
+
+/// <summary> Encodes RGBA as a BC7 block of 16 bytes. </summary>
+/// <remarks> Only mode 6 is used, which encodes all four channels with a single pair of endpoints. </remarks>
+void EncodeBC7(const uint8_t* pixels, uint8_t* block);
+
+
+// Block decoders, mainly to validate the encoders. They write 16 RGBA8 pixels.
+
+void DecodeBC1(const uint8_t* block, uint8_t* pixels);
+void DecodeBC4(const uint8_t* block, uint8_t* values, size_t stride);
+
+/// <remarks> Only mode 6 blocks are supported, other modes decode as transparent black. </remarks>
+void DecodeBC7(const uint8_t* block, uint8_t* pixels);
+
+
+} // namespace inl::asset
@@ -0,0 +1,257 @@
+#include "TextureCooker.hpp"
+
+#include "TextureCompression.hpp"
+
+#include <BaseLibrary/Exception/Exception.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <fstream>
+
+
+namespace inl::asset {
+
+
+static float SrgbToLinear(float value) {
+	return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+}
+
+
+static float LinearToSrgb(float value) {
+	return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+}
+
+
+static const std::array<float, 256>& SrgbToLinearTable() {
+	static const std::array<float, 256> table = [] {
+		std::array<float, 256> values;
+		for (size_t i = 0; i < values.size(); ++i) {
+			values[i] = SrgbToLinear(float(i) / 255.0f);
+		}
+		return values;
+	}();
+	return table;
+}
+
+
+// Reads the pixels as normalized RGBA, missing channels are 0 except alpha which is 1.
+static std::vector<Vec4> ReadPixels(const Image& image, bool srgb) {
+	const uint32_t width = (uint32_t)image.GetWidth();
+	const uint32_t height = (uint32_t)image.GetHeight();
+	const int channelCount = image.GetChannelCount();
+	const auto& srgbTable = SrgbToLinearTable();
+
+	std::vector<Vec4> pixels(size_t(width) * height);
+	for (uint32_t y = 0; y < height; ++y) {
+		const uint8_t* row = reinterpret_cast<const uint8_t*>(image.GetData()) + y * image.GetBytesPerRow();
+		for (uint32_t x = 0; x < width; ++x) {
+			Vec4 pixel = { 0.0f, 0.0f, 0.0f, 1.0f };
+			for (int c = 0; c < channelCount; ++c) {
+				uint8_t value = row[x * channelCount + c];
+				pixel[c] = srgb && c < 3 ? srgbTable[value] : value / 255.0f;
+			}
+			pixels[size_t(y) * width + x] = pixel;
+		}
+	}
+	return pixels;
+}
+
+
+static std::vector<uint8_t> QuantizePixels(const std::vector<Vec4>& pixels, bool srgb) {
+	std::vector<uint8_t> result(pixels.size() * 4);
+	for (size_t i = 0; i < pixels.size(); ++i) {
+		for (int c = 0; c < 4; ++c) {
+			float value = std::clamp(pixels[i][c], 0.0f, 1.0f);
+			if (srgb && c < 3) {
+				value = LinearToSrgb(value);
+			}
+			result[4 * i + c] = uint8_t(value * 255.0f + 0.5f);
+		}
+	}
+	return result;
+}
+
+
+namespace impl {
+
+	std::vector<Vec4> DownsampleBox(const std::vector<Vec4>& pixels, uint32_t width, uint32_t height) {
+		const uint32_t mipWidth = std::max(1u, width / 2);
+		const uint32_t mipHeight = std::max(1u, height / 2);
+		std::vector<Vec4> result(size_t(mipWidth) * mipHeight);
+
+		for (uint32_t y = 0; y < mipHeight; ++y) {
+			const Vec4* row0 = pixels.data() + size_t(std::min(2 * y, height - 1)) * width;
+			const Vec4* row1 = pixels.data() + size_t(std::min(2 * y + 1, height - 1)) * width;
+			Vec4* target = result.data() + size_t(y) * mipWidth;
+			for (uint32_t x = 0; x < mipWidth; ++x) {
+				const uint32_t x0 = std::min(2 * x, width - 1);
+				const uint32_t x1 = std::min(2 * x + 1, width - 1);
+				target[x] = (row0[x0] + row0[x1] + row1[x0] + row1[x1]) * 0.25f;
+			}
+		}
+		return result;
+	}
+
+} // namespace impl
+
+
+
+CookedTexture CookedTexture::Cook(const Image& image, const TextureCookOptions& options) {
+	const uint32_t width = (uint32_t)image.GetWidth();
+	const uint32_t height = (uint32_t)image.GetHeight();
+	const int channelCount = image.GetChannelCount();
+	if (width == 0 || height == 0 || width % 4 != 0 || height % 4 != 0) {
+		throw InvalidArgumentException("Block compressed textures must be a multiple of 4 pixels wide and high.");
+	}
+	// The BC formats used here store 8 bits per channel, 16 bit and HDR images would be clamped and lose precision.
+	if (image.GetType() != eChannelType::INT8) {
+		throw InvalidArgumentException("Only images of 8 bit channels can be block compressed.");
+	}
+
+	CookedTexture result;
+	result.m_width = width;
+	result.m_height = height;
+	result.m_srgb = options.srgb && channelCount >= 3;
+	result.m_autoCompression = !options.compression.has_value();
+	result.m_srgbOption = options.srgb;
+	result.m_mipsOption = options.generateMips;
+	if (options.compression) {
+		result.m_compression = *options.compression;
+	}
+	else {
+		result.m_compression = channelCount == 1 ? gxeng::eBlockCompression::BC4
+							   : channelCount == 2 ? gxeng::eBlockCompression::BC5
+												   : gxeng::eBlockCompression::BC7;
+	}
+
+	std::vector<Vec4> pixels = ReadPixels(image, result.m_srgb);
+	uint32_t mipWidth = width;
+	uint32_t mipHeight = height;
+	while (true) {
+		std::vector<uint8_t> quantized = QuantizePixels(pixels, result.m_srgb);
+		std::vector<uint8_t> blocks(GetCompressedSize(result.m_compression, mipWidth, mipHeight));
+		CompressBlocks(result.m_compression, quantized.data(), mipWidth, mipHeight, blocks.data(), options.threadCount);
+		result.m_mips.push_back(std::move(blocks));
+
+		if (!options.generateMips || (mipWidth == 1 && mipHeight == 1)) {
+			break;
+		}
+		pixels = impl::DownsampleBox(pixels, mipWidth, mipHeight);
+		mipWidth = std::max(1u, mipWidth / 2);
+		mipHeight = std::max(1u, mipHeight / 2);
+	}
+
+	return result;
+}
+
+
+bool CookedTexture::IsCookedWith(const TextureCookOptions& options) const {
+	const bool sameCompression = options.compression ? !m_autoCompression && *options.compression == m_compression : m_autoCompression;
+	return sameCompression && options.srgb == m_srgbOption && options.generateMips == m_mipsOption;
+}
+
+
+std::filesystem::path CookedTexture::GetCookedPath(const std::filesystem::path& sourcePath) {
+	std::filesystem::path cookedPath = sourcePath;
+	cookedPath += FILE_EXTENSION;
+	return cookedPath;
+}
+
+
+template <class T>
+static void WriteValue(std::ostream& stream, T value) {
+	stream.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+
+template <class T>
+static T ReadValue(std::istream& stream) {
+	T value;
+	stream.read(reinterpret_cast<char*>(&value), sizeof(value));
+	return value;
+}
+
+
+void CookedTexture::Save(const std::filesystem::path& path) const {
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	if (!file.is_open()) {
+		throw RuntimeException("Failed to open file for writing.", path.generic_u8string());
+	}
+
+	WriteValue(file, FILE_MAGIC);
+	WriteValue(file, FILE_VERSION);
+	WriteValue(file, uint32_t(m_compression));
+	WriteValue(file, uint32_t(m_srgb));
+	WriteValue(file, uint32_t(m_autoCompression));
+	WriteValue(file, uint32_t(m_srgbOption));
+	WriteValue(file, uint32_t(m_mipsOption));
+	WriteValue(file, m_width);
+	WriteValue(file, m_height);
+	WriteValue(file, uint32_t(m_mips.size()));
+	for (const auto& mip : m_mips) {
+		WriteValue(file, uint64_t(mip.size()));
+		file.write(reinterpret_cast<const char*>(mip.data()), mip.size());
+	}
+	file.close();
+	if (!file) {
+		throw RuntimeException("Failed to write file.", path.generic_u8string());
+	}
+}
+
+
+void CookedTexture::Load(const std::filesystem::path& path) {
+	std::ifstream file(path, std::ios::binary);
+	if (!file.is_open()) {
+		throw FileNotFoundException("Cooked texture was not found.", path.generic_u8string());
+	}
+
+	if (ReadValue<uint32_t>(file) != FILE_MAGIC || ReadValue<uint32_t>(file) != FILE_VERSION) {
+		throw InvalidArgumentException("File is not a cooked texture of this version.", path.generic_u8string());
+	}
+	auto compression = gxeng::eBlockCompression(ReadValue<uint32_t>(file));
+	bool srgb = ReadValue<uint32_t>(file) != 0;
+	bool autoCompression = ReadValue<uint32_t>(file) != 0;
+	bool srgbOption = ReadValue<uint32_t>(file) != 0;
+	bool mipsOption = ReadValue<uint32_t>(file) != 0;
+	uint32_t width = ReadValue<uint32_t>(file);
+	uint32_t height = ReadValue<uint32_t>(file);
+	uint32_t mipCount = ReadValue<uint32_t>(file);
+	if (!file || compression > gxeng::eBlockCompression::BC7 || mipCount > 32) {
+		throw InvalidArgumentException("Cooked texture is corrupt.", path.generic_u8string());
+	}
+
+	std::vector<std::vector<uint8_t>> mips(mipCount);
+	for (uint32_t mipLevel = 0; mipLevel < mipCount; ++mipLevel) {
+		uint64_t size = ReadValue<uint64_t>(file);
+		uint32_t mipWidth = std::max(1u, width >> mipLevel);
+		uint32_t mipHeight = std::max(1u, height >> mipLevel);
+		if (!file || size != GetCompressedSize(compression, mipWidth, mipHeight)) {
+			throw InvalidArgumentException("Cooked texture is corrupt.", path.generic_u8string());
+		}
+		mips[mipLevel].resize(size);
+		file.read(reinterpret_cast<char*>(mips[mipLevel].data()), size);
+	}
+	if (!file) {
+		throw InvalidArgumentException("Cooked texture is truncated.", path.generic_u8string());
+	}
+
+	m_width = width;
+	m_height = height;
+	m_compression = compression;
+	m_srgb = srgb;
+	m_autoCompression = autoCompression;
+	m_srgbOption = srgbOption;
+	m_mipsOption = mipsOption;
+	m_mips = std::move(mips);
+}
+
+
+void CookTexture(const std::filesystem::path& sourcePath, const TextureCookOptions& options) {
+	Image image{ sourcePath };
+	CookedTexture texture = CookedTexture::Cook(image, options);
+	texture.Save(CookedTexture::GetCookedPath(sourcePath));
+}
+
+
+} // namespace inl::asset
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "Image.hpp"
+
+#include <GraphicsEngine/Resources/Pixel.hpp>
+
+#include <InlineMath.hpp>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <vector>
+
+
+namespace inl::asset {
+
+
+struct TextureCookOptions {
+	/// <summary> Chosen by the channel count if not set: BC4 for 1, BC5 for 2 and BC7 for 3 or 4 channels. </summary>
+	std::optional<gxeng::eBlockCompression> compression;
+	/// <summary> The color channels are sRGB encoded, mips are filtered after converting them to linear. </summary>
+	/// <remarks> Only applies to images of 3 or 4 channels. Off by default because uncompressed images are loaded as linear too. </remarks>
+	bool srgb = false;
+	/// <summary> Stores only the most detailed mip level if false. </summary>
+	bool generateMips = true;
+	/// <summary> Number of threads to compress on, 0 to use every core. </summary>
+	unsigned threadCount = 0;
+};
+
+
+/// <summary> A block compressed mip chain, ready to be uploaded to the GPU. </summary>
+/// <remarks> Cooking happens offline so that loading does not have to decode, filter or compress. </remarks>
+class CookedTexture {
+public:
+	static constexpr const char* FILE_EXTENSION = ".ctex";
+
+	/// <summary> Generates the mip chain of the image and compresses it. </summary>
+	/// <exception cref="InvalidArgumentException"> If the image size is not a multiple of 4 or the pixels are not 8 bit. </exception>
+	static CookedTexture Cook(const Image& image, const TextureCookOptions& options = {});
+
+	/// <summary> Returns where the cooked version of the source image is stored. </summary>
+	static std::filesystem::path GetCookedPath(const std::filesystem::path& sourcePath);
+
+	void Save(const std::filesystem::path& path) const;
+	void Load(const std::filesystem::path& path);
+
+	uint32_t GetWidth() const { return m_width; }
+	uint32_t GetHeight() const { return m_height; }
+	gxeng::eBlockCompression GetCompression() const { return m_compression; }
+	bool IsSrgb() const { return m_srgb; }
+	/// <summary> Whether cooking the source with these options would give the same result. </summary>
+	bool IsCookedWith(const TextureCookOptions& options) const;
+
+	size_t GetMipCount() const { return m_mips.size(); }
+	const std::vector<uint8_t>& GetMip(size_t mipLevel) const { return m_mips[mipLevel]; }
+
+private:
+	uint32_t m_width = 0;
+	uint32_t m_height = 0;
+	gxeng::eBlockCompression m_compression = gxeng::eBlockCompression::BC7;
+	bool m_srgb = false;
+	bool m_autoCompression = true;
+	bool m_srgbOption = false;
+	bool m_mipsOption = true;
+	std::vector<std::vector<uint8_t>> m_mips; // Blocks of each mip level row by row.
+
+	static constexpr uint32_t FILE_MAGIC = 0x58455449; // "ITEX"
+	static constexpr uint32_t FILE_VERSION = 2;
+};
+
+
+/// <summary> Cooks the image file and saves the result at <see cref="CookedTexture::GetCookedPath"/>. </summary>
+void CookTexture(const std::filesystem::path& sourcePath, const TextureCookOptions& options = {});
+
+
+namespace impl {
+
+	/// <summary> Halves the image size with a box filter. Odd rows and columns are averaged with the edge. </summary>
+	/// <remarks> Operates on linear values, one SIMD vector per pixel. </remarks>
+	std::vector<Vec4> DownsampleBox(const std::vector<Vec4>& pixels, uint32_t width, uint32_t height);
+
+} // namespace impl
+
+
+} // namespace inl::asset
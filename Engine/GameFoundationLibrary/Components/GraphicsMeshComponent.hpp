@@ -41,7 +41,9 @@ void load(Archive& ar, GraphicsMeshComponent& obj) {
 	   cereal::make_nvp("scene", obj.sceneName));
 	GraphicsModule& graphicsModule = *ar.Modules().Get<std::shared_ptr<GraphicsModule>>();
 	obj.entity = graphicsModule.CreateMeshEntity();
-	obj.entity->SetMesh(graphicsModule.LoadMesh(obj.meshPath));
+	std::shared_ptr<gxeng::IMesh> mesh = graphicsModule.LoadMesh(obj.meshPath);
+	obj.entity->SetMesh(mesh);
+	obj.entity->SetLods(graphicsModule.GetMeshLods(mesh));
 	obj.entity->SetMaterial(graphicsModule.LoadMaterial(obj.materialPath));
 
 	graphicsModule.GetOrCreateScene(obj.sceneName).GetEntities<gxeng::IMeshEntity>().Add(obj.entity.get());
@@ -17,11 +17,17 @@ GraphicsModule::GraphicsModule(gxeng::IGraphicsEngine& engine, std::filesystem::
 	  m_meshCache(std::make_unique<asset::GraphicsMeshCache>(engine)),
 	  m_imageCache(std::make_unique<asset::ImageCache>(engine)),
 	  m_materialShaderCache(std::make_unique<asset::MaterialShaderCache>(engine)),
-	  m_materialCache(std::make_unique<asset::MaterialCache>(engine, *m_materialShaderCache, *m_imageCache)) {
+	  m_materialCache(std::make_unique<asset::MaterialCache>(engine, *m_materialShaderCache, *m_imageCache)),
+	  m_loadScheduler(std::make_unique<jobs::ThreadpoolScheduler>()) {
 	m_meshCache->SetSearchDirectories({ assetDirectory });
 	m_imageCache->SetSearchDirectories({ assetDirectory });
 	m_materialShaderCache->SetSearchDirectories({ assetDirectory });
 	m_materialCache->SetSearchDirectories({ assetDirectory });
+
+	m_meshCache->SetScheduler(*m_loadScheduler);
+	m_imageCache->SetScheduler(*m_loadScheduler);
+	m_materialShaderCache->SetScheduler(*m_loadScheduler);
+	m_materialCache->SetScheduler(*m_loadScheduler);
 }
 
 std::unique_ptr<gxeng::IMeshEntity> GraphicsModule::CreateMeshEntity() const {
@@ -81,6 +87,26 @@ std::shared_ptr<gxeng::IImage> GraphicsModule::LoadImage(std::filesystem::path f
 	return m_imageCache->Load(file);
 }
 
+std::vector<gxeng::IMeshEntity::Lod> GraphicsModule::GetMeshLods(const std::shared_ptr<gxeng::IMesh>& mesh) const {
+	return m_meshCache->GetLods(mesh);
+}
+
+asset::GraphicsMeshCache::AssetFuture GraphicsModule::LoadMeshAsync(std::filesystem::path file) const {
+	return m_meshCache->LoadAsync(file);
+}
+
+asset::MaterialCache::AssetFuture GraphicsModule::LoadMaterialAsync(std::filesystem::path file) const {
+	return m_materialCache->LoadAsync(file);
+}
+
+asset::MaterialShaderCache::AssetFuture GraphicsModule::LoadMaterialShaderAsync(std::filesystem::path file) const {
+	return m_materialShaderCache->LoadAsync(file);
+}
+
+asset::ImageCache::AssetFuture GraphicsModule::LoadImageAsync(std::filesystem::path file) const {
+	return m_imageCache->LoadAsync(file);
+}
+
 std::optional<std::reference_wrapper<gxeng::IScene>> GraphicsModule::FindScene(std::string_view name) const {
 	for (auto& scenePtr : m_scenes) {
 		if (scenePtr->GetName() == name) {
@@ -8,6 +8,8 @@
 #include <GraphicsEngine/IGraphicsEngine.hpp>
 #include <GraphicsEngine/Scene/IScene.hpp>
 
+#include <BaseLibrary/JobSystem/ThreadpoolScheduler.hpp>
+
 #include <optional>
 
 #undef LoadImage
@@ -38,6 +40,15 @@ public:
 	std::shared_ptr<gxeng::IMaterialShader> LoadMaterialShader(std::filesystem::path file) const;
 	std::shared_ptr<gxeng::IImage> LoadImage(std::filesystem::path file) const;
 
+	/// <summary> Levels of detail for <see cref="gxeng::IMeshEntity::SetLods"/>, made when the mesh was cooked. </summary>
+	std::vector<gxeng::IMeshEntity::Lod> GetMeshLods(const std::shared_ptr<gxeng::IMesh>& mesh) const;
+
+	// Start loading on the asset loader threads, so that many assets can be loaded in parallel.
+	asset::GraphicsMeshCache::AssetFuture LoadMeshAsync(std::filesystem::path file) const;
+	asset::MaterialCache::AssetFuture LoadMaterialAsync(std::filesystem::path file) const;
+	asset::MaterialShaderCache::AssetFuture LoadMaterialShaderAsync(std::filesystem::path file) const;
+	asset::ImageCache::AssetFuture LoadImageAsync(std::filesystem::path file) const;
+
 private:
 	std::optional<std::reference_wrapper<gxeng::IScene>> FindScene(std::string_view name) const;
 
@@ -48,6 +59,7 @@ private:
 	std::unique_ptr<asset::ImageCache> m_imageCache;
 	std::unique_ptr<asset::MaterialShaderCache> m_materialShaderCache;
 	std::unique_ptr<asset::MaterialCache> m_materialCache;
+	std::unique_ptr<jobs::ThreadpoolScheduler> m_loadScheduler; // Declared last to finish the loads before the caches are destroyed.
 };
 
 
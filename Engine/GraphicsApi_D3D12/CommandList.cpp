@@ -175,7 +175,7 @@ D3D12_TEXTURE_COPY_LOCATION CopyCommandList::CreateTextureCopyLocation(gxapi::IR
 				footprint.Format = native_cast(description.format);
 				footprint.Height = description.height;
 				footprint.Width = (UINT)description.width; // narrowing conversion!
-				size_t rowSize = size_t(GetFormatSizeInBytes(description.format) * description.width);
+				size_t rowSize = GetFormatRowSize(description.format, description.width);
 				size_t alignement = D3D12_TEXTURE_DATA_PITCH_ALIGNMENT;
 				footprint.RowPitch = static_cast<UINT>(rowSize + (alignement - rowSize % alignement) % alignement);
 			}
@@ -340,6 +340,11 @@ void GraphicsCommandList::ClearRenderTarget(gxapi::DescriptorHandle rtv, gxapi::
 }
 
 
+void GraphicsCommandList::DiscardResource(gxapi::IResource* resource) {
+	m_native->DiscardResource(native_cast(resource), nullptr);
+}
+
+
 // Draw
 void GraphicsCommandList::DrawIndexedInstanced(unsigned numIndices, unsigned startIndex, int vertexOffset, unsigned numInstances, unsigned startInstance) {
 	m_native->DrawIndexedInstanced(numIndices, numInstances, startIndex, vertexOffset, startInstance);
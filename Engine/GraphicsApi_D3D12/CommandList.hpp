@@ -144,6 +144,8 @@ public:
 						   size_t numRects = 0,
 						   gxapi::Rectangle* rects = nullptr) override;
 
+	void DiscardResource(gxapi::IResource* resource) override;
+
 
 	// Draw
 	void DrawIndexedInstanced(unsigned numIndices,
@@ -6,6 +6,7 @@
 #include "CommandQueue.hpp"
 #include "DescriptorHeap.hpp"
 #include "ExceptionExpansions.hpp"
+#include "Heap.hpp"
 #include "NativeCast.hpp"
 #include "d3dx12.h"
 
@@ -128,6 +129,48 @@ gxapi::IResource* GraphicsApi::CreateCommittedResource(gxapi::HeapProperties hea
 }
 
 
+gxapi::IHeap* GraphicsApi::CreateHeap(gxapi::HeapDesc desc) {
+	ComPtr<ID3D12Heap> native;
+
+	D3D12_HEAP_DESC nativeDesc = native_cast(desc);
+	ThrowIfFailed(m_device->CreateHeap(&nativeDesc, IID_PPV_ARGS(&native)));
+
+	return new Heap{ native, desc };
+}
+
+
+gxapi::IResource* GraphicsApi::CreatePlacedResource(gxapi::IHeap* heap,
+													uint64_t heapOffset,
+													gxapi::ResourceDesc desc,
+													gxapi::eResourceState initialState,
+													gxapi::ClearValue* clearValue) {
+	ComPtr<ID3D12Resource> native;
+
+	D3D12_RESOURCE_DESC nativeResourceDesc = native_cast(desc);
+
+	D3D12_CLEAR_VALUE* pNativeClearValue = nullptr;
+	D3D12_CLEAR_VALUE nativeClearValue;
+	if (clearValue != nullptr) {
+		nativeClearValue = native_cast(*clearValue);
+		pNativeClearValue = &nativeClearValue;
+	}
+
+	ThrowIfFailed(m_device->CreatePlacedResource(native_cast(heap), heapOffset, &nativeResourceDesc, native_cast(initialState), pNativeClearValue, IID_PPV_ARGS(&native)));
+
+	Resource* resource = new Resource{ native, m_device };
+	resource->MarkPlaced();
+	return resource;
+}
+
+
+gxapi::ResourceAllocationInfo GraphicsApi::GetResourceAllocationInfo(const gxapi::ResourceDesc& desc) const {
+	D3D12_RESOURCE_DESC nativeResourceDesc = native_cast(desc);
+	D3D12_RESOURCE_ALLOCATION_INFO info = m_device->GetResourceAllocationInfo(0, 1, &nativeResourceDesc);
+
+	return { info.SizeInBytes, info.Alignment };
+}
+
+
 gxapi::IRootSignature* GraphicsApi::CreateRootSignature(gxapi::RootSignatureDesc desc) {
 	ComPtr<ID3D12RootSignature> native;
 
@@ -498,9 +541,15 @@ void GraphicsApi::MakeResident(const std::vector<gxapi::IResource*>& objects) {
 	nativeObjects.reserve(objects.size());
 
 	for (auto curr : objects) {
-		nativeObjects.push_back(native_cast(curr));
+		// Placed resources share the residency of their heap.
+		if (!curr->IsPlaced()) {
+			nativeObjects.push_back(native_cast(curr));
+		}
 	}
 
+	if (nativeObjects.empty()) {
+		return;
+	}
 	ThrowIfFailed(m_device->MakeResident((unsigned)nativeObjects.size(), nativeObjects.data()));
 }
 
@@ -514,6 +563,42 @@ void GraphicsApi::Evict(const std::vector<gxapi::IResource*>& objects) {
 	nativeObjects.reserve(objects.size());
 
 	for (auto curr : objects) {
+		// Placed resources share the residency of their heap.
+		if (!curr->IsPlaced()) {
+			nativeObjects.push_back(native_cast(curr));
+		}
+	}
+
+	if (nativeObjects.empty()) {
+		return;
+	}
+	ThrowIfFailed(m_device->Evict((unsigned)nativeObjects.size(), nativeObjects.data()));
+}
+
+
+void GraphicsApi::MakeResident(const std::vector<gxapi::IHeap*>& heaps) {
+	if (heaps.size() == 0) {
+		return;
+	}
+
+	std::vector<ID3D12Pageable*> nativeObjects;
+	nativeObjects.reserve(heaps.size());
+	for (auto curr : heaps) {
+		nativeObjects.push_back(native_cast(curr));
+	}
+
+	ThrowIfFailed(m_device->MakeResident((unsigned)nativeObjects.size(), nativeObjects.data()));
+}
+
+
+void GraphicsApi::Evict(const std::vector<gxapi::IHeap*>& heaps) {
+	if (heaps.size() == 0) {
+		return;
+	}
+
+	std::vector<ID3D12Pageable*> nativeObjects;
+	nativeObjects.reserve(heaps.size());
+	for (auto curr : heaps) {
 		nativeObjects.push_back(native_cast(curr));
 	}
 
@@ -33,6 +33,13 @@ public:
 											  gxapi::ResourceDesc desc,
 											  gxapi::eResourceState initialState,
 											  gxapi::ClearValue* clearValue = nullptr) override;
+	gxapi::IHeap* CreateHeap(gxapi::HeapDesc desc) override;
+	gxapi::IResource* CreatePlacedResource(gxapi::IHeap* heap,
+										   uint64_t heapOffset,
+										   gxapi::ResourceDesc desc,
+										   gxapi::eResourceState initialState,
+										   gxapi::ClearValue* clearValue = nullptr) override;
+	gxapi::ResourceAllocationInfo GetResourceAllocationInfo(const gxapi::ResourceDesc& desc) const override;
 
 
 	// Pipeline and binding
@@ -102,6 +109,8 @@ public:
 
 	void MakeResident(const std::vector<gxapi::IResource*>& objects) override;
 	void Evict(const std::vector<gxapi::IResource*>& objects) override;
+	void MakeResident(const std::vector<gxapi::IHeap*>& heaps) override;
+	void Evict(const std::vector<gxapi::IHeap*>& heaps) override;
 
 	// Debug
 	void ReportLiveObjects() const override;
@@ -0,0 +1,40 @@
+#ifdef _MSC_VER
+#define _CRT_SECURE_NO_WARNINGS
+#endif
+
+#include "Heap.hpp"
+
+#include <memory>
+
+
+namespace inl::gxapi_dx12 {
+
+
+Heap::Heap(ComPtr<ID3D12Heap>& native, gxapi::HeapDesc desc)
+	: m_native{ native }, m_desc(desc) {}
+
+
+ID3D12Heap* Heap::GetNative() {
+	return m_native.Get();
+}
+
+
+const ID3D12Heap* Heap::GetNative() const {
+	return m_native.Get();
+}
+
+
+gxapi::HeapDesc Heap::GetDesc() const {
+	return m_desc;
+}
+
+
+void Heap::SetName(const char* name) {
+	size_t count = strlen(name);
+	std::unique_ptr<wchar_t[]> dest = std::make_unique<wchar_t[]>(count + 1);
+	mbstowcs(dest.get(), name, count);
+	m_native->SetName(dest.get());
+}
+
+
+} // namespace inl::gxapi_dx12
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "../GraphicsApi_LL/IHeap.hpp"
+
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include "../GraphicsApi_LL/DisableWin32Macros.h"
+
+#include <d3d12.h>
+#include <wrl.h>
+
+namespace inl::gxapi_dx12 {
+
+using Microsoft::WRL::ComPtr;
+
+class Heap : public gxapi::IHeap {
+public:
+	Heap(ComPtr<ID3D12Heap>& native, gxapi::HeapDesc desc);
+	Heap(const Heap&) = delete;
+	Heap& operator=(const Heap&) = delete;
+
+	ID3D12Heap* GetNative();
+	const ID3D12Heap* GetNative() const;
+
+	gxapi::HeapDesc GetDesc() const override;
+
+	void SetName(const char* name) override;
+
+private:
+	ComPtr<ID3D12Heap> m_native;
+	gxapi::HeapDesc m_desc;
+};
+
+
+} // namespace inl::gxapi_dx12
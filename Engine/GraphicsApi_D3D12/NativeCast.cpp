@@ -118,6 +118,15 @@ ID3D12Fence* native_cast(gxapi::IFence* source) {
 	return static_cast<Fence*>(source)->GetNative();
 }
 
+
+ID3D12Heap* native_cast(gxapi::IHeap* source) {
+	if (source == nullptr) {
+		return nullptr;
+	}
+
+	return static_cast<Heap*>(source)->GetNative();
+}
+
 ID3D12CommandQueue* native_cast(gxapi::ICommandQueue* source) {
 	if (source == nullptr) {
 		return nullptr;
@@ -586,6 +595,36 @@ DXGI_FORMAT native_cast(gxapi::eFormat source) {
 			return DXGI_FORMAT_R8_SINT;
 		case gxapi::eFormat::A8_UNORM:
 			return DXGI_FORMAT_A8_UNORM;
+		case gxapi::eFormat::BC1_TYPELESS:
+			return DXGI_FORMAT_BC1_TYPELESS;
+		case gxapi::eFormat::BC1_UNORM:
+			return DXGI_FORMAT_BC1_UNORM;
+		case gxapi::eFormat::BC1_UNORM_SRGB:
+			return DXGI_FORMAT_BC1_UNORM_SRGB;
+		case gxapi::eFormat::BC3_TYPELESS:
+			return DXGI_FORMAT_BC3_TYPELESS;
+		case gxapi::eFormat::BC3_UNORM:
+			return DXGI_FORMAT_BC3_UNORM;
+		case gxapi::eFormat::BC3_UNORM_SRGB:
+			return DXGI_FORMAT_BC3_UNORM_SRGB;
+		case gxapi::eFormat::BC4_TYPELESS:
+			return DXGI_FORMAT_BC4_TYPELESS;
+		case gxapi::eFormat::BC4_UNORM:
+			return DXGI_FORMAT_BC4_UNORM;
+		case gxapi::eFormat::BC4_SNORM:
+			return DXGI_FORMAT_BC4_SNORM;
+		case gxapi::eFormat::BC5_TYPELESS:
+			return DXGI_FORMAT_BC5_TYPELESS;
+		case gxapi::eFormat::BC5_UNORM:
+			return DXGI_FORMAT_BC5_UNORM;
+		case gxapi::eFormat::BC5_SNORM:
+			return DXGI_FORMAT_BC5_SNORM;
+		case gxapi::eFormat::BC7_TYPELESS:
+			return DXGI_FORMAT_BC7_TYPELESS;
+		case gxapi::eFormat::BC7_UNORM:
+			return DXGI_FORMAT_BC7_UNORM;
+		case gxapi::eFormat::BC7_UNORM_SRGB:
+			return DXGI_FORMAT_BC7_UNORM_SRGB;
 
 		default:
 			assert(false);
@@ -1204,6 +1243,18 @@ D3D12_HEAP_PROPERTIES native_cast(gxapi::HeapProperties source) {
 }
 
 
+D3D12_HEAP_DESC native_cast(gxapi::HeapDesc source) {
+	D3D12_HEAP_DESC result;
+
+	result.SizeInBytes = source.sizeInBytes;
+	result.Properties = native_cast(source.properties);
+	result.Alignment = source.alignment;
+	result.Flags = native_cast(source.flags);
+
+	return result;
+}
+
+
 D3D12_RESOURCE_DESC native_cast(gxapi::ResourceDesc source) {
 	D3D12_RESOURCE_DESC result = {};
 
@@ -1961,6 +2012,8 @@ D3D12_RESOURCE_BARRIER native_cast(gxapi::ResourceBarrier source) {
 			native.Flags = native_cast(source.transition.splitMode);
 			break;
 		case gxapi::eResourceBarrierType::ALIASING:
+			native.Aliasing.pResourceBefore = native_cast(source.aliasing.before);
+			native.Aliasing.pResourceAfter = native_cast(source.aliasing.after);
 			break;
 		case gxapi::eResourceBarrierType::UAV:
 			native.UAV.pResource = native_cast(source.uav.resource);
@@ -2130,6 +2183,36 @@ gxapi::eFormat native_cast(DXGI_FORMAT source) {
 			return gxapi::eFormat::R8_SINT;
 		case DXGI_FORMAT_A8_UNORM:
 			return gxapi::eFormat::A8_UNORM;
+		case DXGI_FORMAT_BC1_TYPELESS:
+			return gxapi::eFormat::BC1_TYPELESS;
+		case DXGI_FORMAT_BC1_UNORM:
+			return gxapi::eFormat::BC1_UNORM;
+		case DXGI_FORMAT_BC1_UNORM_SRGB:
+			return gxapi::eFormat::BC1_UNORM_SRGB;
+		case DXGI_FORMAT_BC3_TYPELESS:
+			return gxapi::eFormat::BC3_TYPELESS;
+		case DXGI_FORMAT_BC3_UNORM:
+			return gxapi::eFormat::BC3_UNORM;
+		case DXGI_FORMAT_BC3_UNORM_SRGB:
+			return gxapi::eFormat::BC3_UNORM_SRGB;
+		case DXGI_FORMAT_BC4_TYPELESS:
+			return gxapi::eFormat::BC4_TYPELESS;
+		case DXGI_FORMAT_BC4_UNORM:
+			return gxapi::eFormat::BC4_UNORM;
+		case DXGI_FORMAT_BC4_SNORM:
+			return gxapi::eFormat::BC4_SNORM;
+		case DXGI_FORMAT_BC5_TYPELESS:
+			return gxapi::eFormat::BC5_TYPELESS;
+		case DXGI_FORMAT_BC5_UNORM:
+			return gxapi::eFormat::BC5_UNORM;
+		case DXGI_FORMAT_BC5_SNORM:
+			return gxapi::eFormat::BC5_SNORM;
+		case DXGI_FORMAT_BC7_TYPELESS:
+			return gxapi::eFormat::BC7_TYPELESS;
+		case DXGI_FORMAT_BC7_UNORM:
+			return gxapi::eFormat::BC7_UNORM;
+		case DXGI_FORMAT_BC7_UNORM_SRGB:
+			return gxapi::eFormat::BC7_UNORM_SRGB;
 		default:
 			assert(false);
 			break;
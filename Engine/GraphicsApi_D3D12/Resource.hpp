@@ -36,9 +36,13 @@ public:
 
 	void SetName(const char* name) override;
 
+	void MarkPlaced() { m_placed = true; }
+	bool IsPlaced() const override { return m_placed; }
+
 private:
 	ComPtr<ID3D12Resource> m_native;
 	unsigned m_numMipLevels, m_numTexturePlanes, m_numArrayLevels;
+	bool m_placed = false;
 };
 
 
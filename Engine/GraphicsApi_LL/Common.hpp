@@ -162,21 +162,21 @@ enum class eFormat {
 	//R8G8_B8G8_UNORM = 68,
 	//G8R8_G8B8_UNORM = 69,
 
-	//BC1_TYPELESS = 70,
-	//BC1_UNORM = 71,
-	//BC1_UNORM_SRGB = 72,
+	BC1_TYPELESS = 70,
+	BC1_UNORM = 71,
+	BC1_UNORM_SRGB = 72,
 	//BC2_TYPELESS = 73,
 	//BC2_UNORM = 74,
 	//BC2_UNORM_SRGB = 75,
-	//BC3_TYPELESS = 76,
-	//BC3_UNORM = 77,
-	//BC3_UNORM_SRGB = 78,
-	//BC4_TYPELESS = 79,
-	//BC4_UNORM = 80,
-	//BC4_SNORM = 81,
-	//BC5_TYPELESS = 82,
-	//BC5_UNORM = 83,
-	//BC5_SNORM = 84,
+	BC3_TYPELESS = 76,
+	BC3_UNORM = 77,
+	BC3_UNORM_SRGB = 78,
+	BC4_TYPELESS = 79,
+	BC4_UNORM = 80,
+	BC4_SNORM = 81,
+	BC5_TYPELESS = 82,
+	BC5_UNORM = 83,
+	BC5_SNORM = 84,
 
 	//B5G6R5_UNORM = 85,
 	//B5G5R5A1_UNORM = 86,
@@ -190,9 +190,9 @@ enum class eFormat {
 	//BC6H_TYPELESS = 94,
 	//BC6H_UF16 = 95,
 	//BC6H_SF16 = 96,
-	//BC7_TYPELESS = 97,
-	//BC7_UNORM = 98,
-	//BC7_UNORM_SRGB = 99,
+	BC7_TYPELESS = 97,
+	BC7_UNORM = 98,
+	BC7_UNORM_SRGB = 99,
 	//AYUV = 100,
 	//Y410 = 101,
 	//Y416 = 102,
@@ -726,6 +726,18 @@ struct HeapProperties {
 	eMemoryPool pool = eMemoryPool::UNKNOWN;
 };
 
+struct HeapDesc {
+	uint64_t sizeInBytes = 0;
+	HeapProperties properties;
+	uint64_t alignment = 0;
+	eHeapFlags flags = eHeapFlags::NONE;
+};
+
+struct ResourceAllocationInfo {
+	uint64_t sizeInBytes = 0;
+	uint64_t alignment = 0;
+};
+
 struct BufferDesc {
 	uint64_t sizeInBytes = 0;
 };
@@ -1420,11 +1432,19 @@ struct UavBarrier : public ResourceBarrierTag {
 	IResource* resource = nullptr;
 };
 
+/// <summary> Switches the active resource of overlapping placed resources in a heap. </summary>
+/// <remarks> Null for <see cref="before"/> means any resource that overlaps <see cref="after"/>. </remarks>
+struct AliasingBarrier : public ResourceBarrierTag {
+	IResource* before = nullptr;
+	IResource* after = nullptr;
+};
+
 struct ResourceBarrier {
 	eResourceBarrierType type;
 	union {
 		TransitionBarrier transition;
 		UavBarrier uav;
+		AliasingBarrier aliasing;
 	};
 	ResourceBarrier() {}
 	ResourceBarrier(const ResourceBarrier& rhs) {
@@ -1438,6 +1458,10 @@ struct ResourceBarrier {
 		type = eResourceBarrierType::UAV;
 		uav = rhs;
 	}
+	ResourceBarrier(const AliasingBarrier& rhs) {
+		type = eResourceBarrierType::ALIASING;
+		aliasing = rhs;
+	}
 
 	ResourceBarrier& operator=(const ResourceBarrier& rhs) {
 		memcpy(this, &rhs, sizeof(*this));
@@ -1454,6 +1478,11 @@ struct ResourceBarrier {
 		uav = rhs;
 		return *this;
 	}
+	ResourceBarrier& operator=(const AliasingBarrier& rhs) {
+		type = eResourceBarrierType::ALIASING;
+		aliasing = rhs;
+		return *this;
+	}
 };
 
 
@@ -1776,6 +1805,7 @@ inline RootDescriptorTable& RootParameterDesc::As<RootParameterDesc::eType::DESC
 // Internal helper function
 //------------------------------------------------------------------------------
 
+/// <summary> Returns the size of a pixel, or the size of a 4x4 block for block compressed formats. </summary>
 inline unsigned GetFormatSizeInBytes(eFormat format) {
 	switch (format) {
 		case eFormat::R32G32B32A32_TYPELESS:
@@ -1856,10 +1886,66 @@ inline unsigned GetFormatSizeInBytes(eFormat format) {
 		case eFormat::R8_SINT:
 		case eFormat::A8_UNORM:
 			return 1 * 1;
+		case eFormat::BC1_TYPELESS:
+		case eFormat::BC1_UNORM:
+		case eFormat::BC1_UNORM_SRGB:
+		case eFormat::BC4_TYPELESS:
+		case eFormat::BC4_UNORM:
+		case eFormat::BC4_SNORM:
+			return 8;
+		case eFormat::BC3_TYPELESS:
+		case eFormat::BC3_UNORM:
+		case eFormat::BC3_UNORM_SRGB:
+		case eFormat::BC5_TYPELESS:
+		case eFormat::BC5_UNORM:
+		case eFormat::BC5_SNORM:
+		case eFormat::BC7_TYPELESS:
+		case eFormat::BC7_UNORM:
+		case eFormat::BC7_UNORM_SRGB:
+			return 16;
 		default:
 			return 0;
 	}
 }
 
 
+/// <summary> Returns the width and height of the pixel blocks the format stores together, 1 for uncompressed formats. </summary>
+inline unsigned GetFormatBlockDimension(eFormat format) {
+	switch (format) {
+		case eFormat::BC1_TYPELESS:
+		case eFormat::BC1_UNORM:
+		case eFormat::BC1_UNORM_SRGB:
+		case eFormat::BC3_TYPELESS:
+		case eFormat::BC3_UNORM:
+		case eFormat::BC3_UNORM_SRGB:
+		case eFormat::BC4_TYPELESS:
+		case eFormat::BC4_UNORM:
+		case eFormat::BC4_SNORM:
+		case eFormat::BC5_TYPELESS:
+		case eFormat::BC5_UNORM:
+		case eFormat::BC5_SNORM:
+		case eFormat::BC7_TYPELESS:
+		case eFormat::BC7_UNORM:
+		case eFormat::BC7_UNORM_SRGB:
+			return 4;
+		default:
+			return 1;
+	}
+}
+
+
+/// <summary> Returns the number of bytes a row of pixels (or blocks) occupies without padding. </summary>
+inline size_t GetFormatRowSize(eFormat format, uint64_t width) {
+	unsigned blockDim = GetFormatBlockDimension(format);
+	return size_t((width + blockDim - 1) / blockDim) * GetFormatSizeInBytes(format);
+}
+
+
+/// <summary> Returns how many rows of pixels (or blocks) an image of the given height has. </summary>
+inline uint32_t GetFormatRowCount(eFormat format, uint32_t height) {
+	unsigned blockDim = GetFormatBlockDimension(format);
+	return (height + blockDim - 1) / blockDim;
+}
+
+
 } // namespace inl::gxapi
@@ -126,6 +126,9 @@ public:
 								   size_t numRects = 0,
 								   Rectangle* rects = nullptr) = 0;
 
+	/// <summary> Marks the contents of the resource as no longer needed. </summary>
+	virtual void DiscardResource(IResource* resource) = 0;
+
 
 	// Draw
 	virtual void DrawIndexedInstanced(unsigned numIndices,
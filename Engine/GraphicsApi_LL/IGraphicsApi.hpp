@@ -13,6 +13,7 @@ class ICommandAllocator;
 class IFence;
 
 class IResource;
+class IHeap;
 
 class IRootSignature;
 class IPipelineState;
@@ -40,6 +41,13 @@ public:
 											   ResourceDesc desc,
 											   eResourceState initialState,
 											   ClearValue* clearValue = nullptr) = 0;
+	virtual IHeap* CreateHeap(HeapDesc desc) = 0;
+	virtual IResource* CreatePlacedResource(IHeap* heap,
+											uint64_t heapOffset,
+											ResourceDesc desc,
+											eResourceState initialState,
+											ClearValue* clearValue = nullptr) = 0;
+	virtual ResourceAllocationInfo GetResourceAllocationInfo(const ResourceDesc& desc) const = 0;
 
 	// Pipeline and binding
 	virtual IRootSignature* CreateRootSignature(RootSignatureDesc desc) = 0;
@@ -106,8 +114,13 @@ public:
 	// Misc
 	virtual IFence* CreateFence(uint64_t initialValue) = 0;
 
+	/// <remarks> Placed resources are skipped, make their heap resident instead. </remarks>
 	virtual void MakeResident(const std::vector<gxapi::IResource*>& objects) = 0;
+	/// <remarks> Placed resources are skipped, they are evicted together with their heap. </remarks>
 	virtual void Evict(const std::vector<gxapi::IResource*>& objects) = 0;
+	/// <remarks> Heaps are resident from their creation. The resources placed in them follow their residency. </remarks>
+	virtual void MakeResident(const std::vector<gxapi::IHeap*>& heaps) = 0;
+	virtual void Evict(const std::vector<gxapi::IHeap*>& heaps) = 0;
 
 	// Debug
 	virtual void ReportLiveObjects() const = 0;
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "Common.hpp"
+
+
+namespace inl::gxapi {
+
+
+/// <summary> A block of GPU memory that placed resources can be created in. </summary>
+class IHeap {
+public:
+	virtual ~IHeap() = default;
+
+	virtual HeapDesc GetDesc() const = 0;
+
+	// Debug
+	virtual void SetName(const char* name) = 0;
+};
+
+
+} // namespace inl::gxapi
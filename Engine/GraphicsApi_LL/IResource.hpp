@@ -25,6 +25,10 @@ public:
 	virtual unsigned GetSubresourceIndex(unsigned mipLevel, unsigned arrayIdx, unsigned planeIdx) const = 0;
 	virtual Vec3u64 GetSize(unsigned mipLevel = 0) const = 0;
 
+	/// <summary> True if the resource was created in an explicit heap by <see cref="IGraphicsApi::CreatePlacedResource"/>. </summary>
+	/// <remarks> Placed resources are resident exactly when their heap is, they cannot be made resident or evicted on their own. </remarks>
+	virtual bool IsPlaced() const = 0;
+
 	// Debug
 	virtual void SetName(const char* name) = 0;
 };
@@ -43,6 +43,25 @@ public:
 	/// <param name="reader"> Interprets byte stream. Implement <see cref="IPixelReader"/> or use <see cref="Pixel::Reader"/>. </param>
 	/// <param name="bytesPerRow"> How many bytes to skip in <paramref name="pixels"/> for each row. Leave as 0 for no row padding. </param>
 	virtual void Update(uint64_t x, uint32_t y, uint64_t width, uint32_t height, int mipLevel, const void* pixels, const IPixelReader& reader, size_t bytesPerRow = 0) = 0;
+
+	/// <summary> Allocates the underlying GPU-resident texture for block compressed pixels. </summary>
+	/// <param name="width"> Width of the texture in pixels, must be a multiple of 4. </param>
+	/// <param name="height"> Height of the texture in pixels, must be a multiple of 4. </param>
+	/// <param name="compression"> The block format of the pixels. See <see cref="eBlockCompression"/>. </param>
+	/// <param name="mipCount"> Number of mip levels, all of which should be uploaded. </param>
+	/// <param name="srgb"> The color channels are sRGB encoded and are converted to linear when sampled. Ignored for BC4 and BC5. </param>
+	virtual void SetCompressedLayout(uint64_t width, uint32_t height, eBlockCompression compression, int mipCount, bool srgb = false) = 0;
+
+	/// <summary> Uploads an entire mip level of block compressed pixels to the GPU. </summary>
+	/// <param name="mipLevel"> Target mip level of the texture. </param>
+	/// <param name="blocks"> The 4x4 pixel blocks of the mip level row by row. </param>
+	/// <param name="bytesPerRow"> How many bytes to skip in <paramref name="blocks"/> for each row of blocks. Leave as 0 for no row padding. </param>
+	virtual void UpdateCompressed(int mipLevel, const void* blocks, size_t bytesPerRow = 0) = 0;
+
+	/// <summary> Keeps the pixels in system memory and only the mip levels needed for rendering on the GPU. </summary>
+	/// <remarks> Takes effect at the next call to <see cref="SetLayout"/> or <see cref="SetCompressedLayout"/>.
+	///		Missing mip levels of uncompressed images are generated from the more detailed ones. </remarks>
+	virtual void SetStreaming(bool enabled) = 0;
 };
 
 
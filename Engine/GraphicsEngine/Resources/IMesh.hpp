@@ -2,18 +2,46 @@
 
 
 #include "Vertex.hpp"
+#include "VertexQuantization.hpp"
 
 
 namespace inl::gxeng {
 
 
 class IMesh {
+public:
+	struct Element {
+		eVertexElementSemantic semantic; // Semantic of the vertex elements.
+		int index; // Index of the semantic.
+		int offset; // Offset of the element within it's vertex stream, in bytes.
+	};
+
 public:
 	virtual ~IMesh() = default;
 
 	virtual void Set(const VertexBase* vertices, const IVertexReader* vertexReader, size_t numVertices, const unsigned* indices, size_t numIndices) = 0;
+	/// <summary> Sets vertices that are already in the layout the GPU reads, as produced by the VertexCompressor
+	///		with <paramref name="quantization"/>. </summary>
+	/// <remarks> The data is copied to upload memory right away, so it can be a mapped file that is closed afterwards. </remarks>
+	virtual void SetCompressed(const void* vertexData, uint32_t stride, size_t numVertices, const Element* elements, size_t numElements, const void* indices, bool indices32Bit, size_t numIndices, const VertexQuantization& quantization) = 0;
 	virtual void Update(const VertexBase* vertices, const IVertexReader* vertexReader, size_t numVertices, size_t offsetInVertices) = 0;
 	virtual void Clear() = 0;
+
+	/// <summary> When enabled, <see cref="Set"/> reorders triangles for the post-transform cache and overdraw,
+	///		and vertices for fetch locality. Disabled by default. </summary>
+	/// <remarks> <see cref="Update"/> keeps addressing vertices in the order they were given to Set. </remarks>
+	virtual void SetOptimization(bool enabled) = 0;
+
+	/// <summary> How <see cref="Set"/> and <see cref="Update"/> encode vertices, floats by default. </summary>
+	/// <remarks> Takes effect at the next call to Set, which quantizes positions within the bounds of the vertices it is given.
+	///		Update keeps the encoding of the last Set. </remarks>
+	virtual void SetQuantization(const VertexQuantization& quantization) = 0;
+
+	/// <summary> Axis aligned bounds of the positions in model space, used to pick the level of detail. </summary>
+	/// <remarks> Set computes them, they must be given after <see cref="SetCompressed"/>. </remarks>
+	virtual void SetBounds(const Vec3& boundsMin, const Vec3& boundsMax) = 0;
+	virtual Vec3 GetBoundsMin() const = 0;
+	virtual Vec3 GetBoundsMax() const = 0;
 };
 
 
@@ -1,6 +1,7 @@
 #pragma once
 
 
+#include <cstddef>
 #include <cstdint>
 #include <type_traits>
 
@@ -21,6 +22,15 @@ enum class ePixelClass {
 	VALUE_EXPONENT,
 };
 
+/// <summary> Formats that store 4x4 pixel blocks in 8 or 16 bytes. </summary>
+enum class eBlockCompression {
+	BC1, // RGB, 8 bytes.
+	BC3, // RGBA, 16 bytes.
+	BC4, // R, 8 bytes.
+	BC5, // RG, 16 bytes.
+	BC7, // RGBA, 16 bytes, higher quality.
+};
+
 
 namespace impl {
 
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <InlineMath.hpp>
+
+
+namespace inl::gxeng {
+
+
+enum class ePositionEncoding {
+	FLOAT32, // 12 bytes.
+	UNORM16, // 8 bytes, quantized relative to the bounds of the mesh.
+};
+
+enum class eDirectionEncoding {
+	FLOAT32, // 12 bytes.
+	OCTAHEDRAL16, // 2 bytes for normals, 4 bytes for tangents with bitangent sign.
+	OCTAHEDRAL32, // 4 bytes for normals, 8 bytes for tangents with bitangent sign.
+};
+
+enum class eTexCoordEncoding {
+	FLOAT32, // 8 bytes.
+	HALF16, // 4 bytes, keeps tiling coordinates outside [0, 1].
+	UNORM16, // 4 bytes, quantized relative to the texture coordinate range.
+};
+
+
+/// <summary> Selects how the vertex compressor encodes each semantic. The default leaves vertices as floats. </summary>
+struct VertexQuantization {
+	ePositionEncoding position = ePositionEncoding::FLOAT32;
+	eDirectionEncoding normal = eDirectionEncoding::FLOAT32;
+	/// <summary> Applies to tangents and bitangents. Octahedral tangents store the bitangent's handedness,
+	/// so bitangents are left out of the stream when the vertex also has a normal. </summary>
+	eDirectionEncoding tangent = eDirectionEncoding::FLOAT32;
+	eTexCoordEncoding texCoord = eTexCoordEncoding::FLOAT32;
+
+	/// <summary> Object space bounds of the positions, the decoder needs the same values. </summary>
+	Vec3 boundsMin = { 0, 0, 0 };
+	Vec3 boundsMax = { 1, 1, 1 };
+	/// <summary> Range of the texture coordinates for UNORM16, the decoder needs the same values. </summary>
+	Vec2 texCoordMin = { 0, 0 };
+	Vec2 texCoordMax = { 1, 1 };
+};
+
+
+} // namespace inl::gxeng
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+
 
 namespace inl::gxeng {
 
@@ -16,8 +19,21 @@ public:
 	void Orphan() const;
 	const EntityCollectionBase* GetCollection() const;
 
+	/// <summary> Changes whenever the entity is modified. </summary>
+	/// <remarks> Revisions are unique among all entities, renderers can use them
+	///		to keep data derived from an entity between frames. </remarks>
+	uint64_t GetRevision() const;
+
+protected:
+	/// <summary> Derived classes call this when any of their properties change. </summary>
+	void Modified();
+
+private:
+	static uint64_t NextRevision();
+
 private:
 	mutable EntityCollectionBase* m_collection = nullptr;
+	uint64_t m_revision = NextRevision();
 };
 
 } // namespace inl::gxeng
@@ -41,4 +57,17 @@ inline const EntityCollectionBase* Entity::GetCollection() const {
 	return m_collection;
 }
 
+inline uint64_t Entity::GetRevision() const {
+	return m_revision;
+}
+
+inline void Entity::Modified() {
+	m_revision = NextRevision();
+}
+
+inline uint64_t Entity::NextRevision() {
+	static std::atomic_uint64_t counter = 0;
+	return ++counter;
+}
+
 } // namespace inl::gxeng
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include <BaseLibrary/Exception/Exception.hpp>
 
 #include <cassert>
+#include <cstdint>
 #include <set>
 #include <typeindex>
 
@@ -57,8 +58,12 @@ public:
 	bool Contains(const EntityType* entity) const;
 	void Clear();
 
+	/// <summary> Changes whenever entities are added or removed. </summary>
+	uint64_t GetRevision() const;
+
 private:
 	std::set<const EntityType*> m_entites;
+	uint64_t m_revision = 0;
 };
 
 
@@ -120,6 +125,7 @@ void EntityCollection<EntityType>::Add(const EntityType* entity) {
 	if (result.second == false) {
 		throw InvalidArgumentException("Entity already member of this collection.");
 	}
+	++m_revision;
 }
 
 template <class EntityType>
@@ -139,6 +145,12 @@ void EntityCollection<EntityType>::Clear() {
 		Orphan(entity);
 	}
 	m_entites.clear();
+	++m_revision;
+}
+
+template <class EntityType>
+uint64_t EntityCollection<EntityType>::GetRevision() const {
+	return m_revision;
 }
 
 
@@ -168,6 +180,7 @@ void EntityCollection<EntityType>::Remove(const Entity* entity) {
 		const EntityType* ptr = static_cast<const EntityType*>(entity);
 		m_entites.erase(ptr);
 		Orphan(entity);
+		++m_revision;
 	}
 }
 
@@ -6,11 +6,20 @@
 
 #include <BaseLibrary/Transform.hpp>
 
+#include <vector>
+
 
 namespace inl::gxeng {
 
 
 class IMeshEntity : public Entity {
+public:
+	struct Lod {
+		std::shared_ptr<IMesh> mesh;
+		/// <summary> The level is drawn when the bounding sphere of the mesh covers less than this fraction of the screen height. </summary>
+		float screenSize;
+	};
+
 public:
 	/// <summary> Provides the base geometry for the mesh. </summary>
 	/// <remarks> Passing nullptr is ok, but rendering it is undefined behviour. </remarks>
@@ -19,6 +28,17 @@ public:
 	/// <summary> Returns currently associated triangle mesh. </summary>
 	virtual std::shared_ptr<IMesh> GetMesh() const = 0;
 
+	/// <summary> Sets lower detail versions of the mesh, from the most to the least detailed. </summary>
+	/// <remarks> Screen sizes must decrease with the level. The bounds of the base mesh are used for all levels. </remarks>
+	/// <exception cref="InvalidArgumentException"> If a mesh is null or the sizes are not decreasing. </exception>
+	virtual void SetLods(std::vector<Lod> lods) = 0;
+
+	/// <summary> Returns the lower detail levels, not including the base mesh. </summary>
+	virtual const std::vector<Lod>& GetLods() const = 0;
+
+	/// <summary> Returns the base mesh or one of its levels of detail depending on the projected size. </summary>
+	virtual std::shared_ptr<IMesh> SelectLod(const Mat44& view, const Mat44& projection) const = 0;
+
 	/// <summary> Describes the surface of the triangle mesh. </summary>
 	/// <remarks> Passing nullptr is ok, but rendering it is undefined behviour. </remarks>
 	virtual void SetMaterial(std::shared_ptr<IMaterial> material) = 0;
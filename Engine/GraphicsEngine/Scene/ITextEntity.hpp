@@ -82,6 +82,13 @@ public:
 	virtual float CalculateTextWidth() const = 0;
 	/// <summary> Return the height of a line of text without top and bottom line spacing. </summary>
 	virtual float CalculateTextHeight() const = 0;
+	/// <summary> Return the index of the character at the horizontal coordinate. </summary>
+	/// <param name="coordinate"> Camera units from the left side of the text. </param>
+	/// <returns> -1 if left of the text, the text's length if right of it. </returns>
+	virtual intptr_t FindCharacter(float coordinate) const = 0;
+	/// <summary> Return the horizontal interval the character at index spans, from the left side of the text. </summary>
+	/// <remarks> The index may be the length of the text, that is an empty interval at the end. </remarks>
+	virtual std::pair<float, float> FindCoordinates(size_t index) const = 0;
 
 	/// <summary> Z-Depth determines which 2D entity lays over the other. </summary>
 	/// <remarks> Number are not limited to [0,1], anything is fine. Don't pass NaN and Inf. </remarks>
@@ -0,0 +1,106 @@
+#include "BuddyAllocator.hpp"
+
+#include <BaseLibrary/Exception/Exception.hpp>
+
+#include <algorithm>
+#include <cassert>
+
+
+namespace inl::gxeng {
+
+namespace impl {
+
+	static bool IsPowerOfTwo(uint64_t value) {
+		return value != 0 && (value & (value - 1)) == 0;
+	}
+
+
+	BuddyAllocator::BuddyAllocator(uint64_t size, uint64_t minBlockSize)
+		: m_size(size) {
+		if (!IsPowerOfTwo(size) || !IsPowerOfTwo(minBlockSize) || minBlockSize > size) {
+			throw InvalidArgumentException("Buddy allocator sizes must be powers of two and the minimum block must fit the range.");
+		}
+
+		m_numLevels = 1;
+		while ((size >> m_numLevels) >= minBlockSize) {
+			++m_numLevels;
+		}
+		m_freeBlocks.resize(m_numLevels);
+		m_freeBlocks[0].insert(0);
+	}
+
+
+	std::optional<uint64_t> BuddyAllocator::Allocate(uint64_t size, uint64_t alignment) {
+		if (size == 0 || size > m_size || alignment > m_size) {
+			return {};
+		}
+
+		// Blocks are aligned to their size, so the smallest block that satisfies both will do.
+		const uint64_t required = std::max(size, alignment);
+		unsigned level = m_numLevels - 1;
+		while (BlockSize(level) < required) {
+			--level;
+		}
+
+		// Find the smallest free block that is large enough.
+		int sourceLevel = (int)level;
+		while (sourceLevel >= 0 && m_freeBlocks[sourceLevel].empty()) {
+			--sourceLevel;
+		}
+		if (sourceLevel < 0) {
+			return {};
+		}
+
+		// Split it until it has the right size, keeping the upper halves free.
+		uint64_t offset = *m_freeBlocks[sourceLevel].begin();
+		m_freeBlocks[sourceLevel].erase(m_freeBlocks[sourceLevel].begin());
+		for (unsigned current = sourceLevel + 1; current <= level; ++current) {
+			m_freeBlocks[current].insert(offset + BlockSize(current));
+		}
+
+		m_allocations.insert({ offset, Allocation{ level, size } });
+		m_usedSize += BlockSize(level);
+		m_requestedSize += size;
+		return offset;
+	}
+
+
+	void BuddyAllocator::Deallocate(uint64_t offset) {
+		auto it = m_allocations.find(offset);
+		assert(it != m_allocations.end());
+		if (it == m_allocations.end()) {
+			return;
+		}
+
+		unsigned level = it->second.level;
+		m_usedSize -= BlockSize(level);
+		m_requestedSize -= it->second.requestedSize;
+		m_allocations.erase(it);
+
+		// Merge with the buddy as long as it is free.
+		while (level > 0) {
+			const uint64_t buddy = offset ^ BlockSize(level);
+			auto buddyIt = m_freeBlocks[level].find(buddy);
+			if (buddyIt == m_freeBlocks[level].end()) {
+				break;
+			}
+			m_freeBlocks[level].erase(buddyIt);
+			offset = std::min(offset, buddy);
+			--level;
+		}
+		m_freeBlocks[level].insert(offset);
+	}
+
+
+	uint64_t BuddyAllocator::GetLargestFreeBlock() const {
+		for (unsigned level = 0; level < m_numLevels; ++level) {
+			if (!m_freeBlocks[level].empty()) {
+				return BlockSize(level);
+			}
+		}
+		return 0;
+	}
+
+} // namespace impl
+
+} // namespace inl::gxeng
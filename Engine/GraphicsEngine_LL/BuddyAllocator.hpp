@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <set>
+#include <vector>
+
+
+namespace inl::gxeng {
+
+namespace impl {
+
+	/// <summary> Hands out power-of-two sized blocks of a fixed-size memory range. </summary>
+	/// <remarks> Only offsets are managed, the memory itself is owned by the user.
+	///		Every block is aligned to its own size. </remarks>
+	class BuddyAllocator {
+	public:
+		/// <param name="size"> Size of the managed range. Must be a power of two. </param>
+		/// <param name="minBlockSize"> Size of the smallest block. Must be a power of two. </param>
+		BuddyAllocator(uint64_t size, uint64_t minBlockSize);
+
+		/// <summary> Returns the offset of the new block or nothing if no suitable block is free. </summary>
+		std::optional<uint64_t> Allocate(uint64_t size, uint64_t alignment = 1);
+
+		/// <summary> Releases the block starting at <paramref name="offset"/> and merges it with its free buddies. </summary>
+		void Deallocate(uint64_t offset);
+
+		/// <summary> Size of the managed range. </summary>
+		uint64_t GetSize() const { return m_size; }
+		/// <summary> Sum of the sizes of the allocated blocks. </summary>
+		uint64_t GetUsedSize() const { return m_usedSize; }
+		/// <summary> Sum of the sizes the allocations were requested with. </summary>
+		uint64_t GetRequestedSize() const { return m_requestedSize; }
+		/// <summary> Size of the largest block that can still be allocated. </summary>
+		uint64_t GetLargestFreeBlock() const;
+		size_t GetAllocationCount() const { return m_allocations.size(); }
+		bool IsEmpty() const { return m_allocations.empty(); }
+
+	private:
+		uint64_t BlockSize(unsigned level) const { return m_size >> level; }
+
+	private:
+		struct Allocation {
+			unsigned level;
+			uint64_t requestedSize;
+		};
+
+		uint64_t m_size;
+		unsigned m_numLevels;
+		std::vector<std::set<uint64_t>> m_freeBlocks; // Level 0 is the whole range.
+		std::map<uint64_t, Allocation> m_allocations;
+		uint64_t m_usedSize = 0;
+		uint64_t m_requestedSize = 0;
+	};
+
+} // namespace impl
+
+} // namespace inl::gxeng
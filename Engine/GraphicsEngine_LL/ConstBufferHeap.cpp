@@ -5,7 +5,16 @@
 namespace inl ::gxeng {
 
 
-ConstantBufferHeap::ConstantBufferHeap(gxapi::IGraphicsApi* graphicsApi) : m_graphicsApi(graphicsApi) {
+thread_local ConstantBufferHeap::ThreadCursor ConstantBufferHeap::t_cursor;
+
+
+static uint64_t NextHeapId() {
+	static std::atomic_uint64_t nextId{ 1 };
+	return nextId++;
+}
+
+
+ConstantBufferHeap::ConstantBufferHeap(gxapi::IGraphicsApi* graphicsApi) : m_graphicsApi(graphicsApi), m_heapId(NextHeapId()) {
 	m_pages.PushFront(CreatePage());
 }
 
@@ -13,59 +22,87 @@ ConstantBufferHeap::ConstantBufferHeap(gxapi::IGraphicsApi* graphicsApi) : m_gra
 VolatileConstBuffer ConstantBufferHeap::CreateVolatileConstBuffer(const void* data, uint32_t dataSize) {
 	uint32_t targetSize = (uint32_t)SnapUpward(dataSize, ALIGNEMENT);
 
+	if (targetSize > PAGE_SIZE) {
+		return CreateLargeVolatileConstBuffer(data, dataSize, targetSize);
+	}
+
+	// Each thread bumps its own cursor, the lock is only taken when the thread needs a new page.
+	// A cursor is only valid for the heap and the frame it was acquired for.
+	ThreadCursor& cursor = t_cursor;
+	const uint64_t frameId = m_currFrameID.load(std::memory_order_relaxed);
+	if (cursor.heapId != m_heapId || cursor.frameId != frameId || cursor.consumedSize + targetSize > cursor.pageSize) {
+		cursor = AcquirePage(frameId);
+	}
+
+	size_t offset = cursor.consumedSize;
+	cursor.consumedSize += targetSize;
+
+	void* cpuPtr = cursor.cpuAddress + offset;
+	void* gpuPtr = cursor.gpuAddress + offset;
+
+	memcpy(cpuPtr, data, dataSize);
+
+	auto NullDeleter = [](const gxapi::IResource*) {};
+	auto resource = MemoryObject::UniquePtr(cursor.resource, NullDeleter);
+
+	return VolatileConstBuffer(std::move(resource), true, eResourceHeap::CONSTANT, gpuPtr, dataSize, targetSize);
+}
+
+
+ConstantBufferHeap::ThreadCursor ConstantBufferHeap::AcquirePage(uint64_t frameId) {
 	std::lock_guard<std::mutex> lock(m_mutex);
 
-	MarkEmptyIfRecycled(m_pages.Front());
+	m_pages.RotateFront();
+	if (!HasBecomeAvailable(m_pages.Front())) {
+		m_pages.PushFront(CreatePage());
+	}
+
+	// The whole page belongs to the thread, nobody else may allocate from it until the GPU is done with the frame.
+	ConstBufferPage& page = m_pages.Front();
+	page.m_ownerFrameID = frameId;
+	page.m_consumedSize = page.m_pageSize;
+
+	ThreadCursor cursor;
+	cursor.heapId = m_heapId;
+	cursor.frameId = frameId;
+	cursor.cpuAddress = (uint8_t*)page.m_cpuAddress;
+	cursor.gpuAddress = (uint8_t*)page.m_gpuAddress;
+	cursor.resource = page.m_representedMemory.get();
+	cursor.consumedSize = 0;
+	cursor.pageSize = page.m_pageSize;
+	return cursor;
+}
 
-	ConstBufferPage* targetPage = nullptr;
 
-	if (m_pages.Front().m_consumedSize + targetSize > m_pages.Front().m_pageSize) {
-		if (targetSize > PAGE_SIZE) {
-			if (m_largePages.Count() == 0) {
-				m_largePages.PushFront(CreateLargePage(targetSize));
-			}
-			else {
-				if (HasBecomeAvailable(m_largePages.Front())) {
-					m_largePages.Front().m_consumedSize = 0;
-				}
-
-				auto roundEnd = m_largePages.End();
-				for (;
-					 m_largePages.Begin() != roundEnd;
-					 m_largePages.RotateFront()) {
-					auto& currPage = m_largePages.Front();
-					MarkEmptyIfRecycled(currPage);
-					if (currPage.m_consumedSize + targetSize <= currPage.m_pageSize) {
-						break; // current front will be selected as the target page, see below
-					}
-				}
-
-				bool noSuitable = roundEnd == m_largePages.Begin();
-				if (noSuitable) {
-					m_largePages.PushFront(CreateLargePage(targetSize));
-				}
-			}
+VolatileConstBuffer ConstantBufferHeap::CreateLargeVolatileConstBuffer(const void* data, uint32_t dataSize, uint32_t targetSize) {
+	std::lock_guard<std::mutex> lock(m_mutex);
 
-			targetPage = &m_largePages.Front();
+	if (m_largePages.Count() == 0) {
+		m_largePages.PushFront(CreateLargePage(targetSize));
+	}
+	else {
+		if (HasBecomeAvailable(m_largePages.Front())) {
+			m_largePages.Front().m_consumedSize = 0;
 		}
-		else {
-			m_pages.RotateFront();
 
-			if (HasBecomeAvailable(m_pages.Front())) {
-				m_pages.Front().m_consumedSize = 0;
-			}
-			else {
-				m_pages.PushFront(CreatePage());
+		auto roundEnd = m_largePages.End();
+		for (;
+			 m_largePages.Begin() != roundEnd;
+			 m_largePages.RotateFront()) {
+			auto& currPage = m_largePages.Front();
+			MarkEmptyIfRecycled(currPage);
+			if (currPage.m_consumedSize + targetSize <= currPage.m_pageSize) {
+				break; // current front will be selected as the target page, see below
 			}
+		}
 
-			targetPage = &m_pages.Front();
+		bool noSuitable = roundEnd == m_largePages.Begin();
+		if (noSuitable) {
+			m_largePages.PushFront(CreateLargePage(targetSize));
 		}
 	}
-	else {
-		targetPage = &m_pages.Front();
-	}
 
-	assert(targetPage != nullptr);
+	ConstBufferPage* targetPage = &m_largePages.Front();
 
 	// set owner to mach latest data that is being
 	// used from the page
@@ -9,6 +9,7 @@
 #include <GraphicsApi_LL/IGraphicsApi.hpp>
 #include <GraphicsApi_LL/IResource.hpp>
 
+#include <atomic>
 #include <memory>
 #include <mutex>
 
@@ -57,8 +58,9 @@ protected:
 	RingBuffer<ConstBufferPage> m_pages;
 	std::mutex m_mutex;
 
-	uint64_t m_currFrameID = 1;
+	std::atomic_uint64_t m_currFrameID{ 1 };
 	uint64_t m_lastFinishedFrameID = 0;
+	const uint64_t m_heapId;
 
 protected:
 	// From ( https://msdn.microsoft.com/en-us/library/windows/desktop/dn899216%28v=vs.85%29.aspx )
@@ -71,6 +73,22 @@ protected:
 	static size_t SnapUpward(size_t value, size_t gridSize);
 
 protected:
+	/// <summary> The part of a page a thread allocates from without locking. </summary>
+	struct ThreadCursor {
+		uint64_t heapId = 0;
+		uint64_t frameId = 0;
+		uint8_t* cpuAddress = nullptr;
+		uint8_t* gpuAddress = nullptr;
+		gxapi::IResource* resource = nullptr;
+		size_t consumedSize = 0;
+		size_t pageSize = 0;
+	};
+	static thread_local ThreadCursor t_cursor;
+
+	/// <summary> Reserves a whole page for the calling thread until the end of the frame. </summary>
+	ThreadCursor AcquirePage(uint64_t frameId);
+	VolatileConstBuffer CreateLargeVolatileConstBuffer(const void* data, uint32_t dataSize, uint32_t targetSize);
+
 	ConstBufferPage CreatePage();
 	ConstBufferPage CreateLargePage(size_t fittingSize);
 	bool HasBecomeAvailable(const ConstBufferPage& page);
@@ -4,6 +4,10 @@
 #include "MemoryManager.hpp"
 #include "MemoryObject.hpp"
 
+#include <GraphicsApi_LL/Exception.hpp>
+
+#include <algorithm>
+#include <cassert>
 #include <iostream>
 
 
@@ -15,18 +19,161 @@ namespace impl {
 	CriticalBufferHeap::CriticalBufferHeap(gxapi::IGraphicsApi* graphicsApi) : m_graphicsApi(graphicsApi) {}
 
 
-	CriticalBufferHeap::UniquePtr CriticalBufferHeap::Allocate(gxapi::ResourceDesc desc, gxapi::ClearValue* clearValue) {
-		UniquePtr resource{
-			m_graphicsApi->CreateCommittedResource(
-				gxapi::HeapProperties{ .type = gxapi::eHeapType::DEFAULT, .cpuPageProperty = gxapi::eCpuPageProperty::UNKNOWN, .pool = gxapi::eMemoryPool::UNKNOWN },
-				gxapi::eHeapFlags::NONE,
-				desc,
-				gxapi::eResourceState::COMMON,
-				clearValue),
-			std::default_delete<const gxapi::IResource>()
+	CriticalBufferHeap::Allocation CriticalBufferHeap::Allocate(gxapi::ResourceDesc desc, gxapi::ClearValue* clearValue) {
+		const gxapi::ResourceAllocationInfo info = m_graphicsApi->GetResourceAllocationInfo(desc);
+		const ePlacedPool pool = SelectPool(desc);
+
+		// MSAA render targets need 4 MiB alignment, only the render target heaps are created with that.
+		const uint64_t heapAlignment = pool == ePlacedPool::RENDER_TARGET ? MSAA_HEAP_ALIGNMENT : MIN_BLOCK_SIZE;
+		const bool placeable = info.sizeInBytes <= MAX_PLACED_SIZE && info.alignment <= heapAlignment;
+
+		if (placeable) {
+			try {
+				return AllocatePlaced(pool, desc, info, clearValue);
+			}
+			catch (OutOfMemoryException&) {
+				// Committed resources can still be created from the memory that is left.
+			}
+		}
+
+		return AllocateCommitted(desc, info.sizeInBytes, clearValue);
+	}
+
+
+	CriticalBufferHeap::Allocation CriticalBufferHeap::AllocatePlaced(ePlacedPool pool, const gxapi::ResourceDesc& desc, const gxapi::ResourceAllocationInfo& info, gxapi::ClearValue* clearValue) {
+		PlacedHeap* heap = nullptr;
+		std::optional<uint64_t> offset;
+		{
+			std::lock_guard<std::mutex> lkg(m_mtx);
+
+			auto& heaps = m_pools[(size_t)pool].heaps;
+			for (auto& candidate : heaps) {
+				offset = candidate->allocator.Allocate(info.sizeInBytes, info.alignment);
+				if (offset) {
+					heap = candidate.get();
+					break;
+				}
+			}
+			if (!heap) {
+				gxapi::HeapDesc heapDesc;
+				heapDesc.sizeInBytes = HEAP_SIZE;
+				heapDesc.properties = gxapi::HeapProperties{ .type = gxapi::eHeapType::DEFAULT, .cpuPageProperty = gxapi::eCpuPageProperty::UNKNOWN, .pool = gxapi::eMemoryPool::UNKNOWN };
+				heapDesc.alignment = pool == ePlacedPool::RENDER_TARGET ? MSAA_HEAP_ALIGNMENT : MIN_BLOCK_SIZE;
+				heapDesc.flags = PoolHeapFlags(pool);
+
+				auto newHeap = std::make_unique<PlacedHeap>(PlacedHeap{ std::unique_ptr<gxapi::IHeap>(m_graphicsApi->CreateHeap(heapDesc)), BuddyAllocator(HEAP_SIZE, MIN_BLOCK_SIZE), {} });
+				newHeap->residency = std::make_shared<PlacedHeapResidency>(PlacedHeapResidency{ newHeap->heap.get(), HEAP_SIZE, true });
+				newHeap->heap->SetName("Critical resource heap");
+				offset = newHeap->allocator.Allocate(info.sizeInBytes, info.alignment);
+				assert(offset);
+				heap = newHeap.get();
+				heaps.push_back(std::move(newHeap));
+			}
+		}
+
+		gxapi::IResource* resource;
+		try {
+			resource = m_graphicsApi->CreatePlacedResource(heap->heap.get(), *offset, desc, gxapi::eResourceState::COMMON, clearValue);
+		}
+		catch (...) {
+			DeallocatePlaced(pool, heap, *offset);
+			throw;
+		}
+
+		const uint64_t allocationOffset = *offset;
+		auto deleter = [this, pool, heap, allocationOffset](const gxapi::IResource* resource) {
+			delete resource;
+			DeallocatePlaced(pool, heap, allocationOffset);
+		};
+
+		return Allocation{ UniquePtr{ resource, deleter }, heap->residency };
+	}
+
+
+	CriticalBufferHeap::Allocation CriticalBufferHeap::AllocateCommitted(const gxapi::ResourceDesc& desc, uint64_t size, gxapi::ClearValue* clearValue) {
+		gxapi::IResource* resource = m_graphicsApi->CreateCommittedResource(
+			gxapi::HeapProperties{ .type = gxapi::eHeapType::DEFAULT, .cpuPageProperty = gxapi::eCpuPageProperty::UNKNOWN, .pool = gxapi::eMemoryPool::UNKNOWN },
+			gxapi::eHeapFlags::NONE,
+			desc,
+			gxapi::eResourceState::COMMON,
+			clearValue);
+
+		{
+			std::lock_guard<std::mutex> lkg(m_mtx);
+			++m_committedCount;
+			m_committedSize += size;
+		}
+
+		auto deleter = [this, size](const gxapi::IResource* resource) {
+			delete resource;
+			std::lock_guard<std::mutex> lkg(m_mtx);
+			--m_committedCount;
+			m_committedSize -= size;
 		};
 
-		return resource;
+		return Allocation{ UniquePtr{ resource, deleter }, nullptr };
+	}
+
+
+	void CriticalBufferHeap::DeallocatePlaced(ePlacedPool pool, PlacedHeap* heap, uint64_t offset) {
+		std::lock_guard<std::mutex> lkg(m_mtx);
+
+		heap->allocator.Deallocate(offset);
+
+		// Keep one heap per pool around so that a single resource coming and going does not thrash heaps.
+		auto& heaps = m_pools[(size_t)pool].heaps;
+		if (heap->allocator.IsEmpty() && heaps.size() > 1) {
+			auto it = std::find_if(heaps.begin(), heaps.end(), [heap](const auto& candidate) { return candidate.get() == heap; });
+			assert(it != heaps.end());
+			heaps.erase(it);
+		}
+	}
+
+
+	ePlacedPool CriticalBufferHeap::SelectPool(const gxapi::ResourceDesc& desc) {
+		if (desc.type == gxapi::eResourceType::BUFFER) {
+			return ePlacedPool::BUFFER;
+		}
+		if ((desc.textureDesc.flags & gxapi::eResourceFlags::ALLOW_RENDER_TARGET) || (desc.textureDesc.flags & gxapi::eResourceFlags::ALLOW_DEPTH_STENCIL)) {
+			return ePlacedPool::RENDER_TARGET;
+		}
+		return ePlacedPool::TEXTURE;
+	}
+
+
+	gxapi::eHeapFlags CriticalBufferHeap::PoolHeapFlags(ePlacedPool pool) {
+		switch (pool) {
+			case ePlacedPool::BUFFER: return gxapi::eHeapFlags::ALLOW_ONLY_BUFFERS;
+			case ePlacedPool::TEXTURE: return gxapi::eHeapFlags::ALLOW_ONLY_NON_RT_DS_TEXTURES;
+			case ePlacedPool::RENDER_TARGET: return gxapi::eHeapFlags::ALLOW_ONLY_RT_DS_TEXTURES;
+			default: assert(false); return gxapi::eHeapFlags::NONE;
+		}
+	}
+
+
+	CriticalHeapStatistics CriticalBufferHeap::GetStatistics() const {
+		std::lock_guard<std::mutex> lkg(m_mtx);
+
+		CriticalHeapStatistics statistics;
+		for (size_t poolIdx = 0; poolIdx < m_pools.size(); ++poolIdx) {
+			auto& poolStats = statistics.pools[poolIdx];
+			uint64_t freeSize = 0;
+			for (const auto& heap : m_pools[poolIdx].heaps) {
+				const BuddyAllocator& allocator = heap->allocator;
+				++poolStats.heapCount;
+				poolStats.allocationCount += allocator.GetAllocationCount();
+				poolStats.reservedSize += allocator.GetSize();
+				poolStats.usedSize += allocator.GetUsedSize();
+				poolStats.requestedSize += allocator.GetRequestedSize();
+				poolStats.largestFreeBlock = std::max(poolStats.largestFreeBlock, allocator.GetLargestFreeBlock());
+				freeSize += allocator.GetSize() - allocator.GetUsedSize();
+			}
+			poolStats.fragmentation = freeSize > 0 ? 1.0f - float(poolStats.largestFreeBlock) / float(freeSize) : 0.0f;
+		}
+		statistics.committedCount = m_committedCount;
+		statistics.committedSize = m_committedSize;
+
+		return statistics;
 	}
 
 	gxapi::ClearValue CriticalBufferHeap::DetermineClearValue(const gxapi::ResourceDesc& desc) {
@@ -71,45 +218,55 @@ namespace impl {
 	VertexBuffer CriticalBufferHeap::CreateVertexBuffer(size_t size) {
 		auto apiDesc = gxapi::ResourceDesc::Buffer(size);
 		gxapi::ClearValue clearValue = DetermineClearValue(apiDesc);
-		auto resource = Allocate(apiDesc, clearValue.format != gxapi::eFormat::UNKNOWN ? &clearValue : nullptr);
+		auto allocation = Allocate(apiDesc, clearValue.format != gxapi::eFormat::UNKNOWN ? &clearValue : nullptr);
 
-		return VertexBuffer(std::move(resource), true, eResourceHeap::CRITICAL);
+		VertexBuffer buffer(std::move(allocation.resource), true, eResourceHeap::CRITICAL);
+		buffer._SetPlacement(std::move(allocation.placement));
+		return buffer;
 	}
 
 
 	IndexBuffer CriticalBufferHeap::CreateIndexBuffer(size_t size, size_t indexCount) {
 		auto apiDesc = gxapi::ResourceDesc::Buffer(size);
 		gxapi::ClearValue clearValue = DetermineClearValue(apiDesc);
-		auto resource = Allocate(apiDesc, clearValue.format != gxapi::eFormat::UNKNOWN ? &clearValue : nullptr);
+		auto allocation = Allocate(apiDesc, clearValue.format != gxapi::eFormat::UNKNOWN ? &clearValue : nullptr);
 
-		return IndexBuffer(std::move(resource), true, eResourceHeap::CRITICAL, indexCount);
+		IndexBuffer buffer(std::move(allocation.resource), true, eResourceHeap::CRITICAL, indexCount);
+		buffer._SetPlacement(std::move(allocation.placement));
+		return buffer;
 	}
 
 
 	Texture1D CriticalBufferHeap::CreateTexture1D(const Texture1DDesc& desc, gxapi::eResourceFlags flags) {
 		auto apiDesc = gxapi::ResourceDesc::Texture1DArray(desc.width, desc.format, desc.arraySize, flags, desc.mipLevels);
 		gxapi::ClearValue clearValue = DetermineClearValue(apiDesc);
-		auto resource = Allocate(apiDesc, clearValue.format != gxapi::eFormat::UNKNOWN ? &clearValue : nullptr);
+		auto allocation = Allocate(apiDesc, clearValue.format != gxapi::eFormat::UNKNOWN ? &clearValue : nullptr);
 
-		return Texture1D(std::move(resource), true, eResourceHeap::CRITICAL);
+		Texture1D texture(std::move(allocation.resource), true, eResourceHeap::CRITICAL);
+		texture._SetPlacement(std::move(allocation.placement));
+		return texture;
 	}
 
 
 	Texture2D CriticalBufferHeap::CreateTexture2D(const Texture2DDesc& desc, gxapi::eResourceFlags flags) {
 		auto apiDesc = gxapi::ResourceDesc::Texture2DArray(desc.width, desc.height, desc.format, desc.arraySize, flags, desc.mipLevels);
 		gxapi::ClearValue clearValue = DetermineClearValue(apiDesc);
-		auto resource = Allocate(apiDesc, clearValue.format != gxapi::eFormat::UNKNOWN ? &clearValue : nullptr);
+		auto allocation = Allocate(apiDesc, clearValue.format != gxapi::eFormat::UNKNOWN ? &clearValue : nullptr);
 
-		return Texture2D(std::move(resource), true, eResourceHeap::CRITICAL);
+		Texture2D texture(std::move(allocation.resource), true, eResourceHeap::CRITICAL);
+		texture._SetPlacement(std::move(allocation.placement));
+		return texture;
 	}
 
 
 	Texture3D CriticalBufferHeap::CreateTexture3D(const Texture3DDesc& desc, gxapi::eResourceFlags flags) {
 		auto apiDesc = gxapi::ResourceDesc::Texture3D(desc.width, desc.height, desc.depth, desc.format, flags, desc.mipLevels);
 		gxapi::ClearValue clearValue = DetermineClearValue(apiDesc);
-		auto resource = Allocate(apiDesc, clearValue.format != gxapi::eFormat::UNKNOWN ? &clearValue : nullptr);
+		auto allocation = Allocate(apiDesc, clearValue.format != gxapi::eFormat::UNKNOWN ? &clearValue : nullptr);
 
-		return Texture3D(std::move(resource), true, eResourceHeap::CRITICAL);
+		Texture3D texture(std::move(allocation.resource), true, eResourceHeap::CRITICAL);
+		texture._SetPlacement(std::move(allocation.placement));
+		return texture;
 	}
 
 
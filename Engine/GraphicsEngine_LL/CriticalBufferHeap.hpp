@@ -1,18 +1,56 @@
 #pragma once
 
 #include "BufferHeap.hpp"
+#include "BuddyAllocator.hpp"
 #include "MemoryObject.hpp"
 
 #include "../GraphicsApi_LL/IGraphicsApi.hpp"
+#include "../GraphicsApi_LL/IHeap.hpp"
 #include "../GraphicsApi_LL/IResource.hpp"
 
+#include <array>
+#include <memory>
+#include <mutex>
+
 namespace inl::gxeng {
 
 namespace impl {
 
+	enum class ePlacedPool {
+		BUFFER,
+		TEXTURE,
+		RENDER_TARGET,
+		COUNT,
+	};
+
+
+	struct CriticalHeapStatistics {
+		struct Pool {
+			size_t heapCount = 0;
+			size_t allocationCount = 0;
+			uint64_t reservedSize = 0;
+			uint64_t usedSize = 0;
+			uint64_t requestedSize = 0;
+			uint64_t largestFreeBlock = 0;
+			/// <summary> One minus the ratio of the largest free block to all free memory, 0 means no fragmentation. </summary>
+			float fragmentation = 0.0f;
+		};
+
+		std::array<Pool, (size_t)ePlacedPool::COUNT> pools;
+		size_t committedCount = 0;
+		uint64_t committedSize = 0;
+	};
+
+
+	/// <summary> Places resources into large heaps reserved up front.
+	///		Falls back to committed resources for large allocations or if no heap can be reserved. </summary>
+	/// <remarks> Placed resources share the residency of their heap, the residency manager
+	///		makes resident and evicts whole heaps. </remarks>
 	class CriticalBufferHeap : public BufferHeap {
 	public:
 		CriticalBufferHeap(gxapi::IGraphicsApi* graphicsApi);
+		CriticalBufferHeap(const CriticalBufferHeap&) = delete;
+		CriticalBufferHeap& operator=(const CriticalBufferHeap&) = delete;
 
 		VertexBuffer CreateVertexBuffer(size_t size) override;
 		IndexBuffer CreateIndexBuffer(size_t size, size_t indexCount) override;
@@ -20,13 +58,49 @@ namespace impl {
 		Texture2D CreateTexture2D(const Texture2DDesc& desc, gxapi::eResourceFlags flags = gxapi::eResourceFlags::NONE) override;
 		Texture3D CreateTexture3D(const Texture3DDesc& desc, gxapi::eResourceFlags flags = gxapi::eResourceFlags::NONE) override;
 
+		static gxapi::ClearValue DetermineClearValue(const gxapi::ResourceDesc& desc);
+
+		CriticalHeapStatistics GetStatistics() const;
+
 	protected:
 		using UniquePtr = std::unique_ptr<gxapi::IResource, std::function<void(const gxapi::IResource*)>>;
-		UniquePtr Allocate(gxapi::ResourceDesc desc, gxapi::ClearValue* clearValue = nullptr);
-		gxapi::ClearValue DetermineClearValue(const gxapi::ResourceDesc& desc);
+		struct Allocation {
+			UniquePtr resource;
+			std::shared_ptr<PlacedHeapResidency> placement; // Null for committed resources.
+		};
+		Allocation Allocate(gxapi::ResourceDesc desc, gxapi::ClearValue* clearValue = nullptr);
+
+	private:
+		struct PlacedHeap {
+			std::unique_ptr<gxapi::IHeap> heap;
+			BuddyAllocator allocator;
+			std::shared_ptr<PlacedHeapResidency> residency;
+		};
+
+		struct Pool {
+			std::vector<std::unique_ptr<PlacedHeap>> heaps;
+		};
+
+		static ePlacedPool SelectPool(const gxapi::ResourceDesc& desc);
+		static gxapi::eHeapFlags PoolHeapFlags(ePlacedPool pool);
+
+		Allocation AllocatePlaced(ePlacedPool pool, const gxapi::ResourceDesc& desc, const gxapi::ResourceAllocationInfo& info, gxapi::ClearValue* clearValue);
+		Allocation AllocateCommitted(const gxapi::ResourceDesc& desc, uint64_t size, gxapi::ClearValue* clearValue);
+		void DeallocatePlaced(ePlacedPool pool, PlacedHeap* heap, uint64_t offset);
 
 	private:
 		gxapi::IGraphicsApi* m_graphicsApi;
+
+		std::array<Pool, (size_t)ePlacedPool::COUNT> m_pools;
+		size_t m_committedCount = 0;
+		uint64_t m_committedSize = 0;
+		mutable std::mutex m_mtx;
+
+		static constexpr uint64_t HEAP_SIZE = 64 * 1024 * 1024;
+		static constexpr uint64_t MIN_BLOCK_SIZE = 64 * 1024;
+		static constexpr uint64_t MSAA_HEAP_ALIGNMENT = 4 * 1024 * 1024;
+		/// <summary> Larger resources get their own committed allocation. </summary>
+		static constexpr uint64_t MAX_PLACED_SIZE = HEAP_SIZE / 4;
 	};
 
 
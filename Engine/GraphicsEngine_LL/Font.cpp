@@ -1,9 +1,14 @@
 #include "Font.hpp"
 
+#include "NodeContext.hpp"
 #include <BaseLibrary/Exception/Exception.hpp>
-#include <BaseLibrary/Range.hpp>
 #include <BaseLibrary/Singleton.hpp>
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <optional>
+
 #include <ft2build.h>
 #include FT_FREETYPE_H
 
@@ -54,6 +59,70 @@ private:
 };
 
 
+// Packs rectangles into a texture by tracking the top edge of the filled area.
+// Rectangles are placed where they end up the lowest, i.e. closest to the top of the texture.
+class SkylinePacker {
+public:
+	SkylinePacker(int width = 0, int height = 0) : m_width(width), m_height(height), m_skyline{ { 0, 0, width } } {}
+
+	std::optional<Vec2i> Insert(int width, int height) {
+		size_t bestIndex = m_skyline.size();
+		int bestY = std::numeric_limits<int>::max();
+		for (size_t i = 0; i < m_skyline.size() && m_skyline[i].x + width <= m_width; ++i) {
+			// The rectangle rests on the highest segment below it.
+			int y = 0;
+			for (size_t j = i; j < m_skyline.size() && m_skyline[j].x < m_skyline[i].x + width; ++j) {
+				y = std::max(y, m_skyline[j].y);
+			}
+			if (y + height <= m_height && y < bestY) {
+				bestIndex = i;
+				bestY = y;
+			}
+		}
+		if (bestIndex == m_skyline.size()) {
+			return {};
+		}
+
+		// Replace the segments under the rectangle by its top edge.
+		const int x = m_skyline[bestIndex].x;
+		const int end = x + width;
+		m_skyline.insert(m_skyline.begin() + bestIndex, Segment{ x, bestY + height, width });
+		size_t next = bestIndex + 1;
+		while (next < m_skyline.size() && m_skyline[next].x < end) {
+			const int segmentEnd = m_skyline[next].x + m_skyline[next].width;
+			if (segmentEnd <= end) {
+				m_skyline.erase(m_skyline.begin() + next);
+			}
+			else {
+				m_skyline[next].x = end;
+				m_skyline[next].width = segmentEnd - end;
+				break;
+			}
+		}
+
+		// Merge neighbours of the same height.
+		for (size_t i = 0; i + 1 < m_skyline.size();) {
+			if (m_skyline[i].y == m_skyline[i + 1].y) {
+				m_skyline[i].width += m_skyline[i + 1].width;
+				m_skyline.erase(m_skyline.begin() + i + 1);
+			}
+			else {
+				++i;
+			}
+		}
+
+		return Vec2i{ x, bestY };
+	}
+
+private:
+	struct Segment {
+		int x, y, width;
+	};
+	int m_width, m_height;
+	std::vector<Segment> m_skyline;
+};
+
+
 // Throw an exception in a freetype function failed.
 template <class ExceptionT, class... Args>
 void ThrowIfFailed(FT_Error error, Args&&... args) {
@@ -81,13 +150,41 @@ using Freetype = Singleton<FreetypeInit>;
 
 
 
+// Currently the font is rasterized at a single size, and pages are squares of this size.
+static constexpr int ATLAS_PAGE_SIZE = 1024;
+static constexpr int ATLAS_MAX_PAGES = 4; // Exceeded only when a single frame uses more glyphs.
+
+
+
 //------------------------------------------------------------------------------
 // Font class.
 //------------------------------------------------------------------------------
 
 
-Font::Font(Image atlas)
-	: m_atlas(std::move(atlas)) {}
+struct Font::Page {
+	Page(MemoryManager* memoryManager, CbvSrvUavHeap* descriptorHeap)
+		: image(memoryManager, descriptorHeap), pixels(ATLAS_PAGE_SIZE, ATLAS_PAGE_SIZE), packer(ATLAS_PAGE_SIZE, ATLAS_PAGE_SIZE) {}
+
+	Image image;
+	AtlasHelper pixels; // Copy of the image on the CPU, dirty rects are uploaded from here.
+	SkylinePacker packer;
+	std::vector<char32_t> glyphs;
+	uint64_t lastUse = 0;
+	uint64_t lastUseFrame = 0; // Upload frame of the last use, texts drawn in this frame may still refer to the page.
+	Vec2i dirtyMin = { ATLAS_PAGE_SIZE, ATLAS_PAGE_SIZE };
+	Vec2i dirtyMax = { 0, 0 };
+};
+
+
+Font::Font(MemoryManager* memoryManager, CbvSrvUavHeap* descriptorHeap)
+	: m_memoryManager(memoryManager), m_descriptorHeap(descriptorHeap) {}
+
+
+Font::~Font() {
+	if (m_face) {
+		FT_Done_Face(m_face);
+	}
+}
 
 
 void Font::LoadFile(std::istream& file) {
@@ -97,99 +194,219 @@ void Font::LoadFile(std::istream& file) {
 
 
 void Font::LoadFile(const void* data, size_t size) {
+	std::lock_guard lock(m_mutex);
+
 	FT_Library library = Freetype::GetInstance().GetFreetype();
 	FT_Face face;
+	std::vector<char> fileData((const char*)data, (const char*)data + size);
 
 	// Load font.
-	ThrowIfFailed<InvalidArgumentException>(FT_New_Memory_Face(library, (FT_Byte*)data, (FT_Long)size, 0, &face), "Failed to read font file.");
-	ThrowIfFailed<InvalidArgumentException>(FT_Select_Charmap(face, FT_ENCODING_UNICODE), "Font does not have UNICODE glyph map.");
+	ThrowIfFailed<InvalidArgumentException>(FT_New_Memory_Face(library, (FT_Byte*)fileData.data(), (FT_Long)fileData.size(), 0, &face), "Failed to read font file.");
+	if (FT_Select_Charmap(face, FT_ENCODING_UNICODE) != FT_Err_Ok) {
+		FT_Done_Face(face);
+		throw InvalidArgumentException("Font does not have UNICODE glyph map.");
+	}
 
 	// Set font properties.
 	int sizeInPixels = ATLAS_FONT_SIZE;
-	ThrowIfFailed<RuntimeException>(FT_Set_Pixel_Sizes(face, 0, sizeInPixels), "Could not set pixel size with freetype.");
+	if (FT_Set_Pixel_Sizes(face, 0, sizeInPixels) != FT_Err_Ok) {
+		FT_Done_Face(face);
+		throw RuntimeException("Could not set pixel size with freetype.");
+	}
 
-	AtlasHelper atlasPixels;
-	int totalWidth = 0;
-	int maxHeight = 0;
+	if (m_face) {
+		FT_Done_Face(m_face);
+	}
+	m_face = face;
+	m_fileData = std::move(fileData);
+	m_ascender = int(std::ceil(face->size->metrics.ascender / 64.f));
+	m_lineHeight = std::max(1, m_ascender - int(std::floor(face->size->metrics.descender / 64.f)));
+	m_hasKerning = FT_HAS_KERNING(face);
+	++m_revision;
+
+	m_glyphs.clear();
+	m_unsupported.clear();
+	m_pages.clear();
+
+	// Renderers expect the first page to exist.
+	AddPage();
+}
 
-	// Render 0-255 characters.
-	for (char32_t ch = 0; ch < 256; ++ch) {
-		unsigned glyphIndex = FT_Get_Char_Index(face, ch);
-		if (glyphIndex == 0) {
-			continue;
-		}
 
-		ThrowIfFailed<RuntimeException>(FT_Load_Glyph(face, glyphIndex, FT_LOAD_DEFAULT), "Freetype could not load glyph.", std::to_string(glyphIndex));
-		ThrowIfFailed<RuntimeException>(FT_Render_Glyph(face->glyph, FT_RENDER_MODE_NORMAL), "Freetype could not render glyph.", std::to_string(glyphIndex));
-
-		Vec2i position = { totalWidth, 0 };
-		Vec2i size = {
-			face->glyph->bitmap_left + face->glyph->bitmap.width,
-			face->glyph->bitmap_top + face->glyph->bitmap.rows
-		};
-		totalWidth += size.x + 2;
-		maxHeight = std::max(size.y, maxHeight);
-
-		m_glyphs[ch] = GlyphInfo{
-			float(face->glyph->advance.x) / 64.f / sizeInPixels,
-			position,
-			size
-		};
-
-		// Copy rendered glyph to texture atlas.
-		if (maxHeight > atlasPixels.Height() || totalWidth > atlasPixels.Width()) {
-			atlasPixels.Resize(totalWidth, maxHeight);
-		}
-		for (unsigned y = 0; y < face->glyph->bitmap.rows; ++y) {
-			for (unsigned x = 0; x < face->glyph->bitmap.width; ++x) {
-				Vec2i pxPos = position + Vec2i(x, y) + Vec2i(face->glyph->bitmap_left, sizeInPixels - face->glyph->bitmap_top);
-				atlasPixels(pxPos.x, pxPos.y) = face->glyph->bitmap.buffer[y * face->glyph->bitmap.pitch + x];
-			}
-		}
+bool Font::IsCharacterSupported(char32_t character) const {
+	std::lock_guard lock(m_mutex);
+	const GlyphInfo* glyph = FindGlyph(character);
+	return glyph != nullptr;
+}
+
+
+Font::GlyphInfo Font::GetGlyphInfo(char32_t character) const {
+	std::lock_guard lock(m_mutex);
+	const GlyphInfo* glyph = FindGlyph(character);
+	if (!glyph) {
+		throw OutOfRangeException("Character cannot be rendered.");
 	}
+	return *glyph;
+}
+
 
-	// Upload atlas to GPU.
-	m_atlas.SetLayout(atlasPixels.Width(), atlasPixels.Height(), ePixelChannelType::INT8_NORM, 1, ePixelClass::LINEAR);
-	const IPixelReader& pixelReader = Pixel<ePixelChannelType::INT8_NORM, 1, ePixelClass::LINEAR>::Reader();
-	m_atlas.Update(0, 0, atlasPixels.Width(), atlasPixels.Height(), 0, atlasPixels.Data(), pixelReader);
-	const_cast<Texture2D&>(m_atlas.GetSrv().GetResource()).SetName("font atlas");
+void Font::PrepareGlyphs(std::u32string_view text) const {
+	std::lock_guard lock(m_mutex);
+	for (auto character : text) {
+		FindGlyph(character);
+	}
 }
 
 
-bool Font::IsCharacterSupported(char32_t character) const {
-	auto it = m_glyphs.find(character);
-	return it != m_glyphs.end();
+const Image& Font::GetGlyphAtlas(int page) const {
+	std::lock_guard lock(m_mutex);
+	if (page < 0 || page >= (int)m_pages.size()) {
+		throw OutOfRangeException("Font has no such atlas page.");
+	}
+	return m_pages[page]->image;
 }
 
 
-Font::GlyphInfo Font::GetGlyphInfo(char32_t character) const {
+const Font::GlyphInfo* Font::FindGlyph(char32_t character) const {
 	auto it = m_glyphs.find(character);
-	if (it == m_glyphs.end()) {
-		throw OutOfRangeException("Character cannot be rendered.");
+	if (it != m_glyphs.end()) {
+		MarkUsed(*m_pages[it->second.page]);
+		return &it->second;
+	}
+	if (!m_face || m_unsupported.count(character)) {
+		return nullptr;
+	}
+	return RasterizeGlyph(character);
+}
+
+
+const Font::GlyphInfo* Font::RasterizeGlyph(char32_t character) const {
+	unsigned glyphIndex = FT_Get_Char_Index(m_face, character);
+	if (glyphIndex == 0) {
+		m_unsupported.insert(character);
+		return nullptr;
+	}
+
+	ThrowIfFailed<RuntimeException>(FT_Load_Glyph(m_face, glyphIndex, FT_LOAD_DEFAULT), "Freetype could not load glyph.", std::to_string(glyphIndex));
+	ThrowIfFailed<RuntimeException>(FT_Render_Glyph(m_face->glyph, FT_RENDER_MODE_NORMAL), "Freetype could not render glyph.", std::to_string(glyphIndex));
+	const FT_GlyphSlot slot = m_face->glyph;
+
+	// All glyphs span a whole line, so that they can be drawn on the same quad as the line.
+	// A pixel of padding keeps the neighbours from bleeding in with linear filtering.
+	Vec2i size = { std::max(1, slot->bitmap_left + int(slot->bitmap.width)), m_lineHeight };
+	Vec2i position;
+	const int pageIndex = AcquirePage(size + Vec2i(1, 1), position);
+	Page& page = *m_pages[pageIndex];
+
+	// Copy rendered glyph to texture atlas.
+	for (int y = 0; y < int(slot->bitmap.rows); ++y) {
+		for (int x = 0; x < int(slot->bitmap.width); ++x) {
+			Vec2i pxPos = Vec2i(x, y) + Vec2i(slot->bitmap_left, m_ascender - slot->bitmap_top);
+			if (0 <= pxPos.x && pxPos.x < size.x && 0 <= pxPos.y && pxPos.y < size.y) {
+				page.pixels(position.x + pxPos.x, position.y + pxPos.y) = slot->bitmap.buffer[y * slot->bitmap.pitch + x];
+			}
+		}
+	}
+	page.dirtyMin = Min(page.dirtyMin, position);
+	page.dirtyMax = Max(page.dirtyMax, position + size);
+	page.glyphs.push_back(character);
+	MarkUsed(page);
+
+	auto [it, inserted] = m_glyphs.insert({ character, GlyphInfo{ float(slot->advance.x) / 64.f / ATLAS_FONT_SIZE, position, size, pageIndex, glyphIndex } });
+	return &it->second;
+}
+
+
+int Font::AcquirePage(Vec2i size, Vec2i& position) const {
+	if (size.x > ATLAS_PAGE_SIZE || size.y > ATLAS_PAGE_SIZE) {
+		throw OutOfRangeException("Glyph does not fit into an atlas page.");
+	}
+
+	for (size_t index = 0; index < m_pages.size(); ++index) {
+		if (auto placement = m_pages[index]->packer.Insert(size.x, size.y)) {
+			position = placement.value();
+			return int(index);
+		}
 	}
 
-	return it->second;
+	// Texts drawn earlier in this frame would show the wrong glyphs if their page was evicted,
+	// so the atlas grows past the limit when every page has been used in this frame.
+	auto lru = std::min_element(m_pages.begin(), m_pages.end(), [](auto& lhs, auto& rhs) { return lhs->lastUse < rhs->lastUse; });
+	const bool lruInUse = lru != m_pages.end() && (*lru)->lastUseFrame == m_memoryManager->GetUploadManager().GetUploadFrameId();
+	size_t index;
+	if (m_pages.size() < ATLAS_MAX_PAGES || lruInUse) {
+		index = m_pages.size();
+		AddPage();
+	}
+	else {
+		index = lru - m_pages.begin();
+		EvictPage(**lru);
+	}
+	position = m_pages[index]->packer.Insert(size.x, size.y).value();
+	return int(index);
+}
+
+
+void Font::MarkUsed(Page& page) const {
+	page.lastUse = ++m_useClock;
+	page.lastUseFrame = m_memoryManager->GetUploadManager().GetUploadFrameId();
 }
 
 
-const Image& Font::GetGlyphAtlas() const {
-	return m_atlas;
+void Font::AddPage() const {
+	auto& page = m_pages.emplace_back(std::make_unique<Page>(m_memoryManager, m_descriptorHeap));
+	page->image.SetLayout(ATLAS_PAGE_SIZE, ATLAS_PAGE_SIZE, ePixelChannelType::INT8_NORM, 1, ePixelClass::LINEAR);
+	const_cast<Texture2D&>(page->image.GetSrv().GetResource()).SetName("font atlas");
+	page->dirtyMin = { 0, 0 };
+	page->dirtyMax = { ATLAS_PAGE_SIZE, ATLAS_PAGE_SIZE };
+}
+
+
+void Font::EvictPage(Page& page) const {
+	for (auto character : page.glyphs) {
+		m_glyphs.erase(character);
+	}
+	page.glyphs.clear();
+	page.packer = SkylinePacker(ATLAS_PAGE_SIZE, ATLAS_PAGE_SIZE);
+	page.pixels = AtlasHelper(ATLAS_PAGE_SIZE, ATLAS_PAGE_SIZE);
+	page.dirtyMin = { 0, 0 };
+	page.dirtyMax = { ATLAS_PAGE_SIZE, ATLAS_PAGE_SIZE };
+	++m_revision;
+}
+
+
+void Font::UploadGlyphs(RenderContext& context) const {
+	std::lock_guard lock(m_mutex);
+	GraphicsCommandList& commandList = context.AsGraphics();
+	for (auto& page : m_pages) {
+		if (page->dirtyMin.x < page->dirtyMax.x && page->dirtyMin.y < page->dirtyMax.y) {
+			const Texture2D& texture = page->image.GetSrv().GetResource();
+			const Vec2i size = page->dirtyMax - page->dirtyMin;
+			const uint8_t* pixels = &page->pixels(page->dirtyMin.x, page->dirtyMin.y);
+			commandList.SetResourceState(texture, gxapi::eResourceState::COPY_DEST);
+			context.Upload(texture, page->dirtyMin.x, page->dirtyMin.y, 0, pixels, size.x, size.y, texture.GetFormat(), ATLAS_PAGE_SIZE);
+			page->dirtyMin = { ATLAS_PAGE_SIZE, ATLAS_PAGE_SIZE };
+			page->dirtyMax = { 0, 0 };
+		}
+	}
 }
 
 
 float Font::CalculateTextHeight(float fontSize) const {
 	assert(fontSize > 0);
-	return m_atlas.GetHeight() * fontSize / ATLAS_FONT_SIZE;
+	return float(m_lineHeight) * fontSize / ATLAS_FONT_SIZE;
 }
 
 
 float Font::CalculateTextWidth(std::u32string_view text, float fontSize) const {
 	assert(fontSize > 0);
+	std::lock_guard lock(m_mutex);
 	float width = 0.0f;
-	for (auto& glyph : text) {
-		if (IsCharacterSupported(glyph)) {
-			const auto& info = GetGlyphInfo(glyph);
-			width += info.advance;
+	unsigned previous = 0;
+	for (auto& character : text) {
+		if (const GlyphInfo* glyph = FindGlyph(character)) {
+			width += GetKerning(previous, glyph->index) + glyph->advance;
+			previous = glyph->index;
 		}
 	}
 	return width * fontSize;
@@ -198,28 +415,81 @@ float Font::CalculateTextWidth(std::u32string_view text, float fontSize) const {
 
 intptr_t Font::FindCharacter(std::u32string_view text, float coordinate, float fontSize) const {
 	assert(fontSize > 0);
+	return Shape(text).FindCharacter(coordinate / fontSize);
+}
+
+
+std::pair<float, float> Font::FindCoordinates(std::u32string_view text, size_t index, float fontSize) const {
+	assert(index < text.size());
+	assert(fontSize > 0);
+	auto [left, right] = Shape(text).FindCoordinates(index);
+	return { left * fontSize, right * fontSize };
+}
+
+
+Font::ShapedText Font::Shape(std::u32string_view text) const {
+	std::lock_guard lock(m_mutex);
+	ShapedText shaped;
+	shaped.glyphs.reserve(text.size());
+	shaped.length = text.size();
+
+	unsigned previous = 0;
+	for (size_t index = 0; index < text.size(); ++index) {
+		const GlyphInfo* glyph = FindGlyph(text[index]);
+		if (!glyph) {
+			continue;
+		}
+		shaped.width += GetKerning(previous, glyph->index);
+		shaped.glyphs.push_back({ text[index], index, shaped.width, glyph->advance });
+		shaped.width += glyph->advance;
+		previous = glyph->index;
+	}
+	return shaped;
+}
+
+
+uint64_t Font::GetRevision() const {
+	std::lock_guard lock(m_mutex);
+	return m_revision;
+}
+
+
+float Font::GetKerning(unsigned leftIndex, unsigned rightIndex) const {
+	if (!m_hasKerning || leftIndex == 0) {
+		return 0.0f;
+	}
+	// Unfitted kerning is in the scale of the rasterized glyphs, but not rounded to their pixels.
+	FT_Vector delta;
+	if (FT_Get_Kerning(m_face, leftIndex, rightIndex, FT_KERNING_UNFITTED, &delta) != FT_Err_Ok) {
+		return 0.0f;
+	}
+	return float(delta.x) / 64.f / ATLAS_FONT_SIZE;
+}
+
+
+intptr_t Font::ShapedText::FindCharacter(float coordinate) const {
 	if (coordinate < 0) {
 		return -1;
 	}
-	float width = 0.0f;
-	for (auto glyphIdx : Range(intptr_t(text.size()))) {
-		const auto& info = GetGlyphInfo(text[glyphIdx]);
-		width += info.advance * fontSize;
-		if (width >= coordinate) {
-			return glyphIdx;
+	for (auto& glyph : glyphs) {
+		if (glyph.offset + glyph.advance >= coordinate) {
+			return (intptr_t)glyph.index;
 		}
 	}
-	return (intptr_t)text.size();
+	return (intptr_t)length;
 }
 
 
-std::pair<float, float> Font::FindCoordinates(std::u32string_view text, size_t index, float fontSize) const {
-	assert(index < text.size());
-	assert(fontSize > 0);
-	float precedingWidth = CalculateTextWidth(text.substr(0, index), fontSize);
-	float glyphWidth = GetGlyphInfo(text[index]).advance * fontSize;
-	return { precedingWidth, precedingWidth + glyphWidth };
+std::pair<float, float> Font::ShapedText::FindCoordinates(size_t index) const {
+	auto it = std::lower_bound(glyphs.begin(), glyphs.end(), index, [](const Glyph& glyph, size_t index) { return glyph.index < index; });
+	if (it == glyphs.end()) {
+		return { width, width };
+	}
+	if (it->index != index) {
+		return { it->offset, it->offset };
+	}
+	return { it->offset, it->offset + it->advance };
 }
 
 
-} // namespace inl::gxeng
\ No newline at end of file
+} // namespace inl::gxeng
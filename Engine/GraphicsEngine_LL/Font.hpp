@@ -4,24 +4,64 @@
 
 #include <GraphicsEngine/Resources/IFont.hpp>
 
+#include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+
+struct FT_FaceRec_;
 
 
 namespace inl::gxeng {
 
 
+class MemoryManager;
+class CbvSrvUavHeap;
+class RenderContext;
+
+
 
+/// <summary> Font whose glyphs are rasterized into atlas pages when they are first used. </summary>
+/// <remarks> Any code point covered by the font file can be rendered.
+///		When all pages are full, the least recently used page is cleared to make room,
+///		unless it has been used in the current frame, in which case a page is added over the limit.
+///		All methods are thread safe. </remarks>
 class Font : public IFont {
 public:
 	struct GlyphInfo {
 		float advance;
 		Vec2i atlasPos;
 		Vec2i atlasSize;
+		int page; // Index of the atlas that contains the glyph.
+		unsigned index; // Index of the glyph in the font file.
+	};
+
+	/// <summary> Horizontal layout of a line of text, in units of the font size. </summary>
+	/// <remarks> Characters the font cannot render have no glyph and take no space. </remarks>
+	struct ShapedText {
+		struct Glyph {
+			char32_t character;
+			size_t index; // Position of the character in the source text.
+			float offset; // Left edge of the glyph, kerning included.
+			float advance;
+		};
+		std::vector<Glyph> glyphs;
+		size_t length = 0; // Number of characters in the source text.
+		float width = 0.0f;
+
+		/// <summary> Same as <see cref="IFont::FindCharacter"/>, with the font size being 1. </summary>
+		intptr_t FindCharacter(float coordinate) const;
+		/// <summary> Same as <see cref="IFont::FindCoordinates"/>, with the font size being 1. </summary>
+		/// <remarks> Returns an empty interval at the end of the text for an index past the last character. </remarks>
+		std::pair<float, float> FindCoordinates(size_t index) const;
 	};
 
 public:
-	Font(Image atlas);
+	Font(MemoryManager* memoryManager, CbvSrvUavHeap* descriptorHeap);
+	~Font();
 
 	void LoadFile(std::istream& file) override;
 	void LoadFile(const void* data, size_t size) override;
@@ -34,16 +74,59 @@ public:
 	/// <summary> Returns the width of the specified character. </summary>
 	/// <param name="character"> UCS-4 code point. </param>
 	/// <exception cref="OutOfRangeException"> If character cannot be rendered. </exception>
+	/// <remarks> The glyph's position in the atlas is only valid until its page is evicted,
+	///		which can happen whenever another glyph is rasterized in a later frame. </remarks>
 	GlyphInfo GetGlyphInfo(char32_t character) const;
 
+	/// <summary> Positions the glyphs of <paramref name="text"/>, applying the kerning of the font. </summary>
+	/// <remarks> The result is only valid as long as the <see cref="GetRevision"/> of the font does not change. </remarks>
+	ShapedText Shape(std::u32string_view text) const;
+
+	/// <summary> Incremented each time a font file is loaded or an atlas page is evicted. </summary>
+	/// <remarks> Shaped text and glyph positions in the atlas looked up earlier must be refreshed when it changes. </remarks>
+	uint64_t GetRevision() const;
+
+	/// <summary> Rasterizes the glyphs of <paramref name="text"/> that are not in the atlas yet. </summary>
+	/// <remarks> The glyphs are only on the CPU until <see cref="UploadGlyphs"/> is called. </remarks>
+	void PrepareGlyphs(std::u32string_view text) const;
+
+	/// <summary> Copies the glyphs rasterized since the last call into the atlas pages on the renderer's command list. </summary>
+	/// <remarks> Call it after the text of the frame has been prepared and before it is drawn,
+	///		so that new glyphs show up in the same frame. </remarks>
+	void UploadGlyphs(RenderContext& context) const;
+
 	/// <summary> Returns the texture atlas that contain the rasterized letters. </summary>
-	const Image& GetGlyphAtlas() const;
+	const Image& GetGlyphAtlas(int page = 0) const;
+
+private:
+	struct Page;
+
+	const GlyphInfo* FindGlyph(char32_t character) const;
+	const GlyphInfo* RasterizeGlyph(char32_t character) const;
+	void MarkUsed(Page& page) const;
+	int AcquirePage(Vec2i size, Vec2i& position) const;
+	void AddPage() const;
+	void EvictPage(Page& page) const;
+	float GetKerning(unsigned leftIndex, unsigned rightIndex) const; // Glyph indices, 0 if there is no glyph on the left.
 
 private:
-	Image m_atlas;
-	std::unordered_map<char32_t, GlyphInfo> m_glyphs;
+	MemoryManager* m_memoryManager;
+	CbvSrvUavHeap* m_descriptorHeap;
+
+	std::vector<char> m_fileData; // Freetype reads glyphs from the file lazily.
+	FT_FaceRec_* m_face = nullptr;
+	int m_ascender = 0; // Pixels from the top of a line to the baseline.
+	int m_lineHeight = 1; // Pixels, same for all glyphs.
+	bool m_hasKerning = false;
+
+	mutable std::mutex m_mutex;
+	mutable std::vector<std::unique_ptr<Page>> m_pages;
+	mutable std::unordered_map<char32_t, GlyphInfo> m_glyphs;
+	mutable std::unordered_set<char32_t> m_unsupported;
+	mutable uint64_t m_useClock = 0;
+	mutable uint64_t m_revision = 0;
 };
 
 
 
-} // namespace inl::gxeng
\ No newline at end of file
+} // namespace inl::gxeng
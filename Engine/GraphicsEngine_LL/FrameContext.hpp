@@ -47,6 +47,7 @@ struct FrameContext {
 	ShaderManager* shaderManager = nullptr;
 
 	CommandQueue* commandQueue = nullptr;
+	CommandQueue* copyCommandQueue = nullptr; // Uploads to resources not used by the graphics queue go here.
 	Texture2D backBuffer;
 	const std::set<Scene*>* scenes = nullptr;
 	const std::set<BasicCamera*>* cameras = nullptr;
@@ -33,7 +33,8 @@ GraphicsEngine::GraphicsEngine(GraphicsEngineDesc desc)
 	  m_scratchSpacePool(desc.graphicsApi, gxapi::eDescriptorHeapType::CBV_SRV_UAV),
 	  m_textureSpace(desc.graphicsApi),
 	  m_masterCommandQueue(desc.graphicsApi->CreateCommandQueue(CommandQueueDesc{ eCommandListType::GRAPHICS }), desc.graphicsApi->CreateFence(0)),
-	  m_residencyQueue(std::unique_ptr<gxapi::IFence>(desc.graphicsApi->CreateFence(0))),
+	  m_copyCommandQueue(desc.graphicsApi->CreateCommandQueue(CommandQueueDesc{ eCommandListType::COPY }), desc.graphicsApi->CreateFence(0)),
+	  m_residencyQueue(std::unique_ptr<gxapi::IFence>(desc.graphicsApi->CreateFence(0)), &m_memoryManager),
 	  m_memoryManager(desc.graphicsApi),
 	  m_dsvHeap(desc.graphicsApi),
 	  m_rtvHeap(desc.graphicsApi),
@@ -75,6 +76,7 @@ GraphicsEngine::GraphicsEngine(GraphicsEngineDesc desc)
 
 	m_pipelineEventDispatcher += &m_memoryManager.GetUploadManager();
 	m_pipelineEventDispatcher += &m_memoryManager.GetConstBufferHeap();
+	m_pipelineEventDispatcher += &m_memoryManager.GetResidencyManager();
 
 	// Begin awaiting frame #0's Update()
 	m_pipelineEventDispatcher.DispachFrameBeginAwait(0);
@@ -113,10 +115,12 @@ void GraphicsEngine::Update(float elapsed) {
 	context.shaderManager = &m_shaderManager;
 
 	context.commandQueue = &m_masterCommandQueue;
+	context.copyCommandQueue = &m_copyCommandQueue;
 	context.backBuffer = m_backBufferHeap->GetBackBuffer(backBufferIndex);
 	context.scenes = &m_scenes;
 	context.cameras = &m_cameras;
 
+	m_memoryManager.GetTextureStreamer().Update(m_frame);
 	const std::vector<UploadManager::UploadDescription>& uploadRequests = m_memoryManager.GetUploadManager().GetQueuedUploads();
 	context.uploadRequests = &uploadRequests;
 
@@ -133,7 +137,12 @@ void GraphicsEngine::Update(float elapsed) {
 	// Mark frame completion
 	SyncPoint frameEnd = m_masterCommandQueue.Signal();
 	m_frameEndFenceValues[backBufferIndex] = frameEnd;
-	m_pipelineEventDispatcher.DispatchDeviceFrameEnd(frameEnd, m_frame);
+
+	// Uploads on the copy queue may still read the frame's staging memory, the rendering
+	// does not wait for them, so the frame's resources are only released after both queues are done.
+	m_copyCommandQueue.Wait(frameEnd);
+	SyncPoint uploadsEnd = m_copyCommandQueue.Signal();
+	m_pipelineEventDispatcher.DispatchDeviceFrameEnd(uploadsEnd, m_frame);
 
 	// Present frame
 	m_swapChain->Present();
@@ -204,7 +213,7 @@ std::unique_ptr<IMaterialShaderGraph> GraphicsEngine::CreateMaterialShaderGraph(
 }
 
 std::unique_ptr<IFont> GraphicsEngine::CreateFont() const {
-	return std::make_unique<Font>(Image{ &const_cast<MemoryManager&>(m_memoryManager), &const_cast<CbvSrvUavHeap&>(m_textureSpace) });
+	return std::make_unique<Font>(&const_cast<MemoryManager&>(m_memoryManager), &const_cast<CbvSrvUavHeap&>(m_textureSpace));
 }
 
 
@@ -391,7 +400,14 @@ void GraphicsEngine::SetShaderDirectories(const std::vector<std::filesystem::pat
 }
 
 
+const SubmissionStatistics& GraphicsEngine::GetSubmissionStatistics() const {
+	return m_scheduler.GetSubmissionStatistics();
+}
+
+
 void GraphicsEngine::FlushPipelineQueue() {
+	SyncPoint lastCopySync = m_copyCommandQueue.Signal();
+	lastCopySync.Wait();
 	SyncPoint lastSync = m_masterCommandQueue.Signal();
 	lastSync.Wait();
 }
@@ -154,6 +154,12 @@ public:
 	/// <remarks> May be absolute, relative, or whatever paths you OS can handle. </remarks>
 	void SetShaderDirectories(const std::vector<std::filesystem::path>& directories) override;
 
+
+	// Statistics
+
+	/// <summary> Number of submissions and barriers of the last frame. </summary>
+	const SubmissionStatistics& GetSubmissionStatistics() const;
+
 private:
 	void FlushPipelineQueue();
 	void RegisterPipelineClasses();
@@ -187,6 +193,7 @@ private:
 
 	// Pipeline elements
 	CommandQueue m_masterCommandQueue;
+	CommandQueue m_copyCommandQueue;
 	ResourceResidencyQueue m_residencyQueue;
 	PipelineEventDispatcher m_pipelineEventDispatcher;
 
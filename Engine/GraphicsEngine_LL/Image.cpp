@@ -1,32 +1,395 @@
 #include "Image.hpp"
 
+#include <algorithm>
+#include <cstring>
+
 namespace inl::gxeng {
 
 
+template <class T, class AccumT>
+static void DownsampleBox(const uint8_t* src, uint64_t srcWidth, uint32_t srcHeight, uint8_t* dst, size_t pixelSize) {
+	const size_t channels = pixelSize / sizeof(T);
+	const uint64_t dstWidth = std::max<uint64_t>(1, srcWidth / 2);
+	const uint32_t dstHeight = std::max<uint32_t>(1, srcHeight / 2);
+	const T* srcPixels = reinterpret_cast<const T*>(src);
+	T* dstPixels = reinterpret_cast<T*>(dst);
+
+	for (uint32_t y = 0; y < dstHeight; ++y) {
+		const uint32_t y0 = std::min(2 * y, srcHeight - 1);
+		const uint32_t y1 = std::min(2 * y + 1, srcHeight - 1);
+		for (uint64_t x = 0; x < dstWidth; ++x) {
+			const uint64_t x0 = std::min(2 * x, srcWidth - 1);
+			const uint64_t x1 = std::min(2 * x + 1, srcWidth - 1);
+			for (size_t c = 0; c < channels; ++c) {
+				AccumT sum = AccumT(srcPixels[(y0 * srcWidth + x0) * channels + c])
+							 + AccumT(srcPixels[(y0 * srcWidth + x1) * channels + c])
+							 + AccumT(srcPixels[(y1 * srcWidth + x0) * channels + c])
+							 + AccumT(srcPixels[(y1 * srcWidth + x1) * channels + c]);
+				dstPixels[(y * dstWidth + x) * channels + c] = T(sum / 4);
+			}
+		}
+	}
+}
+
+
+// Compressed mips are stored and copied in whole blocks, even if they are smaller than a block.
+static uint64_t GetMipExtent(uint64_t size, unsigned mipLevel, bool compressed) {
+	const uint64_t extent = std::max<uint64_t>(1, size >> mipLevel);
+	return compressed ? (extent + 3) / 4 * 4 : extent;
+}
+
+
+Image::~Image() {
+	if (m_streaming) {
+		GetMemoryManager()->GetTextureStreamer().Unregister(this);
+	}
+}
+
+
 void Image::SetLayout(uint64_t width, uint32_t height, ePixelChannelType channelType, int channelCount, ePixelClass pixelClass) {
+	if (m_streamingEnabled) {
+		SetStreamingLayout(width, height, channelType, channelCount, pixelClass);
+		return;
+	}
+	StopStreaming();
+	m_hasMipChain = false;
 	ImageBase::SetLayout(width, height, channelType, channelCount, pixelClass, 1);
 }
 
+void Image::SetCompressedLayout(uint64_t width, uint32_t height, eBlockCompression compression, int mipCount, bool srgb) {
+	if (m_streamingEnabled) {
+		SetCompressedStreamingLayout(width, height, compression, (unsigned)mipCount, srgb);
+		return;
+	}
+	StopStreaming();
+	m_hasMipChain = true;
+	ImageBase::SetCompressedLayout(width, height, compression, (unsigned)mipCount, 1, srgb);
+}
+
 void Image::Update(uint64_t x, uint32_t y, uint64_t width, uint32_t height, int mipLevel, const void* pixels, const IPixelReader& reader, size_t bytesPerRow) {
+	if (m_streaming) {
+		UpdateStreaming(x, y, width, height, (unsigned)mipLevel, pixels, reader, bytesPerRow);
+		return;
+	}
 	ImageBase::Update(x, y, width, height, mipLevel, 0, pixels, reader, bytesPerRow);
 }
 
+void Image::UpdateCompressed(int mipLevel, const void* blocks, size_t bytesPerRow) {
+	if (m_streaming) {
+		UpdateCompressedStreaming((unsigned)mipLevel, blocks, bytesPerRow);
+		return;
+	}
+	ImageBase::UpdateCompressed((unsigned)mipLevel, 0, blocks, bytesPerRow);
+}
+
+void Image::SetStreaming(bool enabled) {
+	m_streamingEnabled = enabled;
+}
+
+
+size_t Image::GetWidth() const {
+	return m_streaming ? m_streaming->width : ImageBase::GetWidth();
+}
+
+size_t Image::GetHeight() const {
+	return m_streaming ? m_streaming->height : ImageBase::GetHeight();
+}
+
+ePixelChannelType Image::GetChannelType() const {
+	return m_streaming ? m_streaming->channelType : ImageBase::GetChannelType();
+}
+
+int Image::GetChannelCount() const {
+	return m_streaming ? m_streaming->channelCount : ImageBase::GetChannelCount();
+}
+
+ePixelClass Image::GetPixelClass() const {
+	return m_streaming ? m_streaming->pixelClass : ImageBase::GetPixelClass();
+}
+
+
 const TextureView2D& Image::GetSrv() const {
 	return m_resourceView;
 }
 
 
+bool Image::IsUploaded() const {
+	const Texture2D& texture = m_resourceView.GetResource();
+	return texture && texture.IsUploaded();
+}
+
+
+void Image::RequestMip(unsigned mipLevel) const {
+	if (!m_streaming) {
+		return;
+	}
+	unsigned current = m_streaming->requestedMip.load(std::memory_order_relaxed);
+	while (mipLevel < current && !m_streaming->requestedMip.compare_exchange_weak(current, mipLevel, std::memory_order_relaxed)) {
+	}
+}
+
+
 void Image::CreateResourceView(const Texture2D& texture) {
 	gxapi::SrvTexture2DArray srvdesc;
 	srvdesc.activeArraySize = 1;
 	srvdesc.firstArrayElement = 0;
 	srvdesc.mipLevelClamping = 0;
 	srvdesc.mostDetailedMip = 0;
-	srvdesc.numMipLevels = 1; // change this back to -1
+	srvdesc.numMipLevels = m_streaming || m_hasMipChain ? -1 : 1;
 	srvdesc.planeIndex = 0;
 	m_resourceView = TextureView2D(texture, *m_descriptorHeap, texture.GetFormat(), srvdesc);
 }
 
 
+void Image::StopStreaming() {
+	if (m_streaming) {
+		GetMemoryManager()->GetTextureStreamer().Unregister(this);
+		m_streaming.reset();
+	}
+}
+
+
+void Image::SetStreamingLayout(uint64_t width, uint32_t height, ePixelChannelType channelType, int channelCount, ePixelClass pixelClass) {
+	gxapi::eFormat format;
+	int resultChCnt = 0;
+	if (!ConvertFormat(channelType, channelCount, pixelClass, format, resultChCnt)) {
+		throw InvalidArgumentException("Unsupported texture format.");
+	}
+
+	auto state = std::make_unique<StreamingState>();
+	state->width = width;
+	state->height = height;
+	state->channelType = channelType;
+	state->channelCount = channelCount;
+	state->pixelClass = pixelClass;
+	state->format = format;
+	state->pixelSize = gxapi::GetFormatSizeInBytes(format);
+
+	state->mipCount = 1;
+	while (std::max<uint64_t>(width >> state->mipCount, height >> state->mipCount) > 0) {
+		++state->mipCount;
+	}
+	StartStreaming(std::move(state));
+}
+
+
+void Image::SetCompressedStreamingLayout(uint64_t width, uint32_t height, eBlockCompression compression, unsigned mipCount, bool srgb) {
+	if (width % 4 != 0 || height % 4 != 0) {
+		throw InvalidArgumentException("Block compressed images must be a multiple of 4 pixels wide and high.");
+	}
+	if (mipCount == 0) {
+		throw InvalidArgumentException("Block compressed images must have at least one mip level.");
+	}
+
+	int channelCount = 0;
+	gxapi::eFormat format = ConvertFormat(compression, srgb, channelCount);
+
+	auto state = std::make_unique<StreamingState>();
+	state->width = width;
+	state->height = height;
+	state->channelType = ePixelChannelType::INT8_NORM;
+	state->channelCount = channelCount;
+	state->pixelClass = ePixelClass::LINEAR;
+	state->format = format;
+	state->pixelSize = gxapi::GetFormatSizeInBytes(format);
+	state->compressed = true;
+	state->mipCount = mipCount;
+	StartStreaming(std::move(state));
+}
+
+
+void Image::StartStreaming(std::unique_ptr<StreamingState> state) {
+	const uint64_t width = state->width;
+	const uint32_t height = state->height;
+
+	// The most detailed mip of a compressed texture must be a whole number of blocks.
+	auto canBeFirstMip = [&state, width, height](unsigned mip) {
+		return !state->compressed || (std::max<uint64_t>(1, width >> mip) % 4 == 0 && std::max<uint32_t>(1, height >> mip) % 4 == 0);
+	};
+	state->tailMip = 0;
+	while (state->tailMip + 1 < state->mipCount
+		   && std::max<uint64_t>(width >> state->tailMip, height >> state->tailMip) > STREAMING_TAIL_SIZE
+		   && canBeFirstMip(state->tailMip + 1)) {
+		++state->tailMip;
+	}
+
+	state->mips.resize(state->mipCount);
+	state->providedMips.resize(state->mipCount, false);
+	state->chainSizes.resize(state->mipCount + 1, 0);
+	for (unsigned mip = 0; mip < state->mipCount; ++mip) {
+		uint64_t mipWidth = GetMipExtent(width, mip, state->compressed);
+		uint64_t mipHeight = GetMipExtent(height, mip, state->compressed);
+		uint64_t elementCount = state->compressed ? mipWidth / 4 * mipHeight / 4 : mipWidth * mipHeight;
+		state->mips[mip].resize(elementCount * state->pixelSize, 0);
+	}
+	for (int mip = (int)state->mipCount - 1; mip >= 0; --mip) {
+		state->chainSizes[mip] = state->chainSizes[mip + 1] + state->mips[mip].size();
+	}
+
+	// Start with the tail only, the rest comes when the renderer asks for it.
+	Texture2DDesc desc(std::max<uint64_t>(1, width >> state->tailMip), std::max<uint32_t>(1, height >> state->tailMip), state->format, uint16_t(state->mipCount - state->tailMip), 1);
+	Texture2D texture = GetMemoryManager()->CreateTexture2D(eResourceHeap::CRITICAL, desc);
+	state->texture = texture;
+	state->residentMip = state->tailMip;
+	state->desiredMip = state->tailMip;
+
+	// The streamer must not see the state being replaced.
+	StopStreaming();
+	m_streaming = std::move(state);
+	CreateResourceView(texture);
+	GetMemoryManager()->GetTextureStreamer().Register(this);
+}
+
+
+void Image::UpdateStreaming(uint64_t x, uint32_t y, uint64_t width, uint32_t height, unsigned mipLevel, const void* pixels, const IPixelReader& reader, size_t bytesPerRow) {
+	StreamingState& state = *m_streaming;
+	std::lock_guard<std::mutex> lock(state.mutex);
+	if (state.compressed) {
+		throw InvalidStateException("Block compressed images must be updated with UpdateCompressed.");
+	}
+	if (mipLevel >= state.mipCount) {
+		throw OutOfRangeException("Mip level does not exist.");
+	}
+	const uint64_t mipWidth = std::max<uint64_t>(1, state.width >> mipLevel);
+	const uint64_t mipHeight = std::max<uint64_t>(1, state.height >> mipLevel);
+	if (x + width > mipWidth || y + height > mipHeight) {
+		throw OutOfRangeException("Destination region out of bounds.");
+	}
+
+	std::unique_ptr<uint8_t[]> pixels4;
+	pixels = ConvertPixels(width, height, pixels, reader, bytesPerRow, pixels4);
+	const size_t rowSize = width * state.pixelSize;
+	const size_t srcPitch = bytesPerRow > 0 ? bytesPerRow : rowSize;
+
+	// Keep a copy in system memory, evicted mips are uploaded again from here.
+	uint8_t* dst = state.mips[mipLevel].data();
+	for (uint32_t row = 0; row < height; ++row) {
+		memcpy(dst + ((y + row) * mipWidth + x) * state.pixelSize, (const uint8_t*)pixels + row * srcPitch, rowSize);
+	}
+	state.providedMips[mipLevel] = true;
+
+	unsigned lastChanged = mipLevel;
+	while (lastChanged + 1 < state.mipCount && !state.providedMips[lastChanged + 1]) {
+		GenerateMip(++lastChanged);
+	}
+
+	// Refresh the mips that are on the GPU already or are being uploaded.
+	for (const Texture2D* texture : { &state.texture, &state.pendingTexture }) {
+		if (!*texture) {
+			continue;
+		}
+		const unsigned firstMip = texture == &state.texture ? state.residentMip : state.pendingMip;
+		if (mipLevel >= firstMip) {
+			GetMemoryManager()->GetUploadManager().Upload(*texture, (uint32_t)x, y, texture->GetSubresourceIndex(mipLevel - firstMip, 0, 0), pixels, width, height, state.format, bytesPerRow);
+		}
+		for (unsigned mip = std::max(mipLevel + 1, firstMip); mip <= lastChanged; ++mip) {
+			UploadMip(*texture, firstMip, mip);
+		}
+	}
+}
+
+
+void Image::UpdateCompressedStreaming(unsigned mipLevel, const void* blocks, size_t bytesPerRow) {
+	StreamingState& state = *m_streaming;
+	std::lock_guard<std::mutex> lock(state.mutex);
+	if (!state.compressed) {
+		throw InvalidStateException("Must create block compressed image first.");
+	}
+	if (mipLevel >= state.mipCount) {
+		throw OutOfRangeException("Mip level does not exist.");
+	}
+	const uint64_t blockColumns = GetMipExtent(state.width, mipLevel, true) / 4;
+	const uint64_t blockRows = GetMipExtent(state.height, mipLevel, true) / 4;
+	const size_t rowSize = blockColumns * state.pixelSize;
+	const size_t srcPitch = bytesPerRow > 0 ? bytesPerRow : rowSize;
+
+	uint8_t* dst = state.mips[mipLevel].data();
+	for (uint64_t row = 0; row < blockRows; ++row) {
+		memcpy(dst + row * rowSize, (const uint8_t*)blocks + row * srcPitch, rowSize);
+	}
+	state.providedMips[mipLevel] = true;
+
+	for (const Texture2D* texture : { &state.texture, &state.pendingTexture }) {
+		const unsigned firstMip = texture == &state.texture ? state.residentMip : state.pendingMip;
+		if (*texture && mipLevel >= firstMip) {
+			UploadMip(*texture, firstMip, mipLevel);
+		}
+	}
+}
+
+
+// Called with the streaming state locked.
+void Image::GenerateMip(unsigned mipLevel) {
+	StreamingState& state = *m_streaming;
+	const uint8_t* src = state.mips[mipLevel - 1].data();
+	uint8_t* dst = state.mips[mipLevel].data();
+	const uint64_t srcWidth = std::max<uint64_t>(1, state.width >> (mipLevel - 1));
+	const uint32_t srcHeight = std::max<uint32_t>(1, state.height >> (mipLevel - 1));
+
+	switch (state.channelType) {
+		case ePixelChannelType::INT8_NORM: DownsampleBox<uint8_t, uint32_t>(src, srcWidth, srcHeight, dst, state.pixelSize); break;
+		case ePixelChannelType::INT16_NORM: DownsampleBox<uint16_t, uint32_t>(src, srcWidth, srcHeight, dst, state.pixelSize); break;
+		case ePixelChannelType::INT32: DownsampleBox<uint32_t, uint64_t>(src, srcWidth, srcHeight, dst, state.pixelSize); break;
+		case ePixelChannelType::FLOAT32: DownsampleBox<float, float>(src, srcWidth, srcHeight, dst, state.pixelSize); break;
+	}
+}
+
+
+// Called with the streaming state locked.
+void Image::UploadMip(const Texture2D& texture, unsigned firstMip, unsigned mipLevel) {
+	StreamingState& state = *m_streaming;
+	const uint64_t mipWidth = GetMipExtent(state.width, mipLevel, state.compressed);
+	const uint32_t mipHeight = (uint32_t)GetMipExtent(state.height, mipLevel, state.compressed);
+	GetMemoryManager()->GetUploadManager().Upload(texture, 0, 0, texture.GetSubresourceIndex(mipLevel - firstMip, 0, 0), state.mips[mipLevel].data(), mipWidth, mipHeight, state.format);
+}
+
+
+impl::StreamingCandidate Image::GetStreamingCandidate(uint64_t frame, uint64_t forgetFrames) {
+	StreamingState& state = *m_streaming;
+	std::lock_guard<std::mutex> lock(state.mutex);
+	unsigned requested = state.requestedMip.exchange(StreamingState::NO_REQUEST);
+	if (requested != StreamingState::NO_REQUEST) {
+		state.desiredMip = std::min(requested, state.tailMip);
+		state.lastRequestedFrame = frame;
+	}
+	else if (frame > state.lastRequestedFrame + forgetFrames) {
+		state.desiredMip = state.tailMip;
+	}
+	return { state.desiredMip, state.tailMip, state.lastRequestedFrame, &state.chainSizes };
+}
+
+
+void Image::BeginResidencyChange(unsigned mipLevel) {
+	StreamingState& state = *m_streaming;
+	std::lock_guard<std::mutex> lock(state.mutex);
+	if (state.pendingTexture || mipLevel == state.residentMip) {
+		return;
+	}
+
+	// Textures cannot be partially resident, so a texture with the new mip chain replaces the current one.
+	Texture2DDesc desc(std::max<uint64_t>(1, state.width >> mipLevel), std::max<uint32_t>(1, state.height >> mipLevel), state.format, uint16_t(state.mipCount - mipLevel), 1);
+	state.pendingTexture = GetMemoryManager()->CreateTexture2D(eResourceHeap::CRITICAL, desc);
+	state.pendingMip = mipLevel;
+	for (unsigned mip = mipLevel; mip < state.mipCount; ++mip) {
+		UploadMip(state.pendingTexture, mipLevel, mip);
+	}
+}
+
+
+void Image::CommitResidencyChange() {
+	StreamingState& state = *m_streaming;
+	std::lock_guard<std::mutex> lock(state.mutex);
+	if (!state.pendingTexture || !state.pendingTexture.IsUploaded()) {
+		return;
+	}
+
+	// The old texture is released once the GPU is done with it.
+	state.texture = std::move(state.pendingTexture);
+	state.pendingTexture = {};
+	state.residentMip = state.pendingMip;
+	CreateResourceView(state.texture);
+}
+
+
 
-} // namespace inl::gxeng
\ No newline at end of file
+} // namespace inl::gxeng
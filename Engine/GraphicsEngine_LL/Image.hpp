@@ -1,37 +1,103 @@
 #pragma once
 
 #include "ImageBase.hpp"
+#include "TextureStreamer.hpp"
 
 #include <GraphicsEngine/Resources/IImage.hpp>
 
+#include <atomic>
 #include <memory>
+#include <mutex>
 
 
 namespace inl::gxeng {
 
 
 class Image : public IImage, protected ImageBase {
+	friend class TextureStreamer;
+
 public:
 	Image(MemoryManager* memoryManager, CbvSrvUavHeap* descriptorHeap) : ImageBase(memoryManager, descriptorHeap) {}
+	~Image();
 
 	void SetLayout(uint64_t width, uint32_t height, ePixelChannelType channelType, int channelCount, ePixelClass pixelClass) override;
 	void Update(uint64_t x, uint32_t y, uint64_t width, uint32_t height, int mipLevel, const void* pixels, const IPixelReader& reader, size_t bytesPerRow = 0) override;
+	void SetCompressedLayout(uint64_t width, uint32_t height, eBlockCompression compression, int mipCount, bool srgb = false) override;
+	void UpdateCompressed(int mipLevel, const void* blocks, size_t bytesPerRow = 0) override;
+	void SetStreaming(bool enabled) override;
 
-	size_t GetWidth() const override { return ImageBase::GetWidth(); }
-	size_t GetHeight() const override { return ImageBase::GetHeight(); }
-	ePixelChannelType GetChannelType() const override { return ImageBase::GetChannelType(); }
-	int GetChannelCount() const override { return ImageBase::GetChannelCount(); }
-	ePixelClass GetPixelClass() const override { return ImageBase::GetPixelClass(); }
+	size_t GetWidth() const override;
+	size_t GetHeight() const override;
+	ePixelChannelType GetChannelType() const override;
+	int GetChannelCount() const override;
+	ePixelClass GetPixelClass() const override;
 
 	const TextureView2D& GetSrv() const;
 
+	/// <summary> False until the texture has pixels on the GPU, the image must not be sampled before. </summary>
+	bool IsUploaded() const;
+
+	/// <summary> Tells the streamer that the renderer would sample this mip level. </summary>
+	/// <remarks> May be called from any thread. Has no effect if the image is not streaming. </remarks>
+	void RequestMip(unsigned mipLevel) const;
+
 private:
 	void CreateResourceView(const Texture2D& texture) override;
 
+	// Streaming
+	void StopStreaming();
+	void SetStreamingLayout(uint64_t width, uint32_t height, ePixelChannelType channelType, int channelCount, ePixelClass pixelClass);
+	void SetCompressedStreamingLayout(uint64_t width, uint32_t height, eBlockCompression compression, unsigned mipCount, bool srgb);
+	struct StreamingState;
+	void StartStreaming(std::unique_ptr<StreamingState> state);
+	void UpdateStreaming(uint64_t x, uint32_t y, uint64_t width, uint32_t height, unsigned mipLevel, const void* pixels, const IPixelReader& reader, size_t bytesPerRow);
+	void UpdateCompressedStreaming(unsigned mipLevel, const void* blocks, size_t bytesPerRow);
+	void GenerateMip(unsigned mipLevel);
+	void UploadMip(const Texture2D& texture, unsigned firstMip, unsigned mipLevel);
+	impl::StreamingCandidate GetStreamingCandidate(uint64_t frame, uint64_t forgetFrames);
+	void BeginResidencyChange(unsigned mipLevel);
+	void CommitResidencyChange();
+
 private:
 	TextureView2D m_resourceView;
+	bool m_hasMipChain = false; // Whether the view should include all mip levels.
+
+	struct StreamingState {
+		uint64_t width = 0;
+		uint32_t height = 0;
+		ePixelChannelType channelType;
+		int channelCount = 0;
+		ePixelClass pixelClass;
+		gxapi::eFormat format = gxapi::eFormat::UNKNOWN;
+		size_t pixelSize = 0; // Size of a 4x4 block for compressed images.
+		bool compressed = false; // Compressed mips are uploaded as they are, none of them are generated.
+		unsigned mipCount = 0;
+		unsigned tailMip = 0;
+
+		std::vector<std::vector<uint8_t>> mips; // Tightly packed pixels or blocks of each mip level in the texture's format.
+		std::vector<bool> providedMips; // Mips not provided by the user are generated from the more detailed ones.
+		std::vector<uint64_t> chainSizes; // GPU size of the mip chain starting at each mip level.
+
+		Texture2D texture;
+		unsigned residentMip = 0;
+		Texture2D pendingTexture; // Used once its uploads are done.
+		unsigned pendingMip = 0;
+
+		// Pixels arrive on asset loader threads while the streamer changes residency on the render thread.
+		std::mutex mutex;
+
+		mutable std::atomic<unsigned> requestedMip{ NO_REQUEST };
+		unsigned desiredMip = 0;
+		uint64_t lastRequestedFrame = 0;
+
+		static constexpr unsigned NO_REQUEST = ~0u;
+	};
+	bool m_streamingEnabled = false;
+	std::unique_ptr<StreamingState> m_streaming; // Only for streaming images.
+
+	static constexpr uint64_t STREAMING_TAIL_SIZE = 64; // Mips this large or smaller are always resident.
 };
 
 
 
-} // namespace inl::gxeng
\ No newline at end of file
+} // namespace inl::gxeng
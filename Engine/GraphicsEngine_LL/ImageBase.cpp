@@ -1,5 +1,9 @@
 #include "ImageBase.hpp"
 
+#include "PixelConversion.hpp"
+
+#include <algorithm>
+
 namespace inl ::gxeng {
 
 
@@ -34,6 +38,32 @@ void ImageBase::SetLayout(uint64_t width, uint32_t height, ePixelChannelType cha
 	m_channelCount = channelCount;
 	m_channelType = channelType;
 	m_pixelClass = pixelClass;
+	m_compressed = false;
+}
+
+
+void ImageBase::SetCompressedLayout(uint64_t width, uint32_t height, eBlockCompression compression, unsigned mipCount, unsigned arraySize, bool srgb) {
+	if (width % 4 != 0 || height % 4 != 0) {
+		throw InvalidArgumentException("Block compressed images must be a multiple of 4 pixels wide and high.");
+	}
+	if (mipCount == 0) {
+		throw InvalidArgumentException("Block compressed images must have at least one mip level.");
+	}
+
+	int channelCount = 0;
+	gxapi::eFormat format = ConvertFormat(compression, srgb, channelCount);
+
+	Texture2DDesc resdesc(width, height, format, uint16_t(mipCount), arraySize);
+	Texture2D texture = m_memoryManager->CreateTexture2D(eResourceHeap::CRITICAL, resdesc);
+
+	// In case this throws an exception changes will be unrolled.
+	CreateResourceView(texture);
+
+	m_resource = std::move(texture);
+	m_channelCount = channelCount;
+	m_channelType = ePixelChannelType::INT8_NORM;
+	m_pixelClass = ePixelClass::LINEAR;
+	m_compressed = true;
 }
 
 
@@ -42,6 +72,10 @@ void ImageBase::Update(uint64_t x, uint32_t y, uint64_t width, uint32_t height,
 		throw InvalidStateException("Must create image first.");
 	}
 
+	if (m_compressed) {
+		throw InvalidStateException("Block compressed images must be updated with UpdateCompressed.");
+	}
+
 	if (x + width > GetWidth() || y + height > GetHeight()) {
 		throw OutOfRangeException("Destination region out of bounds.");
 	}
@@ -55,23 +89,8 @@ void ImageBase::Update(uint64_t x, uint32_t y, uint64_t width, uint32_t height,
 	}
 
 	// Convert 3 channel pixels to 4 channels.
-	std::unique_ptr<uint8_t> pixels4;
-	if (reader.GetChannelCount() == 3) {
-		size_t structureSize = reader.StructureSize();
-		size_t structureSize4 = structureSize * 4 / 3;
-		size_t channelSize = structureSize / 3;
-		pixels4.reset(new uint8_t[structureSize4 * width * height]);
-		size_t dstPitch = width * structureSize4;
-		size_t srcPitch = bytesPerRow > 0 ? bytesPerRow : width * structureSize;
-		for (size_t y = 0; y < height; ++y) {
-			for (size_t x = 0; x < width; ++x) {
-				uint8_t* dst = pixels4.get() + (y * dstPitch + x * structureSize4);
-				memcpy(dst, (uint8_t*)pixels + (y * srcPitch + x * structureSize), structureSize);
-				memset(dst + structureSize, 0, channelSize);
-			}
-		}
-		pixels = pixels4.get();
-	}
+	std::unique_ptr<uint8_t[]> pixels4;
+	pixels = ConvertPixels(width, height, pixels, reader, bytesPerRow, pixels4);
 
 	// Upload data to gpu.
 	m_memoryManager->GetUploadManager().Upload(
@@ -87,6 +106,55 @@ void ImageBase::Update(uint64_t x, uint32_t y, uint64_t width, uint32_t height,
 }
 
 
+void ImageBase::UpdateCompressed(unsigned mipLevel, unsigned arrayIndex, const void* blocks, size_t bytesPerRow) {
+	if (!m_resource || !m_compressed) {
+		throw InvalidStateException("Must create block compressed image first.");
+	}
+	if (mipLevel >= m_resource.GetDescription().textureDesc.mipLevels) {
+		throw OutOfRangeException("Mip level does not exist.");
+	}
+
+	// Copies cover whole blocks, even for mip levels smaller than a block.
+	uint64_t width = ((std::max<uint64_t>(1, m_resource.GetWidth() >> mipLevel) + 3) / 4) * 4;
+	uint32_t height = ((std::max<uint32_t>(1, m_resource.GetHeight() >> mipLevel) + 3) / 4) * 4;
+
+	m_memoryManager->GetUploadManager().Upload(
+		m_resource,
+		0,
+		0,
+		m_resource.GetSubresourceIndex(mipLevel, arrayIndex, 0),
+		blocks,
+		width,
+		height,
+		m_resource.GetFormat(),
+		bytesPerRow);
+}
+
+
+const void* ImageBase::ConvertPixels(uint64_t width, uint32_t height, const void* pixels, const IPixelReader& reader, size_t& bytesPerRow, std::unique_ptr<uint8_t[]>& storage) {
+	if (reader.GetChannelCount() != 3) {
+		return pixels;
+	}
+
+	size_t structureSize = reader.StructureSize();
+	size_t structureSize4 = structureSize * 4 / 3;
+	size_t channelSize = structureSize / 3;
+	storage.reset(new uint8_t[structureSize4 * width * height]);
+	size_t dstPitch = width * structureSize4;
+	size_t srcPitch = bytesPerRow > 0 ? bytesPerRow : width * structureSize;
+	if (srcPitch == width * structureSize) {
+		ExpandRgbToRgba(pixels, storage.get(), width * height, channelSize);
+	}
+	else {
+		for (size_t y = 0; y < height; ++y) {
+			ExpandRgbToRgba((const uint8_t*)pixels + y * srcPitch, storage.get() + y * dstPitch, width, channelSize);
+		}
+	}
+	bytesPerRow = 0;
+	return storage.get();
+}
+
+
 size_t ImageBase::GetWidth() const {
 	if (m_resource) {
 		return m_resource.GetWidth();
@@ -156,5 +224,19 @@ bool ImageBase::ConvertFormat(ePixelChannelType channelType, int channelCount, e
 }
 
 
+gxapi::eFormat ImageBase::ConvertFormat(eBlockCompression compression, bool srgb, int& resultingChannelCount) {
+	using gxapi::eFormat;
+
+	switch (compression) {
+		case eBlockCompression::BC1: resultingChannelCount = 4; return srgb ? eFormat::BC1_UNORM_SRGB : eFormat::BC1_UNORM;
+		case eBlockCompression::BC3: resultingChannelCount = 4; return srgb ? eFormat::BC3_UNORM_SRGB : eFormat::BC3_UNORM;
+		case eBlockCompression::BC4: resultingChannelCount = 1; return eFormat::BC4_UNORM;
+		case eBlockCompression::BC5: resultingChannelCount = 2; return eFormat::BC5_UNORM;
+		case eBlockCompression::BC7: resultingChannelCount = 4; return srgb ? eFormat::BC7_UNORM_SRGB : eFormat::BC7_UNORM;
+	}
+	throw InvalidArgumentException("Unsupported block compression.");
+}
+
+
 
 } // namespace inl::gxeng
\ No newline at end of file
@@ -47,6 +47,15 @@ protected:
 	/// <param name="arraySize"> Specify 1 for simple images and 6 for cubemaps. </param>
 	void SetLayout(uint64_t width, uint32_t height, ePixelChannelType channelType, unsigned channelCount, ePixelClass pixelClass, unsigned arraySize);
 
+	/// <summary> Allocates the underlying GPU-resident texture for block compressed pixels. </summary>
+	/// <param name="width"> Width of the texture in pixels, must be a multiple of 4. </param>
+	/// <param name="height"> Height of the texture in pixels, must be a multiple of 4. </param>
+	/// <param name="compression"> The block format of the pixels. See <see cref="eBlockCompression"/>. </param>
+	/// <param name="mipCount"> Number of mip levels. </param>
+	/// <param name="arraySize"> Specify 1 for simple images and 6 for cubemaps. </param>
+	/// <param name="srgb"> The color channels are sRGB encoded. Ignored for BC4 and BC5. </param>
+	void SetCompressedLayout(uint64_t width, uint32_t height, eBlockCompression compression, unsigned mipCount, unsigned arraySize, bool srgb);
+
 	/// <summary> Upload pixels as byte array to the GPU. </summary>
 	/// <param name="x"> Where to insert the block of uploaded pixels. Top-left corner. </param>
 	/// <param name="y"> Where to insert the block of uploaded pixels. Top-left corner. </param>
@@ -60,13 +69,30 @@ protected:
 	/// <remarks> As you can't create multi-planed textures, uploading to specific plane is not supported. </remarks>
 	void Update(uint64_t x, uint32_t y, uint64_t width, uint32_t height, unsigned mipLevel, unsigned arrayIdx, const void* pixels, const IPixelReader& reader, size_t bytesPerRow = 0);
 
+	/// <summary> Upload an entire mip level of block compressed pixels to the GPU. </summary>
+	/// <param name="mipLevel"> Target mip level of the texture. </param>
+	/// <param name="arrayIdx"> Target array element of the texture. </param>
+	/// <param name="blocks"> The 4x4 pixel blocks of the mip level row by row. </param>
+	/// <param name="bytesPerRow"> How many bytes to skip in <paramref name="blocks"/> for each row of blocks. Leave as 0 for no row padding. </param>
+	void UpdateCompressed(unsigned mipLevel, unsigned arrayIdx, const void* blocks, size_t bytesPerRow = 0);
+
+	/// <summary> Expands 3 channel pixels to 4 channels, as there are no 3 channel texture formats for most channel types. </summary>
+	/// <returns> The converted pixels, which are either <paramref name="pixels"/> or point into <paramref name="storage"/>. </returns>
+	/// <remarks> <paramref name="bytesPerRow"/> is updated to match the returned pixels. </remarks>
+	static const void* ConvertPixels(uint64_t width, uint32_t height, const void* pixels, const IPixelReader& reader, size_t& bytesPerRow, std::unique_ptr<uint8_t[]>& storage);
+
 	/// <summary> Converts simplified pixel format to GraphicsAPI format. </summary>
 	static bool ConvertFormat(ePixelChannelType channelType, int channelCount, ePixelClass pixelClass, gxapi::eFormat& fmt, int& resultingChannelCount);
 
+	/// <summary> Converts block compression to GraphicsAPI format. </summary>
+	static gxapi::eFormat ConvertFormat(eBlockCompression compression, bool srgb, int& resultingChannelCount);
+
 	/// <summary> This method is called whenever a new view needs to be created. </summary>
 	/// <remarks> This must be implemented until the bottom-most subclass. </remarks>
 	virtual void CreateResourceView(const Texture2D& texture) = 0;
 
+	MemoryManager* GetMemoryManager() const { return m_memoryManager; }
+
 protected:
 	CbvSrvUavHeap* m_descriptorHeap;
 
@@ -75,6 +101,7 @@ private:
 	ePixelChannelType m_channelType;
 	int m_channelCount;
 	ePixelClass m_pixelClass;
+	bool m_compressed = false;
 	MemoryManager* m_memoryManager;
 };
 
@@ -1,5 +1,6 @@
 #include "Material.hpp"
 
+#include "Image.hpp"
 #include "MaterialShader.hpp"
 
 #include <BaseLibrary/Exception/Exception.hpp>
@@ -113,4 +114,19 @@ const Material::Parameter& Material::operator[](const std::string& name) const {
 }
 
 
+bool Material::IsUploaded() const {
+	for (auto& parameter : m_parameters) {
+		const bool isImage = parameter.GetType() == eMaterialShaderParamType::BITMAP_COLOR_2D
+							 || parameter.GetType() == eMaterialShaderParamType::BITMAP_VALUE_2D;
+		if (isImage && parameter.IsSet()) {
+			const Image* image = parameter;
+			if (image && !image->IsUploaded()) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+
 } // namespace inl::gxeng
\ No newline at end of file
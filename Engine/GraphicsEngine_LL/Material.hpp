@@ -38,6 +38,9 @@ public:
 	Parameter& operator[](const std::string& name);
 	const Parameter& operator[](const std::string& name) const;
 
+	/// <summary> False if any of the images of the material is not uploaded yet. </summary>
+	bool IsUploaded() const;
+
 private:
 	std::vector<Parameter> m_parameters;
 	const MaterialShader* m_shader = nullptr;
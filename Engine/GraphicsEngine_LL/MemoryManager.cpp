@@ -17,20 +17,20 @@ namespace inl::gxeng {
 
 MemoryManager::MemoryManager(gxapi::IGraphicsApi* graphicsApi) : m_graphicsApi(graphicsApi),
 																 m_criticalHeap(graphicsApi),
+																 m_transientHeap(graphicsApi),
 																 m_uploadHeap(graphicsApi),
-																 m_constBufferHeap(graphicsApi) {}
+																 m_constBufferHeap(graphicsApi),
+																 m_residencyManager(graphicsApi),
+																 m_textureStreamer(m_uploadHeap) {}
 
 
 void MemoryManager::LockResident(const std::vector<MemoryObject>& resources) {
-	// Lock resident wants to modify contents but not the vector.
-	auto& nonconst = const_cast<std::vector<MemoryObject>&>(resources);
-	LockResident(nonconst.begin(), nonconst.end());
+	m_residencyManager.LockResident(resources);
 }
 
 
 void MemoryManager::UnlockResident(const std::vector<MemoryObject>& resources) {
-	auto& nonconst = const_cast<std::vector<MemoryObject>&>(resources);
-	UnlockResident(nonconst.begin(), nonconst.end());
+	m_residencyManager.UnlockResident(resources);
 }
 
 
@@ -38,6 +38,16 @@ UploadManager& MemoryManager::GetUploadManager() {
 	return m_uploadHeap;
 }
 
+
+ResidencyManager& MemoryManager::GetResidencyManager() {
+	return m_residencyManager;
+}
+
+
+TextureStreamer& MemoryManager::GetTextureStreamer() {
+	return m_textureStreamer;
+}
+
 ConstantBufferHeap& MemoryManager::GetConstBufferHeap() {
 	return m_constBufferHeap;
 }
@@ -78,6 +88,21 @@ Texture3D MemoryManager::CreateTexture3D(eResourceHeap heap, const Texture3DDesc
 }
 
 
+Texture2D MemoryManager::CreateTransientTexture2D(const Texture2DDesc& desc, gxapi::eResourceFlags flags, TransientLifetime lifetime) {
+	return m_transientHeap.CreateTexture2D(desc, flags, lifetime);
+}
+
+
+TransientResourceHeap& MemoryManager::GetTransientHeap() {
+	return m_transientHeap;
+}
+
+
+impl::CriticalHeapStatistics MemoryManager::GetCriticalHeapStatistics() const {
+	return m_criticalHeap.GetStatistics();
+}
+
+
 BufferHeap& MemoryManager::GetHeap(eResourceHeap heap) {
 	switch (heap) {
 		case eResourceHeap::UPLOAD: throw NotImplementedException("Memory heap not implemented yet.");
@@ -4,6 +4,9 @@
 #include "CriticalBufferHeap.hpp"
 #include "HostDescHeap.hpp"
 #include "MemoryObject.hpp"
+#include "ResidencyManager.hpp"
+#include "TextureStreamer.hpp"
+#include "TransientResourceHeap.hpp"
 #include "UploadManager.hpp"
 
 #include "../GraphicsApi_D3D12/DescriptorHeap.hpp"
@@ -66,7 +69,8 @@ public:
 	MemoryManager(gxapi::IGraphicsApi* graphicsApi);
 
 	/// <summary>
-	/// Makes given resources resident.
+	/// Makes given resources resident and keeps them so until they are unlocked.
+	/// Least recently used resources are evicted if the residency budget requires.
 	/// </summary>
 	/// <exception cref="inl::gxapi::OutOfMemoryException">
 	/// If there is not enough free memory in the resource's appropriate
@@ -77,13 +81,15 @@ public:
 	void LockResident(IterT begin, IterT end);
 
 	/// <summary>
-	/// WRITE A DESCRIPTION
+	/// Lets the resources be evicted when memory is needed for others.
 	/// </summary>
 	void UnlockResident(const std::vector<MemoryObject>& resources);
 	template <typename IterT>
 	void UnlockResident(IterT begin, IterT end);
 
 	UploadManager& GetUploadManager();
+	ResidencyManager& GetResidencyManager();
+	TextureStreamer& GetTextureStreamer();
 	ConstantBufferHeap& GetConstBufferHeap();
 	VolatileConstBuffer CreateVolatileConstBuffer(const void* data, uint32_t size);
 	PersistentConstBuffer CreatePersistentConstBuffer(const void* data, uint32_t size);
@@ -94,6 +100,13 @@ public:
 	Texture2D CreateTexture2D(eResourceHeap heap, const Texture2DDesc& desc, gxapi::eResourceFlags flags = gxapi::eResourceFlags::NONE);
 	Texture3D CreateTexture3D(eResourceHeap heap, const Texture3DDesc& desc, gxapi::eResourceFlags flags = gxapi::eResourceFlags::NONE);
 
+	/// <summary> Creates a texture whose memory may be shared with other transient textures of disjoint lifetime. </summary>
+	Texture2D CreateTransientTexture2D(const Texture2DDesc& desc, gxapi::eResourceFlags flags, TransientLifetime lifetime);
+	TransientResourceHeap& GetTransientHeap();
+
+	/// <summary> Usage of the heaps the critical resources are placed in. </summary>
+	impl::CriticalHeapStatistics GetCriticalHeapStatistics() const;
+
 private:
 	BufferHeap& GetHeap(eResourceHeap heap);
 
@@ -101,76 +114,27 @@ private:
 	gxapi::IGraphicsApi* m_graphicsApi;
 
 	impl::CriticalBufferHeap m_criticalHeap;
+	TransientResourceHeap m_transientHeap;
 
 	UploadManager m_uploadHeap;
 	ConstantBufferHeap m_constBufferHeap;
 
-	std::mutex m_evictablesMtx;
-	std::unordered_set<MemoryObject> m_evictables;
+	ResidencyManager m_residencyManager;
+	TextureStreamer m_textureStreamer;
 };
 
 
 template <typename IterT>
 void MemoryManager::LockResident(IterT begin, IterT end) {
 	static_assert(std::is_same<typename IterT::value_type, MemoryObject>::value);
-
-	std::vector<gxapi::IResource*> lowLevelTargets;
-	std::vector<MemoryObject> highLevelTargets;
-
-	{
-		std::lock_guard<std::mutex> lock(m_evictablesMtx);
-
-		IterT currIter = begin;
-		while (currIter != end) {
-			auto& curr = *(currIter++);
-			auto currEvictableIter = m_evictables.find(curr);
-			bool evictable = currEvictableIter != m_evictables.end();
-			if (evictable) {
-				assert(curr._GetResident());
-				m_evictables.erase(currEvictableIter);
-			}
-			else {
-				if (curr._GetResident() == false) {
-					lowLevelTargets.push_back(curr._GetResourcePtr());
-					highLevelTargets.push_back(curr);
-				}
-			}
-		}
-
-		try {
-			m_graphicsApi->MakeResident(lowLevelTargets);
-		}
-		catch (OutOfMemoryException&) {
-			std::vector<gxapi::IResource*> toEvict;
-			toEvict.reserve(m_evictables.size());
-			for (auto& curr : m_evictables) {
-				// NOTE I'm not sure why 'curr' is a const reference. I had to add a const cast.
-				toEvict.push_back(const_cast<gxapi::IResource*>(curr._GetResourcePtr()));
-			}
-			m_graphicsApi->Evict(toEvict);
-			m_evictables.clear();
-
-			m_graphicsApi->MakeResident(lowLevelTargets);
-		}
-	}
-
-	assert(lowLevelTargets.size() == highLevelTargets.size());
-	for (size_t i = 0; i < highLevelTargets.size(); i++) {
-		auto currLowlevel = lowLevelTargets[i];
-		auto& currHighLevel = highLevelTargets[i];
-		assert(currHighLevel._GetResourcePtr() == currLowlevel);
-
-		currHighLevel._SetResident(true);
-	}
+	m_residencyManager.LockResident(std::vector<MemoryObject>(begin, end));
 }
 
 
 template <typename IterT>
 void MemoryManager::UnlockResident(IterT begin, IterT end) {
 	static_assert(std::is_same<typename IterT::value_type, MemoryObject>::value);
-
-	std::lock_guard<std::mutex> lock(m_evictablesMtx);
-	m_evictables.insert(begin, end);
+	m_residencyManager.UnlockResident(std::vector<MemoryObject>(begin, end));
 }
 
 } // namespace inl::gxeng
@@ -53,15 +53,52 @@ void MemoryObject::SetName(const char* name) {
 
 void MemoryObject::_SetResident(bool value) noexcept {
 	assert(m_contents);
-	m_contents->resident = value;
+	if (m_contents->placement) {
+		m_contents->placement->resident = value;
+	}
+	else {
+		m_contents->resident = value;
+	}
 }
 
 
 bool MemoryObject::_GetResident() const noexcept {
 	assert(m_contents);
-	return m_contents->resident;
+	return m_contents->placement ? m_contents->placement->resident : m_contents->resident;
+}
+
+
+void MemoryObject::_SetPlacement(std::shared_ptr<PlacedHeapResidency> placement) noexcept {
+	assert(m_contents);
+	m_contents->placement = std::move(placement);
 }
 
+
+PlacedHeapResidency* MemoryObject::_GetPlacement() const noexcept {
+	assert(m_contents);
+	return m_contents->placement.get();
+}
+
+
+bool MemoryObject::IsUploaded() const noexcept {
+	assert(m_contents);
+	return m_contents->pendingUploads.load(std::memory_order_acquire) == 0;
+}
+
+
+void MemoryObject::_BeginUpload() const noexcept {
+	assert(m_contents);
+	m_contents->pendingUploads.fetch_add(1, std::memory_order_relaxed);
+}
+
+
+void MemoryObject::_EndUpload() const noexcept {
+	assert(m_contents);
+	assert(m_contents->pendingUploads > 0);
+	m_contents->pendingUploads.fetch_sub(1, std::memory_order_release);
+}
+
+
 gxapi::IResource* MemoryObject::_GetResourcePtr() const noexcept {
 	assert(m_contents);
 	return m_contents->resource.get();
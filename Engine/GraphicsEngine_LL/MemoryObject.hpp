@@ -5,8 +5,10 @@
 #include "../GraphicsApi_LL/IGraphicsApi.hpp"
 #include "../GraphicsApi_LL/IResource.hpp"
 
+#include <atomic>
 #include <cassert>
 #include <functional>
+#include <memory>
 #include <string>
 
 namespace inl::gxeng {
@@ -22,11 +24,20 @@ enum class eResourceHeap {
 	STREAMING,
 	PIPELINE,
 	CRITICAL,
+	TRANSIENT,
 	BACKBUFFER,
 	INVALID,
 };
 
 
+/// <summary> A heap that resources are placed in. The resources in it are resident exactly when the heap is. </summary>
+struct PlacedHeapResidency {
+	gxapi::IHeap* heap;
+	uint64_t size;
+	bool resident;
+};
+
+
 class MemoryObject {
 public:
 	friend struct std::hash<MemoryObject>;
@@ -104,8 +115,23 @@ public:
 		return m_contents->heap;
 	}
 
+	/// <remarks> The residency of placed resources is that of their heap, shared with all other resources in it. </remarks>
 	void _SetResident(bool value) noexcept;
 	bool _GetResident() const noexcept;
+	/// <summary> Marks the resource as placed in the heap, they are made resident and evicted together. </summary>
+	void _SetPlacement(std::shared_ptr<PlacedHeapResidency> placement) noexcept;
+	/// <summary> The heap the resource is placed in, null for committed resources. </summary>
+	PlacedHeapResidency* _GetPlacement() const noexcept;
+	/// <summary> False while data queued for upload to the resource may not have arrived yet. </summary>
+	/// <remarks> Rendering must skip resources that are not uploaded, as the copy queue may still be writing them. </remarks>
+	bool IsUploaded() const noexcept;
+	/// <summary> Called by the upload manager when an upload to the resource is queued. </summary>
+	void _BeginUpload() const noexcept;
+	/// <summary> Called once a queued upload is visible to rendering. </summary>
+	void _EndUpload() const noexcept;
+
+	/// <summary> True if no other MemoryObject refers to the same resource. </summary>
+	bool _IsUnique() const noexcept { return m_contents.use_count() == 1; }
 
 	gxapi::IResource* _GetResourcePtr() const noexcept;
 
@@ -120,6 +146,8 @@ protected:
 		eResourceHeap heap;
 		std::vector<gxapi::eResourceState> subresourceStates;
 		std::string name;
+		std::atomic_uint32_t pendingUploads = 0;
+		std::shared_ptr<PlacedHeapResidency> placement;
 	};
 	std::shared_ptr<Contents> m_contents;
 };
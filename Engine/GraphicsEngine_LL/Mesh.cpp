@@ -1,42 +1,124 @@
 #include "Mesh.hpp"
+#include "MeshOptimizer.hpp"
 #include "VertexCompressor.hpp"
 
 #include <BaseLibrary/Container/ArrayView.hpp>
 #include <BaseLibrary/HashCombine.hpp>
 
+#include <algorithm>
+
 
 namespace inl ::gxeng {
 
 
+// Returns an empty list if the vertices have no position.
+static std::vector<Vec3> ReadPositions(const VertexBase* vertices, const IVertexReader* vertexReader, size_t numVertices) {
+	auto& elements = vertexReader->GetElements();
+	auto positionIt = std::find_if(elements.begin(), elements.end(), [](const IVertexReader::Element& element) {
+		return element.semantic == eVertexElementSemantic::POSITION;
+	});
+	std::vector<Vec3> positions;
+	if (positionIt != elements.end()) {
+		positions.reserve(numVertices);
+		ArrayView<const VertexBase> inputArray{ vertices, numVertices, (size_t)vertexReader->GetStride() };
+		for (size_t vertex = 0; vertex < numVertices; ++vertex) {
+			using PositionT = VertexPartReader<eVertexElementSemantic::POSITION>::DataType;
+			positions.push_back(*static_cast<const PositionT*>(vertexReader->GetPointer(inputArray[vertex], positionIt->semantic, positionIt->index)));
+		}
+	}
+	return positions;
+}
+
 
 void Mesh::Set(const VertexBase* vertices, const IVertexReader* vertexReader, size_t numVertices, const unsigned* indices, size_t numIndices) {
 	// Create constants
 	auto& elements = vertexReader->GetElements();
 	std::vector<bool> elementMap(elements.size(), true);
 
+	// Quantize positions within the bounds of these vertices.
+	std::vector<Vec3> positions = ReadPositions(vertices, vertexReader, numVertices);
+	m_boundsMin = m_boundsMax = Vec3{ 0, 0, 0 };
+	if (!positions.empty()) {
+		m_boundsMin = m_boundsMax = positions[0];
+		for (const auto& position : positions) {
+			m_boundsMin = Min(m_boundsMin, position);
+			m_boundsMax = Max(m_boundsMax, position);
+		}
+	}
+	VertexQuantization quantization = m_requestedQuantization;
+	quantization.boundsMin = m_boundsMin;
+	quantization.boundsMax = m_boundsMax;
+
 	// Compress vertices
-	VertexCompressor compressor{ vertexReader, elementMap };
+	VertexCompressor compressor{ vertexReader, elementMap, quantization };
 	std::vector<uint8_t> compressedData = compressor.GetCompressedStream(vertices, numVertices);
 	auto offsets = compressor.GetCompressedOffsets();
+	auto formats = compressor.GetCompressedFormats();
 
 	// Set data
 	VertexStream stream;
 	stream.stride = compressor.GetCompressedStride();
 	stream.count = numVertices;
 	stream.data = compressedData.data();
-	MeshBuffer::Set(&stream, &stream + 1, indices, indices + numIndices);
+	if (m_optimize) {
+		std::vector<uint32_t> optimizedIndices(indices, indices + numIndices);
+		std::vector<uint8_t> optimizedData(compressedData.size());
+		Optimize(positions, numVertices, optimizedIndices);
+		RemapVertices(compressedData.data(), optimizedData.data(), numVertices, stream.stride, m_vertexRemap);
+		stream.data = optimizedData.data();
+		MeshBuffer::Set(&stream, &stream + 1, optimizedIndices.data(), optimizedIndices.data() + optimizedIndices.size());
+	}
+	else {
+		m_vertexRemap.clear();
+		MeshBuffer::Set(&stream, &stream + 1, indices, indices + numIndices);
+	}
 
-	// Set stream elements.
-	std::vector<std::vector<Element>> layout;
-	layout.clear();
+	// Set stream elements, skipping those the compressor folded into others.
 	std::vector<Element> streamElements;
+	std::vector<gxapi::eFormat> streamFormats;
 	for (size_t i = 0; i < elements.size(); ++i) {
-		streamElements.push_back(Element{ elements[i].semantic, elements[i].index, offsets[i] });
+		if (offsets[i] >= 0) {
+			streamElements.push_back(Element{ elements[i].semantic, elements[i].index, offsets[i] });
+			streamFormats.push_back(formats[i]);
+		}
 	}
-	layout.push_back(streamElements);
 
 	// Calculate hashes
-	m_layout = Layout(layout);
+	m_layout = Layout({ streamElements }, { streamFormats });
+	m_quantization = quantization;
+}
+
+
+void Mesh::SetCompressed(const void* vertexData, uint32_t stride, size_t numVertices, const Element* elements, size_t numElements, const void* indices, bool indices32Bit, size_t numIndices, const VertexQuantization& quantization) {
+	VertexStream stream;
+	stream.stride = stride;
+	stream.count = numVertices;
+	stream.data = const_cast<void*>(vertexData); // Only read by the upload.
+	if (indices32Bit) {
+		auto first = static_cast<const uint32_t*>(indices);
+		MeshBuffer::Set(&stream, &stream + 1, first, first + numIndices);
+	}
+	else {
+		auto first = static_cast<const uint16_t*>(indices);
+		MeshBuffer::Set(&stream, &stream + 1, first, first + numIndices);
+	}
+
+	// Elements are packed, each one lasts until the next one or the end of the vertex.
+	std::vector<gxapi::eFormat> formats;
+	for (size_t i = 0; i < numElements; ++i) {
+		int end = int(stride);
+		for (size_t j = 0; j < numElements; ++j) {
+			if (elements[j].offset > elements[i].offset) {
+				end = std::min(end, elements[j].offset);
+			}
+		}
+		formats.push_back(VertexCompressor::GetCompressedFormat(elements[i].semantic, end - elements[i].offset, quantization));
+	}
+
+	m_layout = Layout({ std::vector<Element>(elements, elements + numElements) }, { formats });
+	m_quantization = quantization;
+	m_vertexRemap.clear(); // Cooked meshes are optimized offline.
+	m_boundsMin = m_boundsMax = Vec3{ 0, 0, 0 };
 }
 
 
@@ -45,13 +127,66 @@ void Mesh::Update(const VertexBase* vertices, const IVertexReader* vertexReader,
 	auto& elements = vertexReader->GetElements();
 	std::vector<bool> elementMap(elements.size(), true);
 
-	// Compress vertices
-	VertexCompressor compressor{ vertexReader, elementMap };
+	// Compress vertices the same way as the ones already in the buffer.
+	VertexCompressor compressor{ vertexReader, elementMap, m_quantization };
 	std::vector<uint8_t> compressedData = compressor.GetCompressedStream(vertices, numVertices);
-	auto offsets = compressor.GetCompressedOffsets();
 
 	// Update data
-	MeshBuffer::Update(0, compressedData.data(), numVertices, offsetInVertices);
+	if (m_vertexRemap.empty()) {
+		MeshBuffer::Update(0, compressedData.data(), numVertices, offsetInVertices);
+		return;
+	}
+
+	// Vertices were reordered by Set, upload runs that stayed contiguous.
+	if (offsetInVertices + numVertices > m_vertexRemap.size()) {
+		throw OutOfRangeException("Data doesn't fit in given vertex buffer.");
+	}
+	const size_t stride = compressor.GetCompressedStride();
+	size_t first = 0;
+	while (first < numVertices) {
+		size_t last = first + 1;
+		const uint32_t target = m_vertexRemap[offsetInVertices + first];
+		while (last < numVertices && m_vertexRemap[offsetInVertices + last] == target + (last - first)) {
+			++last;
+		}
+		MeshBuffer::Update(0, compressedData.data() + first * stride, last - first, target);
+		first = last;
+	}
+}
+
+
+void Mesh::SetOptimization(bool enabled) {
+	m_optimize = enabled;
+}
+
+
+void Mesh::SetQuantization(const VertexQuantization& quantization) {
+	m_requestedQuantization = quantization;
+}
+
+
+void Mesh::SetBounds(const Vec3& boundsMin, const Vec3& boundsMax) {
+	m_boundsMin = boundsMin;
+	m_boundsMax = boundsMax;
+}
+
+
+Vec3 Mesh::GetBoundsMin() const {
+	return m_boundsMin;
+}
+
+
+Vec3 Mesh::GetBoundsMax() const {
+	return m_boundsMax;
+}
+
+
+void Mesh::Optimize(const std::vector<Vec3>& positions, size_t numVertices, std::vector<uint32_t>& indices) {
+	OptimizeVertexCache(indices.data(), indices.size(), numVertices);
+	if (!positions.empty()) {
+		OptimizeOverdraw(indices.data(), indices.size(), positions.data(), numVertices);
+	}
+	m_vertexRemap = OptimizeVertexFetch(indices.data(), indices.size(), numVertices);
 }
 
 
@@ -66,29 +201,30 @@ const Mesh::Layout& Mesh::GetLayout() const {
 }
 
 
+const VertexQuantization& Mesh::GetQuantization() const {
+	return m_quantization;
+}
 
-bool Mesh::Layout::EqualElements(const Layout& rhs) const {
-	if (m_elementHash != rhs.m_elementHash) {
-		return false;
+
+Mat44 Mesh::GetPositionDequantization() const {
+	if (m_quantization.position == ePositionEncoding::FLOAT32) {
+		return Identity();
 	}
+	return Mat44(Scale(m_quantization.boundsMax - m_quantization.boundsMin)) * Mat44(Translation(m_quantization.boundsMin));
+}
+
 
-	auto lhsElements = GetAllElements(m_layout);
-	auto rhsElements = GetAllElements(rhs.m_layout);
-	if (lhsElements.size() != rhsElements.size()) {
+
+bool Mesh::Layout::EqualElements(const Layout& rhs) const {
+	if (m_elementHash != rhs.m_elementHash) {
 		return false;
 	}
 
+	auto lhsElements = GetAllElements();
+	auto rhsElements = rhs.GetAllElements();
 	RadixSortElements(lhsElements);
 	RadixSortElements(rhsElements);
-	for (size_t i = 0; i < lhsElements.size(); ++i) {
-		if (lhsElements[i].semantic != rhsElements[i].semantic
-			|| lhsElements[i].index != rhsElements[i].index
-			|| lhsElements[i].offset != rhsElements[i].offset) {
-			return false;
-		}
-	}
-
-	return true;
+	return EqualElementLists(lhsElements, rhsElements);
 }
 
 bool Mesh::Layout::EqualLayout(const Layout& rhs) const {
@@ -97,15 +233,18 @@ bool Mesh::Layout::EqualLayout(const Layout& rhs) const {
 	}
 
 	// same as above, except for sorting
-	auto lhsElements = GetAllElements(m_layout);
-	auto rhsElements = GetAllElements(rhs.m_layout);
-	if (lhsElements.size() != rhsElements.size()) {
+	return EqualElementLists(GetAllElements(), rhs.GetAllElements());
+}
+
+bool Mesh::Layout::EqualElementLists(const std::vector<FormattedElement>& lhs, const std::vector<FormattedElement>& rhs) {
+	if (lhs.size() != rhs.size()) {
 		return false;
 	}
-	for (size_t i = 0; i < lhsElements.size(); ++i) {
-		if (lhsElements[i].semantic != rhsElements[i].semantic
-			|| lhsElements[i].index != rhsElements[i].index
-			|| lhsElements[i].offset != rhsElements[i].offset) {
+	for (size_t i = 0; i < lhs.size(); ++i) {
+		if (lhs[i].semantic != rhs[i].semantic
+			|| lhs[i].index != rhs[i].index
+			|| lhs[i].offset != rhs[i].offset
+			|| lhs[i].format != rhs[i].format) {
 			return false;
 		}
 	}
@@ -131,12 +270,15 @@ UniqueId Mesh::Layout::GetLayoutId() const {
 
 void Mesh::Layout::Clear() {
 	m_layout.clear();
+	m_formats.clear();
 	m_elementHash = m_layoutHash = 0;
 	m_elementId = m_layoutId = UniqueId{};
 }
 
-Mesh::Layout::Layout(std::vector<std::vector<Element>> layout) : m_layout(std::move(layout)) {
-	CalculateHashes(m_layout, m_elementHash, m_layoutHash);
+Mesh::Layout::Layout(std::vector<std::vector<Element>> layout, std::vector<std::vector<gxapi::eFormat>> formats)
+	: m_layout(std::move(layout)), m_formats(std::move(formats)) {
+	assert(m_layout.size() == m_formats.size());
+	CalculateHashes();
 	std::lock_guard lkg(idGeneratorMtx);
 	m_elementId = elementIdGenerator(*this);
 	m_layoutId = layoutIdGenerator(*this);
@@ -172,16 +314,19 @@ inline uint64_t inthash(uint64_t key) {
 }
 
 
-std::vector<Mesh::Element> Mesh::Layout::GetAllElements(const std::vector<std::vector<Element>>& layout) {
-	std::vector<Element> allElements;
-	std::vector<Element> streamElements;
+std::vector<Mesh::Layout::FormattedElement> Mesh::Layout::GetAllElements() const {
+	std::vector<FormattedElement> allElements;
+	std::vector<FormattedElement> streamElements;
 
-	for (const auto& s : layout) {
-		streamElements = s;
+	for (size_t stream = 0; stream < m_layout.size(); ++stream) {
+		streamElements.clear();
+		for (size_t i = 0; i < m_layout[stream].size(); ++i) {
+			streamElements.push_back({ m_layout[stream][i], m_formats[stream][i] });
+		}
 		// sort elements by offset (elements are unique by offset, no radix sort needed)
 		// sorting is needed because different order still means the same stream content layout
 		// this way, hash value will be the same regardless of order; only content layout matters
-		std::sort(streamElements.begin(), streamElements.end(), [](const Element& lhs, const Element& rhs) {
+		std::sort(streamElements.begin(), streamElements.end(), [](const FormattedElement& lhs, const FormattedElement& rhs) {
 			return lhs.offset < rhs.offset;
 		});
 		// push list to all elements
@@ -194,26 +339,28 @@ std::vector<Mesh::Element> Mesh::Layout::GetAllElements(const std::vector<std::v
 }
 
 
-void Mesh::Layout::RadixSortElements(std::vector<Element>& elements) {
-	std::stable_sort(elements.begin(), elements.end(), [](const Element& lhs, const Element& rhs) {
+void Mesh::Layout::RadixSortElements(std::vector<FormattedElement>& elements) {
+	std::stable_sort(elements.begin(), elements.end(), [](const FormattedElement& lhs, const FormattedElement& rhs) {
 		return lhs.offset < rhs.offset;
 	});
-	std::stable_sort(elements.begin(), elements.end(), [](const Element& lhs, const Element& rhs) {
+	std::stable_sort(elements.begin(), elements.end(), [](const FormattedElement& lhs, const FormattedElement& rhs) {
 		return lhs.index < rhs.index;
 	});
-	std::stable_sort(elements.begin(), elements.end(), [](const Element& lhs, const Element& rhs) {
+	std::stable_sort(elements.begin(), elements.end(), [](const FormattedElement& lhs, const FormattedElement& rhs) {
 		return lhs.semantic < rhs.semantic;
 	});
 }
 
 
-void Mesh::Layout::CalculateHashes(const std::vector<std::vector<Element>>& layout, size_t& elementHash, size_t& layoutHash) {
-	std::vector<Element> allElements;
+void Mesh::Layout::CalculateHashes() {
+	std::vector<FormattedElement> allElements;
+	size_t& elementHash = m_elementHash;
+	size_t& layoutHash = m_layoutHash;
 
 	elementHash = 0;
 	layoutHash = 0;
 
-	allElements = GetAllElements(layout);
+	allElements = GetAllElements();
 
 	// hashing allElements will result in a hash tied to a specific layout
 	// this is because allElements retains the information as to which element is in which stream
@@ -221,6 +368,7 @@ void Mesh::Layout::CalculateHashes(const std::vector<std::vector<Element>>& layo
 		layoutHash = CombineHash(layoutHash, inthash((size_t)e.semantic));
 		layoutHash = CombineHash(layoutHash, inthash((size_t)e.index));
 		layoutHash = CombineHash(layoutHash, inthash((size_t)e.offset));
+		layoutHash = CombineHash(layoutHash, inthash((size_t)e.format));
 	}
 
 	// now we order allElements to remove layout information, and keep only element information
@@ -230,6 +378,7 @@ void Mesh::Layout::CalculateHashes(const std::vector<std::vector<Element>>& layo
 		elementHash = CombineHash(layoutHash, inthash((size_t)e.semantic));
 		elementHash = CombineHash(layoutHash, inthash((size_t)e.index));
 		elementHash = CombineHash(layoutHash, inthash((size_t)e.offset));
+		elementHash = CombineHash(layoutHash, inthash((size_t)e.format));
 	}
 }
 
@@ -3,6 +3,7 @@
 #include "MeshBuffer.hpp"
 
 #include <BaseLibrary/UniqueIdGenerator.hpp>
+#include <GraphicsApi_LL/Common.hpp>
 #include <GraphicsEngine/Resources/IMesh.hpp>
 #include <GraphicsEngine/Resources/Vertex.hpp>
 
@@ -15,17 +16,14 @@ namespace inl ::gxeng {
 
 class Mesh : public IMesh, protected MeshBuffer {
 public:
-	struct Element {
-		eVertexElementSemantic semantic; // Semantic of the vertex elements.
-		int index; // Index of the semantic.
-		int offset; // Offset of the element within it's vertex stream, in bytes.
-	};
+	using Element = IMesh::Element;
 
 	/// <summary> Describes what vertex elements are contained in the streams of the mesh. </summary>
 	struct Layout {
 	public:
 		Layout() = default;
-		Layout(std::vector<std::vector<Element>> layout);
+		/// <param name="formats"> The format of each element, in the same arrangement as <paramref name="layout"/>. </param>
+		Layout(std::vector<std::vector<Element>> layout, std::vector<std::vector<gxapi::eFormat>> formats);
 
 		/// <summary> Returns the number of vertex streams. </summary>
 		size_t GetStreamCount() const;
@@ -33,7 +31,11 @@ public:
 		/// <summary> Returns the <paramref name="idx"/>-th stream's elements. </summary>
 		const std::vector<Element>& operator[](size_t idx) const { return m_layout[idx]; }
 
+		/// <summary> Returns the formats of the <paramref name="idx"/>-th stream's elements, for the pipeline's input layout. </summary>
+		const std::vector<gxapi::eFormat>& GetFormats(size_t idx) const { return m_formats[idx]; }
+
 		/// <summary> Returns true if layouts have the exact same elements, but they may be arranged into streams differently. </summary>
+		/// <remarks> Elements are only the same if their formats match too. </remarks>
 		bool EqualElements(const Layout& rhs) const;
 
 		/// <summary> Returns true if layouts have the exact same elements arranged exactly the same way. </summary>
@@ -71,12 +73,18 @@ public:
 		};
 
 	private:
-		static void CalculateHashes(const std::vector<std::vector<Element>>& layout, size_t& elementHash, size_t& layoutHash);
-		static std::vector<Element> GetAllElements(const std::vector<std::vector<Element>>& layout);
-		static void RadixSortElements(std::vector<Element>& elements);
+		struct FormattedElement : Element {
+			gxapi::eFormat format;
+		};
+
+		void CalculateHashes();
+		std::vector<FormattedElement> GetAllElements() const;
+		static void RadixSortElements(std::vector<FormattedElement>& elements);
+		static bool EqualElementLists(const std::vector<FormattedElement>& lhs, const std::vector<FormattedElement>& rhs);
 
 	private:
 		std::vector<std::vector<Element>> m_layout; // One set of elements for each vertex buffer.
+		std::vector<std::vector<gxapi::eFormat>> m_formats; // Same arrangement as the elements.
 		size_t m_elementHash = 0;
 		size_t m_layoutHash = 0;
 		UniqueId m_elementId;
@@ -90,19 +98,43 @@ public:
 	Mesh(MemoryManager* memoryManager) : MeshBuffer(memoryManager) {}
 
 	void Set(const VertexBase* vertices, const IVertexReader* vertexReader, size_t numVertices, const unsigned* indices, size_t numIndices) override;
+	void SetCompressed(const void* vertexData, uint32_t stride, size_t numVertices, const Element* elements, size_t numElements, const void* indices, bool indices32Bit, size_t numIndices, const VertexQuantization& quantization) override;
 	void Update(const VertexBase* vertices, const IVertexReader* vertexReader, size_t numVertices, size_t offsetInVertices) override;
 	void Clear() override;
+	void SetOptimization(bool enabled) override;
+	void SetQuantization(const VertexQuantization& quantization) override;
+	void SetBounds(const Vec3& boundsMin, const Vec3& boundsMax) override;
+	Vec3 GetBoundsMin() const override;
+	Vec3 GetBoundsMax() const override;
 
 	using MeshBuffer::GetIndexBuffer;
 	using MeshBuffer::GetNumStreams;
 	using MeshBuffer::GetVertexBuffer;
 	using MeshBuffer::GetVertexBufferStride;
 	using MeshBuffer::IsIndexBuffer32Bit;
+	using MeshBuffer::IsUploaded;
 
 	const Layout& GetLayout() const;
 
+	/// <summary> How the current vertices are encoded, the bounds are the ones positions were quantized within. </summary>
+	const VertexQuantization& GetQuantization() const;
+
+	/// <summary> Transforms positions as the input assembler reads them into model space.
+	///		Identity unless positions are quantized, prepend it to the model matrix. </summary>
+	Mat44 GetPositionDequantization() const;
+
+private:
+	/// <summary> Reorders the indices in place and sets <see cref="m_vertexRemap"/>. </summary>
+	void Optimize(const std::vector<Vec3>& positions, size_t numVertices, std::vector<uint32_t>& indices);
+
 private:
 	Layout m_layout;
+	bool m_optimize = false;
+	VertexQuantization m_requestedQuantization; // For the next Set.
+	VertexQuantization m_quantization; // Of the current vertices.
+	std::vector<uint32_t> m_vertexRemap; // New index of each vertex given to Set, empty if they were not reordered.
+	Vec3 m_boundsMin = { 0, 0, 0 };
+	Vec3 m_boundsMax = { 0, 0, 0 };
 };
 
 
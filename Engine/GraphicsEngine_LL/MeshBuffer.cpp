@@ -62,6 +62,15 @@ const IndexBuffer& MeshBuffer::GetIndexBuffer() const {
 	return m_indexBuffer;
 }
 
+bool MeshBuffer::IsUploaded() const {
+	for (auto& vertexBuffer : m_vertexBuffers) {
+		if (!vertexBuffer.IsUploaded()) {
+			return false;
+		}
+	}
+	return !m_indexBuffer || m_indexBuffer.IsUploaded();
+}
+
 
 
 } // namespace inl::gxeng
\ No newline at end of file
@@ -45,6 +45,8 @@ public:
 	size_t GetVertexBufferStride(size_t streamIndex) const;
 	const IndexBuffer& GetIndexBuffer() const;
 	bool IsIndexBuffer32Bit() const { return m_isIndex32Bit; }
+	/// <summary> False while uploads to any of the buffers are in flight, the mesh must not be drawn then. </summary>
+	bool IsUploaded() const;
 
 private:
 	template <class StreamIt, class IndexIt>
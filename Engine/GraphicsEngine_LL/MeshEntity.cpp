@@ -4,6 +4,13 @@
 #include "GuiEngine/Board.hpp"
 #include "GuiEngine/Board.hpp"
 
+#include <BaseLibrary/Exception/Exception.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+
 namespace inl::gxeng {
 
 
@@ -20,6 +27,81 @@ const std::shared_ptr<Mesh>& MeshEntity::GetMeshNative() const {
 	return m_mesh;
 }
 
+void MeshEntity::SetLods(std::vector<Lod> lods) {
+	for (size_t i = 0; i < lods.size(); ++i) {
+		if (!lods[i].mesh) {
+			throw InvalidArgumentException("Level of detail meshes cannot be null.");
+		}
+		if (i > 0 && lods[i].screenSize >= lods[i - 1].screenSize) {
+			throw InvalidArgumentException("Level of detail screen sizes must decrease with the level.");
+		}
+	}
+	m_lods = std::move(lods);
+}
+
+const std::vector<MeshEntity::Lod>& MeshEntity::GetLods() const {
+	return m_lods;
+}
+
+std::shared_ptr<IMesh> MeshEntity::SelectLod(const Mat44& view, const Mat44& projection) const {
+	size_t level = SelectLodLevel(view, projection);
+	return level == 0 ? std::shared_ptr<IMesh>(m_mesh) : m_lods[level - 1].mesh;
+}
+
+Mesh* MeshEntity::SelectLodNative(const Mat44& view, const Mat44& projection) const {
+	size_t level = SelectLodLevel(view, projection);
+	return level == 0 ? m_mesh.get() : static_cast<Mesh*>(m_lods[level - 1].mesh.get());
+}
+
+float MeshEntity::GetScreenSize(const Mat44& view, const Mat44& projection) const {
+	constexpr float unknown = std::numeric_limits<float>::infinity();
+	if (!m_mesh) {
+		return unknown;
+	}
+	const Vec3 boundsMin = m_mesh->GetBoundsMin();
+	const Vec3 boundsMax = m_mesh->GetBoundsMax();
+	const float localRadius = Length(boundsMax - boundsMin) * 0.5f;
+	if (localRadius <= 0.0f) {
+		return unknown;
+	}
+
+	// Bounding sphere in view space, scaled by the largest axis of the transform.
+	const Mat44 world = m_transform.GetMatrix();
+	float scale = 0.0f;
+	for (const Vec4& axis : { Vec4{ 1, 0, 0, 0 }, Vec4{ 0, 1, 0, 0 }, Vec4{ 0, 0, 1, 0 } }) {
+		scale = std::max(scale, Length((axis * world).xyz));
+	}
+	const float radius = localRadius * scale;
+	const Vec4 center = Vec4((boundsMin + boundsMax) * 0.5f, 1.0f) * world * view;
+
+	// Project the center and offsets along each view axis, the one pointing up gives the radius on screen.
+	const Vec4 centerClip = center * projection;
+	if (centerClip.w <= 0.0f) {
+		return unknown;
+	}
+	float screenRadius = 0.0f;
+	for (const Vec4& axis : { Vec4{ 1, 0, 0, 0 }, Vec4{ 0, 1, 0, 0 }, Vec4{ 0, 0, 1, 0 } }) {
+		const Vec4 offsetClip = (center + axis * radius) * projection;
+		if (offsetClip.w <= 0.0f) {
+			return unknown; // The camera is inside or right next to the sphere.
+		}
+		screenRadius = std::max(screenRadius, std::abs(offsetClip.y / offsetClip.w - centerClip.y / centerClip.w));
+	}
+	return screenRadius; // Normalized device coordinates span 2 units, so the radius is the diameter's fraction.
+}
+
+size_t MeshEntity::SelectLodLevel(const Mat44& view, const Mat44& projection) const {
+	if (m_lods.empty()) {
+		return 0;
+	}
+	const float screenSize = GetScreenSize(view, projection);
+	size_t level = 0;
+	while (level < m_lods.size() && screenSize < m_lods[level].screenSize) {
+		++level;
+	}
+	return level;
+}
+
 void MeshEntity::SetMaterial(std::shared_ptr<Material> material) {
 	m_material = material;
 }
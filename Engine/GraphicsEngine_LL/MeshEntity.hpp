@@ -17,6 +17,13 @@ public:
 	std::shared_ptr<IMesh> GetMesh() const override;
 	const std::shared_ptr<Mesh>& GetMeshNative() const;
 
+	void SetLods(std::vector<Lod> lods) override;
+	const std::vector<Lod>& GetLods() const override;
+	std::shared_ptr<IMesh> SelectLod(const Mat44& view, const Mat44& projection) const override;
+	Mesh* SelectLodNative(const Mat44& view, const Mat44& projection) const;
+	/// <summary> Returns the fraction of the screen height the bounding sphere of the mesh covers, infinity if unknown. </summary>
+	float GetScreenSize(const Mat44& view, const Mat44& projection) const;
+
 	void SetMaterial(std::shared_ptr<Material> material);
 	void SetMaterial(std::shared_ptr<IMaterial> material) override { SetMaterial(static_pointer_cast<Material>(material)); }
 	std::shared_ptr<IMaterial> GetMaterial() const override;
@@ -25,8 +32,12 @@ public:
 	Transform3D& Transform() override;
 	const Transform3D& Transform() const override;
 	
+private:
+	size_t SelectLodLevel(const Mat44& view, const Mat44& projection) const;
+
 private:
 	std::shared_ptr<Mesh> m_mesh = nullptr;
+	std::vector<Lod> m_lods;
 	std::shared_ptr<Material> m_material = nullptr;
 	Transform3D m_transform;
 };
@@ -0,0 +1,454 @@
+#include "MeshOptimizer.hpp"
+
+#include <BaseLibrary/Exception/Exception.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <numeric>
+
+
+namespace inl::gxeng {
+
+
+//------------------------------------------------------------------------------
+// Statistics
+//------------------------------------------------------------------------------
+
+namespace {
+
+	// FIFO cache simulation: a vertex is cached if fewer than cacheSize vertices were transformed since it was.
+	class FifoCache {
+	public:
+		FifoCache(size_t vertexCount, unsigned cacheSize) : m_timestamps(vertexCount, 0), m_cacheSize(cacheSize) {}
+
+		bool Access(uint32_t vertex) {
+			if (m_timestamps[vertex] != 0 && m_time - m_timestamps[vertex] < m_cacheSize) {
+				return true;
+			}
+			m_timestamps[vertex] = ++m_time;
+			return false;
+		}
+
+		unsigned Misses(const uint32_t* triangle) {
+			return unsigned(!Access(triangle[0])) + unsigned(!Access(triangle[1])) + unsigned(!Access(triangle[2]));
+		}
+
+		void Flush() {
+			m_time += m_cacheSize;
+		}
+
+	private:
+		std::vector<size_t> m_timestamps;
+		size_t m_time = 0;
+		unsigned m_cacheSize;
+	};
+
+} // namespace
+
+
+VertexCacheStatistics AnalyzeVertexCache(const uint32_t* indices, size_t indexCount, size_t vertexCount, unsigned cacheSize) {
+	VertexCacheStatistics statistics;
+	FifoCache cache(vertexCount, cacheSize);
+	for (size_t i = 0; i + 2 < indexCount; i += 3) {
+		statistics.transformedVertices += cache.Misses(indices + i);
+	}
+	const size_t triangleCount = indexCount / 3;
+	statistics.acmr = triangleCount > 0 ? float(statistics.transformedVertices) / float(triangleCount) : 0.0f;
+	statistics.atvr = vertexCount > 0 ? float(statistics.transformedVertices) / float(vertexCount) : 0.0f;
+	return statistics;
+}
+
+
+//------------------------------------------------------------------------------
+// Vertex cache
+//------------------------------------------------------------------------------
+
+namespace {
+
+	constexpr unsigned ScoringCacheSize = 32;
+	constexpr unsigned ScoringValenceTableSize = 32;
+
+	struct ScoreTables {
+		ScoreTables() {
+			for (unsigned position = 0; position < ScoringCacheSize; ++position) {
+				// The last triangle's vertices get a fixed score so that strips are not preferred over fans.
+				cache[position] = position < 3 ? 0.75f : std::pow(1.0f - float(position - 3) / float(ScoringCacheSize - 3), 1.5f);
+			}
+			valence[0] = 0.0f;
+			for (unsigned remaining = 1; remaining < ScoringValenceTableSize; ++remaining) {
+				valence[remaining] = 2.0f / std::sqrt(float(remaining));
+			}
+		}
+		float cache[ScoringCacheSize];
+		float valence[ScoringValenceTableSize];
+	};
+
+
+	float VertexScore(int cachePosition, unsigned remainingTriangles) {
+		static const ScoreTables tables;
+		if (remainingTriangles == 0) {
+			return -1.0f; // Not needed anymore.
+		}
+		float score = cachePosition >= 0 ? tables.cache[cachePosition] : 0.0f;
+		score += remainingTriangles < ScoringValenceTableSize ? tables.valence[remainingTriangles] : 2.0f / std::sqrt(float(remainingTriangles));
+		return score;
+	}
+
+
+	// Triangles adjacent to each vertex. The first remaining[v] entries of a vertex are the not yet emitted ones.
+	struct Adjacency {
+		Adjacency(const uint32_t* indices, size_t indexCount, size_t vertexCount) : offsets(vertexCount + 1, 0), remaining(vertexCount, 0) {
+			for (size_t i = 0; i < indexCount; ++i) {
+				++remaining[indices[i]];
+			}
+			for (size_t v = 0; v < vertexCount; ++v) {
+				offsets[v + 1] = offsets[v] + remaining[v];
+			}
+			triangles.resize(offsets.back());
+			std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+			for (size_t i = 0; i < indexCount; ++i) {
+				triangles[fill[indices[i]]++] = uint32_t(i / 3);
+			}
+		}
+
+		void Remove(uint32_t vertex, uint32_t triangle) {
+			uint32_t* first = triangles.data() + offsets[vertex];
+			uint32_t* last = first + remaining[vertex];
+			uint32_t* it = std::find(first, last, triangle);
+			std::swap(*it, *(last - 1));
+			--remaining[vertex];
+		}
+
+		std::vector<uint32_t> offsets;
+		std::vector<uint32_t> remaining;
+		std::vector<uint32_t> triangles;
+	};
+
+} // namespace
+
+
+void OptimizeVertexCache(uint32_t* indices, size_t indexCount, size_t vertexCount) {
+	const size_t triangleCount = indexCount / 3;
+	if (triangleCount == 0) {
+		return;
+	}
+
+	Adjacency adjacency(indices, triangleCount * 3, vertexCount);
+	std::vector<int> cachePositions(vertexCount, -1);
+	std::vector<float> vertexScores(vertexCount);
+	for (size_t v = 0; v < vertexCount; ++v) {
+		vertexScores[v] = VertexScore(-1, adjacency.remaining[v]);
+	}
+	std::vector<float> triangleScores(triangleCount);
+	std::vector<bool> emitted(triangleCount, false);
+	for (size_t t = 0; t < triangleCount; ++t) {
+		const uint32_t* triangle = indices + 3 * t;
+		triangleScores[t] = vertexScores[triangle[0]] + vertexScores[triangle[1]] + vertexScores[triangle[2]];
+	}
+
+	std::vector<uint32_t> output;
+	output.reserve(triangleCount * 3);
+	std::vector<uint32_t> cache;
+	std::vector<uint32_t> newCache;
+	cache.reserve(ScoringCacheSize + 3);
+	newCache.reserve(ScoringCacheSize + 3);
+
+	size_t inputCursor = 0; // Fallback when no cached vertex has triangles left.
+	uint32_t best = uint32_t(std::max_element(triangleScores.begin(), triangleScores.end()) - triangleScores.begin());
+	while (true) {
+		const uint32_t* triangle = indices + 3 * best;
+		output.insert(output.end(), triangle, triangle + 3);
+		emitted[best] = true;
+		for (int corner = 0; corner < 3; ++corner) {
+			adjacency.Remove(triangle[corner], best);
+		}
+
+		// Move the triangle's vertices to the front of the LRU cache.
+		newCache.clear();
+		for (int corner = 0; corner < 3; ++corner) {
+			if (std::find(newCache.begin(), newCache.end(), triangle[corner]) == newCache.end()) {
+				newCache.push_back(triangle[corner]);
+			}
+		}
+		const size_t triangleVertexCount = newCache.size();
+		for (uint32_t vertex : cache) {
+			const auto triangleVerticesEnd = newCache.begin() + triangleVertexCount;
+			if (std::find(newCache.begin(), triangleVerticesEnd, vertex) == triangleVerticesEnd) {
+				newCache.push_back(vertex);
+			}
+		}
+
+		// Rescore the vertices whose cache position or valence changed, and their triangles.
+		best = std::numeric_limits<uint32_t>::max();
+		float bestScore = -1.0f;
+		for (size_t position = 0; position < newCache.size(); ++position) {
+			const uint32_t vertex = newCache[position];
+			cachePositions[vertex] = position < ScoringCacheSize ? int(position) : -1;
+			const float score = VertexScore(cachePositions[vertex], adjacency.remaining[vertex]);
+			const float delta = score - vertexScores[vertex];
+			vertexScores[vertex] = score;
+
+			const uint32_t* first = adjacency.triangles.data() + adjacency.offsets[vertex];
+			for (const uint32_t* it = first; it != first + adjacency.remaining[vertex]; ++it) {
+				triangleScores[*it] += delta;
+				if (triangleScores[*it] > bestScore) {
+					bestScore = triangleScores[*it];
+					best = *it;
+				}
+			}
+		}
+		if (newCache.size() > ScoringCacheSize) {
+			newCache.resize(ScoringCacheSize);
+		}
+		std::swap(cache, newCache);
+
+		if (best == std::numeric_limits<uint32_t>::max()) {
+			while (inputCursor < triangleCount && emitted[inputCursor]) {
+				++inputCursor;
+			}
+			if (inputCursor == triangleCount) {
+				break;
+			}
+			best = uint32_t(inputCursor);
+		}
+	}
+
+	std::copy(output.begin(), output.end(), indices);
+}
+
+
+//------------------------------------------------------------------------------
+// Overdraw
+//------------------------------------------------------------------------------
+
+void OptimizeOverdraw(uint32_t* indices, size_t indexCount, const Vec3* positions, size_t vertexCount, float threshold) {
+	constexpr unsigned CacheSize = 16;
+	const size_t triangleCount = indexCount / 3;
+	if (triangleCount == 0) {
+		return;
+	}
+
+	// Hard boundaries are where the cache starts over anyway: all three vertices of the triangle miss.
+	std::vector<unsigned> misses(triangleCount);
+	std::vector<size_t> hardBoundaries;
+	{
+		FifoCache cache(vertexCount, CacheSize);
+		for (size_t t = 0; t < triangleCount; ++t) {
+			misses[t] = cache.Misses(indices + 3 * t);
+			if (t == 0 || misses[t] == 3) {
+				hardBoundaries.push_back(t);
+			}
+		}
+		hardBoundaries.push_back(triangleCount);
+	}
+
+	// Soft boundaries split hard clusters where starting over with an empty cache costs at most threshold more.
+	std::vector<size_t> clusters;
+	{
+		FifoCache cache(vertexCount, CacheSize);
+		for (size_t h = 0; h + 1 < hardBoundaries.size(); ++h) {
+			const size_t first = hardBoundaries[h];
+			const size_t last = hardBoundaries[h + 1];
+			const unsigned clusterMisses = std::accumulate(misses.begin() + first, misses.begin() + last, 0u);
+			const float clusterAcmr = float(clusterMisses) / float(last - first);
+
+			cache.Flush();
+			clusters.push_back(first);
+			size_t start = first;
+			unsigned runningMisses = 0;
+			for (size_t t = first; t < last; ++t) {
+				runningMisses += cache.Misses(indices + 3 * t);
+				if (t + 1 < last && float(runningMisses) <= threshold * clusterAcmr * float(t + 1 - start)) {
+					cache.Flush();
+					clusters.push_back(t + 1);
+					start = t + 1;
+					runningMisses = 0;
+				}
+			}
+		}
+		clusters.push_back(triangleCount);
+	}
+
+	// Clusters facing away from the center of the mesh are drawn first as they likely occlude the rest.
+	const size_t clusterCount = clusters.size() - 1;
+	std::vector<Vec3> centroids(clusterCount);
+	std::vector<Vec3> normals(clusterCount);
+	Vec3 meshCentroid = { 0, 0, 0 };
+	float meshArea = 0.0f;
+	for (size_t c = 0; c < clusterCount; ++c) {
+		Vec3 centroid = { 0, 0, 0 };
+		Vec3 normal = { 0, 0, 0 };
+		float area = 0.0f;
+		for (size_t t = clusters[c]; t < clusters[c + 1]; ++t) {
+			const Vec3& a = positions[indices[3 * t + 0]];
+			const Vec3& b = positions[indices[3 * t + 1]];
+			const Vec3& c2 = positions[indices[3 * t + 2]];
+			const Vec3 cross = Cross(b - a, c2 - a);
+			const float triangleArea = Length(cross);
+			centroid += (a + b + c2) * (triangleArea / 3.0f);
+			normal += cross;
+			area += triangleArea;
+		}
+		meshCentroid += centroid;
+		meshArea += area;
+		centroids[c] = area > 0.0f ? centroid / area : Vec3{ 0, 0, 0 };
+		normals[c] = normal;
+	}
+	meshCentroid = meshArea > 0.0f ? meshCentroid / meshArea : Vec3{ 0, 0, 0 };
+
+	std::vector<float> sortKeys(clusterCount);
+	for (size_t c = 0; c < clusterCount; ++c) {
+		const float normalLength = Length(normals[c]);
+		sortKeys[c] = normalLength > 0.0f ? Dot(centroids[c] - meshCentroid, normals[c] / normalLength) : 0.0f;
+	}
+	std::vector<size_t> order(clusterCount);
+	std::iota(order.begin(), order.end(), size_t(0));
+	std::stable_sort(order.begin(), order.end(), [&](size_t lhs, size_t rhs) { return sortKeys[lhs] > sortKeys[rhs]; });
+
+	std::vector<uint32_t> output;
+	output.reserve(triangleCount * 3);
+	for (size_t c : order) {
+		output.insert(output.end(), indices + 3 * clusters[c], indices + 3 * clusters[c + 1]);
+	}
+	std::copy(output.begin(), output.end(), indices);
+}
+
+
+//------------------------------------------------------------------------------
+// Vertex fetch
+//------------------------------------------------------------------------------
+
+std::vector<uint32_t> OptimizeVertexFetch(uint32_t* indices, size_t indexCount, size_t vertexCount) {
+	constexpr uint32_t Unassigned = std::numeric_limits<uint32_t>::max();
+	std::vector<uint32_t> remap(vertexCount, Unassigned);
+	uint32_t next = 0;
+	for (size_t i = 0; i < indexCount; ++i) {
+		uint32_t& target = remap[indices[i]];
+		if (target == Unassigned) {
+			target = next++;
+		}
+		indices[i] = target;
+	}
+	for (auto& target : remap) {
+		if (target == Unassigned) {
+			target = next++;
+		}
+	}
+	return remap;
+}
+
+
+void RemapVertices(const void* source, void* destination, size_t vertexCount, size_t stride, const std::vector<uint32_t>& remap) {
+	auto sourceBytes = static_cast<const uint8_t*>(source);
+	auto destinationBytes = static_cast<uint8_t*>(destination);
+	for (size_t v = 0; v < vertexCount; ++v) {
+		std::memcpy(destinationBytes + remap[v] * stride, sourceBytes + v * stride, stride);
+	}
+}
+
+
+//------------------------------------------------------------------------------
+// Meshlets
+//------------------------------------------------------------------------------
+
+static void ComputeMeshletBounds(Meshlet& meshlet, const MeshletBuffers& buffers, const Vec3* positions) {
+	const uint32_t* vertices = buffers.vertices.data() + meshlet.vertexOffset;
+	const uint8_t* triangles = buffers.triangles.data() + 3 * meshlet.triangleOffset;
+
+	Vec3 boundsMin = positions[vertices[0]];
+	Vec3 boundsMax = boundsMin;
+	for (uint32_t v = 1; v < meshlet.vertexCount; ++v) {
+		boundsMin = Min(boundsMin, positions[vertices[v]]);
+		boundsMax = Max(boundsMax, positions[vertices[v]]);
+	}
+	const Vec3 center = (boundsMin + boundsMax) * 0.5f;
+	float radius = 0.0f;
+	for (uint32_t v = 0; v < meshlet.vertexCount; ++v) {
+		radius = std::max(radius, Length(positions[vertices[v]] - center));
+	}
+
+	std::vector<Vec3> normals;
+	Vec3 axis = { 0, 0, 0 };
+	for (uint32_t t = 0; t < meshlet.triangleCount; ++t) {
+		const Vec3& a = positions[vertices[triangles[3 * t + 0]]];
+		const Vec3& b = positions[vertices[triangles[3 * t + 1]]];
+		const Vec3& c = positions[vertices[triangles[3 * t + 2]]];
+		const Vec3 normal = Cross(b - a, c - a);
+		const float length = Length(normal);
+		if (length > 0.0f) {
+			normals.push_back(normal / length);
+			axis += normals.back();
+		}
+	}
+	const float axisLength = Length(axis);
+	float minDot = 1.0f;
+	for (const auto& normal : normals) {
+		minDot = std::min(minDot, axisLength > 0.0f ? Dot(normal, axis / axisLength) : -1.0f);
+	}
+
+	meshlet.center = center;
+	meshlet.radius = radius;
+	if (normals.empty() || minDot <= 0.0f) {
+		meshlet.coneAxis = Vec3{ 0, 0, 0 };
+		meshlet.coneCutoff = 1.0f;
+	}
+	else {
+		meshlet.coneAxis = axis / axisLength;
+		meshlet.coneCutoff = std::sqrt(1.0f - minDot * minDot);
+	}
+}
+
+
+MeshletBuffers BuildMeshlets(const uint32_t* indices, size_t indexCount, const Vec3* positions, size_t vertexCount, unsigned maxVertices, unsigned maxTriangles) {
+	if (maxVertices < 3 || maxVertices > 256 || maxTriangles < 1) {
+		throw InvalidArgumentException("Meshlets must hold 3 to 256 vertices and at least one triangle.");
+	}
+
+	constexpr uint16_t NotInMeshlet = 0xFFFF;
+	std::vector<uint16_t> localIndices(vertexCount, NotInMeshlet);
+
+	MeshletBuffers buffers;
+	Meshlet meshlet = {};
+	auto Finish = [&] {
+		for (uint32_t v = 0; v < meshlet.vertexCount; ++v) {
+			localIndices[buffers.vertices[meshlet.vertexOffset + v]] = NotInMeshlet;
+		}
+		ComputeMeshletBounds(meshlet, buffers, positions);
+		buffers.meshlets.push_back(meshlet);
+		meshlet = {};
+		meshlet.vertexOffset = uint32_t(buffers.vertices.size());
+		meshlet.triangleOffset = uint32_t(buffers.triangles.size() / 3);
+	};
+
+	for (size_t i = 0; i + 2 < indexCount; i += 3) {
+		const uint32_t* triangle = indices + i;
+		unsigned newVertices = 0;
+		for (int corner = 0; corner < 3; ++corner) {
+			const bool repeated = (corner > 0 && triangle[corner] == triangle[0]) || (corner > 1 && triangle[corner] == triangle[1]);
+			newVertices += localIndices[triangle[corner]] == NotInMeshlet && !repeated;
+		}
+		if (meshlet.vertexCount + newVertices > maxVertices || meshlet.triangleCount + 1 > maxTriangles) {
+			Finish();
+		}
+
+		for (int corner = 0; corner < 3; ++corner) {
+			uint16_t& local = localIndices[triangle[corner]];
+			if (local == NotInMeshlet) {
+				local = uint16_t(meshlet.vertexCount++);
+				buffers.vertices.push_back(triangle[corner]);
+			}
+			buffers.triangles.push_back(uint8_t(local));
+		}
+		++meshlet.triangleCount;
+	}
+	if (meshlet.triangleCount > 0) {
+		Finish();
+	}
+
+	return buffers;
+}
+
+
+} // namespace inl::gxeng
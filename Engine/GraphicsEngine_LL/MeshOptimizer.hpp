@@ -0,0 +1,65 @@
+#pragma once
+
+#include <InlineMath.hpp>
+#include <cstdint>
+#include <vector>
+
+
+namespace inl::gxeng {
+
+
+/// <summary> Efficiency of an index buffer on a simulated FIFO post-transform cache. </summary>
+struct VertexCacheStatistics {
+	size_t transformedVertices = 0; // Number of cache misses.
+	float acmr = 0.0f; // Average cache miss ratio: transformed vertices per triangle, 0.5 at best and 3 at worst.
+	float atvr = 0.0f; // Average transform to vertex ratio: transformed vertices per vertex, 1 at best.
+};
+
+
+/// <summary> A small cluster of triangles that fits the limits of a mesh shader workgroup. </summary>
+struct Meshlet {
+	uint32_t vertexOffset; // First entry in <see cref="MeshletBuffers::vertices"/>.
+	uint32_t vertexCount;
+	uint32_t triangleOffset; // First entry in <see cref="MeshletBuffers::triangles"/>, in triangles.
+	uint32_t triangleCount;
+	Vec3_Packed center; // Bounding sphere.
+	float radius;
+	Vec3_Packed coneAxis; // Normal cone, see <see cref="BuildMeshlets"/>.
+	float coneCutoff;
+};
+
+
+struct MeshletBuffers {
+	std::vector<Meshlet> meshlets;
+	std::vector<uint32_t> vertices; // Mesh vertex indices referenced by the meshlets.
+	std::vector<uint8_t> triangles; // Three meshlet-local vertex indices per triangle.
+};
+
+
+/// <summary> Simulates a FIFO post-transform vertex cache of the given size. </summary>
+VertexCacheStatistics AnalyzeVertexCache(const uint32_t* indices, size_t indexCount, size_t vertexCount, unsigned cacheSize = 16);
+
+/// <summary> Reorders the triangles in place so that consecutive triangles reuse recently transformed vertices. </summary>
+/// <remarks> Tom Forsyth's linear speed algorithm, which does not depend on the exact size of the hardware cache. </remarks>
+void OptimizeVertexCache(uint32_t* indices, size_t indexCount, size_t vertexCount);
+
+/// <summary> Reorders clusters of an already cache optimized index buffer to draw outward facing surfaces first. </summary>
+/// <param name="threshold"> How much the cache miss ratio may grow in exchange for finer clusters, 1.05 allows 5%. </param>
+void OptimizeOverdraw(uint32_t* indices, size_t indexCount, const Vec3* positions, size_t vertexCount, float threshold = 1.05f);
+
+/// <summary> Renumbers vertices in the order the indices first reference them, so vertex fetch reads memory linearly. </summary>
+/// <returns> The new index of each original vertex. Unreferenced vertices are moved to the end in their original order. </returns>
+std::vector<uint32_t> OptimizeVertexFetch(uint32_t* indices, size_t indexCount, size_t vertexCount);
+
+/// <summary> Moves each vertex of <paramref name="source"/> to its new index in <paramref name="destination"/>. </summary>
+void RemapVertices(const void* source, void* destination, size_t vertexCount, size_t stride, const std::vector<uint32_t>& remap);
+
+/// <summary> Splits the triangles into meshlets in index order, so run it after <see cref="OptimizeVertexCache"/>. </summary>
+/// <remarks> A meshlet is entirely backfacing if
+///		dot(normalize(center - cameraPosition), coneAxis) >= coneCutoff + radius / length(center - cameraPosition).
+///		Meshlets whose normals span a hemisphere or more have a cutoff of 1 and are never culled. </remarks>
+/// <exception cref="InvalidArgumentException"> If the limits are less than one triangle or more than 8 bit local indices allow. </exception>
+MeshletBuffers BuildMeshlets(const uint32_t* indices, size_t indexCount, const Vec3* positions, size_t vertexCount, unsigned maxVertices = 64, unsigned maxTriangles = 124);
+
+
+} // namespace inl::gxeng
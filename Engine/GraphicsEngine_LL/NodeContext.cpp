@@ -39,13 +39,17 @@ SetupContext::SetupContext(MemoryManager* memoryManager,
 						   RTVHeap* rtvHeap,
 						   DSVHeap* dsvHeap,
 						   ShaderManager* shaderManager,
-						   gxapi::IGraphicsApi* graphicsApi)
+						   gxapi::IGraphicsApi* graphicsApi,
+						   TransientLifetime taskLifetime,
+						   TransientLifetime outputLifetime)
 	: m_memoryManager(memoryManager),
 	  m_srvHeap(srvHeap),
 	  m_rtvHeap(rtvHeap),
 	  m_dsvHeap(dsvHeap),
 	  m_shaderManager(shaderManager),
-	  m_graphicsApi(graphicsApi) {}
+	  m_graphicsApi(graphicsApi),
+	  m_taskLifetime(taskLifetime),
+	  m_outputLifetime(outputLifetime) {}
 
 
 Texture2D SetupContext::CreateTexture2D(const Texture2DDesc& desc, const TextureUsage& usage) const {
@@ -64,6 +68,22 @@ Texture2D SetupContext::CreateTexture2D(const Texture2DDesc& desc, const Texture
 	return texture;
 }
 
+Texture2D SetupContext::CreateTransientTexture2D(const Texture2DDesc& desc, const TextureUsage& usage, eTransientLifetime lifetime) const {
+	gxapi::eResourceFlags flags;
+
+	if (!usage.shaderResource)
+		flags += gxapi::eResourceFlags::DENY_SHADER_RESOURCE;
+	if (usage.renderTarget)
+		flags += gxapi::eResourceFlags::ALLOW_RENDER_TARGET;
+	if (usage.depthStencil)
+		flags += gxapi::eResourceFlags::ALLOW_DEPTH_STENCIL;
+	if (usage.randomAccess)
+		flags += gxapi::eResourceFlags::ALLOW_UNORDERED_ACCESS;
+
+	Texture2D texture = m_memoryManager->CreateTransientTexture2D(desc, flags, lifetime == eTransientLifetime::TASK ? m_taskLifetime : m_outputLifetime);
+	return texture;
+}
+
 Texture3D SetupContext::CreateTexture3D(const Texture3DDesc& desc, const TextureUsage& usage) const {
 	gxapi::eResourceFlags flags;
 
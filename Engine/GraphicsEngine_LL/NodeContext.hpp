@@ -74,6 +74,13 @@ enum class eResourceUsage {
 	DOWNLOAD
 };
 
+enum class eTransientLifetime {
+	/// <summary> The texture is only used by the task that creates it. </summary>
+	TASK,
+	/// <summary> The texture is also read by the nodes directly connected to the outputs. </summary>
+	OUTPUT,
+};
+
 
 class SetupContext {
 public:
@@ -82,7 +89,9 @@ public:
 				 RTVHeap* rtvHeap = nullptr,
 				 DSVHeap* dsvHeap = nullptr,
 				 ShaderManager* shaderManager = nullptr,
-				 gxapi::IGraphicsApi* graphicsApi = nullptr);
+				 gxapi::IGraphicsApi* graphicsApi = nullptr,
+				 TransientLifetime taskLifetime = {},
+				 TransientLifetime outputLifetime = {});
 	SetupContext(SetupContext&&) = delete;
 	SetupContext& operator=(SetupContext&&) = delete;
 	SetupContext(const SetupContext&) = delete;
@@ -92,6 +101,10 @@ public:
 	// Create resources
 	Texture2D CreateTexture2D(const Texture2DDesc& desc, const TextureUsage& usage) const;
 	Texture3D CreateTexture3D(const Texture3DDesc& desc, const TextureUsage& usage) const;
+	/// <summary> Creates a texture that shares memory with other transient textures not alive at the same time. </summary>
+	/// <remarks> The contents are undefined when the texture is first used in the frame, it has to be fully overwritten.
+	///		Must not be forwarded further than the lifetime allows, i.e. through pass-through nodes. </remarks>
+	Texture2D CreateTransientTexture2D(const Texture2DDesc& desc, const TextureUsage& usage, eTransientLifetime lifetime = eTransientLifetime::OUTPUT) const;
 	VertexBuffer CreateVertexBuffer(size_t size) const;
 	IndexBuffer CreateIndexBuffer(size_t size, size_t indexCount) const;
 
@@ -125,6 +138,10 @@ private:
 	// Shaders and PSOs
 	ShaderManager* m_shaderManager;
 	gxapi::IGraphicsApi* m_graphicsApi;
+
+	// Position of the task in the frame
+	TransientLifetime m_taskLifetime;
+	TransientLifetime m_outputLifetime;
 };
 
 
@@ -10,7 +10,10 @@ OverlayEntity::OverlayEntity() {
 
 
 void OverlayEntity::SetMesh(std::shared_ptr<Mesh> mesh) {
-	m_mesh = mesh;
+	if (m_mesh != mesh) {
+		m_mesh = mesh;
+		Modified();
+	}
 }
 
 
@@ -23,7 +26,10 @@ const std::shared_ptr<Mesh>& OverlayEntity::GetMeshNative() const {
 }
 
 void OverlayEntity::SetColor(Vec4 color) {
-	m_color = color;
+	if (m_color != color) {
+		m_color = color;
+		Modified();
+	}
 }
 
 
@@ -33,7 +39,10 @@ Vec4 OverlayEntity::GetColor() const {
 
 
 void OverlayEntity::SetTexture(std::shared_ptr<Image> texture) {
-	m_texture = texture;
+	if (m_texture != texture) {
+		m_texture = texture;
+		Modified();
+	}
 }
 
 
@@ -47,7 +56,10 @@ const std::shared_ptr<Image>& OverlayEntity::GetTextureNative() const {
 
 
 void OverlayEntity::SetZDepth(float z) {
-	m_zDepth = z;
+	if (m_zDepth != z) {
+		m_zDepth = z;
+		Modified();
+	}
 }
 float OverlayEntity::GetZDepth() const {
 	return m_zDepth;
@@ -57,18 +69,24 @@ float OverlayEntity::GetZDepth() const {
 void OverlayEntity::SetAdditionalClip(RectF clipRectangle, Mat33 transform) {
 	m_clipRect = clipRectangle;
 	m_clipRectTransform = transform;
+	Modified();
 }
 std::pair<RectF, Mat33> OverlayEntity::GetAdditionalClip() const {
 	return { m_clipRect, m_clipRectTransform };
 }
 void OverlayEntity::EnableAdditionalClip(bool enabled) {
-	m_clipEnabled = enabled;
+	if (m_clipEnabled != enabled) {
+		m_clipEnabled = enabled;
+		Modified();
+	}
 }
 bool OverlayEntity::IsAdditionalClipEnabled() const {
 	return m_clipEnabled;
 }
 
 Transform2D& OverlayEntity::Transform() {
+	// The transform may be changed through the reference.
+	Modified();
 	return m_transform;
 }
 
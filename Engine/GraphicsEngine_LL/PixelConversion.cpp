@@ -0,0 +1,362 @@
+#include "PixelConversion.hpp"
+
+#include <BaseLibrary/Exception/Exception.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define INL_PIXEL_CONVERSION_X86 1
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+
+namespace inl::gxeng {
+
+
+//------------------------------------------------------------------------------
+// Single values
+//------------------------------------------------------------------------------
+
+namespace impl {
+
+	static uint32_t FloatBits(float value) {
+		uint32_t bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+		return bits;
+	}
+
+	static float BitsFloat(uint32_t bits) {
+		float value;
+		std::memcpy(&value, &bits, sizeof(value));
+		return value;
+	}
+
+
+	uint16_t FloatToHalf(float value) {
+		constexpr uint32_t f32Infinity = 255u << 23;
+		constexpr uint32_t f16Max = (127u + 16u) << 23;
+		constexpr uint32_t denormMagic = ((127u - 15u) + (23u - 10u) + 1u) << 23;
+
+		uint32_t bits = FloatBits(value);
+		const uint32_t sign = bits & 0x8000'0000u;
+		bits ^= sign;
+
+		uint32_t result;
+		if (bits >= f16Max) {
+			result = bits > f32Infinity ? 0x7E00 : 0x7C00; // NaN stays NaN, the rest becomes infinity.
+		}
+		else if (bits < (113u << 23)) {
+			// Denormals are rounded by the float addition.
+			result = FloatBits(BitsFloat(bits) + BitsFloat(denormMagic)) - denormMagic;
+		}
+		else {
+			const uint32_t mantissaOdd = (bits >> 13) & 1;
+			bits += ((15u - 127u) << 23) + 0xFFF;
+			bits += mantissaOdd;
+			result = bits >> 13;
+		}
+		return uint16_t(result | (sign >> 16));
+	}
+
+
+	float HalfToFloat(uint16_t value) {
+		constexpr uint32_t shiftedExponent = 0x7C00u << 13;
+		constexpr uint32_t magic = 113u << 23;
+
+		uint32_t bits = (value & 0x7FFFu) << 13;
+		const uint32_t exponent = shiftedExponent & bits;
+		bits += (127u - 15u) << 23;
+		if (exponent == shiftedExponent) {
+			bits += (128u - 16u) << 23; // Infinity or NaN.
+		}
+		else if (exponent == 0) {
+			bits += 1u << 23; // Denormal, renormalize.
+			bits = FloatBits(BitsFloat(bits) - BitsFloat(magic));
+		}
+		return BitsFloat(bits | (uint32_t(value & 0x8000u) << 16));
+	}
+
+
+	float SrgbToLinear(float value) {
+		return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+	}
+
+
+	float LinearToSrgb(float value) {
+		return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+	}
+
+
+	const std::array<float, 256>& GetSrgbToLinearTable() {
+		static const std::array<float, 256> table = [] {
+			std::array<float, 256> values;
+			for (size_t i = 0; i < values.size(); ++i) {
+				values[i] = SrgbToLinear(float(i) / 255.0f);
+			}
+			return values;
+		}();
+		return table;
+	}
+
+} // namespace impl
+
+
+
+//------------------------------------------------------------------------------
+// Scalar implementation
+//------------------------------------------------------------------------------
+
+template <class T>
+static void ExpandRgbToRgbaScalar(const T* source, T* destination, size_t count, T alpha) {
+	for (size_t i = 0; i < count; ++i) {
+		destination[4 * i + 0] = source[3 * i + 0];
+		destination[4 * i + 1] = source[3 * i + 1];
+		destination[4 * i + 2] = source[3 * i + 2];
+		destination[4 * i + 3] = alpha;
+	}
+}
+
+
+static void SwizzleRgba8Scalar(const uint8_t* source, uint8_t* destination, size_t count, std::array<uint8_t, 4> order) {
+	for (size_t i = 0; i < count; ++i) {
+		const uint8_t pixel[4] = { source[4 * i + 0], source[4 * i + 1], source[4 * i + 2], source[4 * i + 3] };
+		for (int c = 0; c < 4; ++c) {
+			destination[4 * i + c] = pixel[order[c]];
+		}
+	}
+}
+
+
+template <class T>
+static void UnormToFloatScalar(const T* source, float* destination, size_t count) {
+	constexpr float scale = 1.0f / float(T(~T(0)));
+	for (size_t i = 0; i < count; ++i) {
+		destination[i] = source[i] * scale;
+	}
+}
+
+
+template <class T>
+static void FloatToUnormScalar(const float* source, T* destination, size_t count) {
+	constexpr float scale = float(T(~T(0)));
+	for (size_t i = 0; i < count; ++i) {
+		// Written so that NaN becomes 0, the same as the SIMD max.
+		float value = source[i] > 0.0f ? (source[i] < 1.0f ? source[i] : 1.0f) : 0.0f;
+		destination[i] = T(std::lrint(value * scale));
+	}
+}
+
+
+static void FloatToHalfScalar(const float* source, uint16_t* destination, size_t count) {
+	for (size_t i = 0; i < count; ++i) {
+		destination[i] = impl::FloatToHalf(source[i]);
+	}
+}
+
+
+static void HalfToFloatScalar(const uint16_t* source, float* destination, size_t count) {
+	for (size_t i = 0; i < count; ++i) {
+		destination[i] = impl::HalfToFloat(source[i]);
+	}
+}
+
+
+static void SrgbToLinearScalar(const float* source, float* destination, size_t count) {
+	for (size_t i = 0; i < count; ++i) {
+		destination[i] = impl::SrgbToLinear(source[i]);
+	}
+}
+
+
+static void LinearToSrgbScalar(const float* source, float* destination, size_t count) {
+	for (size_t i = 0; i < count; ++i) {
+		destination[i] = impl::LinearToSrgb(source[i]);
+	}
+}
+
+
+static void Srgb8ToLinearScalar(const uint8_t* source, float* destination, size_t count) {
+	const auto& table = impl::GetSrgbToLinearTable();
+	for (size_t i = 0; i < count; ++i) {
+		destination[i] = table[source[i]];
+	}
+}
+
+
+const impl::PixelConversionTable& impl::GetScalarPixelConversions() {
+	static const PixelConversionTable table = {
+		&ExpandRgbToRgbaScalar<uint8_t>,
+		&ExpandRgbToRgbaScalar<uint16_t>,
+		&ExpandRgbToRgbaScalar<uint32_t>,
+		&SwizzleRgba8Scalar,
+		&UnormToFloatScalar<uint8_t>,
+		&UnormToFloatScalar<uint16_t>,
+		&FloatToUnormScalar<uint8_t>,
+		&FloatToUnormScalar<uint16_t>,
+		&FloatToHalfScalar,
+		&HalfToFloatScalar,
+		&SrgbToLinearScalar,
+		&LinearToSrgbScalar,
+		&Srgb8ToLinearScalar,
+	};
+	return table;
+}
+
+
+
+//------------------------------------------------------------------------------
+// Dispatch
+//------------------------------------------------------------------------------
+
+static eSimdLevel DetectSimdLevel() {
+#ifdef INL_PIXEL_CONVERSION_X86
+	unsigned leaf1[4] = {};
+	unsigned leaf7[4] = {};
+#ifdef _MSC_VER
+	int regs[4];
+	__cpuid(regs, 1);
+	std::memcpy(leaf1, regs, sizeof(regs));
+	__cpuidex(regs, 7, 0);
+	std::memcpy(leaf7, regs, sizeof(regs));
+#else
+	__get_cpuid(1, &leaf1[0], &leaf1[1], &leaf1[2], &leaf1[3]);
+	__get_cpuid_count(7, 0, &leaf7[0], &leaf7[1], &leaf7[2], &leaf7[3]);
+#endif
+
+	const bool sse2 = (leaf1[3] >> 26) & 1;
+	const bool osxsave = (leaf1[2] >> 27) & 1;
+	const bool avx = (leaf1[2] >> 28) & 1;
+	const bool f16c = (leaf1[2] >> 29) & 1;
+	const bool avx2 = (leaf7[1] >> 5) & 1;
+
+	// The OS must also save the YMM registers on context switches.
+	bool ymmEnabled = false;
+	if (osxsave) {
+#ifdef _MSC_VER
+		ymmEnabled = (_xgetbv(0) & 6) == 6;
+#else
+		unsigned eax, edx;
+		__asm__("xgetbv"
+				: "=a"(eax), "=d"(edx)
+				: "c"(0));
+		ymmEnabled = (eax & 6) == 6;
+#endif
+	}
+
+	if (avx && avx2 && f16c && ymmEnabled) {
+		return eSimdLevel::AVX2;
+	}
+	if (sse2) {
+		return eSimdLevel::SSE2;
+	}
+#endif
+	return eSimdLevel::SCALAR;
+}
+
+
+static eSimdLevel SupportedLevel() {
+	static const eSimdLevel level = DetectSimdLevel();
+	return level;
+}
+
+
+static std::atomic<eSimdLevel>& CurrentLevel() {
+	static std::atomic<eSimdLevel> level{ SupportedLevel() };
+	return level;
+}
+
+
+static const impl::PixelConversionTable& Conversions() {
+	switch (CurrentLevel().load(std::memory_order_relaxed)) {
+		case eSimdLevel::AVX2: return impl::GetAvx2PixelConversions();
+		case eSimdLevel::SSE2: return impl::GetSse2PixelConversions();
+		default: return impl::GetScalarPixelConversions();
+	}
+}
+
+
+eSimdLevel GetPixelConversionLevel() {
+	return CurrentLevel().load(std::memory_order_relaxed);
+}
+
+
+eSimdLevel SetPixelConversionLevel(eSimdLevel level) {
+	level = std::min(level, SupportedLevel());
+	CurrentLevel().store(level, std::memory_order_relaxed);
+	return level;
+}
+
+
+
+//------------------------------------------------------------------------------
+// Conversions
+//------------------------------------------------------------------------------
+
+void ExpandRgbToRgba(const void* source, void* destination, size_t count, size_t channelSize, uint32_t alpha) {
+	switch (channelSize) {
+		case 1: Conversions().expandRgbToRgba8(static_cast<const uint8_t*>(source), static_cast<uint8_t*>(destination), count, uint8_t(alpha)); break;
+		case 2: Conversions().expandRgbToRgba16(static_cast<const uint16_t*>(source), static_cast<uint16_t*>(destination), count, uint16_t(alpha)); break;
+		case 4: Conversions().expandRgbToRgba32(static_cast<const uint32_t*>(source), static_cast<uint32_t*>(destination), count, alpha); break;
+		default: throw InvalidArgumentException("Channels must be 1, 2 or 4 bytes.");
+	}
+}
+
+
+void SwizzleRgba8(const uint8_t* source, uint8_t* destination, size_t count, std::array<uint8_t, 4> order) {
+	Conversions().swizzleRgba8(source, destination, count, order);
+}
+
+
+void UnormToFloat(const uint8_t* source, float* destination, size_t count) {
+	Conversions().unorm8ToFloat(source, destination, count);
+}
+
+
+void UnormToFloat(const uint16_t* source, float* destination, size_t count) {
+	Conversions().unorm16ToFloat(source, destination, count);
+}
+
+
+void FloatToUnorm(const float* source, uint8_t* destination, size_t count) {
+	Conversions().floatToUnorm8(source, destination, count);
+}
+
+
+void FloatToUnorm(const float* source, uint16_t* destination, size_t count) {
+	Conversions().floatToUnorm16(source, destination, count);
+}
+
+
+void FloatToHalf(const float* source, uint16_t* destination, size_t count) {
+	Conversions().floatToHalf(source, destination, count);
+}
+
+
+void HalfToFloat(const uint16_t* source, float* destination, size_t count) {
+	Conversions().halfToFloat(source, destination, count);
+}
+
+
+void SrgbToLinear(const float* source, float* destination, size_t count) {
+	Conversions().srgbToLinear(source, destination, count);
+}
+
+
+void LinearToSrgb(const float* source, float* destination, size_t count) {
+	Conversions().linearToSrgb(source, destination, count);
+}
+
+
+void SrgbToLinear(const uint8_t* source, float* destination, size_t count) {
+	Conversions().srgb8ToLinear(source, destination, count);
+}
+
+
+} // namespace inl::gxeng
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+
+namespace inl::gxeng {
+
+
+/// <summary> Instruction sets the pixel conversions can be implemented with. </summary>
+enum class eSimdLevel {
+	SCALAR,
+	SSE2,
+	AVX2, // Includes F16C for half floats.
+};
+
+
+/// <summary> Returns the instruction set the conversions currently use. </summary>
+/// <remarks> By default the best one the CPU supports, detected at the first call. </remarks>
+eSimdLevel GetPixelConversionLevel();
+
+/// <summary> Forces the conversions to use at most the given instruction set, mainly for benchmarking. </summary>
+/// <returns> The level actually in use, which is lower if the CPU does not support the requested one. </returns>
+eSimdLevel SetPixelConversionLevel(eSimdLevel level);
+
+
+// All conversions work on tightly packed arrays of <paramref name="count"/> pixels or values.
+// Source and destination must not overlap.
+
+/// <summary> Appends an alpha channel to RGB pixels of 1, 2 or 4 bytes per channel. </summary>
+/// <param name="alpha"> The bytes of the alpha channel, only the lowest <paramref name="channelSize"/> bytes are used. </param>
+void ExpandRgbToRgba(const void* source, void* destination, size_t count, size_t channelSize, uint32_t alpha = 0);
+
+/// <summary> Reorders the channels of RGBA8 pixels. </summary>
+/// <param name="order"> For each destination channel, the index of the source channel, i.e. {2, 1, 0, 3} swaps red and blue. </param>
+void SwizzleRgba8(const uint8_t* source, uint8_t* destination, size_t count, std::array<uint8_t, 4> order);
+
+/// <summary> Converts normalized integers to floats in [0, 1]. </summary>
+void UnormToFloat(const uint8_t* source, float* destination, size_t count);
+void UnormToFloat(const uint16_t* source, float* destination, size_t count);
+
+/// <summary> Converts floats to normalized integers, clamping to [0, 1] and rounding to nearest. </summary>
+void FloatToUnorm(const float* source, uint8_t* destination, size_t count);
+void FloatToUnorm(const float* source, uint16_t* destination, size_t count);
+
+/// <summary> Converts between single and half precision floats, rounding to nearest even. </summary>
+void FloatToHalf(const float* source, uint16_t* destination, size_t count);
+void HalfToFloat(const uint16_t* source, float* destination, size_t count);
+
+/// <summary> Applies the sRGB transfer functions. Alpha must be handled separately. </summary>
+void SrgbToLinear(const float* source, float* destination, size_t count);
+void LinearToSrgb(const float* source, float* destination, size_t count);
+
+/// <summary> Decodes sRGB encoded bytes to linear floats. </summary>
+void SrgbToLinear(const uint8_t* source, float* destination, size_t count);
+
+
+namespace impl {
+
+	/// <summary> One implementation of every conversion for a given instruction set. </summary>
+	struct PixelConversionTable {
+		void (*expandRgbToRgba8)(const uint8_t*, uint8_t*, size_t, uint8_t);
+		void (*expandRgbToRgba16)(const uint16_t*, uint16_t*, size_t, uint16_t);
+		void (*expandRgbToRgba32)(const uint32_t*, uint32_t*, size_t, uint32_t);
+		void (*swizzleRgba8)(const uint8_t*, uint8_t*, size_t, std::array<uint8_t, 4>);
+		void (*unorm8ToFloat)(const uint8_t*, float*, size_t);
+		void (*unorm16ToFloat)(const uint16_t*, float*, size_t);
+		void (*floatToUnorm8)(const float*, uint8_t*, size_t);
+		void (*floatToUnorm16)(const float*, uint16_t*, size_t);
+		void (*floatToHalf)(const float*, uint16_t*, size_t);
+		void (*halfToFloat)(const uint16_t*, float*, size_t);
+		void (*srgbToLinear)(const float*, float*, size_t);
+		void (*linearToSrgb)(const float*, float*, size_t);
+		void (*srgb8ToLinear)(const uint8_t*, float*, size_t);
+	};
+
+	// Implementations per instruction set, the SIMD ones convert the remainder with the scalar functions.
+	const PixelConversionTable& GetScalarPixelConversions();
+	const PixelConversionTable& GetSse2PixelConversions();
+	const PixelConversionTable& GetAvx2PixelConversions();
+
+	// Scalar conversions of single values, shared by the implementations.
+	uint16_t FloatToHalf(float value);
+	float HalfToFloat(uint16_t value);
+	float SrgbToLinear(float value);
+	float LinearToSrgb(float value);
+	const std::array<float, 256>& GetSrgbToLinearTable();
+
+} // namespace impl
+
+
+} // namespace inl::gxeng
@@ -0,0 +1,274 @@
+#include "PixelConversion.hpp"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define INL_PIXEL_CONVERSION_X86 1
+#include <immintrin.h>
+#endif
+
+#include <cstring>
+
+
+// This file is compiled with AVX2 and F16C enabled and only called when the CPU supports them.
+// Avoid calling inline functions and templates from headers here: the linker may keep their
+// AVX2 compiled copy for the whole program, which then crashes on older CPUs.
+
+
+namespace inl::gxeng {
+
+
+#ifdef INL_PIXEL_CONVERSION_X86
+
+
+//------------------------------------------------------------------------------
+// Helpers
+//------------------------------------------------------------------------------
+
+static __m256 Log2(__m256 x) {
+	const __m256 one = _mm256_set1_ps(1.0f);
+	const __m256i bits = _mm256_castps_si256(x);
+	const __m256 exponent = _mm256_cvtepi32_ps(_mm256_sub_epi32(_mm256_srli_epi32(bits, 23), _mm256_set1_epi32(127)));
+	const __m256 mantissa = _mm256_castsi256_ps(_mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi32(0x007F'FFFF)), _mm256_castps_si256(one)));
+
+	// log2(m) = 2/ln(2) * atanh(t), where t = (m-1)/(m+1) is in [0, 1/3).
+	const __m256 t = _mm256_div_ps(_mm256_sub_ps(mantissa, one), _mm256_add_ps(mantissa, one));
+	const __m256 t2 = _mm256_mul_ps(t, t);
+	__m256 series = _mm256_set1_ps(1.0f / 9.0f);
+	series = _mm256_add_ps(_mm256_mul_ps(series, t2), _mm256_set1_ps(1.0f / 7.0f));
+	series = _mm256_add_ps(_mm256_mul_ps(series, t2), _mm256_set1_ps(1.0f / 5.0f));
+	series = _mm256_add_ps(_mm256_mul_ps(series, t2), _mm256_set1_ps(1.0f / 3.0f));
+	series = _mm256_add_ps(_mm256_mul_ps(series, t2), one);
+	return _mm256_add_ps(exponent, _mm256_mul_ps(_mm256_mul_ps(series, t), _mm256_set1_ps(2.8853900817779268f)));
+}
+
+
+static __m256 Exp2(__m256 x) {
+	x = _mm256_min_ps(_mm256_max_ps(x, _mm256_set1_ps(-126.0f)), _mm256_set1_ps(127.0f));
+	const __m256i whole = _mm256_cvtps_epi32(x);
+	const __m256 y = _mm256_mul_ps(_mm256_sub_ps(x, _mm256_cvtepi32_ps(whole)), _mm256_set1_ps(0.69314718055994531f));
+
+	// Taylor series of e^y for y in [-ln(2)/2, ln(2)/2].
+	__m256 series = _mm256_set1_ps(1.0f / 720.0f);
+	series = _mm256_add_ps(_mm256_mul_ps(series, y), _mm256_set1_ps(1.0f / 120.0f));
+	series = _mm256_add_ps(_mm256_mul_ps(series, y), _mm256_set1_ps(1.0f / 24.0f));
+	series = _mm256_add_ps(_mm256_mul_ps(series, y), _mm256_set1_ps(1.0f / 6.0f));
+	series = _mm256_add_ps(_mm256_mul_ps(series, y), _mm256_set1_ps(1.0f / 2.0f));
+	series = _mm256_add_ps(_mm256_mul_ps(series, y), _mm256_set1_ps(1.0f));
+	series = _mm256_add_ps(_mm256_mul_ps(series, y), _mm256_set1_ps(1.0f));
+	const __m256 scale = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_add_epi32(whole, _mm256_set1_epi32(127)), 23));
+	return _mm256_mul_ps(series, scale);
+}
+
+
+static __m256 Pow(__m256 x, float exponent) {
+	return Exp2(_mm256_mul_ps(Log2(x), _mm256_set1_ps(exponent)));
+}
+
+
+
+//------------------------------------------------------------------------------
+// Conversions
+//------------------------------------------------------------------------------
+
+template <class T>
+static void ExpandRgbToRgbaAvx2(const T* source, T* destination, size_t count, T alpha) {
+	constexpr size_t ChannelSize = sizeof(T);
+	constexpr size_t BlockPixels = 8 / ChannelSize;
+	constexpr size_t LoadPixels = (32 + 3 * ChannelSize - 1) / (3 * ChannelSize);
+
+	// Bytes 0-11 go to the lower lane and 12-23 to the upper one, then each lane is spread to 16 bytes.
+	const __m256i split = _mm256_setr_epi32(0, 1, 2, 0, 3, 4, 5, 0);
+	__m256i spread;
+	__m256i alphaVector;
+	if constexpr (ChannelSize == 1) {
+		spread = _mm256_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1,
+								  0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+		alphaVector = _mm256_set1_epi32(int32_t(uint32_t(alpha) << 24));
+	}
+	else if constexpr (ChannelSize == 2) {
+		spread = _mm256_setr_epi8(0, 1, 2, 3, 4, 5, -1, -1, 6, 7, 8, 9, 10, 11, -1, -1,
+								  0, 1, 2, 3, 4, 5, -1, -1, 6, 7, 8, 9, 10, 11, -1, -1);
+		alphaVector = _mm256_set1_epi64x(int64_t(uint64_t(alpha) << 48));
+	}
+	else {
+		spread = _mm256_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, -1, -1, -1, -1,
+								  0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, -1, -1, -1, -1);
+		alphaVector = _mm256_setr_epi32(0, 0, 0, int32_t(alpha), 0, 0, 0, int32_t(alpha));
+	}
+
+	// Each block loads 32 bytes but uses only 24, so stop early enough not to read past the end.
+	size_t i = 0;
+	for (; i + LoadPixels <= count; i += BlockPixels) {
+		const __m256i rgb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + 3 * i));
+		const __m256i rgba = _mm256_or_si256(_mm256_shuffle_epi8(_mm256_permutevar8x32_epi32(rgb, split), spread), alphaVector);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + 4 * i), rgba);
+	}
+
+	const auto& scalar = impl::GetScalarPixelConversions();
+	if constexpr (ChannelSize == 1) {
+		scalar.expandRgbToRgba8(source + 3 * i, destination + 4 * i, count - i, alpha);
+	}
+	else if constexpr (ChannelSize == 2) {
+		scalar.expandRgbToRgba16(source + 3 * i, destination + 4 * i, count - i, alpha);
+	}
+	else {
+		scalar.expandRgbToRgba32(source + 3 * i, destination + 4 * i, count - i, alpha);
+	}
+}
+
+
+static void SwizzleRgba8Avx2(const uint8_t* source, uint8_t* destination, size_t count, std::array<uint8_t, 4> order) {
+	uint8_t channels[4];
+	std::memcpy(channels, &order, sizeof(channels));
+
+	// The byte shuffle works within 128 bit lanes, so both lanes use the same indices.
+	alignas(32) uint8_t indices[32];
+	for (int b = 0; b < 32; ++b) {
+		indices[b] = uint8_t((b % 16) / 4 * 4 + channels[b % 4]);
+	}
+	const __m256i shuffle = _mm256_load_si256(reinterpret_cast<const __m256i*>(indices));
+
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8) {
+		const __m256i pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + 4 * i));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + 4 * i), _mm256_shuffle_epi8(pixels, shuffle));
+	}
+	impl::GetScalarPixelConversions().swizzleRgba8(source + 4 * i, destination + 4 * i, count - i, order);
+}
+
+
+static void Unorm8ToFloatAvx2(const uint8_t* source, float* destination, size_t count) {
+	const __m256 scale = _mm256_set1_ps(1.0f / 255.0f);
+
+	size_t i = 0;
+	for (; i + 16 <= count; i += 16) {
+		const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+		_mm256_storeu_ps(destination + i + 0, _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(bytes)), scale));
+		_mm256_storeu_ps(destination + i + 8, _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_srli_si128(bytes, 8))), scale));
+	}
+	impl::GetScalarPixelConversions().unorm8ToFloat(source + i, destination + i, count - i);
+}
+
+
+static void Unorm16ToFloatAvx2(const uint16_t* source, float* destination, size_t count) {
+	const __m256 scale = _mm256_set1_ps(1.0f / 65535.0f);
+
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8) {
+		const __m128i words = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+		_mm256_storeu_ps(destination + i, _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(words)), scale));
+	}
+	impl::GetScalarPixelConversions().unorm16ToFloat(source + i, destination + i, count - i);
+}
+
+
+// Max takes the second operand for NaN, so NaN becomes 0 like in the scalar code.
+static __m256i FloatToScaledInt(const float* source, __m256 scale) {
+	const __m256 value = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(source), _mm256_setzero_ps()), _mm256_set1_ps(1.0f));
+	return _mm256_cvtps_epi32(_mm256_mul_ps(value, scale));
+}
+
+
+static void FloatToUnorm8Avx2(const float* source, uint8_t* destination, size_t count) {
+	const __m256 scale = _mm256_set1_ps(255.0f);
+	const __m256i interleave = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+
+	// Packing works within 128 bit lanes, the final permute puts the 4 byte groups in order.
+	size_t i = 0;
+	for (; i + 32 <= count; i += 32) {
+		const __m256i low = _mm256_packs_epi32(FloatToScaledInt(source + i + 0, scale), FloatToScaledInt(source + i + 8, scale));
+		const __m256i high = _mm256_packs_epi32(FloatToScaledInt(source + i + 16, scale), FloatToScaledInt(source + i + 24, scale));
+		const __m256i bytes = _mm256_permutevar8x32_epi32(_mm256_packus_epi16(low, high), interleave);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + i), bytes);
+	}
+	impl::GetScalarPixelConversions().floatToUnorm8(source + i, destination + i, count - i);
+}
+
+
+static void FloatToUnorm16Avx2(const float* source, uint16_t* destination, size_t count) {
+	const __m256 scale = _mm256_set1_ps(65535.0f);
+
+	size_t i = 0;
+	for (; i + 16 <= count; i += 16) {
+		const __m256i packed = _mm256_packus_epi32(FloatToScaledInt(source + i + 0, scale), FloatToScaledInt(source + i + 8, scale));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + i), _mm256_permute4x64_epi64(packed, 0xD8));
+	}
+	impl::GetScalarPixelConversions().floatToUnorm16(source + i, destination + i, count - i);
+}
+
+
+static void FloatToHalfAvx2(const float* source, uint16_t* destination, size_t count) {
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8) {
+		const __m128i halves = _mm256_cvtps_ph(_mm256_loadu_ps(source + i), _MM_FROUND_TO_NEAREST_INT);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), halves);
+	}
+	impl::GetScalarPixelConversions().floatToHalf(source + i, destination + i, count - i);
+}
+
+
+static void HalfToFloatAvx2(const uint16_t* source, float* destination, size_t count) {
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8) {
+		const __m128i halves = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+		_mm256_storeu_ps(destination + i, _mm256_cvtph_ps(halves));
+	}
+	impl::GetScalarPixelConversions().halfToFloat(source + i, destination + i, count - i);
+}
+
+
+static void SrgbToLinearAvx2(const float* source, float* destination, size_t count) {
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8) {
+		const __m256 value = _mm256_loadu_ps(source + i);
+		const __m256 linear = _mm256_div_ps(value, _mm256_set1_ps(12.92f));
+		const __m256 curve = Pow(_mm256_div_ps(_mm256_add_ps(value, _mm256_set1_ps(0.055f)), _mm256_set1_ps(1.055f)), 2.4f);
+		_mm256_storeu_ps(destination + i, _mm256_blendv_ps(curve, linear, _mm256_cmp_ps(value, _mm256_set1_ps(0.04045f), _CMP_LE_OQ)));
+	}
+	impl::GetScalarPixelConversions().srgbToLinear(source + i, destination + i, count - i);
+}
+
+
+static void LinearToSrgbAvx2(const float* source, float* destination, size_t count) {
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8) {
+		const __m256 value = _mm256_loadu_ps(source + i);
+		const __m256 linear = _mm256_mul_ps(value, _mm256_set1_ps(12.92f));
+		const __m256 curve = _mm256_sub_ps(_mm256_mul_ps(Pow(value, 1.0f / 2.4f), _mm256_set1_ps(1.055f)), _mm256_set1_ps(0.055f));
+		_mm256_storeu_ps(destination + i, _mm256_blendv_ps(curve, linear, _mm256_cmp_ps(value, _mm256_set1_ps(0.0031308f), _CMP_LE_OQ)));
+	}
+	impl::GetScalarPixelConversions().linearToSrgb(source + i, destination + i, count - i);
+}
+
+
+const impl::PixelConversionTable& impl::GetAvx2PixelConversions() {
+	static const PixelConversionTable table = {
+		&ExpandRgbToRgbaAvx2<uint8_t>,
+		&ExpandRgbToRgbaAvx2<uint16_t>,
+		&ExpandRgbToRgbaAvx2<uint32_t>,
+		&SwizzleRgba8Avx2,
+		&Unorm8ToFloatAvx2,
+		&Unorm16ToFloatAvx2,
+		&FloatToUnorm8Avx2,
+		&FloatToUnorm16Avx2,
+		&FloatToHalfAvx2,
+		&HalfToFloatAvx2,
+		&SrgbToLinearAvx2,
+		&LinearToSrgbAvx2,
+		GetScalarPixelConversions().srgb8ToLinear, // Gathers are slower than scalar table lookups.
+	};
+	return table;
+}
+
+
+#else
+
+
+const impl::PixelConversionTable& impl::GetAvx2PixelConversions() {
+	return GetScalarPixelConversions();
+}
+
+
+#endif
+
+
+} // namespace inl::gxeng
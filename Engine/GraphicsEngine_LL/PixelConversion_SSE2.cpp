@@ -0,0 +1,346 @@
+#include "PixelConversion.hpp"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define INL_PIXEL_CONVERSION_X86 1
+#include <emmintrin.h>
+#endif
+
+#include <cstring>
+
+
+namespace inl::gxeng {
+
+
+#ifdef INL_PIXEL_CONVERSION_X86
+
+
+//------------------------------------------------------------------------------
+// Helpers
+//------------------------------------------------------------------------------
+
+static __m128i Load12(const uint8_t* source) {
+	int32_t last;
+	std::memcpy(&last, source + 8, sizeof(last));
+	return _mm_unpacklo_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(source)), _mm_cvtsi32_si128(last));
+}
+
+
+static __m128 Select(__m128 mask, __m128 ifTrue, __m128 ifFalse) {
+	return _mm_or_ps(_mm_and_ps(mask, ifTrue), _mm_andnot_ps(mask, ifFalse));
+}
+
+
+static __m128 Log2(__m128 x) {
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128i bits = _mm_castps_si128(x);
+	const __m128 exponent = _mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(bits, 23), _mm_set1_epi32(127)));
+	const __m128 mantissa = _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(bits, _mm_set1_epi32(0x007F'FFFF)), _mm_castps_si128(one)));
+
+	// log2(m) = 2/ln(2) * atanh(t), where t = (m-1)/(m+1) is in [0, 1/3).
+	const __m128 t = _mm_div_ps(_mm_sub_ps(mantissa, one), _mm_add_ps(mantissa, one));
+	const __m128 t2 = _mm_mul_ps(t, t);
+	__m128 series = _mm_set1_ps(1.0f / 9.0f);
+	series = _mm_add_ps(_mm_mul_ps(series, t2), _mm_set1_ps(1.0f / 7.0f));
+	series = _mm_add_ps(_mm_mul_ps(series, t2), _mm_set1_ps(1.0f / 5.0f));
+	series = _mm_add_ps(_mm_mul_ps(series, t2), _mm_set1_ps(1.0f / 3.0f));
+	series = _mm_add_ps(_mm_mul_ps(series, t2), one);
+	return _mm_add_ps(exponent, _mm_mul_ps(_mm_mul_ps(series, t), _mm_set1_ps(2.8853900817779268f)));
+}
+
+
+static __m128 Exp2(__m128 x) {
+	x = _mm_min_ps(_mm_max_ps(x, _mm_set1_ps(-126.0f)), _mm_set1_ps(127.0f));
+	const __m128i whole = _mm_cvtps_epi32(x);
+	const __m128 y = _mm_mul_ps(_mm_sub_ps(x, _mm_cvtepi32_ps(whole)), _mm_set1_ps(0.69314718055994531f));
+
+	// Taylor series of e^y for y in [-ln(2)/2, ln(2)/2].
+	__m128 series = _mm_set1_ps(1.0f / 720.0f);
+	series = _mm_add_ps(_mm_mul_ps(series, y), _mm_set1_ps(1.0f / 120.0f));
+	series = _mm_add_ps(_mm_mul_ps(series, y), _mm_set1_ps(1.0f / 24.0f));
+	series = _mm_add_ps(_mm_mul_ps(series, y), _mm_set1_ps(1.0f / 6.0f));
+	series = _mm_add_ps(_mm_mul_ps(series, y), _mm_set1_ps(1.0f / 2.0f));
+	series = _mm_add_ps(_mm_mul_ps(series, y), _mm_set1_ps(1.0f));
+	series = _mm_add_ps(_mm_mul_ps(series, y), _mm_set1_ps(1.0f));
+	const __m128 scale = _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(whole, _mm_set1_epi32(127)), 23));
+	return _mm_mul_ps(series, scale);
+}
+
+
+static __m128 Pow(__m128 x, float exponent) {
+	return Exp2(_mm_mul_ps(Log2(x), _mm_set1_ps(exponent)));
+}
+
+
+
+//------------------------------------------------------------------------------
+// Conversions
+//------------------------------------------------------------------------------
+
+// Moves the 12 bytes of RGB pixels apart to make room for alpha.
+template <size_t ChannelSize>
+static __m128i SpreadRgb(__m128i rgb, __m128i alpha) {
+	if constexpr (ChannelSize == 1) {
+		const __m128i p0 = _mm_and_si128(rgb, _mm_set_epi32(0, 0, 0, 0x00FF'FFFF));
+		const __m128i p1 = _mm_and_si128(_mm_slli_si128(rgb, 1), _mm_set_epi32(0, 0, 0x00FF'FFFF, 0));
+		const __m128i p2 = _mm_and_si128(_mm_slli_si128(rgb, 2), _mm_set_epi32(0, 0x00FF'FFFF, 0, 0));
+		const __m128i p3 = _mm_and_si128(_mm_slli_si128(rgb, 3), _mm_set_epi32(0x00FF'FFFF, 0, 0, 0));
+		return _mm_or_si128(_mm_or_si128(_mm_or_si128(p0, p1), _mm_or_si128(p2, p3)), alpha);
+	}
+	else if constexpr (ChannelSize == 2) {
+		const __m128i p0 = _mm_and_si128(rgb, _mm_set_epi32(0, 0, 0x0000'FFFF, -1));
+		const __m128i p1 = _mm_and_si128(_mm_slli_si128(rgb, 2), _mm_set_epi32(0x0000'FFFF, -1, 0, 0));
+		return _mm_or_si128(_mm_or_si128(p0, p1), alpha);
+	}
+	else {
+		return _mm_or_si128(_mm_and_si128(rgb, _mm_set_epi32(0, -1, -1, -1)), alpha);
+	}
+}
+
+
+template <class T>
+static void ExpandRgbToRgbaSse2(const T* source, T* destination, size_t count, T alpha) {
+	constexpr size_t ChannelSize = sizeof(T);
+	constexpr size_t BlockPixels = 16 / ChannelSize;
+
+	__m128i alphaVector;
+	if constexpr (ChannelSize == 1) {
+		alphaVector = _mm_set1_epi32(int32_t(uint32_t(alpha) << 24));
+	}
+	else if constexpr (ChannelSize == 2) {
+		alphaVector = _mm_set_epi32(int32_t(uint32_t(alpha) << 16), 0, int32_t(uint32_t(alpha) << 16), 0);
+	}
+	else {
+		alphaVector = _mm_set_epi32(int32_t(alpha), 0, 0, 0);
+	}
+
+	// Each block reads 48 bytes, i.e. four times 12 bytes that expand to 16.
+	size_t i = 0;
+	for (; i + BlockPixels <= count; i += BlockPixels) {
+		const uint8_t* src = reinterpret_cast<const uint8_t*>(source + 3 * i);
+		__m128i* dst = reinterpret_cast<__m128i*>(destination + 4 * i);
+		_mm_storeu_si128(dst + 0, SpreadRgb<ChannelSize>(Load12(src + 0), alphaVector));
+		_mm_storeu_si128(dst + 1, SpreadRgb<ChannelSize>(Load12(src + 12), alphaVector));
+		_mm_storeu_si128(dst + 2, SpreadRgb<ChannelSize>(Load12(src + 24), alphaVector));
+		_mm_storeu_si128(dst + 3, SpreadRgb<ChannelSize>(Load12(src + 36), alphaVector));
+	}
+
+	const auto& scalar = impl::GetScalarPixelConversions();
+	if constexpr (ChannelSize == 1) {
+		scalar.expandRgbToRgba8(source + 3 * i, destination + 4 * i, count - i, alpha);
+	}
+	else if constexpr (ChannelSize == 2) {
+		scalar.expandRgbToRgba16(source + 3 * i, destination + 4 * i, count - i, alpha);
+	}
+	else {
+		scalar.expandRgbToRgba32(source + 3 * i, destination + 4 * i, count - i, alpha);
+	}
+}
+
+
+static void SwizzleRgba8Sse2(const uint8_t* source, uint8_t* destination, size_t count, std::array<uint8_t, 4> order) {
+	const __m128i byteMask = _mm_set1_epi32(0xFF);
+	__m128i sourceShift[4];
+	__m128i destinationShift[4];
+	for (int c = 0; c < 4; ++c) {
+		sourceShift[c] = _mm_cvtsi32_si128(8 * order[c]);
+		destinationShift[c] = _mm_cvtsi32_si128(8 * c);
+	}
+
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4) {
+		const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + 4 * i));
+		__m128i result = _mm_setzero_si128();
+		for (int c = 0; c < 4; ++c) {
+			const __m128i channel = _mm_and_si128(_mm_srl_epi32(pixels, sourceShift[c]), byteMask);
+			result = _mm_or_si128(result, _mm_sll_epi32(channel, destinationShift[c]));
+		}
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(destination + 4 * i), result);
+	}
+	impl::GetScalarPixelConversions().swizzleRgba8(source + 4 * i, destination + 4 * i, count - i, order);
+}
+
+
+static void Unorm8ToFloatSse2(const uint8_t* source, float* destination, size_t count) {
+	const __m128i zero = _mm_setzero_si128();
+	const __m128 scale = _mm_set1_ps(1.0f / 255.0f);
+
+	size_t i = 0;
+	for (; i + 16 <= count; i += 16) {
+		const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+		const __m128i low = _mm_unpacklo_epi8(bytes, zero);
+		const __m128i high = _mm_unpackhi_epi8(bytes, zero);
+		_mm_storeu_ps(destination + i + 0, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(low, zero)), scale));
+		_mm_storeu_ps(destination + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(low, zero)), scale));
+		_mm_storeu_ps(destination + i + 8, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(high, zero)), scale));
+		_mm_storeu_ps(destination + i + 12, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(high, zero)), scale));
+	}
+	impl::GetScalarPixelConversions().unorm8ToFloat(source + i, destination + i, count - i);
+}
+
+
+static void Unorm16ToFloatSse2(const uint16_t* source, float* destination, size_t count) {
+	const __m128i zero = _mm_setzero_si128();
+	const __m128 scale = _mm_set1_ps(1.0f / 65535.0f);
+
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8) {
+		const __m128i words = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+		_mm_storeu_ps(destination + i + 0, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(words, zero)), scale));
+		_mm_storeu_ps(destination + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(words, zero)), scale));
+	}
+	impl::GetScalarPixelConversions().unorm16ToFloat(source + i, destination + i, count - i);
+}
+
+
+// Max takes the second operand for NaN, so NaN becomes 0 like in the scalar code.
+static __m128i FloatToScaledInt(const float* source, __m128 scale) {
+	const __m128 value = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(source), _mm_setzero_ps()), _mm_set1_ps(1.0f));
+	return _mm_cvtps_epi32(_mm_mul_ps(value, scale));
+}
+
+
+static void FloatToUnorm8Sse2(const float* source, uint8_t* destination, size_t count) {
+	const __m128 scale = _mm_set1_ps(255.0f);
+
+	size_t i = 0;
+	for (; i + 16 <= count; i += 16) {
+		const __m128i low = _mm_packs_epi32(FloatToScaledInt(source + i + 0, scale), FloatToScaledInt(source + i + 4, scale));
+		const __m128i high = _mm_packs_epi32(FloatToScaledInt(source + i + 8, scale), FloatToScaledInt(source + i + 12, scale));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), _mm_packus_epi16(low, high));
+	}
+	impl::GetScalarPixelConversions().floatToUnorm8(source + i, destination + i, count - i);
+}
+
+
+static void FloatToUnorm16Sse2(const float* source, uint16_t* destination, size_t count) {
+	const __m128 scale = _mm_set1_ps(65535.0f);
+	const __m128i bias32 = _mm_set1_epi32(32768);
+	const __m128i bias16 = _mm_set1_epi16(-32768);
+
+	// SSE2 can only pack with signed saturation, so the values are shifted to the signed range and back.
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8) {
+		const __m128i low = _mm_sub_epi32(FloatToScaledInt(source + i + 0, scale), bias32);
+		const __m128i high = _mm_sub_epi32(FloatToScaledInt(source + i + 4, scale), bias32);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), _mm_xor_si128(_mm_packs_epi32(low, high), bias16));
+	}
+	impl::GetScalarPixelConversions().floatToUnorm16(source + i, destination + i, count - i);
+}
+
+
+// Same algorithm as impl::FloatToHalf, the branches replaced by masks.
+// The result is sign extended to 32 bits so that it can be packed with signed saturation.
+static __m128i FloatToHalf4(__m128 value) {
+	const __m128 justSign = _mm_and_ps(value, _mm_castsi128_ps(_mm_set1_epi32(int32_t(0x8000'0000u))));
+	const __m128 absolute = _mm_xor_ps(value, justSign);
+	const __m128i bits = _mm_castps_si128(absolute);
+
+	const __m128i isNan = _mm_castps_si128(_mm_cmpunord_ps(absolute, absolute));
+	const __m128i isRegular = _mm_cmpgt_epi32(_mm_set1_epi32((127 + 16) << 23), bits);
+	const __m128i isDenormal = _mm_cmpgt_epi32(_mm_set1_epi32(113 << 23), bits);
+	const __m128i special = _mm_or_si128(_mm_and_si128(isNan, _mm_set1_epi32(0x200)), _mm_set1_epi32(0x7C00));
+
+	const __m128i denormMagic = _mm_set1_epi32(((127 - 15) + (23 - 10) + 1) << 23);
+	const __m128i denormal = _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(absolute, _mm_castsi128_ps(denormMagic))), denormMagic);
+
+	const __m128i mantissaOdd = _mm_srai_epi32(_mm_slli_epi32(bits, 31 - 13), 31);
+	const __m128i rounded = _mm_sub_epi32(_mm_add_epi32(bits, _mm_set1_epi32(0xFFF - ((127 - 15) << 23))), mantissaOdd);
+	const __m128i normal = _mm_srli_epi32(rounded, 13);
+
+	const __m128i finite = _mm_or_si128(_mm_and_si128(isDenormal, denormal), _mm_andnot_si128(isDenormal, normal));
+	const __m128i result = _mm_or_si128(_mm_and_si128(isRegular, finite), _mm_andnot_si128(isRegular, special));
+	return _mm_or_si128(result, _mm_srai_epi32(_mm_castps_si128(justSign), 16));
+}
+
+
+static void FloatToHalfSse2(const float* source, uint16_t* destination, size_t count) {
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8) {
+		const __m128i low = FloatToHalf4(_mm_loadu_ps(source + i + 0));
+		const __m128i high = FloatToHalf4(_mm_loadu_ps(source + i + 4));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), _mm_packs_epi32(low, high));
+	}
+	impl::GetScalarPixelConversions().floatToHalf(source + i, destination + i, count - i);
+}
+
+
+// Shifting the bits into place and multiplying by 2^112 rebiases the exponent and normalizes denormals.
+static __m128 HalfToFloat4(__m128i value) {
+	const __m128i exponentMantissa = _mm_and_si128(value, _mm_set1_epi32(0x7FFF));
+	const __m128i sign = _mm_slli_epi32(_mm_xor_si128(value, exponentMantissa), 16);
+	const __m128 scaled = _mm_mul_ps(_mm_castsi128_ps(_mm_slli_epi32(exponentMantissa, 13)), _mm_castsi128_ps(_mm_set1_epi32((254 - 15) << 23)));
+	const __m128i wasInfNan = _mm_cmpgt_epi32(exponentMantissa, _mm_set1_epi32(0x7BFF));
+	const __m128i infNanExponent = _mm_and_si128(wasInfNan, _mm_set1_epi32(255 << 23));
+	return _mm_or_ps(scaled, _mm_castsi128_ps(_mm_or_si128(sign, infNanExponent)));
+}
+
+
+static void HalfToFloatSse2(const uint16_t* source, float* destination, size_t count) {
+	const __m128i zero = _mm_setzero_si128();
+
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8) {
+		const __m128i halves = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+		_mm_storeu_ps(destination + i + 0, HalfToFloat4(_mm_unpacklo_epi16(halves, zero)));
+		_mm_storeu_ps(destination + i + 4, HalfToFloat4(_mm_unpackhi_epi16(halves, zero)));
+	}
+	impl::GetScalarPixelConversions().halfToFloat(source + i, destination + i, count - i);
+}
+
+
+static void SrgbToLinearSse2(const float* source, float* destination, size_t count) {
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4) {
+		const __m128 value = _mm_loadu_ps(source + i);
+		const __m128 linear = _mm_div_ps(value, _mm_set1_ps(12.92f));
+		const __m128 curve = Pow(_mm_div_ps(_mm_add_ps(value, _mm_set1_ps(0.055f)), _mm_set1_ps(1.055f)), 2.4f);
+		_mm_storeu_ps(destination + i, Select(_mm_cmple_ps(value, _mm_set1_ps(0.04045f)), linear, curve));
+	}
+	impl::GetScalarPixelConversions().srgbToLinear(source + i, destination + i, count - i);
+}
+
+
+static void LinearToSrgbSse2(const float* source, float* destination, size_t count) {
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4) {
+		const __m128 value = _mm_loadu_ps(source + i);
+		const __m128 linear = _mm_mul_ps(value, _mm_set1_ps(12.92f));
+		const __m128 curve = _mm_sub_ps(_mm_mul_ps(Pow(value, 1.0f / 2.4f), _mm_set1_ps(1.055f)), _mm_set1_ps(0.055f));
+		_mm_storeu_ps(destination + i, Select(_mm_cmple_ps(value, _mm_set1_ps(0.0031308f)), linear, curve));
+	}
+	impl::GetScalarPixelConversions().linearToSrgb(source + i, destination + i, count - i);
+}
+
+
+const impl::PixelConversionTable& impl::GetSse2PixelConversions() {
+	static const PixelConversionTable table = {
+		&ExpandRgbToRgbaSse2<uint8_t>,
+		&ExpandRgbToRgbaSse2<uint16_t>,
+		&ExpandRgbToRgbaSse2<uint32_t>,
+		&SwizzleRgba8Sse2,
+		&Unorm8ToFloatSse2,
+		&Unorm16ToFloatSse2,
+		&FloatToUnorm8Sse2,
+		&FloatToUnorm16Sse2,
+		&FloatToHalfSse2,
+		&HalfToFloatSse2,
+		&SrgbToLinearSse2,
+		&LinearToSrgbSse2,
+		GetScalarPixelConversions().srgb8ToLinear, // Table lookups, SSE2 has no gather.
+	};
+	return table;
+}
+
+
+#else
+
+
+const impl::PixelConversionTable& impl::GetSse2PixelConversions() {
+	return GetScalarPixelConversions();
+}
+
+
+#endif
+
+
+} // namespace inl::gxeng
@@ -0,0 +1,299 @@
+#include "ResidencyManager.hpp"
+
+#include <BaseLibrary/Exception/Exception.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <unordered_set>
+
+
+namespace inl::gxeng {
+
+
+namespace impl {
+
+	void ResidencyTracker::Lock(const void* key, uint64_t size, uint64_t frame) {
+		auto it = m_entries.find(key);
+		if (it == m_entries.end()) {
+			m_entries.insert({ key, Entry{ size, 1, frame, {} } });
+			m_residentSize += size;
+			return;
+		}
+
+		Entry& entry = it->second;
+		if (entry.lockCount == 0) {
+			m_lru.erase(entry.lruPosition);
+		}
+		++entry.lockCount;
+		entry.lastUsedFrame = std::max(entry.lastUsedFrame, frame);
+	}
+
+
+	void ResidencyTracker::Unlock(const void* key, uint64_t frame) {
+		auto it = m_entries.find(key);
+		assert(it != m_entries.end() && it->second.lockCount > 0);
+		if (it == m_entries.end() || it->second.lockCount == 0) {
+			return;
+		}
+
+		Entry& entry = it->second;
+		entry.lastUsedFrame = std::max(entry.lastUsedFrame, frame);
+		if (--entry.lockCount == 0) {
+			// Unlocks come in the order the GPU finishes, so the back is always the most recent.
+			entry.lruPosition = m_lru.insert(m_lru.end(), key);
+		}
+	}
+
+
+	void ResidencyTracker::Remove(const void* key) {
+		auto it = m_entries.find(key);
+		if (it == m_entries.end()) {
+			return;
+		}
+		if (it->second.lockCount == 0) {
+			m_lru.erase(it->second.lruPosition);
+		}
+		m_residentSize -= it->second.size;
+		m_entries.erase(it);
+	}
+
+
+	std::vector<const void*> ResidencyTracker::EvictForBudget(uint64_t additionalSize) {
+		std::vector<const void*> victims;
+		auto OverBudget = [this, additionalSize] {
+			return additionalSize > m_budget || m_residentSize > m_budget - additionalSize;
+		};
+		while (OverBudget() && !m_lru.empty()) {
+			const void* key = m_lru.front();
+			Remove(key);
+			victims.push_back(key);
+		}
+		return victims;
+	}
+
+
+	std::vector<const void*> ResidencyTracker::EvictAtLeast(uint64_t size) {
+		std::vector<const void*> victims;
+		uint64_t freed = 0;
+		while (freed < size && !m_lru.empty()) {
+			const void* key = m_lru.front();
+			freed += m_entries[key].size;
+			Remove(key);
+			victims.push_back(key);
+		}
+		return victims;
+	}
+
+
+	bool ResidencyTracker::IsLocked(const void* key) const {
+		auto it = m_entries.find(key);
+		return it != m_entries.end() && it->second.lockCount > 0;
+	}
+
+
+	std::optional<uint64_t> ResidencyTracker::GetLastUsedFrame(const void* key) const {
+		auto it = m_entries.find(key);
+		if (it == m_entries.end()) {
+			return {};
+		}
+		return it->second.lastUsedFrame;
+	}
+
+} // namespace impl
+
+
+
+ResidencyManager::ResidencyManager(gxapi::IGraphicsApi* graphicsApi)
+	: m_graphicsApi(graphicsApi) {}
+
+
+void ResidencyManager::LockResident(const std::vector<MemoryObject>& resources) {
+	const uint64_t frame = m_currentFrame;
+
+	std::lock_guard<std::mutex> lock(m_mtx);
+
+	// Lock everything first so that none of the requested resources is picked for eviction.
+	std::vector<gxapi::IResource*> lowLevelTargets;
+	std::vector<gxapi::IHeap*> lowLevelHeaps;
+	std::vector<MemoryObject> highLevelTargets;
+	uint64_t requiredSize = 0;
+	std::unordered_set<const void*> seen;
+	for (const MemoryObject& resource : resources) {
+		if (!resource || !IsManaged(resource)) {
+			continue;
+		}
+		const void* key = GetResidencyKey(resource);
+		const bool tracked = m_tracker.IsTracked(key);
+		const uint64_t size = tracked ? 0 : GetResidencySize(resource);
+		m_tracker.Lock(key, size, frame);
+		m_objects[key].insert({ resource._GetResourcePtr(), resource });
+		if (!resource._GetResident() && seen.insert(key).second) {
+			if (PlacedHeapResidency* placement = resource._GetPlacement()) {
+				lowLevelHeaps.push_back(placement->heap);
+			}
+			else {
+				lowLevelTargets.push_back(resource._GetResourcePtr());
+			}
+			highLevelTargets.push_back(resource);
+			requiredSize += size;
+		}
+	}
+
+	// Newly tracked memory is already counted, make room for it within the budget.
+	Evict(m_tracker.EvictForBudget(0));
+
+	if (!lowLevelTargets.empty() || !lowLevelHeaps.empty()) {
+		uint64_t evictionSize = std::max(requiredSize, MIN_OOM_EVICTION_SIZE);
+		while (true) {
+			try {
+				m_graphicsApi->MakeResident(lowLevelTargets);
+				lowLevelTargets.clear(); // Already resident if only the heaps have to be retried.
+				m_graphicsApi->MakeResident(lowLevelHeaps);
+				break;
+			}
+			catch (OutOfMemoryException&) {
+				// The budget was too optimistic, make room gradually instead of flushing everything.
+				auto victims = m_tracker.EvictAtLeast(evictionSize);
+				if (victims.empty()) {
+					throw;
+				}
+				Evict(victims);
+				evictionSize *= 2;
+			}
+		}
+	}
+
+	for (auto& resource : highLevelTargets) {
+		resource._SetResident(true);
+	}
+}
+
+
+void ResidencyManager::UnlockResident(const std::vector<MemoryObject>& resources) {
+	const uint64_t frame = m_currentFrame;
+
+	std::lock_guard<std::mutex> lock(m_mtx);
+	for (const MemoryObject& resource : resources) {
+		if (resource && IsManaged(resource)) {
+			m_tracker.Unlock(GetResidencyKey(resource), frame);
+		}
+	}
+}
+
+
+void ResidencyManager::SetBudget(uint64_t bytes) {
+	std::lock_guard<std::mutex> lock(m_mtx);
+	m_tracker.SetBudget(bytes);
+	Evict(m_tracker.EvictForBudget(0));
+}
+
+
+uint64_t ResidencyManager::GetBudget() const {
+	std::lock_guard<std::mutex> lock(m_mtx);
+	return m_tracker.GetBudget();
+}
+
+
+uint64_t ResidencyManager::GetResidentSize() const {
+	std::lock_guard<std::mutex> lock(m_mtx);
+	return m_tracker.GetResidentSize();
+}
+
+
+void ResidencyManager::OnFrameBeginHost(uint64_t frameId) {
+	m_currentFrame = frameId;
+}
+
+
+void ResidencyManager::OnFrameCompleteDevice(uint64_t frameId) {
+	// Forget resources nobody else refers to anymore, so that they get released.
+	std::vector<MemoryObject> released;
+	{
+		std::lock_guard<std::mutex> lock(m_mtx);
+		for (const void* key : std::vector<const void*>(m_tracker.GetEvictables().begin(), m_tracker.GetEvictables().end())) {
+			auto it = m_objects.find(key);
+			if (it == m_objects.end()) {
+				continue;
+			}
+			auto& objects = it->second;
+			for (auto objectIt = objects.begin(); objectIt != objects.end();) {
+				if (objectIt->second._IsUnique()) {
+					released.push_back(std::move(objectIt->second));
+					objectIt = objects.erase(objectIt);
+				}
+				else {
+					++objectIt;
+				}
+			}
+			// A heap is forgotten once none of its tracked resources are left.
+			if (objects.empty()) {
+				m_tracker.Remove(key);
+				m_objects.erase(it);
+			}
+		}
+	}
+	// Resources are destroyed here, outside the lock.
+}
+
+
+bool ResidencyManager::IsManaged(const MemoryObject& resource) {
+	switch (resource.GetHeap()) {
+		case eResourceHeap::UPLOAD:
+		case eResourceHeap::CONSTANT:
+		case eResourceHeap::TRANSIENT:
+		case eResourceHeap::BACKBUFFER:
+			return false;
+		default:
+			return true;
+	}
+}
+
+
+const void* ResidencyManager::GetResidencyKey(const MemoryObject& resource) {
+	if (PlacedHeapResidency* placement = resource._GetPlacement()) {
+		return placement->heap;
+	}
+	return resource._GetResourcePtr();
+}
+
+
+uint64_t ResidencyManager::GetResidencySize(const MemoryObject& resource) const {
+	if (PlacedHeapResidency* placement = resource._GetPlacement()) {
+		return placement->size;
+	}
+	return m_graphicsApi->GetResourceAllocationInfo(resource.GetDescription()).sizeInBytes;
+}
+
+
+void ResidencyManager::Evict(const std::vector<const void*>& victims) {
+	if (victims.empty()) {
+		return;
+	}
+
+	// The objects are kept until the call returns, they might be the last references.
+	std::vector<MemoryObject> highLevelTargets;
+	std::vector<gxapi::IResource*> lowLevelTargets;
+	std::vector<gxapi::IHeap*> lowLevelHeaps;
+	highLevelTargets.reserve(victims.size());
+	for (const void* key : victims) {
+		auto it = m_objects.find(key);
+		assert(it != m_objects.end() && !it->second.empty());
+		const MemoryObject& first = it->second.begin()->second;
+		if (PlacedHeapResidency* placement = first._GetPlacement()) {
+			lowLevelHeaps.push_back(placement->heap);
+		}
+		else {
+			lowLevelTargets.push_back(first._GetResourcePtr());
+		}
+		for (auto& entry : it->second) {
+			entry.second._SetResident(false);
+			highLevelTargets.push_back(std::move(entry.second));
+		}
+		m_objects.erase(it);
+	}
+	m_graphicsApi->Evict(lowLevelTargets);
+	m_graphicsApi->Evict(lowLevelHeaps);
+}
+
+
+} // namespace inl::gxeng
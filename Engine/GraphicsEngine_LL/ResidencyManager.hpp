@@ -0,0 +1,126 @@
+#pragma once
+
+#include "MemoryObject.hpp"
+#include "PipelineEventListener.hpp"
+
+#include <GraphicsApi_LL/IGraphicsApi.hpp>
+
+#include <atomic>
+#include <limits>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+
+namespace inl::gxeng {
+
+
+namespace impl {
+
+	/// <summary> Bookkeeping of resident resources for least-recently-used eviction. </summary>
+	/// <remarks> Resources are identified by an opaque key. Locked resources are in use by the GPU,
+	///		they are never selected for eviction. </remarks>
+	class ResidencyTracker {
+	public:
+		static constexpr uint64_t UNLIMITED = std::numeric_limits<uint64_t>::max();
+
+		ResidencyTracker(uint64_t budget = UNLIMITED) : m_budget(budget) {}
+
+		/// <summary> Marks the resource as used by the GPU. Untracked resources start being tracked with the given size. </summary>
+		void Lock(const void* key, uint64_t size, uint64_t frame);
+
+		/// <summary> Releases a lock, the resource can be evicted once it has no locks left. </summary>
+		void Unlock(const void* key, uint64_t frame);
+
+		/// <summary> Stops tracking the resource. </summary>
+		void Remove(const void* key);
+
+		/// <summary> Selects the least recently used unlocked resources that must go so that
+		///		<paramref name="additionalSize"/> more bytes fit in the budget. </summary>
+		/// <remarks> The selected resources are no longer tracked. Might not free enough if too much is locked. </remarks>
+		std::vector<const void*> EvictForBudget(uint64_t additionalSize);
+
+		/// <summary> Selects the least recently used unlocked resources until their sizes add up to at least <paramref name="size"/>. </summary>
+		/// <remarks> The selected resources are no longer tracked. </remarks>
+		std::vector<const void*> EvictAtLeast(uint64_t size);
+
+		bool IsTracked(const void* key) const { return m_entries.count(key) > 0; }
+		bool IsLocked(const void* key) const;
+		std::optional<uint64_t> GetLastUsedFrame(const void* key) const;
+
+		/// <summary> Unlocked resources, least recently used first. </summary>
+		const std::list<const void*>& GetEvictables() const { return m_lru; }
+
+		uint64_t GetResidentSize() const { return m_residentSize; }
+		uint64_t GetBudget() const { return m_budget; }
+		void SetBudget(uint64_t budget) { m_budget = budget; }
+
+	private:
+		struct Entry {
+			uint64_t size;
+			uint32_t lockCount;
+			uint64_t lastUsedFrame;
+			std::list<const void*>::iterator lruPosition; // Only valid when not locked.
+		};
+
+		std::unordered_map<const void*, Entry> m_entries;
+		std::list<const void*> m_lru;
+		uint64_t m_budget;
+		uint64_t m_residentSize = 0;
+	};
+
+} // namespace impl
+
+
+
+/// <summary> Keeps the resources the GPU uses resident within a memory budget. </summary>
+/// <remarks> When the budget or the device runs out, resources that have not been used for the
+///		longest time are evicted, only as many as needed. Resources in the upload, constant,
+///		transient and back buffer heaps are not managed, they stay resident all the time.
+///		Placed resources are managed by their heap: the heap is locked while any resource in
+///		it is, and it is evicted as a whole, together with all resources in it. </remarks>
+class ResidencyManager : public PipelineEventListener {
+public:
+	ResidencyManager(gxapi::IGraphicsApi* graphicsApi);
+
+	/// <summary> Makes the resources resident and protects them from eviction until unlocked. </summary>
+	/// <exception cref="inl::OutOfMemoryException"> If the resources do not fit even after evicting everything unlocked. </exception>
+	void LockResident(const std::vector<MemoryObject>& resources);
+
+	/// <summary> Lets the resources be evicted when memory is needed. </summary>
+	void UnlockResident(const std::vector<MemoryObject>& resources);
+
+	/// <summary> Sets how many bytes of managed resources may be resident at once. </summary>
+	void SetBudget(uint64_t bytes);
+	uint64_t GetBudget() const;
+
+	/// <summary> Size of the managed resources that are currently resident. </summary>
+	uint64_t GetResidentSize() const;
+
+	void OnFrameBeginDevice(uint64_t frameId) override {}
+	void OnFrameBeginHost(uint64_t frameId) override;
+	void OnFrameBeginAwait(uint64_t frameId) override {}
+	void OnFrameCompleteDevice(uint64_t frameId) override;
+	void OnFrameCompleteHost(uint64_t frameId) override {}
+
+private:
+	static bool IsManaged(const MemoryObject& resource);
+	/// <summary> Placed resources are tracked by their heap, committed ones by themselves. </summary>
+	static const void* GetResidencyKey(const MemoryObject& resource);
+	uint64_t GetResidencySize(const MemoryObject& resource) const;
+	void Evict(const std::vector<const void*>& victims);
+
+private:
+	gxapi::IGraphicsApi* m_graphicsApi;
+	impl::ResidencyTracker m_tracker;
+	std::unordered_map<const void*, std::unordered_map<const void*, MemoryObject>> m_objects; // The tracked resources by residency key, so that evicted pointers are never dangling.
+	std::atomic_uint64_t m_currentFrame{ 0 };
+	mutable std::mutex m_mtx;
+
+	static constexpr uint64_t MIN_OOM_EVICTION_SIZE = 32 * 1024 * 1024;
+};
+
+
+} // namespace inl::gxeng
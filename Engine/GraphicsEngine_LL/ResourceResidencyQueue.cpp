@@ -1,13 +1,18 @@
 #include "ResourceResidencyQueue.hpp"
 
+#include "MemoryManager.hpp"
+
+#include <BaseLibrary/Exception/Exception.hpp>
+
 #include <BaseLibrary/ThreadName.hpp>
 
 namespace inl ::gxeng {
 
 
-ResourceResidencyQueue::ResourceResidencyQueue(std::unique_ptr<gxapi::IFence> fence)
+ResourceResidencyQueue::ResourceResidencyQueue(std::unique_ptr<gxapi::IFence> fence, MemoryManager* memoryManager)
 	: m_fence(std::move(fence)),
-	  m_fenceValue(0) {
+	  m_fenceValue(0),
+	  m_memoryManager(memoryManager) {
 	m_fence->Signal(0);
 	m_runThreads = true;
 	m_initThread = std::thread(std::bind(&ResourceResidencyQueue::InitThreadFunc, this));
@@ -35,10 +40,11 @@ const std::function<void()>& ResourceResidencyQueue::GetFailureHandler() const {
 
 
 SyncPoint ResourceResidencyQueue::EnqueueInit(std::vector<MemoryObject> resources) {
+	// Fence values must be queued in increasing order, tasks may come from multiple threads.
+	std::lock_guard<std::mutex> lkg(m_initMutex);
 	++m_fenceValue;
 	SyncPoint syncPoint(m_fence, m_fenceValue);
 
-	std::lock_guard<std::mutex> lkg(m_initMutex);
 	m_initQueue.push(std::make_unique<Task>(std::move(resources), syncPoint));
 	m_initCv.notify_one();
 
@@ -46,6 +52,12 @@ SyncPoint ResourceResidencyQueue::EnqueueInit(std::vector<MemoryObject> resource
 }
 
 
+void ResourceResidencyQueue::EnqueuePrefetch(std::vector<MemoryObject> resources) {
+	SyncPoint residentPoint = EnqueueInit(resources);
+	EnqueueClean(residentPoint, std::move(resources));
+}
+
+
 void ResourceResidencyQueue::InitThreadFunc() {
 	SetCurrentThreadName("CommandList Init Thread");
 
@@ -62,8 +74,14 @@ void ResourceResidencyQueue::InitThreadFunc() {
 		lk.unlock();
 
 		for (auto& task : workingSet) {
-			for (const MemoryObject& res : task->resources) {
-				// TODO...
+			try {
+				m_memoryManager->LockResident(task->resources);
+			}
+			catch (OutOfMemoryException&) {
+				// Evicting everything that is not in use did not help either.
+				if (m_failureHandler) {
+					m_failureHandler();
+				}
 			}
 			task->syncPoint.m_fence->Signal(task->syncPoint.m_value);
 		}
@@ -90,9 +108,7 @@ void ResourceResidencyQueue::CleanThreadFunc() {
 
 		for (auto& task : workingSet) {
 			task->syncPoint.m_fence->Wait(task->syncPoint.m_value);
-			for (const MemoryObject& res : task->resources) {
-				// TODO...
-			}
+			m_memoryManager->UnlockResident(task->resources);
 		}
 
 		workingSet.clear();
@@ -12,6 +12,10 @@
 
 namespace inl::gxeng {
 
+
+class MemoryManager;
+
+
 /// <summary> Manages initializing and cleanup of command lists. </summary>
 class ResourceResidencyQueue {
 	struct Task {
@@ -24,7 +28,8 @@ class ResourceResidencyQueue {
 	};
 
 public:
-	ResourceResidencyQueue(std::unique_ptr<gxapi::IFence> fence);
+	/// <param name="memoryManager"> Resources are made resident and evictable through this. </param>
+	ResourceResidencyQueue(std::unique_ptr<gxapi::IFence> fence, MemoryManager* memoryManager);
 	~ResourceResidencyQueue();
 
 
@@ -54,6 +59,11 @@ public:
 	template <class... CleanObjectT>
 	void EnqueueClean(SyncPoint waitFor, std::vector<MemoryObject> resources, CleanObjectT&&... cleanObjects);
 
+	/// <summary> Makes the resources resident in the background ahead of their use. </summary>
+	/// <remarks> The resources are evictable again as soon as they are resident,
+	///		but being the most recently used, they are evicted last. </remarks>
+	void EnqueuePrefetch(std::vector<MemoryObject> resources);
+
 private:
 	void InitThreadFunc();
 	void CleanThreadFunc();
@@ -80,7 +90,9 @@ private:
 
 	// Event tracking
 	std::shared_ptr<gxapi::IFence> m_fence;
-	uint64_t m_fenceValue;
+	uint64_t m_fenceValue; // Protected by m_initMutex.
+
+	MemoryManager* m_memoryManager;
 };
 
 
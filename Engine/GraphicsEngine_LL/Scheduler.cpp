@@ -38,6 +38,11 @@ void Scheduler::ReleaseResources() {
 	}
 }
 
+const SubmissionStatistics& Scheduler::GetSubmissionStatistics() const {
+	return m_gpuScheduler.GetStatistics();
+}
+
+
 void Scheduler::Execute(FrameContext context) {
 	try {
 		m_cpuScheduler.RunPipeline(context, m_jobScheduler);
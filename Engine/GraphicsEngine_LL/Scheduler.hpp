@@ -33,6 +33,9 @@ public:
 	///		so that old resources won't prevent new ones from being allocated. </remarks>
 	void ReleaseResources();
 
+	/// <summary> What the last frame submitted to the graphics queue. </summary>
+	const SubmissionStatistics& GetSubmissionStatistics() const;
+
 private:
 	Pipeline m_pipeline;
 	SchedulerCPU m_cpuScheduler;
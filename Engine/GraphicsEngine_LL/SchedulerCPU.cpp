@@ -1,6 +1,9 @@
 #include "SchedulerCPU.hpp"
 
 #include "GraphicsCommandList.hpp"
+#include "SchedulerGPU.hpp"
+
+#include <algorithm>
 
 namespace inl::gxeng {
 
@@ -8,16 +11,21 @@ namespace inl::gxeng {
 SchedulerCPU::SchedulerCPU(const Pipeline& pipeline)
 	: m_pipeline(pipeline),
 	  m_listForwarding(pipeline.GetTaskGraph()),
+	  m_taskLifetimes(pipeline.GetTaskGraph()),
+	  m_outputLifetimes(pipeline.GetTaskGraph()),
 	  m_setupJobs(pipeline.GetTaskGraph()),
 	  m_executeJobs(pipeline.GetTaskGraph()),
 	  m_commandJobs(pipeline.GetTaskGraph()) {
 	CalculateListForwarding();
 	FindTaskGraphSinks();
+	CalculateTransientLifetimes();
 }
 
 SchedulerCPU::SchedulerCPU(SchedulerCPU&& rhs)
 	: m_pipeline(rhs.m_pipeline),
 	  m_listForwarding(rhs.m_pipeline.GetTaskGraph()),
+	  m_taskLifetimes(rhs.m_pipeline.GetTaskGraph()),
+	  m_outputLifetimes(rhs.m_pipeline.GetTaskGraph()),
 	  m_setupJobs(rhs.m_pipeline.GetTaskGraph()),
 	  m_executeJobs(rhs.m_pipeline.GetTaskGraph()),
 	  m_commandJobs(rhs.m_pipeline.GetTaskGraph()),
@@ -27,6 +35,8 @@ SchedulerCPU::SchedulerCPU(SchedulerCPU&& rhs)
 		m_listForwarding[arc] = rhs.m_listForwarding[arc];
 	}
 	for (lemon::ListDigraph::NodeIt node(taskGraph); node != lemon::INVALID; ++node) {
+		m_taskLifetimes[node] = rhs.m_taskLifetimes[node];
+		m_outputLifetimes[node] = rhs.m_outputLifetimes[node];
 		m_setupJobs[node] = std::move(rhs.m_setupJobs[node]);
 		m_executeJobs[node] = std::move(rhs.m_executeJobs[node]);
 	}
@@ -73,6 +83,41 @@ void SchedulerCPU::FindTaskGraphSinks() {
 }
 
 
+void SchedulerCPU::CalculateTransientLifetimes() {
+	// Lifetimes are expressed as positions in the order the GPU scheduler submits the tasks.
+	const auto& taskGraph = m_pipeline.GetTaskGraph();
+	const auto& dependencyGraph = m_pipeline.GetDependencyGraph();
+	const auto& taskParentMap = m_pipeline.GetTaskParentMap();
+	const auto sortedNodes = SchedulerGPU::SortNodes(taskGraph);
+
+	lemon::ListDigraph::NodeMap<uint32_t> order(taskGraph);
+	lemon::ListDigraph::NodeMap<uint32_t> lastTaskOfNode(dependencyGraph, 0);
+	for (uint32_t index = 0; index < sortedNodes.size(); ++index) {
+		const auto task = sortedNodes[index];
+		order[task] = index;
+		const lemon::ListDigraph::Node parent = taskParentMap[task];
+		if (parent != lemon::INVALID) {
+			lastTaskOfNode[parent] = std::max(lastTaskOfNode[parent], index);
+		}
+	}
+
+	// Outputs must stay alive until every task of the consumer nodes has run.
+	for (lemon::ListDigraph::NodeIt task(taskGraph); task != lemon::INVALID; ++task) {
+		m_taskLifetimes[task] = { order[task], order[task] };
+
+		uint32_t last = order[task];
+		const lemon::ListDigraph::Node parent = taskParentMap[task];
+		if (parent != lemon::INVALID) {
+			last = std::max(last, lastTaskOfNode[parent]);
+			for (lemon::ListDigraph::OutArcIt arc(dependencyGraph, parent); arc != lemon::INVALID; ++arc) {
+				last = std::max(last, lastTaskOfNode[dependencyGraph.target(arc)]);
+			}
+		}
+		m_outputLifetimes[task] = { order[task], last };
+	}
+}
+
+
 void SchedulerCPU::CreateSetupJobs(const FrameContext& frameContext, jobs::Scheduler& scheduler) {
 	auto& taskGraph = m_pipeline.GetTaskGraph();
 	for (lemon::ListDigraph::NodeIt nodeIt(taskGraph); nodeIt != lemon::INVALID; ++nodeIt) {
@@ -118,7 +163,9 @@ jobs::SharedFuture<void> SchedulerCPU::SetupJob(lemon::ListDigraph::Node node, c
 		frameContext.rtvHeap,
 		frameContext.dsvHeap,
 		frameContext.shaderManager,
-		frameContext.gxApi
+		frameContext.gxApi,
+		m_taskLifetimes[node],
+		m_outputLifetimes[node]
 	};
 	task.Setup(context);
 	co_return;
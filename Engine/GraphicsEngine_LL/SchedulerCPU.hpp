@@ -2,6 +2,7 @@
 
 #include "FrameContext.hpp"
 #include "Pipeline.hpp"
+#include "TransientResourceHeap.hpp"
 
 #include "BaseLibrary/JobSystem/Mutex.hpp"
 #include <BaseLibrary/JobSystem/Scheduler.hpp>
@@ -34,6 +35,7 @@ public:
 private:
 	void CalculateListForwarding();
 	void FindTaskGraphSinks();
+	void CalculateTransientLifetimes();
 
 	void CreateSetupJobs(const FrameContext& frameContext, jobs::Scheduler& scheduler);
 	void CreateExecuteJobs(const FrameContext& frameContext, jobs::Scheduler& scheduler);
@@ -47,6 +49,8 @@ private:
 	const Pipeline& m_pipeline;
 	lemon::ListDigraph::ArcMap<bool> m_listForwarding;
 	std::vector<lemon::ListDigraph::Node> m_sinks;
+	lemon::ListDigraph::NodeMap<TransientLifetime> m_taskLifetimes;
+	lemon::ListDigraph::NodeMap<TransientLifetime> m_outputLifetimes;
 	lemon::ListDigraph::NodeMap<std::shared_ptr<jobs::SharedFuture<void>>> m_setupJobs;
 	lemon::ListDigraph::NodeMap<std::shared_ptr<jobs::SharedFuture<RenderCommandCandidate>>> m_executeJobs;
 	lemon::ListDigraph::NodeMap<std::shared_ptr<jobs::SharedFuture<RenderCommand>>> m_commandJobs;
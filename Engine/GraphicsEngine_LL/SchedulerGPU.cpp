@@ -4,7 +4,11 @@
 #include "ResourceResidencyQueue.hpp"
 #include "SchedulerCPU.hpp"
 
-#include <queue>
+#include <deque>
+#include <iterator>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
 
 
 #ifdef _MSC_VER // disable lemon warnings
@@ -22,6 +26,21 @@ namespace inl::gxeng {
 
 using VolatileViewPtr = std::unique_ptr<VolatileViewHeap>;
 
+
+/// <summary> Marks the destinations of asynchronous uploads uploaded when destroyed. </summary>
+struct UploadCompletion {
+	explicit UploadCompletion(std::vector<MemoryObject> destinations) : destinations(std::move(destinations)) {}
+	UploadCompletion(UploadCompletion&&) = default;
+	UploadCompletion& operator=(UploadCompletion&&) = delete;
+	~UploadCompletion() {
+		for (auto& destination : destinations) {
+			destination._EndUpload();
+		}
+	}
+	std::vector<MemoryObject> destinations; // Empty after being moved from.
+};
+
+
 struct DecomposedRenderCommand {
 	DecomposedRenderCommand() = default;
 	DecomposedRenderCommand(CmdAllocPtr commandAllocator,
@@ -59,40 +78,59 @@ public:
 	void operator<<(RenderCommand command);
 	void Present();
 
+	const SubmissionStatistics& GetStatistics() const { return m_statistics; }
+
 private:
 	/// <summary> Dissects the command list to raw gxapi command list and resource information. </summary>
 	DecomposedRenderCommand DecomposeRenderCommand(RenderCommand command);
 
 	/// <summary> Injects transition barriers into <paramref name="subject"/> to match states for <paramref name="next"/>. </summary>
+	/// <remarks> If the resource was last used by an earlier command that is still in the queue,
+	///		the transition is split: it begins right after that command and ends in <paramref name="subject"/>. </remarks>
 	void InjectBarriers(DecomposedRenderCommand& subject, const DecomposedRenderCommand& next);
 
 	/// <summary> Injects transition barrier into <paramref name="subject"/> to set back-buffer to PRESENT. </summary>
 	void FinalizeBackBuffer(DecomposedRenderCommand& subject);
 
-	/// <summary> Submits some command lists to the command queue. </summary>
-	/// <param name="chunk"> How many lists to submit at once. </param>
+	/// <summary> Submits command lists to the command queue in batches. </summary>
+	/// <param name="chunk"> How many lists to submit at once. Zero submits everything in one batch. </param>
 	/// <param name="keep"> How many lists to keep in m_queue. </param>
-	void SubmitSome(size_t chunk = 5, size_t keep = 1);
+	/// <remarks> Commands kept in the queue can still receive the beginning of split barriers. </remarks>
+	void SubmitSome(size_t chunk = 5, size_t keep = 3);
 
-	/// <summary> Enqueues command list, manages init and clean jobs. </summary>
-	template <class... Args>
-	static void Submit(CommandQueue& target,
-					   const FrameContext& context,
-					   CmdListPtr list,
-					   std::vector<MemoryObject> usedResources,
-					   Args&&... cleanables);
+	/// <summary> Enqueues the command lists with a single call, manages init and clean jobs. </summary>
+	void SubmitBatch(size_t count);
 
 	/// <summary> Barriers from the resource's current state to the first usage state. </summary>
-	static std::vector<gxapi::ResourceBarrier> TransitionBarriers(const std::vector<ResourceUsage>& usages);
+	/// <remarks> Subresources that all transition the same way are merged into a single whole-resource barrier,
+	///		and transitions that are repeated or have nothing to do are dropped. </remarks>
+	std::vector<gxapi::TransitionBarrier> TransitionBarriers(const std::vector<ResourceUsage>& usages);
+
+	/// <summary> Aliasing barriers for transient resources that are used the first time this frame. </summary>
+	/// <param name="discards"> Receives the resources whose previous contents can be thrown away. </param>
+	std::vector<gxapi::ResourceBarrier> AliasingBarriers(const std::vector<ResourceUsage>& usages, std::vector<gxapi::IResource*>& discards);
 
 	/// <summary> Update the state of the resources to the last usage state. </summary>
 	static void UpdateResourceStates(std::vector<ResourceUsage>& usages);
 
+	/// <summary> Remembers that the resources were last used by the command with the given sequence number. </summary>
+	void UpdateLastUses(const std::vector<ResourceUsage>& usages, uint64_t sequence);
+
+	/// <summary> Returns the queued command with the given sequence number, or null if it has been submitted. </summary>
+	DecomposedRenderCommand* FindQueued(uint64_t sequence);
+
 	/// <summary> Concatenates the two sets of <see cref="MemoryObject"/>s. </summary>
 	std::vector<MemoryObject> UsedResources(const std::vector<ResourceUsage>& usages, std::vector<MemoryObject> additional);
 
+	/// <summary> Creates an ad-hoc command list for <paramref name="subject"/> if it has none. </summary>
+	gxapi::IGraphicsCommandList* RequireCommandList(DecomposedRenderCommand& subject);
+
 private:
-	std::queue<DecomposedRenderCommand> m_queue;
+	std::deque<DecomposedRenderCommand> m_queue;
+	uint64_t m_frontSequence = 0; // Sequence number of m_queue.front().
+	std::unordered_map<const gxapi::IResource*, uint64_t> m_lastUses;
+	std::unordered_set<const gxapi::IResource*> m_activatedTransients;
+	SubmissionStatistics m_statistics;
 	const FrameContext& m_context;
 };
 
@@ -105,19 +143,20 @@ void LinearQueue::operator<<(RenderCommand command) {
 	DecomposedRenderCommand decomp = DecomposeRenderCommand(std::move(command));
 
 	if (m_queue.empty()) {
-		m_queue.push({});
+		m_queue.push_back({});
 	}
 	InjectBarriers(m_queue.back(), decomp);
 	UpdateResourceStates(decomp.usedResources);
+	UpdateLastUses(decomp.usedResources, m_frontSequence + m_queue.size());
 
-	m_queue.push(std::move(decomp));
+	m_queue.push_back(std::move(decomp));
 	SubmitSome();
 }
 
 
 void LinearQueue::Present() {
 	if (m_queue.empty()) {
-		m_queue.push({});
+		m_queue.push_back({});
 	}
 	FinalizeBackBuffer(m_queue.back());
 
@@ -137,26 +176,47 @@ DecomposedRenderCommand LinearQueue::DecomposeRenderCommand(RenderCommand comman
 }
 
 
-std::vector<gxapi::ResourceBarrier> LinearQueue::TransitionBarriers(const std::vector<ResourceUsage>& usages) {
-	std::vector<gxapi::ResourceBarrier> barriers;
+std::vector<gxapi::TransitionBarrier> LinearQueue::TransitionBarriers(const std::vector<ResourceUsage>& usages) {
+	std::vector<gxapi::TransitionBarrier> barriers;
+	std::unordered_set<const gxapi::IResource*> wholeResources;
+	std::set<std::pair<const gxapi::IResource*, unsigned>> subresources;
+
+	auto AddBarrier = [&](gxapi::IResource* resource, unsigned subresource, gxapi::eResourceState sourceState, gxapi::eResourceState targetState) {
+		if (sourceState == targetState || wholeResources.count(resource) || !subresources.insert({ resource, subresource }).second) {
+			return;
+		}
+		barriers.push_back(gxapi::TransitionBarrier{ .resource = resource, .subResource = subresource, .beforeState = sourceState, .afterState = targetState });
+	};
 
 	for (auto& usage : usages) {
 		const MemoryObject& resource = usage.resource;
+		gxapi::IResource* native = resource._GetResourcePtr();
 		unsigned subresource = usage.subresource;
 		gxapi::eResourceState targetState = usage.firstState;
 
 		if (subresource != gxapi::ALL_SUBRESOURCES) {
-			gxapi::eResourceState sourceState = resource.ReadState(subresource);
-			if (sourceState != targetState) {
-				barriers.push_back(gxapi::TransitionBarrier{ .resource = resource._GetResourcePtr(), .subResource = subresource, .beforeState = sourceState, .afterState = targetState });
+			AddBarrier(native, subresource, resource.ReadState(subresource), targetState);
+			continue;
+		}
+
+		// A single barrier does if all subresources come from the same state and none was handled separately.
+		const unsigned numSubresources = resource.GetNumSubresources();
+		const gxapi::eResourceState commonState = resource.ReadState(0);
+		bool uniform = !wholeResources.count(native);
+		for (unsigned subresourceIdx = 0; subresourceIdx < numSubresources && uniform; ++subresourceIdx) {
+			uniform = resource.ReadState(subresourceIdx) == commonState && !subresources.count({ native, subresourceIdx });
+		}
+
+		if (uniform) {
+			wholeResources.insert(native);
+			if (commonState != targetState) {
+				barriers.push_back(gxapi::TransitionBarrier{ .resource = native, .subResource = gxapi::ALL_SUBRESOURCES, .beforeState = commonState, .afterState = targetState });
+				m_statistics.mergedBarriers += numSubresources - 1;
 			}
 		}
 		else {
-			for (unsigned subresourceIdx = 0; subresourceIdx < resource.GetNumSubresources(); ++subresourceIdx) {
-				gxapi::eResourceState sourceState = resource.ReadState(subresourceIdx);
-				if (sourceState != targetState) {
-					barriers.push_back(gxapi::TransitionBarrier{ .resource = resource._GetResourcePtr(), .subResource = subresourceIdx, .beforeState = sourceState, .afterState = targetState });
-				}
+			for (unsigned subresourceIdx = 0; subresourceIdx < numSubresources; ++subresourceIdx) {
+				AddBarrier(native, subresourceIdx, resource.ReadState(subresourceIdx), targetState);
 			}
 		}
 	}
@@ -165,6 +225,34 @@ std::vector<gxapi::ResourceBarrier> LinearQueue::TransitionBarriers(const std::v
 }
 
 
+std::vector<gxapi::ResourceBarrier> LinearQueue::AliasingBarriers(const std::vector<ResourceUsage>& usages, std::vector<gxapi::IResource*>& discards) {
+	std::vector<gxapi::ResourceBarrier> barriers;
+
+	for (auto& usage : usages) {
+		const MemoryObject& resource = usage.resource;
+		if (resource.GetHeap() != eResourceHeap::TRANSIENT) {
+			continue;
+		}
+		gxapi::IResource* native = resource._GetResourcePtr();
+		if (!m_activatedTransients.insert(native).second) {
+			continue;
+		}
+
+		// The memory may have been used by another transient resource since the last use of this one.
+		barriers.push_back(gxapi::AliasingBarrier{ .before = nullptr, .after = native });
+
+		const gxapi::eResourceState state = usage.firstState;
+		if (state == gxapi::eResourceState::RENDER_TARGET
+			|| state == gxapi::eResourceState::DEPTH_WRITE
+			|| state == gxapi::eResourceState::UNORDERED_ACCESS) {
+			discards.push_back(native);
+		}
+	}
+
+	return barriers;
+}
+
+
 void LinearQueue::UpdateResourceStates(std::vector<ResourceUsage>& usages) {
 	for (auto& usage : usages) {
 		if (usage.subresource != gxapi::ALL_SUBRESOURCES) {
@@ -179,6 +267,21 @@ void LinearQueue::UpdateResourceStates(std::vector<ResourceUsage>& usages) {
 }
 
 
+void LinearQueue::UpdateLastUses(const std::vector<ResourceUsage>& usages, uint64_t sequence) {
+	for (auto& usage : usages) {
+		m_lastUses[usage.resource._GetResourcePtr()] = sequence;
+	}
+}
+
+
+DecomposedRenderCommand* LinearQueue::FindQueued(uint64_t sequence) {
+	if (sequence < m_frontSequence || sequence >= m_frontSequence + m_queue.size()) {
+		return nullptr;
+	}
+	return &m_queue[sequence - m_frontSequence];
+}
+
+
 std::vector<MemoryObject> LinearQueue::UsedResources(const std::vector<ResourceUsage>& usages, std::vector<MemoryObject> additional) {
 	std::vector<MemoryObject> usedResourceList = std::move(additional);
 
@@ -193,17 +296,45 @@ std::vector<MemoryObject> LinearQueue::UsedResources(const std::vector<ResourceU
 	return usedResourceList;
 }
 
+
+gxapi::IGraphicsCommandList* LinearQueue::RequireCommandList(DecomposedRenderCommand& subject) {
+	if (!subject.commandList) {
+		subject.commandAllocator = m_context.commandAllocatorPool->RequestAllocator(gxapi::eCommandListType::GRAPHICS);
+		subject.commandList = m_context.commandListPool->RequestGraphicsList(subject.commandAllocator.get());
+	}
+	return dynamic_cast<gxapi::IGraphicsCommandList*>(subject.commandList.get());
+}
+
+
 void LinearQueue::InjectBarriers(DecomposedRenderCommand& subject, const DecomposedRenderCommand& next) {
-	auto barriers = TransitionBarriers(next.usedResources);
+	std::vector<gxapi::IResource*> discards;
+	auto barriers = AliasingBarriers(next.usedResources, discards);
+	m_statistics.aliasingBarriers += (uint32_t)barriers.size();
+
+	const uint64_t subjectSequence = m_frontSequence + m_queue.size() - 1;
+	for (auto& transition : TransitionBarriers(next.usedResources)) {
+		// Give the GPU time to do the transition while the commands in between run.
+		auto lastUse = m_lastUses.find(transition.resource);
+		DecomposedRenderCommand* producer = lastUse != m_lastUses.end() && lastUse->second < subjectSequence ? FindQueued(lastUse->second) : nullptr;
+		if (producer && producer->commandList) {
+			gxapi::TransitionBarrier begin = transition;
+			begin.splitMode = gxapi::eResourceBarrierSplit::BEGIN;
+			dynamic_cast<gxapi::ICopyCommandList*>(producer->commandList.get())->ResourceBarrier(begin);
+			transition.splitMode = gxapi::eResourceBarrierSplit::END;
+			++m_statistics.splitBarriers;
+		}
+		barriers.push_back(transition);
+		++m_statistics.transitionBarriers;
+	}
 
 	if (!barriers.empty()) {
-		// Create an ad-hoc command list just for the barriers.
-		if (!subject.commandList) {
-			subject.commandAllocator = m_context.commandAllocatorPool->RequestAllocator(gxapi::eCommandListType::GRAPHICS);
-			subject.commandList = m_context.commandListPool->RequestGraphicsList(subject.commandAllocator.get());
-		}
-		auto* underlyingList = dynamic_cast<gxapi::IGraphicsCommandList*>(subject.commandList.get());
+		auto* underlyingList = RequireCommandList(subject);
 		underlyingList->ResourceBarrier((unsigned)barriers.size(), barriers.data());
+
+		// Discarding tells the driver it need not preserve or decompress the aliased memory.
+		for (auto resource : discards) {
+			underlyingList->DiscardResource(resource);
+		}
 	}
 }
 
@@ -211,62 +342,77 @@ void LinearQueue::FinalizeBackBuffer(DecomposedRenderCommand& subject) {
 	Texture2D backBuffer = m_context.backBuffer;
 	gxapi::eResourceState backBufferState = backBuffer.ReadState(0);
 	if (backBufferState != gxapi::eResourceState::PRESENT) {
-		// Create an ad-hoc list.
-		if (!subject.commandList) {
-			subject.commandAllocator = m_context.commandAllocatorPool->RequestAllocator(gxapi::eCommandListType::GRAPHICS);
-			subject.commandList = m_context.commandListPool->RequestGraphicsList(subject.commandAllocator.get());
-		}
-
 		gxapi::TransitionBarrier barrier{ .resource = m_context.backBuffer._GetResourcePtr(), .beforeState = backBufferState, .afterState = gxapi::eResourceState::PRESENT };
-		dynamic_cast<gxapi::ICopyCommandList*>(subject.commandList.get())->ResourceBarrier(barrier);
+		RequireCommandList(subject)->ResourceBarrier(barrier);
 		backBuffer.RecordState(gxapi::eResourceState::PRESENT);
+		++m_statistics.transitionBarriers;
 	}
 }
 
 void LinearQueue::SubmitSome(size_t chunk, size_t keep) {
-	while (m_queue.size() > keep) {
-		auto& command = m_queue.front();
-		if (command.commandList) {
-			auto usedResource = UsedResources(command.usedResources, command.additionalResources);
-
-			Submit(*m_context.commandQueue,
-				   m_context,
-				   std::move(command.commandList),
-				   std::move(usedResource),
-				   std::move(command.scratchSpaces),
-				   std::move(command.commandAllocator),
-				   std::move(command.volatileViewHeap));
+	if (chunk == 0) {
+		if (m_queue.size() > keep) {
+			SubmitBatch(m_queue.size() - keep);
 		}
-
-		m_queue.pop();
+		return;
+	}
+	while (m_queue.size() >= keep + chunk) {
+		SubmitBatch(chunk);
 	}
 }
 
 
-template <class... Args>
-void LinearQueue::Submit(CommandQueue& target,
-						 const FrameContext& context,
-						 CmdListPtr list,
-						 std::vector<MemoryObject> usedResources,
-						 Args&&... cleanables) {
-	// Enqueue CPU task to make resources resident before the command list runs.
-	SyncPoint residentPoint = context.residencyQueue->EnqueueInit(usedResources);
+void LinearQueue::SubmitBatch(size_t count) {
+	std::vector<CmdListPtr> lists;
+	std::vector<MemoryObject> usedResources;
+	std::vector<std::vector<ScratchSpacePtr>> scratchSpaces;
+	std::vector<CmdAllocPtr> commandAllocators;
+	std::vector<VolatileViewPtr> volatileViewHeaps;
 
-	// Close the command list.
-	dynamic_cast<gxapi::ICopyCommandList*>(list.get())->Close();
+	for (size_t i = 0; i < count; ++i) {
+		auto& command = m_queue.front();
+		if (command.commandList) {
+			auto commandResources = UsedResources(command.usedResources, std::move(command.additionalResources));
+			usedResources.insert(usedResources.end(), std::make_move_iterator(commandResources.begin()), std::make_move_iterator(commandResources.end()));
+
+			dynamic_cast<gxapi::ICopyCommandList*>(command.commandList.get())->Close();
+			lists.push_back(std::move(command.commandList));
+			scratchSpaces.push_back(std::move(command.scratchSpaces));
+			commandAllocators.push_back(std::move(command.commandAllocator));
+			volatileViewHeaps.push_back(std::move(command.volatileViewHeap));
+		}
 
-	// Enqueue the command list itself on the GPU.
-	gxapi::ICommandList* execLists[] = {
-		list.get(),
-	};
-	context.commandQueue->Wait(residentPoint);
-	context.commandQueue->ExecuteCommandLists(1, execLists);
-	SyncPoint completionPoint = context.commandQueue->Signal();
+		m_queue.pop_front();
+		++m_frontSequence;
+	}
 
-	// Enqueue CPU task to clean up resources after command list finished.
-	context.residencyQueue->EnqueueClean(completionPoint, std::move(usedResources), std::forward<Args>(cleanables)...);
-}
+	if (lists.empty()) {
+		return;
+	}
+
+	// Enqueue CPU task to make resources resident before the command lists run.
+	SyncPoint residentPoint = m_context.residencyQueue->EnqueueInit(usedResources);
 
+	// Enqueue the command lists themselves on the GPU.
+	std::vector<gxapi::ICommandList*> execLists;
+	execLists.reserve(lists.size());
+	for (auto& list : lists) {
+		execLists.push_back(list.get());
+	}
+	m_context.commandQueue->Wait(residentPoint);
+	m_context.commandQueue->ExecuteCommandLists((unsigned)execLists.size(), execLists.data());
+	SyncPoint completionPoint = m_context.commandQueue->Signal();
+
+	++m_statistics.submissions;
+	m_statistics.commandLists += (uint32_t)lists.size();
+
+	// Enqueue CPU task to clean up resources after command lists finished.
+	m_context.residencyQueue->EnqueueClean(completionPoint,
+										   std::move(usedResources),
+										   std::move(scratchSpaces),
+										   std::move(commandAllocators),
+										   std::move(volatileViewHeaps));
+}
 
 SchedulerGPU::SchedulerGPU(Pipeline& pipeline) : m_pipeline(pipeline) {
 }
@@ -314,6 +460,7 @@ jobs::SharedFuture<void> SchedulerGPU::EnqueueCommands(const FrameContext& frame
 	}
 
 	linearQueue.Present();
+	m_statistics = linearQueue.GetStatistics();
 }
 
 
@@ -325,29 +472,82 @@ RenderCommand SchedulerGPU::UploadResources(const FrameContext& frameContext) {
 													   *frameContext.commandAllocatorPool,
 													   *frameContext.scratchSpacePool,
 													   *frameContext.memoryManager, *vheap);
-	for (auto& request : uploads) {
-		// Init copy parameters
-		auto& source = request.source;
-		auto& destination = request.destination;
-
-		// Set resource states
-		clist->SetResourceState(destination, gxapi::eResourceState::COPY_DEST);
-
-		auto destType = request.destType;
+	std::unique_ptr<CopyCommandList> asyncList;
+	std::vector<MemoryObject> asyncDestinations;
 
-		if (destType == UploadManager::DestType::BUFFER) {
-			auto& dstBuffer = static_cast<const LinearBuffer&>(destination);
-			clist->CopyBuffer(dstBuffer, request.dstOffsetX, source, 0, source.GetSize());
+	for (auto& request : uploads) {
+		// Resources that are not in use by the graphics queue are filled on the copy queue.
+		if (request.onCopyQueue) {
+			assert(frameContext.copyCommandQueue);
+			if (!asyncList) {
+				asyncList = std::make_unique<CopyCommandList>(frameContext.gxApi,
+															  *frameContext.commandListPool,
+															  *frameContext.commandAllocatorPool,
+															  *frameContext.scratchSpacePool);
+			}
+			RecordUpload(*asyncList, request);
+			asyncDestinations.push_back(request.destination);
 		}
-		else if (destType == UploadManager::DestType::TEXTURE_2D) {
-			auto& dstTexture = static_cast<const Texture2D&>(destination);
-			SubTexture2D dstPlace(request.dstSubresource, Vector<intptr_t, 2>((intptr_t)request.dstOffsetX, (intptr_t)request.dstOffsetY));
-			clist->CopyTexture(dstTexture, source, dstPlace, request.textureBufferDesc);
+		else {
+			clist->SetResourceState(request.destination, gxapi::eResourceState::COPY_DEST);
+			RecordUpload(*clist, request);
 		}
 	}
 
+	if (asyncList) {
+		SubmitAsyncUploads(frameContext, std::move(asyncList), std::move(asyncDestinations));
+	}
+
 	return { std::move(clist), std::move(vheap) };
 }
 
 
+void SchedulerGPU::RecordUpload(CopyCommandList& commandList, const UploadManager::UploadDescription& request) {
+	auto& source = request.source;
+	auto& destination = request.destination;
+
+	if (request.destType == UploadManager::DestType::BUFFER) {
+		auto& dstBuffer = static_cast<const LinearBuffer&>(destination);
+		commandList.CopyBuffer(dstBuffer, request.dstOffsetX, source, request.srcOffset, request.srcSize);
+	}
+	else if (request.destType == UploadManager::DestType::TEXTURE_2D) {
+		auto& dstTexture = static_cast<const Texture2D&>(destination);
+		SubTexture2D dstPlace(request.dstSubresource, Vector<intptr_t, 2>((intptr_t)request.dstOffsetX, (intptr_t)request.dstOffsetY));
+		commandList.CopyTexture(dstTexture, source, dstPlace, request.textureBufferDesc);
+	}
+}
+
+
+void SchedulerGPU::SubmitAsyncUploads(const FrameContext& frameContext, std::unique_ptr<CopyCommandList> commandList, std::vector<MemoryObject> destinations) {
+	auto decomposition = commandList->Decompose();
+
+	// The copy queue promotes COMMON resources to COPY_DEST implicitly and they decay back
+	// to COMMON once the copy finishes, so no barriers are needed and the tracked states stay valid.
+	std::vector<MemoryObject> usedResources = std::move(decomposition.additionalResources);
+	usedResources.reserve(usedResources.size() + decomposition.usedResources.size());
+	for (auto& usage : decomposition.usedResources) {
+		usedResources.push_back(std::move(usage.resource));
+	}
+
+	CommandQueue& copyQueue = *frameContext.copyCommandQueue;
+	SyncPoint residentPoint = frameContext.residencyQueue->EnqueueInit(usedResources);
+
+	dynamic_cast<gxapi::ICopyCommandList*>(decomposition.commandList.get())->Close();
+	gxapi::ICommandList* execLists[] = {
+		decomposition.commandList.get(),
+	};
+	copyQueue.Wait(residentPoint);
+	copyQueue.ExecuteCommandLists(1, execLists);
+	SyncPoint completionPoint = copyQueue.Signal();
+
+	// The graphics queue does not wait for the copy, the destinations are released
+	// to rendering when the clean job destroys the completion after the copy has finished.
+	frameContext.residencyQueue->EnqueueClean(completionPoint,
+											  std::move(usedResources),
+											  std::move(decomposition.scratchSpaces),
+											  std::move(decomposition.commandAllocator),
+											  UploadCompletion{ std::move(destinations) });
+}
+
+
 } // namespace inl::gxeng
\ No newline at end of file
@@ -18,6 +18,18 @@ namespace inl::gxeng {
 
 struct RenderCommand;
 class SchedulerCPU;
+class CopyCommandList;
+
+
+/// <summary> Counts the work the GPU scheduler submitted to the graphics queue during a frame. </summary>
+struct SubmissionStatistics {
+	uint32_t submissions = 0; // Calls to ExecuteCommandLists.
+	uint32_t commandLists = 0;
+	uint32_t transitionBarriers = 0; // A split barrier counts once.
+	uint32_t splitBarriers = 0;
+	uint32_t aliasingBarriers = 0;
+	uint32_t mergedBarriers = 0; // Subresource barriers saved by whole-resource transitions.
+};
 
 
 class SchedulerGPU {
@@ -27,6 +39,9 @@ public:
 	void RunPipeline(const FrameContext& frameContext, jobs::Scheduler& scheduler, const SchedulerCPU& cpuScheduler);
 	static std::vector<lemon::ListDigraph::Node> SortNodes(const lemon::ListDigraph& taskGraph);
 
+	/// <summary> Statistics of the last frame that was run. </summary>
+	const SubmissionStatistics& GetStatistics() const { return m_statistics; }
+
 private:
 	struct UsedResource {
 		MemoryObject* resource;
@@ -39,8 +54,14 @@ private:
 	jobs::SharedFuture<void> EnqueueCommands(const FrameContext& frameContext, const SchedulerCPU& cpuScheduler);
 	RenderCommand UploadResources(const FrameContext& frameContext);
 
+	static void RecordUpload(CopyCommandList& commandList, const UploadManager::UploadDescription& request);
+	/// <summary> Executes the uploads on the copy queue without making the graphics queue wait for them. </summary>
+	/// <remarks> The destinations count as uploaded once the copy queue has finished, rendering skips them until then. </remarks>
+	static void SubmitAsyncUploads(const FrameContext& frameContext, std::unique_ptr<CopyCommandList> commandList, std::vector<MemoryObject> destinations);
+
 private:
 	const Pipeline& m_pipeline;
+	SubmissionStatistics m_statistics;
 };
 
 
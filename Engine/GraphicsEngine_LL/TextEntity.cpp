@@ -3,7 +3,6 @@
 #include "Font.hpp"
 
 #include <BaseLibrary/Exception/Exception.hpp>
-#include <BaseLibrary/StringUtil.hpp>
 
 namespace inl::gxeng {
 
@@ -11,14 +10,25 @@ namespace inl::gxeng {
 TextEntity::TextEntity() {}
 
 void TextEntity::SetFont(std::shared_ptr<const Font> font) {
+	if (m_font != font) {
+		m_shapedText.reset();
+		Modified();
+	}
 	m_font = font;
 }
 
 void TextEntity::SetColor(Vec4 color) {
-	m_color = color;
+	if (m_color != color) {
+		m_color = color;
+		Modified();
+	}
 }
 
 void TextEntity::SetText(std::u32string text) {
+	if (m_text != text) {
+		m_shapedText.reset();
+		Modified();
+	}
 	m_text = std::move(text);
 }
 
@@ -26,11 +36,17 @@ void TextEntity::SetFontSize(float size) {
 	if (size <= 0.0f) {
 		throw InvalidArgumentException("Font size must be a positive real number.");
 	}
-	m_fontSize = size;
+	if (m_fontSize != size) {
+		m_fontSize = size;
+		Modified();
+	}
 }
 
 void TextEntity::SetSize(const Vec2& size) {
-	m_size = size;
+	if (m_size != size) {
+		m_size = size;
+		Modified();
+	}
 }
 
 std::shared_ptr<const IFont> TextEntity::GetFont() const {
@@ -56,12 +72,16 @@ float TextEntity::GetFontSize() const {
 void TextEntity::SetAdditionalClip(RectF clipRectangle, Mat33 transform) {
 	m_clipRect = clipRectangle;
 	m_clipRectTransform = transform;
+	Modified();
 }
 std::pair<RectF, Mat33> TextEntity::GetAdditionalClip() const {
 	return { m_clipRect, m_clipRectTransform };
 }
 void TextEntity::EnableAdditionalClip(bool enabled) {
-	m_clipEnabled = enabled;
+	if (m_clipEnabled != enabled) {
+		m_clipEnabled = enabled;
+		Modified();
+	}
 }
 bool TextEntity::IsAdditionalClipEnabled() const {
 	return m_clipEnabled;
@@ -69,10 +89,16 @@ bool TextEntity::IsAdditionalClipEnabled() const {
 
 
 void TextEntity::SetHorizontalAlignment(float alignment) {
-	m_alignment.x = alignment;
+	if (m_alignment.x != alignment) {
+		m_alignment.x = alignment;
+		Modified();
+	}
 }
 void TextEntity::SetVerticalAlignment(float alignment) {
-	m_alignment.y = alignment;
+	if (m_alignment.y != alignment) {
+		m_alignment.y = alignment;
+		Modified();
+	}
 }
 float TextEntity::GetHorizontalAlignment() const {
 	return m_alignment.x;
@@ -82,23 +108,7 @@ float TextEntity::GetVerticalAlignment() const {
 }
 
 float TextEntity::CalculateTextWidth() const {
-	if (m_font) {
-		// Convert string to UCS-4 code-points.
-		std::u32string text = EncodeString<char32_t>(m_text);
-
-		// Accumulate length.
-		float width = 0.0f;
-		for (auto ch : text) {
-			if (!m_font->IsCharacterSupported(ch)) {
-				continue;
-			}
-			width += m_fontSize * m_font->GetGlyphInfo(ch).advance;
-		}
-		return width;
-	}
-	else {
-		throw InvalidCallException("Cannot calculate text metrics because no font is set.");
-	}
+	return m_fontSize * GetShapedText().width;
 }
 
 float TextEntity::CalculateTextHeight() const {
@@ -110,19 +120,45 @@ float TextEntity::CalculateTextHeight() const {
 	}
 }
 
+intptr_t TextEntity::FindCharacter(float coordinate) const {
+	return GetShapedText().FindCharacter(coordinate / m_fontSize);
+}
+
+std::pair<float, float> TextEntity::FindCoordinates(size_t index) const {
+	auto [left, right] = GetShapedText().FindCoordinates(index);
+	return { left * m_fontSize, right * m_fontSize };
+}
+
+const Font::ShapedText& TextEntity::GetShapedText() const {
+	if (!m_font) {
+		throw InvalidCallException("Cannot calculate text metrics because no font is set.");
+	}
+	const uint64_t revision = m_font->GetRevision();
+	if (!m_shapedText || m_shapedRevision != revision) {
+		m_shapedText = m_font->Shape(m_text);
+		m_shapedRevision = revision;
+	}
+	return m_shapedText.value();
+}
+
 const Vec2& TextEntity::GetSize() const {
 	return m_size;
 }
 
 
 void TextEntity::SetZDepth(float z) {
-	m_zDepth = z;
+	if (m_zDepth != z) {
+		m_zDepth = z;
+		Modified();
+	}
 }
 float TextEntity::GetZDepth() const {
 	return m_zDepth;
 }
 
 Transform2D& TextEntity::Transform() {
+	// The transform may be changed through the reference.
+	Modified();
 	return m_transform;
 }
 
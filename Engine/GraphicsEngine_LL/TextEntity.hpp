@@ -7,6 +7,7 @@
 #include <GraphicsEngine/Scene/ITextEntity.hpp>
 
 #include <InlineMath.hpp>
+#include <optional>
 #include <utility>
 #include <variant>
 
@@ -82,6 +83,14 @@ public:
 	float CalculateTextWidth() const override;
 	/// <summary> Return the height of a line of text without top and bottom line spacing. </summary>
 	float CalculateTextHeight() const override;
+	/// <summary> Return the index of the character at the horizontal coordinate, see <see cref="IFont::FindCharacter"/>. </summary>
+	intptr_t FindCharacter(float coordinate) const override;
+	/// <summary> Return the horizontal interval the character at index spans, see <see cref="IFont::FindCoordinates"/>. </summary>
+	std::pair<float, float> FindCoordinates(size_t index) const override;
+
+	/// <summary> Returns the glyph layout of the text in units of the font size. </summary>
+	/// <remarks> The layout is cached until the text or the font changes. </remarks>
+	const Font::ShapedText& GetShapedText() const;
 
 	/// <summary> Z-Depth determines which 2D entity lays over the other. </summary>
 	/// <remarks> Number are not limited to [0,1], anything is fine. Don't pass NaN and Inf. </remarks>
@@ -95,6 +104,8 @@ private:
 	float m_fontSize = 16;
 	std::u32string m_text;
 	std::shared_ptr<const Font> m_font = nullptr;
+	mutable std::optional<Font::ShapedText> m_shapedText;
+	mutable uint64_t m_shapedRevision = 0;
 	float m_zDepth = 0.0f;
 	Vec2 m_size = { 16, 16 };
 
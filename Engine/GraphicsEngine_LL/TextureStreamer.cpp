@@ -0,0 +1,104 @@
+#include "TextureStreamer.hpp"
+
+#include "Image.hpp"
+#include "UploadManager.hpp"
+
+#include <algorithm>
+
+
+namespace inl::gxeng {
+
+
+namespace impl {
+
+	uint64_t FitStreamingBudget(std::vector<StreamingCandidate>& candidates, uint64_t budget) {
+		uint64_t totalSize = 0;
+		for (auto& candidate : candidates) {
+			candidate.desiredMip = std::min(candidate.desiredMip, candidate.tailMip);
+			totalSize += (*candidate.chainSizes)[candidate.desiredMip];
+		}
+
+		while (totalSize > budget) {
+			// Drop a mip from the texture that was needed the longest ago, the largest one if there is a tie.
+			StreamingCandidate* victim = nullptr;
+			for (auto& candidate : candidates) {
+				if (candidate.desiredMip >= candidate.tailMip) {
+					continue;
+				}
+				if (!victim
+					|| candidate.lastRequestedFrame < victim->lastRequestedFrame
+					|| (candidate.lastRequestedFrame == victim->lastRequestedFrame
+						&& (*candidate.chainSizes)[candidate.desiredMip] > (*victim->chainSizes)[victim->desiredMip])) {
+					victim = &candidate;
+				}
+			}
+			if (!victim) {
+				break;
+			}
+
+			const auto& sizes = *victim->chainSizes;
+			totalSize -= sizes[victim->desiredMip] - sizes[victim->desiredMip + 1];
+			++victim->desiredMip;
+		}
+
+		return totalSize;
+	}
+
+} // namespace impl
+
+
+
+void TextureStreamer::Register(Image* image) {
+	std::lock_guard<std::mutex> lock(m_mtx);
+	m_images.insert(image);
+}
+
+
+void TextureStreamer::Unregister(Image* image) {
+	std::lock_guard<std::mutex> lock(m_mtx);
+	m_images.erase(image);
+}
+
+
+void TextureStreamer::Update(uint64_t frame) {
+	std::lock_guard<std::mutex> lock(m_mtx);
+
+	// Images switch to their new mip chains once all their uploads have completed.
+	for (Image* image : m_images) {
+		image->CommitResidencyChange();
+	}
+
+	std::vector<Image*> images(m_images.begin(), m_images.end());
+	std::vector<impl::StreamingCandidate> candidates;
+	candidates.reserve(images.size());
+	for (Image* image : images) {
+		candidates.push_back(image->GetStreamingCandidate(frame, FORGET_FRAMES));
+	}
+
+	m_residentSize = impl::FitStreamingBudget(candidates, m_budget);
+
+	for (size_t i = 0; i < images.size(); ++i) {
+		images[i]->BeginResidencyChange(candidates[i].desiredMip);
+	}
+}
+
+
+void TextureStreamer::SetBudget(uint64_t bytes) {
+	std::lock_guard<std::mutex> lock(m_mtx);
+	m_budget = bytes;
+}
+
+
+uint64_t TextureStreamer::GetBudget() const {
+	std::lock_guard<std::mutex> lock(m_mtx);
+	return m_budget;
+}
+
+
+uint64_t TextureStreamer::GetResidentSize() const {
+	std::lock_guard<std::mutex> lock(m_mtx);
+	return m_residentSize;
+}
+
+
+} // namespace inl::gxeng
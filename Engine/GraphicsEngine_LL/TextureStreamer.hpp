@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+
+namespace inl::gxeng {
+
+
+class Image;
+class UploadManager;
+
+
+namespace impl {
+
+	struct StreamingCandidate {
+		unsigned desiredMip; // Most detailed mip the renderer asked for, lowered if it does not fit.
+		unsigned tailMip; // Least detailed mip chain, this is always resident.
+		uint64_t lastRequestedFrame;
+		const std::vector<uint64_t>* chainSizes; // Size of the mip chain starting at each mip.
+	};
+
+	/// <summary> Lowers the detail of the least recently requested textures until their mip chains fit in the budget. </summary>
+	/// <returns> The total size of the selected mip chains. It can exceed the budget if the tail mips alone do. </returns>
+	uint64_t FitStreamingBudget(std::vector<StreamingCandidate>& candidates, uint64_t budget);
+
+} // namespace impl
+
+
+
+/// <summary> Decides which mip levels of streaming images are resident and uploads them. </summary>
+/// <remarks> Streaming images keep their pixels in system memory and only have the mip chain
+///		that the renderer requested in GPU memory. The total size of the resident chains
+///		is kept within the budget by dropping detail from textures that were not requested for the longest. </remarks>
+class TextureStreamer {
+public:
+	TextureStreamer(UploadManager& uploadManager) : m_uploadManager(uploadManager) {}
+
+	void Register(Image* image);
+	void Unregister(Image* image);
+
+	/// <summary> Applies the mip requests of the previous frame. </summary>
+	/// <remarks> Must be called before the uploads of the frame are queried. </remarks>
+	void Update(uint64_t frame);
+
+	/// <summary> Sets how many bytes the resident mips of streaming images may occupy. </summary>
+	void SetBudget(uint64_t bytes);
+	uint64_t GetBudget() const;
+
+	/// <summary> The size of the mip chains selected in the last update. </summary>
+	uint64_t GetResidentSize() const;
+
+private:
+	UploadManager& m_uploadManager;
+	std::unordered_set<Image*> m_images;
+	uint64_t m_budget = DEFAULT_BUDGET;
+	uint64_t m_residentSize = 0;
+	mutable std::mutex m_mtx;
+
+	static constexpr uint64_t DEFAULT_BUDGET = 1024ull * 1024 * 1024;
+	static constexpr uint64_t FORGET_FRAMES = 120; // Textures not requested for this long go back to their tail mips.
+};
+
+
+} // namespace inl::gxeng
@@ -0,0 +1,149 @@
+#include "TransientResourceHeap.hpp"
+
+#include "CriticalBufferHeap.hpp"
+#include "MemoryManager.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+
+namespace inl::gxeng {
+
+
+namespace impl {
+
+	std::optional<uint64_t> AliasingPage::Allocate(uint64_t size, uint64_t alignment, TransientLifetime lifetime) {
+		// Only allocations that are alive at the same time as the new one block memory.
+		std::vector<std::pair<uint64_t, uint64_t>> blocked;
+		for (const auto& allocation : m_allocations) {
+			if (allocation.lifetime.Overlaps(lifetime)) {
+				blocked.push_back({ allocation.offset, allocation.offset + allocation.size });
+			}
+		}
+		std::sort(blocked.begin(), blocked.end());
+
+		// First fit: try the start of the page and the end of every blocked range.
+		auto AlignUp = [alignment](uint64_t value) {
+			return alignment > 1 ? (value + alignment - 1) / alignment * alignment : value;
+		};
+		uint64_t candidate = 0;
+		for (const auto& [begin, end] : blocked) {
+			if (candidate + size <= begin) {
+				break;
+			}
+			candidate = std::max(candidate, AlignUp(end));
+		}
+		if (candidate + size > m_size) {
+			return {};
+		}
+
+		m_allocations.push_back({ candidate, size, lifetime });
+		return candidate;
+	}
+
+
+	void AliasingPage::Deallocate(uint64_t offset, TransientLifetime lifetime) {
+		auto it = std::find_if(m_allocations.begin(), m_allocations.end(), [&](const Allocation& allocation) {
+			return allocation.offset == offset && allocation.lifetime.first == lifetime.first && allocation.lifetime.last == lifetime.last;
+		});
+		assert(it != m_allocations.end());
+		if (it != m_allocations.end()) {
+			std::swap(*it, m_allocations.back());
+			m_allocations.pop_back();
+		}
+	}
+
+} // namespace impl
+
+
+
+TransientResourceHeap::TransientResourceHeap(gxapi::IGraphicsApi* graphicsApi)
+	: m_graphicsApi(graphicsApi) {}
+
+
+Texture2D TransientResourceHeap::CreateTexture2D(const Texture2DDesc& desc, gxapi::eResourceFlags flags, TransientLifetime lifetime) {
+	auto apiDesc = gxapi::ResourceDesc::Texture2DArray(desc.width, desc.height, desc.format, desc.arraySize, flags, desc.mipLevels);
+	gxapi::ClearValue clearValue = impl::CriticalBufferHeap::DetermineClearValue(apiDesc);
+	auto resource = Allocate(apiDesc, clearValue.format != gxapi::eFormat::UNKNOWN ? &clearValue : nullptr, lifetime);
+
+	return Texture2D(std::move(resource), true, eResourceHeap::TRANSIENT);
+}
+
+
+uint64_t TransientResourceHeap::GetReservedSize() const {
+	std::lock_guard<std::mutex> lkg(m_mtx);
+	uint64_t size = 0;
+	for (const auto& page : m_pages) {
+		size += page->allocator.GetSize();
+	}
+	return size;
+}
+
+
+uint64_t TransientResourceHeap::GetRequestedSize() const {
+	std::lock_guard<std::mutex> lkg(m_mtx);
+	return m_requestedSize;
+}
+
+
+TransientResourceHeap::UniquePtr TransientResourceHeap::Allocate(const gxapi::ResourceDesc& desc, gxapi::ClearValue* clearValue, TransientLifetime lifetime) {
+	// Render targets and depth buffers cannot share a heap with other textures on every hardware tier.
+	const bool isRtDs = (desc.textureDesc.flags & gxapi::eResourceFlags::ALLOW_RENDER_TARGET) || (desc.textureDesc.flags & gxapi::eResourceFlags::ALLOW_DEPTH_STENCIL);
+	const gxapi::eHeapFlags heapFlags = isRtDs ? gxapi::eHeapFlags::ALLOW_ONLY_RT_DS_TEXTURES : gxapi::eHeapFlags::ALLOW_ONLY_NON_RT_DS_TEXTURES;
+
+	const gxapi::ResourceAllocationInfo info = m_graphicsApi->GetResourceAllocationInfo(desc);
+
+	std::lock_guard<std::mutex> lkg(m_mtx);
+
+	// Find a page where the resource fits, or reserve a new one.
+	Page* page = nullptr;
+	std::optional<uint64_t> offset;
+	for (auto& candidate : m_pages) {
+		if (candidate->flags == heapFlags) {
+			offset = candidate->allocator.Allocate(info.sizeInBytes, info.alignment, lifetime);
+			if (offset) {
+				page = candidate.get();
+				break;
+			}
+		}
+	}
+	if (!page) {
+		gxapi::HeapDesc heapDesc;
+		heapDesc.sizeInBytes = std::max(PAGE_SIZE, info.sizeInBytes);
+		heapDesc.properties = gxapi::HeapProperties{ .type = gxapi::eHeapType::DEFAULT, .cpuPageProperty = gxapi::eCpuPageProperty::UNKNOWN, .pool = gxapi::eMemoryPool::UNKNOWN };
+		heapDesc.alignment = info.alignment;
+		heapDesc.flags = heapFlags;
+
+		auto newPage = std::make_unique<Page>(Page{ std::unique_ptr<gxapi::IHeap>(m_graphicsApi->CreateHeap(heapDesc)), impl::AliasingPage(heapDesc.sizeInBytes), heapFlags });
+		newPage->heap->SetName("Transient resource heap");
+		offset = newPage->allocator.Allocate(info.sizeInBytes, info.alignment, lifetime);
+		assert(offset);
+		page = newPage.get();
+		m_pages.push_back(std::move(newPage));
+	}
+
+	gxapi::IResource* resource;
+	try {
+		resource = m_graphicsApi->CreatePlacedResource(page->heap.get(), *offset, desc, gxapi::eResourceState::COMMON, clearValue);
+	}
+	catch (...) {
+		page->allocator.Deallocate(*offset, lifetime);
+		throw;
+	}
+	m_requestedSize += info.sizeInBytes;
+
+	// Give the memory back to the page when the resource dies.
+	const uint64_t allocationOffset = *offset;
+	const uint64_t allocationSize = info.sizeInBytes;
+	auto deleter = [this, page, allocationOffset, allocationSize, lifetime](const gxapi::IResource* resource) {
+		delete resource;
+		std::lock_guard<std::mutex> lkg(m_mtx);
+		page->allocator.Deallocate(allocationOffset, lifetime);
+		m_requestedSize -= allocationSize;
+	};
+
+	return UniquePtr{ resource, deleter };
+}
+
+
+} // namespace inl::gxeng
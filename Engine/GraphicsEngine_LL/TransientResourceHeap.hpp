@@ -0,0 +1,99 @@
+#pragma once
+
+#include "MemoryObject.hpp"
+
+#include <GraphicsApi_LL/IGraphicsApi.hpp>
+#include <GraphicsApi_LL/IHeap.hpp>
+
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+
+namespace inl::gxeng {
+
+
+struct Texture2DDesc;
+
+
+/// <summary> Interval of tasks in the order the GPU scheduler submits them. Both ends are inclusive. </summary>
+struct TransientLifetime {
+	uint32_t first = 0;
+	uint32_t last = 0;
+
+	bool Overlaps(const TransientLifetime& other) const {
+		return first <= other.last && other.first <= last;
+	}
+};
+
+
+namespace impl {
+
+	/// <summary> Places allocations inside a fixed-size memory block so that allocations
+	///		with overlapping lifetimes never overlap in memory. </summary>
+	/// <remarks> Allocations whose lifetimes are disjoint may share the same memory. </remarks>
+	class AliasingPage {
+	public:
+		AliasingPage(uint64_t size) : m_size(size) {}
+
+		/// <summary> Returns the offset of the new allocation or nothing if it does not fit. </summary>
+		std::optional<uint64_t> Allocate(uint64_t size, uint64_t alignment, TransientLifetime lifetime);
+
+		/// <summary> Releases the allocation at the given offset with the given lifetime. </summary>
+		void Deallocate(uint64_t offset, TransientLifetime lifetime);
+
+		uint64_t GetSize() const { return m_size; }
+		bool IsEmpty() const { return m_allocations.empty(); }
+
+	private:
+		struct Allocation {
+			uint64_t offset;
+			uint64_t size;
+			TransientLifetime lifetime;
+		};
+
+		uint64_t m_size;
+		std::vector<Allocation> m_allocations;
+	};
+
+} // namespace impl
+
+
+/// <summary> Creates placed textures that are only needed during a portion of the frame.
+///		Memory is aliased between textures whose lifetimes do not overlap. </summary>
+class TransientResourceHeap {
+public:
+	TransientResourceHeap(gxapi::IGraphicsApi* graphicsApi);
+	TransientResourceHeap(const TransientResourceHeap&) = delete;
+	TransientResourceHeap& operator=(const TransientResourceHeap&) = delete;
+
+	Texture2D CreateTexture2D(const Texture2DDesc& desc, gxapi::eResourceFlags flags, TransientLifetime lifetime);
+
+	/// <summary> Total size of the heaps reserved from the device. </summary>
+	uint64_t GetReservedSize() const;
+
+	/// <summary> Total size of the live transient resources, as if they were not aliased. </summary>
+	uint64_t GetRequestedSize() const;
+
+private:
+	struct Page {
+		std::unique_ptr<gxapi::IHeap> heap;
+		impl::AliasingPage allocator;
+		gxapi::eHeapFlags flags;
+	};
+
+	using UniquePtr = MemoryObject::UniquePtr;
+	UniquePtr Allocate(const gxapi::ResourceDesc& desc, gxapi::ClearValue* clearValue, TransientLifetime lifetime);
+
+private:
+	gxapi::IGraphicsApi* m_graphicsApi;
+	std::vector<std::unique_ptr<Page>> m_pages;
+	uint64_t m_requestedSize = 0;
+	mutable std::mutex m_mtx;
+
+	static constexpr uint64_t PAGE_SIZE = 128 * 1024 * 1024;
+};
+
+
+} // namespace inl::gxeng
@@ -5,6 +5,7 @@
 #include <BaseLibrary/Exception/Exception.hpp>
 #include <GraphicsApi_LL/Common.hpp>
 
+#include <algorithm>
 #include <atomic>
 #include <cassert>
 #include <sstream>
@@ -14,6 +15,20 @@ namespace inl::gxeng {
 
 UploadManager::UploadManager(gxapi::IGraphicsApi* graphicsApi) : m_graphicsApi(graphicsApi) {
 	std::lock_guard<std::mutex> lock(m_mtx);
+
+	auto resource = MemoryObject::UniquePtr(
+		m_graphicsApi->CreateCommittedResource(
+			gxapi::HeapProperties{ .type = gxapi::eHeapType::UPLOAD },
+			gxapi::eHeapFlags::NONE,
+			gxapi::ResourceDesc::Buffer(RING_SIZE),
+			gxapi::eResourceState::GENERIC_READ),
+		std::default_delete<const gxapi::IResource>());
+	resource->SetName("Upload ring");
+
+	// Upload heaps can stay mapped for their whole lifetime.
+	gxapi::MemoryRange noReadRange{ 0, 0 };
+	m_ringCpuAddress = reinterpret_cast<uint8_t*>(resource->Map(0, &noReadRange));
+	m_ring = LinearBuffer(std::move(resource), true, eResourceHeap::UPLOAD);
 }
 
 
@@ -22,6 +37,35 @@ void UploadManager::Upload(const LinearBuffer& target, size_t offset, const void
 		throw InvalidArgumentException("Target buffer is not large enough for the uploaded data to fit.", "target");
 	}
 
+	if (size <= MAX_RING_UPLOAD_SIZE) {
+		std::lock_guard<std::mutex> lock(m_mtx);
+		std::optional<size_t> ringOffset = AllocateRing(size, BUFFER_PLACEMENT_ALIGNMENT);
+		if (ringOffset) {
+			memcpy(m_ringCpuAddress + *ringOffset, data, size);
+
+			std::vector<UploadDescription>& currQueue = m_uploadFrames.back().uploads;
+
+			// Merge with the previous upload if both the source and the destination ranges are contiguous.
+			if (!currQueue.empty()) {
+				UploadDescription& last = currQueue.back();
+				const bool contiguous = last.destType == DestType::BUFFER
+										&& last.source == m_ring
+										&& last.destination == target
+										&& last.srcOffset + last.srcSize == *ringOffset
+										&& last.dstOffsetX + last.srcSize == offset;
+				if (contiguous) {
+					last.srcSize += size;
+					return;
+				}
+			}
+
+			currQueue.push_back(UploadDescription(LinearBuffer{ m_ring }, *ringOffset, size, target, offset));
+			target._BeginUpload();
+			return;
+		}
+	}
+
+	// Large uploads and uploads that don't fit the ring get a dedicated staging resource.
 	auto resource = CreateStagingResource(data, size);
 
 	// Add upload to queue so that scheduler can enqueue it.
@@ -30,9 +74,12 @@ void UploadManager::Upload(const LinearBuffer& target, size_t offset, const void
 
 	UploadDescription uploadDesc(
 		LinearBuffer(std::move(resource), true, eResourceHeap::UPLOAD),
+		0,
+		size,
 		target,
 		offset);
 	currQueue.push_back(std::move(uploadDesc));
+	target._BeginUpload();
 }
 
 
@@ -49,6 +96,38 @@ void UploadManager::Upload(const Texture2D& target,
 		throw InvalidArgumentException("Uploaded data does not fit inside target texture. (Uploaded size or offset is too large)", "target");
 	}
 
+	// Block compressed formats are copied in rows of blocks.
+	size_t rowSize = gxapi::GetFormatRowSize(format, width);
+	size_t srcPitch = bytesPerRow > 0 ? bytesPerRow : rowSize;
+	size_t rowPitch = SnapUpwrads(rowSize, DUP_D3D12_TEXTURE_DATA_PITCH_ALIGNMENT);
+	uint32_t rowCount = gxapi::GetFormatRowCount(format, height);
+	size_t requiredSize = rowPitch * rowCount;
+
+	if (requiredSize <= MAX_RING_UPLOAD_SIZE) {
+		std::lock_guard<std::mutex> lock(m_mtx);
+		std::optional<size_t> ringOffset = AllocateRing(requiredSize, DUP_D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT);
+		if (ringOffset) {
+			// Copy texture to the ring row-by-row.
+			auto stagePtr = m_ringCpuAddress + *ringOffset;
+			auto byteData = reinterpret_cast<const uint8_t*>(data);
+			for (size_t y = 0; y < rowCount; y++) {
+				memcpy(stagePtr + rowPitch * y, byteData + srcPitch * y, rowSize);
+			}
+
+			std::vector<UploadDescription>& currQueue = m_uploadFrames.back().uploads;
+			currQueue.push_back(UploadDescription(
+				LinearBuffer{ m_ring },
+				target,
+				subresource,
+				offsetX,
+				offsetY,
+				0,
+				gxapi::TextureCopyDesc::Buffer(format, width, height, 1, *ringOffset)));
+			target._BeginUpload();
+			return;
+		}
+	}
+
 	auto resource = CreateStagingResource(data, width, height, format, bytesPerRow);
 
 	// Push upload description to queue so that the scheduler can enqueue the upload.
@@ -66,6 +145,7 @@ void UploadManager::Upload(const Texture2D& target,
 
 	currQueue.push_back(std::move(uploadDesc));
 	currQueue.back().source._SetResident(true);
+	target._BeginUpload();
 }
 
 void UploadManager::UploadNow(CopyCommandList& commandList,
@@ -119,6 +199,13 @@ void UploadManager::OnFrameBeginHost(uint64_t frameId) {
 void UploadManager::OnFrameCompleteDevice(uint64_t frameId) {
 	std::lock_guard<std::mutex> lock(m_mtx);
 
+	// Give back the ring memory of the completed frames.
+	while (!m_ringMarkers.empty() && m_ringMarkers.front().frameId <= frameId) {
+		m_ringTail = m_ringMarkers.front().head;
+		m_ringRetiredTotal = m_ringMarkers.front().allocatedTotal;
+		m_ringMarkers.pop_front();
+	}
+
 	// Loop may be removed.
 	int framesPopped = 0;
 	while (!m_uploadFrames.empty() && m_uploadFrames.front().frameId <= frameId) {
@@ -137,18 +224,99 @@ void UploadManager::OnFrameCompleteHost(uint64_t frameId) {
 void UploadManager::OnFrameBeginAwait(uint64_t frameId) {
 	std::lock_guard<std::mutex> lock(m_mtx);
 
+	// Everything allocated from the ring so far belongs to the frames already begun.
+	if (!m_uploadFrames.empty()) {
+		m_ringMarkers.push_back({ std::max(m_uploadFrames.back().frameId, m_ringHoldFrameId), m_ringHead, m_ringAllocatedTotal });
+	}
+
+	// Uploads over the previous frame's budget go first.
 	UploadFrame uploadFrame;
 	uploadFrame.frameId = frameId;
-	m_uploadFrames.push_back(uploadFrame);
+	uploadFrame.uploads = std::move(m_deferredUploads);
+	m_deferredUploads.clear();
+	m_uploadFrames.push_back(std::move(uploadFrame));
+	m_uploadFrameId.store(frameId, std::memory_order_relaxed);
 }
 
 
-const std::vector<UploadManager::UploadDescription>& UploadManager::GetQueuedUploads() const {
+const std::vector<UploadManager::UploadDescription>& UploadManager::GetQueuedUploads() {
 	std::lock_guard<std::mutex> lock(m_mtx);
 
 	assert(m_uploadFrames.size() > 0);
-	m_uploadFrames.back().wasQueried = true;
-	return m_uploadFrames.back().uploads;
+	UploadFrame& frame = m_uploadFrames.back();
+	frame.wasQueried = true;
+
+	// Keep uploads within the budget, but always let at least one through so huge uploads are not stuck.
+	size_t totalSize = 0;
+	auto firstDeferred = frame.uploads.begin();
+	while (firstDeferred != frame.uploads.end()) {
+		totalSize += GetUploadSize(*firstDeferred);
+		if (totalSize > m_uploadBudget && firstDeferred != frame.uploads.begin()) {
+			break;
+		}
+		++firstDeferred;
+	}
+
+	if (firstDeferred != frame.uploads.end()) {
+		m_deferredUploads.insert(m_deferredUploads.end(), std::make_move_iterator(firstDeferred), std::make_move_iterator(frame.uploads.end()));
+		frame.uploads.erase(firstDeferred, frame.uploads.end());
+
+		// The deferred uploads read ring memory in the next frame, so nothing may be retired before that completes.
+		const uint64_t nextFrameId = frame.frameId + 1;
+		for (auto& marker : m_ringMarkers) {
+			marker.frameId = std::max(marker.frameId, nextFrameId);
+		}
+		m_ringHoldFrameId = nextFrameId;
+	}
+
+	// Resources stay hidden from rendering while their uploads are pending. Uploads recorded on the
+	// graphics queue precede all rendering of the frame, those resources can be used right away.
+	// Copy queue uploads are released by the scheduler once the copy queue has finished them.
+	for (auto& upload : frame.uploads) {
+		upload.onCopyQueue = IsInCommonState(upload.destination);
+		if (!upload.onCopyQueue) {
+			upload.destination._EndUpload();
+		}
+	}
+
+	return frame.uploads;
+}
+
+
+bool UploadManager::IsInCommonState(const MemoryObject& resource) {
+	for (unsigned subresource = 0; subresource < resource.GetNumSubresources(); ++subresource) {
+		if (resource.ReadState(subresource) != gxapi::eResourceState::COMMON) {
+			return false;
+		}
+	}
+	return true;
+}
+
+
+void UploadManager::SetUploadBudget(size_t bytesPerFrame) {
+	std::lock_guard<std::mutex> lock(m_mtx);
+	m_uploadBudget = bytesPerFrame;
+}
+
+
+size_t UploadManager::GetUploadBudget() const {
+	std::lock_guard<std::mutex> lock(m_mtx);
+	return m_uploadBudget;
+}
+
+
+uint64_t UploadManager::GetUploadFrameId() const {
+	return m_uploadFrameId.load(std::memory_order_relaxed);
+}
+
+
+size_t UploadManager::GetUploadSize(const UploadDescription& upload) {
+	if (upload.destType == DestType::BUFFER) {
+		return upload.srcSize;
+	}
+	const auto& desc = upload.textureBufferDesc;
+	size_t rowPitch = SnapUpwrads(gxapi::GetFormatRowSize(desc.format, desc.width), DUP_D3D12_TEXTURE_DATA_PITCH_ALIGNMENT);
+	return rowPitch * gxapi::GetFormatRowCount(desc.format, desc.height);
 }
 
 
@@ -160,6 +328,39 @@ size_t UploadManager::SnapUpwrads(size_t value, size_t gridSize) {
 }
 
 
+std::optional<size_t> UploadManager::AllocateRing(size_t size, size_t alignment) {
+	if (size > RING_SIZE) {
+		return {};
+	}
+
+	// Head and tail are not reset when the ring empties, pending markers still refer to their positions.
+	const uint64_t used = m_ringAllocatedTotal - m_ringRetiredTotal;
+	if (used != 0 && m_ringHead == m_ringTail) {
+		return {}; // Full.
+	}
+
+	size_t offset = SnapUpwrads(m_ringHead, alignment);
+	if (m_ringHead >= m_ringTail) {
+		// Free space is [head, end) and [0, tail).
+		if (offset + size > RING_SIZE) {
+			if (size > m_ringTail && used != 0) {
+				return {};
+			}
+			offset = 0;
+		}
+	}
+	else if (offset + size > m_ringTail) {
+		// Free space is [head, tail).
+		return {};
+	}
+
+	const size_t newHead = offset + size;
+	m_ringAllocatedTotal += offset >= m_ringHead ? newHead - m_ringHead : (RING_SIZE - m_ringHead) + newHead;
+	m_ringHead = newHead == RING_SIZE ? 0 : newHead;
+	return offset;
+}
+
+
 MemoryObject::UniquePtr UploadManager::CreateStagingResource(const void* data, size_t size) {
 	auto resource = MemoryObject::UniquePtr(
 		m_graphicsApi->CreateCommittedResource(
@@ -189,10 +390,11 @@ MemoryObject::UniquePtr UploadManager::CreateStagingResource(const void* data, s
 
 
 MemoryObject::UniquePtr UploadManager::CreateStagingResource(const void* data, uint64_t width, uint32_t height, gxapi::eFormat format, size_t bytesPerRow) {
-	auto pixelSize = gxapi::GetFormatSizeInBytes(format);
-	auto rowSize = width * pixelSize;
+	size_t rowSize = gxapi::GetFormatRowSize(format, width);
+	size_t srcPitch = bytesPerRow > 0 ? bytesPerRow : rowSize;
 	size_t rowPitch = SnapUpwrads(rowSize, DUP_D3D12_TEXTURE_DATA_PITCH_ALIGNMENT);
-	auto requiredSize = bytesPerRow > 0 ? bytesPerRow : rowPitch * height;
+	uint32_t rowCount = gxapi::GetFormatRowCount(format, height);
+	auto requiredSize = rowPitch * rowCount;
 
 	auto resource = MemoryObject::UniquePtr(
 		m_graphicsApi->CreateCommittedResource(
@@ -214,8 +416,8 @@ MemoryObject::UniquePtr UploadManager::CreateStagingResource(const void* data, u
 	gxapi::MemoryRange noReadRange{ 0, 0 };
 	auto stagePtr = reinterpret_cast<uint8_t*>(resource->Map(0, &noReadRange));
 	auto byteData = reinterpret_cast<const uint8_t*>(data);
-	for (size_t y = 0; y < height; y++) {
-		memcpy(stagePtr + rowPitch * y, byteData + rowSize * y, rowSize);
+	for (size_t y = 0; y < rowCount; y++) {
+		memcpy(stagePtr + rowPitch * y, byteData + srcPitch * y, rowSize);
 	}
 	resource->Unmap(0, nullptr);
 
@@ -3,9 +3,11 @@
 #include "MemoryObject.hpp"
 #include "PipelineEventListener.hpp"
 
+#include <atomic>
 #include <deque>
 #include <list>
 #include <mutex>
+#include <optional>
 #include <utility>
 
 namespace inl::gxeng {
@@ -19,8 +21,12 @@ public:
 						  TEXTURE_2D };
 	struct UploadDescription {
 		UploadDescription(LinearBuffer&& source,
+						  size_t srcOffset,
+						  size_t srcSize,
 						  const LinearBuffer& destination,
 						  size_t bufferOffset) : source(std::move(source)),
+												 srcOffset(srcOffset),
+												 srcSize(srcSize),
 												 destination(destination),
 												 destType(DestType::BUFFER),
 												 dstOffsetX(bufferOffset) {}
@@ -38,6 +44,9 @@ public:
 																	  textureBufferDesc(textureBufferDesc) {}
 
 		LinearBuffer source;
+		// Where the data is inside source, only for buffers. Textures use textureBufferDesc.byteOffset.
+		size_t srcOffset = 0;
+		size_t srcSize = 0;
 
 		// Destination is a weak pointer because it might get deleted before
 		// the graphics engine starts to process the request.
@@ -50,6 +59,10 @@ public:
 		unsigned dstSubresource;
 
 		gxapi::TextureCopyDesc textureBufferDesc;
+
+		// Set when handed to the scheduler. Fresh resources are filled on the copy queue,
+		// the rest in the graphics queue's first command list of the frame.
+		bool onCopyQueue = false;
 	};
 
 private:
@@ -138,15 +151,52 @@ public:
 
 	/// <summary> Returns the batch of scheduled uploads for the upcoming frame. </summary>
 	/// <remarks> If this function is called from the <see cref="Scheduler"/> - as it should be -
-	///		the upcoming frame will be the one currently processed by the scheduler. </remarks>
-	const std::vector<UploadDescription>& GetQueuedUploads() const;
+	///		the upcoming frame will be the one currently processed by the scheduler.
+	///		Uploads over the budget are removed from the batch and moved to the next frame. </remarks>
+	const std::vector<UploadDescription>& GetQueuedUploads();
+
+	/// <summary> Sets how many bytes may be uploaded in a single frame. </summary>
+	/// <remarks> A single upload larger than the budget still goes through, alone. </remarks>
+	void SetUploadBudget(size_t bytesPerFrame);
+	size_t GetUploadBudget() const;
+
+	/// <summary> The frame that uploads issued now are executed in. </summary>
+	/// <remarks> Changes once per frame, so resources used with the same value were used in the same frame. May be called from any thread. </remarks>
+	uint64_t GetUploadFrameId() const;
 
 protected:
 	gxapi::IGraphicsApi* m_graphicsApi;
 	std::list<UploadFrame> m_uploadFrames;
+	std::atomic_uint64_t m_uploadFrameId = 0; // Same as the last of m_uploadFrames, readable without locking.
 
 	mutable std::mutex m_mtx;
 
+	// Persistently mapped staging ring, uploads are sub-allocated from it.
+	// Memory is given back when the frame that used it completes on the GPU.
+	struct RingMarker {
+		uint64_t frameId;
+		size_t head;
+		uint64_t allocatedTotal;
+	};
+	LinearBuffer m_ring;
+	uint8_t* m_ringCpuAddress = nullptr;
+	size_t m_ringHead = 0;
+	size_t m_ringTail = 0;
+	uint64_t m_ringAllocatedTotal = 0; // Includes padding, monotonically increasing.
+	uint64_t m_ringRetiredTotal = 0;
+	std::deque<RingMarker> m_ringMarkers;
+	uint64_t m_ringHoldFrameId = 0; // Markers may not retire before this frame, deferred uploads still read them.
+
+	std::vector<UploadDescription> m_deferredUploads;
+	size_t m_uploadBudget = DEFAULT_UPLOAD_BUDGET;
+
+	/// <summary> Reserves space in the staging ring. Returns nothing if the ring is full. </summary>
+	/// <remarks> Must be called with m_mtx locked. </remarks>
+	std::optional<size_t> AllocateRing(size_t size, size_t alignment);
+
+	/// <summary> True if every subresource is in COMMON state, so the graphics queue does not use the resource and the copy queue may write it. </summary>
+	static bool IsInCommonState(const MemoryObject& resource);
+
 	// Creates and copies uploaded data into a staging GPU buffer (for buffers).
 	MemoryObject::UniquePtr CreateStagingResource(const void* data, size_t size);
 	// Creates and copies uploaded data into a staging GPU buffer (for textures).
@@ -154,9 +204,16 @@ protected:
 
 protected:
 	static constexpr int DUP_D3D12_TEXTURE_DATA_PITCH_ALIGNMENT = 256;
+	static constexpr int DUP_D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT = 512;
+	static constexpr size_t BUFFER_PLACEMENT_ALIGNMENT = 4;
+	static constexpr size_t RING_SIZE = 32 * 1024 * 1024;
+	/// <summary> Larger uploads get their own staging resource so they don't starve the ring. </summary>
+	static constexpr size_t MAX_RING_UPLOAD_SIZE = RING_SIZE / 4;
+	static constexpr size_t DEFAULT_UPLOAD_BUDGET = 64 * 1024 * 1024;
 
 private:
 	static size_t SnapUpwrads(size_t value, size_t gridSize);
+	static size_t GetUploadSize(const UploadDescription& upload);
 };
 
 
@@ -1,15 +1,86 @@
 #include "VertexCompressor.hpp"
 
+#include "PixelConversion.hpp"
+
 #include <BaseLibrary/Container/ArrayView.hpp>
 
 #include <InlineMath.hpp>
 #include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
 
 
 namespace inl::gxeng {
 
 
 
+//------------------------------------------------------------------------------
+// Helpers
+//------------------------------------------------------------------------------
+
+static const char* const octahedralDecodeFunction =
+	"float3 DecodeOctahedral(float2 encoded) {\n"
+	"	float3 n = float3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));\n"
+	"	float t = saturate(-n.z);\n"
+	"	n.xy += float2(n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t);\n"
+	"	return normalize(n);\n"
+	"}\n";
+
+
+// Folds the unit sphere onto an octahedron and unfolds its lower half onto the corners of the square.
+static Vec2 EncodeOctahedral(const Vec3& v) {
+	const float sum = std::abs(v.x) + std::abs(v.y) + std::abs(v.z);
+	if (sum == 0.0f) {
+		return { 0.0f, 0.0f };
+	}
+	Vec2 p = { v.x / sum, v.y / sum };
+	if (v.z < 0.0f) {
+		p = { (1.0f - std::abs(p.y)) * (p.x >= 0.0f ? 1.0f : -1.0f),
+			  (1.0f - std::abs(p.x)) * (p.y >= 0.0f ? 1.0f : -1.0f) };
+	}
+	return p;
+}
+
+
+// Passed through elements are made of floats.
+static gxapi::eFormat GetFloatFormat(int size) {
+	switch (size) {
+		case 4: return gxapi::eFormat::R32_FLOAT;
+		case 8: return gxapi::eFormat::R32G32_FLOAT;
+		case 12: return gxapi::eFormat::R32G32B32_FLOAT;
+		case 16: return gxapi::eFormat::R32G32B32A32_FLOAT;
+		default: return gxapi::eFormat::UNKNOWN;
+	}
+}
+
+
+template <class T>
+static T ToSnorm(float value) {
+	constexpr float maxValue = float(std::numeric_limits<T>::max());
+	return T(std::round(std::clamp(value, -1.0f, 1.0f) * maxValue));
+}
+
+
+static uint16_t ToUnorm16(float value) {
+	return uint16_t(std::round(std::clamp(value, 0.0f, 1.0f) * 65535.0f));
+}
+
+
+template <class T>
+static void WriteOctahedral(const Vec3& v, float w, bool hasW, void* output) {
+	const Vec2 p = EncodeOctahedral(v);
+	T* out = reinterpret_cast<T*>(output);
+	out[0] = ToSnorm<T>(p.x);
+	out[1] = ToSnorm<T>(p.y);
+	if (hasW) {
+		out[2] = 0;
+		out[3] = ToSnorm<T>(w);
+	}
+}
+
+
+
 //------------------------------------------------------------------------------
 // Semantic compressor implementations
 //------------------------------------------------------------------------------
@@ -33,6 +104,9 @@ bool NormalCompressor::IsSupported(eVertexElementSemantic semantic) const {
 		   || semantic == eVertexElementSemantic::TANGENT
 		   || semantic == eVertexElementSemantic::BITANGENT;
 }
+gxapi::eFormat NormalCompressor::GetFormat() const {
+	return gxapi::eFormat::R32G32B32_FLOAT;
+}
 
 
 
@@ -52,6 +126,179 @@ int ColorCompressor::Size() const {
 bool ColorCompressor::IsSupported(eVertexElementSemantic semantic) const {
 	return semantic == eVertexElementSemantic::COLOR;
 }
+gxapi::eFormat ColorCompressor::GetFormat() const {
+	return gxapi::eFormat::R32G32B32_FLOAT;
+}
+
+
+
+OctahedralNormalCompressor::OctahedralNormalCompressor(eDirectionEncoding encoding)
+	: m_encoding(encoding) {
+	assert(encoding != eDirectionEncoding::FLOAT32);
+}
+void OctahedralNormalCompressor::Compress(const void* input, void* output) const {
+	using InputT = VertexPartReader<eVertexElementSemantic::NORMAL>::DataType;
+	const InputT* in = reinterpret_cast<const InputT*>(input);
+	if (m_encoding == eDirectionEncoding::OCTAHEDRAL16) {
+		WriteOctahedral<int8_t>({ in->x, in->y, in->z }, 0.0f, false, output);
+	}
+	else {
+		WriteOctahedral<int16_t>({ in->x, in->y, in->z }, 0.0f, false, output);
+	}
+}
+int OctahedralNormalCompressor::Size() const {
+	return m_encoding == eDirectionEncoding::OCTAHEDRAL16 ? 2 : 4;
+}
+bool OctahedralNormalCompressor::IsSupported(eVertexElementSemantic semantic) const {
+	return semantic == eVertexElementSemantic::NORMAL;
+}
+gxapi::eFormat OctahedralNormalCompressor::GetFormat() const {
+	return m_encoding == eDirectionEncoding::OCTAHEDRAL16 ? gxapi::eFormat::R8G8_SNORM : gxapi::eFormat::R16G16_SNORM;
+}
+std::vector<std::string> OctahedralNormalCompressor::GetDecodeFunctions() const {
+	return { octahedralDecodeFunction };
+}
+
+
+
+TangentFrameCompressor::TangentFrameCompressor(eDirectionEncoding encoding)
+	: m_encoding(encoding) {
+	assert(encoding != eDirectionEncoding::FLOAT32);
+}
+void TangentFrameCompressor::Compress(const void* input, void* output) const {
+	using InputT = VertexPartReader<eVertexElementSemantic::TANGENT>::DataType;
+	const InputT* in = reinterpret_cast<const InputT*>(input);
+	Encode({ in->x, in->y, in->z }, 1.0f, output);
+}
+void TangentFrameCompressor::Compress(const VertexBase& vertex, const IVertexReader* reader, const IVertexReader::Element& element, void* output) const {
+	using InputT = VertexPartReader<eVertexElementSemantic::TANGENT>::DataType;
+	const InputT* in = reinterpret_cast<const InputT*>(reader->GetPointer(vertex, element.semantic, element.index));
+	const Vec3 tangent = { in->x, in->y, in->z };
+
+	// The sign tells if the bitangent is cross(normal, tangent) or its opposite.
+	float sign = 1.0f;
+	if (element.semantic == eVertexElementSemantic::TANGENT) {
+		auto& elements = reader->GetElements();
+		auto Has = [&elements, &element](eVertexElementSemantic semantic) {
+			return std::any_of(elements.begin(), elements.end(), [&](const IVertexReader::Element& other) {
+				return other.semantic == semantic && other.index == element.index;
+			});
+		};
+		if (Has(eVertexElementSemantic::NORMAL) && Has(eVertexElementSemantic::BITANGENT)) {
+			const InputT* n = reinterpret_cast<const InputT*>(reader->GetPointer(vertex, eVertexElementSemantic::NORMAL, element.index));
+			const InputT* b = reinterpret_cast<const InputT*>(reader->GetPointer(vertex, eVertexElementSemantic::BITANGENT, element.index));
+			sign = Dot(Cross(Vec3{ n->x, n->y, n->z }, tangent), Vec3{ b->x, b->y, b->z }) < 0.0f ? -1.0f : 1.0f;
+		}
+	}
+	Encode(tangent, sign, output);
+}
+void TangentFrameCompressor::Encode(const Vec3& tangent, float bitangentSign, void* output) const {
+	if (m_encoding == eDirectionEncoding::OCTAHEDRAL16) {
+		WriteOctahedral<int8_t>(tangent, bitangentSign, true, output);
+	}
+	else {
+		WriteOctahedral<int16_t>(tangent, bitangentSign, true, output);
+	}
+}
+int TangentFrameCompressor::Size() const {
+	return m_encoding == eDirectionEncoding::OCTAHEDRAL16 ? 4 : 8;
+}
+bool TangentFrameCompressor::IsSupported(eVertexElementSemantic semantic) const {
+	return semantic == eVertexElementSemantic::TANGENT
+		   || semantic == eVertexElementSemantic::BITANGENT;
+}
+gxapi::eFormat TangentFrameCompressor::GetFormat() const {
+	return m_encoding == eDirectionEncoding::OCTAHEDRAL16 ? gxapi::eFormat::R8G8B8A8_SNORM : gxapi::eFormat::R16G16B16A16_SNORM;
+}
+std::vector<std::string> TangentFrameCompressor::GetDecodeFunctions() const {
+	return {
+		octahedralDecodeFunction,
+		"void DecodeTangentFrame(float4 encoded, float3 normal, out float3 tangent, out float3 bitangent) {\n"
+		"	tangent = DecodeOctahedral(encoded.xy);\n"
+		"	bitangent = cross(normal, tangent) * (encoded.w < 0.0 ? -1.0 : 1.0);\n"
+		"}\n"
+	};
+}
+
+
+
+PositionCompressor::PositionCompressor(const Vec3& boundsMin, const Vec3& boundsMax)
+	: m_boundsMin(boundsMin) {
+	const Vec3 extent = boundsMax - boundsMin;
+	for (int i = 0; i < 3; ++i) {
+		m_scale[i] = extent[i] > 0.0f ? 1.0f / extent[i] : 0.0f;
+	}
+}
+void PositionCompressor::Compress(const void* input, void* output) const {
+	using InputT = VertexPartReader<eVertexElementSemantic::POSITION>::DataType;
+	const InputT* in = reinterpret_cast<const InputT*>(input);
+	uint16_t* out = reinterpret_cast<uint16_t*>(output);
+
+	out[0] = ToUnorm16((in->x - m_boundsMin.x) * m_scale.x);
+	out[1] = ToUnorm16((in->y - m_boundsMin.y) * m_scale.y);
+	out[2] = ToUnorm16((in->z - m_boundsMin.z) * m_scale.z);
+	out[3] = 65535; // Reads as w = 1.
+}
+int PositionCompressor::Size() const {
+	return 4 * sizeof(uint16_t);
+}
+bool PositionCompressor::IsSupported(eVertexElementSemantic semantic) const {
+	return semantic == eVertexElementSemantic::POSITION;
+}
+gxapi::eFormat PositionCompressor::GetFormat() const {
+	return gxapi::eFormat::R16G16B16A16_UNORM;
+}
+std::vector<std::string> PositionCompressor::GetDecodeFunctions() const {
+	return {
+		"float3 DecodePosition(float3 quantized, float3 boundsMin, float3 boundsExtent) {\n"
+		"	return boundsMin + quantized * boundsExtent;\n"
+		"}\n"
+	};
+}
+
+
+
+TexCoordCompressor::TexCoordCompressor(eTexCoordEncoding encoding, const Vec2& rangeMin, const Vec2& rangeMax)
+	: m_encoding(encoding), m_rangeMin(rangeMin) {
+	assert(encoding != eTexCoordEncoding::FLOAT32);
+	const Vec2 extent = rangeMax - rangeMin;
+	for (int i = 0; i < 2; ++i) {
+		m_scale[i] = extent[i] > 0.0f ? 1.0f / extent[i] : 0.0f;
+	}
+}
+void TexCoordCompressor::Compress(const void* input, void* output) const {
+	using InputT = VertexPartReader<eVertexElementSemantic::TEX_COORD>::DataType;
+	const InputT* in = reinterpret_cast<const InputT*>(input);
+	uint16_t* out = reinterpret_cast<uint16_t*>(output);
+
+	if (m_encoding == eTexCoordEncoding::HALF16) {
+		out[0] = impl::FloatToHalf(in->x);
+		out[1] = impl::FloatToHalf(in->y);
+	}
+	else {
+		out[0] = ToUnorm16((in->x - m_rangeMin.x) * m_scale.x);
+		out[1] = ToUnorm16((in->y - m_rangeMin.y) * m_scale.y);
+	}
+}
+int TexCoordCompressor::Size() const {
+	return 2 * sizeof(uint16_t);
+}
+bool TexCoordCompressor::IsSupported(eVertexElementSemantic semantic) const {
+	return semantic == eVertexElementSemantic::TEX_COORD;
+}
+gxapi::eFormat TexCoordCompressor::GetFormat() const {
+	return m_encoding == eTexCoordEncoding::HALF16 ? gxapi::eFormat::R16G16_FLOAT : gxapi::eFormat::R16G16_UNORM;
+}
+std::vector<std::string> TexCoordCompressor::GetDecodeFunctions() const {
+	if (m_encoding == eTexCoordEncoding::HALF16) {
+		return {};
+	}
+	return {
+		"float2 DecodeTexCoord(float2 quantized, float2 rangeMin, float2 rangeExtent) {\n"
+		"	return rangeMin + quantized * rangeExtent;\n"
+		"}\n"
+	};
+}
 
 
 
@@ -67,6 +314,9 @@ int PassthroughCompressor::Size() const {
 bool PassthroughCompressor::IsSupported(eVertexElementSemantic semantic) const {
 	return true;
 }
+gxapi::eFormat PassthroughCompressor::GetFormat() const {
+	return GetFloatFormat(m_stride);
+}
 
 
 
@@ -76,12 +326,13 @@ bool PassthroughCompressor::IsSupported(eVertexElementSemantic semantic) const {
 
 VertexCompressor::VertexCompressor(
 	const IVertexReader* reader,
-	const std::vector<bool>& elementMap) {
+	const std::vector<bool>& elementMap,
+	const VertexQuantization& quantization) {
 	assert(reader != nullptr);
 	m_reader = reader;
 
 	// Default compressors.
-	CreateDefaultCompressorList();
+	CreateDefaultCompressorList(quantization);
 
 	// Create a filtered list that only has those elements that should be written to output.
 	const std::vector<IVertexReader::Element>& elements = reader->GetElements();
@@ -94,6 +345,21 @@ VertexCompressor::VertexCompressor(
 		}
 	}
 
+	// Octahedral tangents carry the bitangent's handedness, the shader rebuilds it from the normal.
+	if (quantization.tangent != eDirectionEncoding::FLOAT32) {
+		auto IsChosen = [&chosenElements](eVertexElementSemantic semantic, int index) {
+			return std::any_of(chosenElements.begin(), chosenElements.end(), [&](const IVertexReader::Element& element) {
+				return element.semantic == semantic && element.index == index;
+			});
+		};
+		auto newEnd = std::remove_if(chosenElements.begin(), chosenElements.end(), [&](const IVertexReader::Element& element) {
+			return element.semantic == eVertexElementSemantic::BITANGENT
+				   && IsChosen(eVertexElementSemantic::NORMAL, element.index)
+				   && IsChosen(eVertexElementSemantic::TANGENT, element.index);
+		});
+		chosenElements.erase(newEnd, chosenElements.end());
+	}
+
 	// Sort filtered list by semantic, and by index within same semantic.
 	// Sorts are seemingly reversed, that's how it works.
 	std::stable_sort(
@@ -147,13 +413,9 @@ std::vector<uint8_t> VertexCompressor::GetCompressedStream(const VertexBase* ver
 	ArrayView<const VertexBase> inputArray{ vertices, vertexCount, (size_t)m_reader->GetStride() };
 	for (size_t vertex = 0; vertex < vertexCount; ++vertex) {
 		for (size_t element = 0; element < numElements; ++element) {
-			eVertexElementSemantic semantic = m_elementsToCompress[element].sourceElement.semantic;
-			int index = m_elementsToCompress[element].sourceElement.index;
-			const void* input = m_reader->GetPointer(inputArray[vertex], semantic, index);
-
 			void* output = data.data() + offset;
 
-			m_elementsToCompress[element].assignedCompressor->Compress(input, output);
+			m_elementsToCompress[element].assignedCompressor->Compress(inputArray[vertex], m_reader, m_elementsToCompress[element].sourceElement, output);
 
 			offset += sizes[element];
 		}
@@ -193,6 +455,50 @@ std::vector<int> VertexCompressor::GetCompressedOffsets() const {
 
 
 
+std::vector<gxapi::eFormat> VertexCompressor::GetCompressedFormats() const {
+	auto& elements = m_reader->GetElements();
+	std::vector<gxapi::eFormat> formats(elements.size(), gxapi::eFormat::UNKNOWN);
+
+	for (auto& v : m_elementsToCompress) {
+		for (size_t i = 0; i < elements.size(); ++i) {
+			if (v.sourceElement.semantic == elements[i].semantic
+				&& v.sourceElement.index == elements[i].index) {
+				formats[i] = v.assignedCompressor->GetFormat();
+			}
+		}
+	}
+	return formats;
+}
+
+std::string VertexCompressor::GetDecodeCode() const {
+	std::vector<std::string> functions;
+	for (auto& v : m_elementsToCompress) {
+		for (auto& function : v.assignedCompressor->GetDecodeFunctions()) {
+			if (std::find(functions.begin(), functions.end(), function) == functions.end()) {
+				functions.push_back(function);
+			}
+		}
+	}
+
+	std::string code;
+	for (auto& function : functions) {
+		code += function;
+	}
+	return code;
+}
+
+gxapi::eFormat VertexCompressor::GetCompressedFormat(eVertexElementSemantic semantic, int size, const VertexQuantization& quantization) {
+	VertexCompressor compressor;
+	compressor.CreateDefaultCompressorList(quantization);
+	const SemanticCompressor* assigned = compressor.AssignCompressor({ semantic, 0 });
+	if (assigned != nullptr && assigned->Size() == size) {
+		return assigned->GetFormat();
+	}
+	return GetFloatFormat(size);
+}
+
+
+
 SemanticCompressor* VertexCompressor::AssignCompressor(const IVertexReader::Element& element) {
 	auto it = m_availableCompressors.begin();
 	while (it != m_availableCompressors.end()) {
@@ -201,21 +507,27 @@ SemanticCompressor* VertexCompressor::AssignCompressor(const IVertexReader::Elem
 		}
 		++it;
 	}
-	auto passit = m_passThroughCompressors.begin();
-	while (passit != m_passThroughCompressors.end()) {
-		if ((*passit)->IsSupported(element.semantic)) {
-			return passit->get();
-		}
-		++passit;
-	}
+	// Passthrough compressors are not shared, their size depends on the element.
 	return nullptr;
 }
 
 
-void VertexCompressor::CreateDefaultCompressorList() {
+void VertexCompressor::CreateDefaultCompressorList(const VertexQuantization& quantization) {
 	// Compressors are checked in order.
-	// They shouldn't have overlapping capabilities.
+	// The quantizing ones come first to take over semantics from the float compressors.
 
+	if (quantization.position != ePositionEncoding::FLOAT32) {
+		m_availableCompressors.push_back(std::make_unique<PositionCompressor>(quantization.boundsMin, quantization.boundsMax));
+	}
+	if (quantization.normal != eDirectionEncoding::FLOAT32) {
+		m_availableCompressors.push_back(std::make_unique<OctahedralNormalCompressor>(quantization.normal));
+	}
+	if (quantization.tangent != eDirectionEncoding::FLOAT32) {
+		m_availableCompressors.push_back(std::make_unique<TangentFrameCompressor>(quantization.tangent));
+	}
+	if (quantization.texCoord != eTexCoordEncoding::FLOAT32) {
+		m_availableCompressors.push_back(std::make_unique<TexCoordCompressor>(quantization.texCoord, quantization.texCoordMin, quantization.texCoordMax));
+	}
 	m_availableCompressors.push_back(std::make_unique<NormalCompressor>());
 	m_availableCompressors.push_back(std::make_unique<ColorCompressor>());
 }
@@ -1,8 +1,11 @@
 #pragma once
 
+#include <GraphicsApi_LL/Common.hpp>
 #include <GraphicsEngine/Resources/Vertex.hpp>
+#include <GraphicsEngine/Resources/VertexQuantization.hpp>
 
 #include <memory>
+#include <string>
 
 
 namespace inl::gxeng {
@@ -13,8 +16,17 @@ public:
 	virtual ~SemanticCompressor() {}
 
 	virtual void Compress(const void* input, void* output) const = 0;
+	/// <summary> Compresses an element that may depend on other elements of the same vertex.
+	///		By default, only the element itself is read. </summary>
+	virtual void Compress(const VertexBase& vertex, const IVertexReader* reader, const IVertexReader::Element& element, void* output) const {
+		Compress(reader->GetPointer(vertex, element.semantic, element.index), output);
+	}
 	virtual int Size() const = 0;
 	virtual bool IsSupported(eVertexElementSemantic semantic) const = 0;
+	/// <summary> The format of the compressed element for the pipeline's input layout. </summary>
+	virtual gxapi::eFormat GetFormat() const = 0;
+	/// <summary> HLSL functions that restore the element in the vertex shader, empty if the input assembler does it all. </summary>
+	virtual std::vector<std::string> GetDecodeFunctions() const { return {}; }
 };
 
 
@@ -23,6 +35,7 @@ public:
 	void Compress(const void* input, void* output) const override;
 	int Size() const override;
 	bool IsSupported(eVertexElementSemantic semantic) const override;
+	gxapi::eFormat GetFormat() const override;
 };
 
 
@@ -31,6 +44,78 @@ public:
 	void Compress(const void* input, void* output) const override;
 	int Size() const override;
 	bool IsSupported(eVertexElementSemantic semantic) const override;
+	gxapi::eFormat GetFormat() const override;
+};
+
+
+/// <summary> Stores unit vectors folded onto an octahedron as two signed normalized components. </summary>
+class OctahedralNormalCompressor : public SemanticCompressor {
+public:
+	explicit OctahedralNormalCompressor(eDirectionEncoding encoding);
+
+	void Compress(const void* input, void* output) const override;
+	int Size() const override;
+	bool IsSupported(eVertexElementSemantic semantic) const override;
+	gxapi::eFormat GetFormat() const override;
+	std::vector<std::string> GetDecodeFunctions() const override;
+
+private:
+	eDirectionEncoding m_encoding;
+};
+
+
+/// <summary> Stores tangents like <see cref="OctahedralNormalCompressor"/>, plus the sign of the bitangent in the last component. </summary>
+/// <remarks> Bitangents that get here are encoded the same way with a positive sign. </remarks>
+class TangentFrameCompressor : public SemanticCompressor {
+public:
+	explicit TangentFrameCompressor(eDirectionEncoding encoding);
+
+	void Compress(const void* input, void* output) const override;
+	void Compress(const VertexBase& vertex, const IVertexReader* reader, const IVertexReader::Element& element, void* output) const override;
+	int Size() const override;
+	bool IsSupported(eVertexElementSemantic semantic) const override;
+	gxapi::eFormat GetFormat() const override;
+	std::vector<std::string> GetDecodeFunctions() const override;
+
+private:
+	void Encode(const Vec3& tangent, float bitangentSign, void* output) const;
+
+private:
+	eDirectionEncoding m_encoding;
+};
+
+
+/// <summary> Quantizes positions to 16 bits per axis within the bounds of the mesh. </summary>
+class PositionCompressor : public SemanticCompressor {
+public:
+	PositionCompressor(const Vec3& boundsMin, const Vec3& boundsMax);
+
+	void Compress(const void* input, void* output) const override;
+	int Size() const override;
+	bool IsSupported(eVertexElementSemantic semantic) const override;
+	gxapi::eFormat GetFormat() const override;
+	std::vector<std::string> GetDecodeFunctions() const override;
+
+private:
+	Vec3 m_boundsMin;
+	Vec3 m_scale;
+};
+
+
+class TexCoordCompressor : public SemanticCompressor {
+public:
+	TexCoordCompressor(eTexCoordEncoding encoding, const Vec2& rangeMin, const Vec2& rangeMax);
+
+	void Compress(const void* input, void* output) const override;
+	int Size() const override;
+	bool IsSupported(eVertexElementSemantic semantic) const override;
+	gxapi::eFormat GetFormat() const override;
+	std::vector<std::string> GetDecodeFunctions() const override;
+
+private:
+	eTexCoordEncoding m_encoding;
+	Vec2 m_rangeMin;
+	Vec2 m_scale;
 };
 
 
@@ -41,6 +126,7 @@ public:
 	void Compress(const void* input, void* output) const override;
 	int Size() const override;
 	bool IsSupported(eVertexElementSemantic semantic) const override;
+	gxapi::eFormat GetFormat() const override;
 
 private:
 	int m_stride = 0;
@@ -50,15 +136,26 @@ private:
 
 class VertexCompressor {
 public:
-	VertexCompressor(const IVertexReader* reader, const std::vector<bool>& elementMap);
+	VertexCompressor(const IVertexReader* reader, const std::vector<bool>& elementMap, const VertexQuantization& quantization = {});
 
 	std::vector<uint8_t> GetCompressedStream(const VertexBase* vertices, size_t vertexCount) const;
 	int GetCompressedStride() const;
+	/// <summary> Offsets of the reader's elements in the compressed vertex, -1 for elements that are not stored. </summary>
 	std::vector<int> GetCompressedOffsets() const;
+	/// <summary> Formats of the reader's elements in the compressed vertex, UNKNOWN for elements that are not stored. </summary>
+	std::vector<gxapi::eFormat> GetCompressedFormats() const;
+	/// <summary> HLSL functions the vertex shader needs to decode the stream, each function only once. </summary>
+	std::string GetDecodeCode() const;
+
+	/// <summary> Format of an element of <paramref name="size"/> bytes in a stream compressed with <paramref name="quantization"/>. </summary>
+	/// <remarks> For data that was compressed earlier, such as cooked meshes. </remarks>
+	static gxapi::eFormat GetCompressedFormat(eVertexElementSemantic semantic, int size, const VertexQuantization& quantization);
 
 private:
+	VertexCompressor() = default;
+
 	SemanticCompressor* AssignCompressor(const IVertexReader::Element& element);
-	void CreateDefaultCompressorList();
+	void CreateDefaultCompressorList(const VertexQuantization& quantization);
 
 private:
 	struct CompressionElement {
@@ -66,7 +163,7 @@ private:
 		SemanticCompressor* assignedCompressor;
 	};
 
-	const IVertexReader* m_reader;
+	const IVertexReader* m_reader = nullptr;
 	std::vector<CompressionElement> m_elementsToCompress;
 	std::vector<std::unique_ptr<SemanticCompressor>> m_availableCompressors;
 	std::vector<std::unique_ptr<PassthroughCompressor>> m_passThroughCompressors;
@@ -8,6 +8,9 @@
 #include <GraphicsEngine_LL/MeshEntity.hpp>
 #include <GraphicsEngine_LL/Nodes/NodeUtility.hpp>
 
+#include <algorithm>
+#include <cmath>
+
 
 
 namespace inl::gxeng::nodes {
@@ -18,10 +21,84 @@ INL_REGISTER_GRAPHICS_NODE(DebugDraw)
 
 struct Uniforms {
 	Mat44_Packed vp;
-	Vec4_Packed color;
 };
 
 
+// Line list of the unit shape, see eDebugShape.
+static void GetShapeMesh(eDebugShape shape, std::vector<Vec3>& vertices, std::vector<uint32_t>& indices) {
+	vertices.clear();
+	indices.clear();
+
+	switch (shape) {
+		case eDebugShape::LINE: {
+			vertices = { Vec3(0, 0, 0), Vec3(1, 0, 0) };
+			indices = { 0, 1 };
+			break;
+		}
+		case eDebugShape::CROSS: {
+			vertices = { Vec3(-1, 0, 0), Vec3(1, 0, 0), Vec3(0, -1, 0), Vec3(0, 1, 0), Vec3(0, 0, -1), Vec3(0, 0, 1) };
+			indices = { 0, 1, 2, 3, 4, 5 };
+			break;
+		}
+		case eDebugShape::SPHERE: {
+			const float pi = 3.14159265f;
+
+			const int resolutionU = 10;
+			const int resolutionV = 10 * 2;
+
+			// Circles through the poles, each one a closed loop.
+			for (int uIndex = 0; uIndex < resolutionU; ++uIndex) {
+				//0 <= alpha <= pi
+				const float alpha = float(uIndex) / resolutionU * pi;
+				const uint32_t first = (uint32_t)vertices.size();
+
+				for (int vIndex = 0; vIndex < resolutionV; ++vIndex) {
+					//0 <= theta <= 2*pi
+					const float theta = float(vIndex) / resolutionV * 2 * pi;
+					vertices.push_back(Vec3(cosf(alpha) * cosf(theta), sinf(alpha) * cosf(theta), sinf(theta)));
+					indices.push_back(first + vIndex);
+					indices.push_back(first + (vIndex + 1) % resolutionV);
+				}
+			}
+			break;
+		}
+		case eDebugShape::BOX: {
+			for (int corner = 0; corner < 8; ++corner) {
+				vertices.push_back(Vec3(float((corner >> 2) & 1), float((corner >> 1) & 1), float(corner & 1)));
+			}
+			// Connect corners that differ in a single coordinate.
+			for (uint32_t corner = 0; corner < 8; ++corner) {
+				for (uint32_t axis = 1; axis < 8; axis <<= 1) {
+					if (!(corner & axis)) {
+						indices.push_back(corner);
+						indices.push_back(corner | axis);
+					}
+				}
+			}
+			break;
+		}
+		case eDebugShape::CONE: {
+			const float pi = 3.14159265f;
+			const uint32_t resolution = 16;
+
+			vertices.push_back(Vec3(0, 0, 0));
+			for (uint32_t i = 0; i < resolution; ++i) {
+				const float angle = float(i) / resolution * 2 * pi;
+				vertices.push_back(Vec3(cosf(angle), sinf(angle), 1.0f));
+				indices.push_back(1 + i);
+				indices.push_back(1 + (i + 1) % resolution);
+			}
+			// Sides from the apex to four points of the base.
+			for (uint32_t i = 0; i < resolution; i += resolution / 4) {
+				indices.push_back(0);
+				indices.push_back(1 + i);
+			}
+			break;
+		}
+	}
+}
+
+
 static bool CheckMeshFormat(const Mesh& mesh) {
 	for (size_t i = 0; i < mesh.GetNumStreams(); i++) {
 		auto& elements = mesh.GetLayout()[0];
@@ -35,6 +112,13 @@ static bool CheckMeshFormat(const Mesh& mesh) {
 			return false;
 	}
 
+	// The input layout reads floats.
+	const VertexQuantization& quantization = mesh.GetQuantization();
+	if (quantization.position != ePositionEncoding::FLOAT32
+		|| quantization.normal != eDirectionEncoding::FLOAT32
+		|| quantization.texCoord != eTexCoordEncoding::FLOAT32)
+		return false;
+
 	return true;
 }
 
@@ -131,9 +215,14 @@ void DebugDraw::Setup(SetupContext& context) {
 
 		m_shader = context.CreateShader("DebugDraw", shaderParts, "");
 
+		// Slot 0 is the unit shape, slot 1 is the transform and color of the instances.
 		std::vector<gxapi::InputElementDesc> inputElementDesc = {
 			gxapi::InputElementDesc{ .semanticName = "POSITION", .semanticIndex = 0, .format = gxapi::eFormat::R32G32B32_FLOAT, .inputSlot = 0, .offset = 0 },
 		};
+		for (unsigned row = 0; row < 4; ++row) {
+			inputElementDesc.push_back({ .semanticName = "TRANSFORM", .semanticIndex = row, .format = gxapi::eFormat::R32G32B32A32_FLOAT, .inputSlot = 1, .offset = row * 16, .classifiacation = gxapi::eInputClassification::INSTANCE_DATA, .instanceDataStepRate = 1 });
+		}
+		inputElementDesc.push_back({ .semanticName = "COLOR", .semanticIndex = 0, .format = gxapi::eFormat::R32G32B32A32_FLOAT, .inputSlot = 1, .offset = 64, .classifiacation = gxapi::eInputClassification::INSTANCE_DATA, .instanceDataStepRate = 1 });
 
 		gxapi::GraphicsPipelineStateDesc psoDesc;
 		psoDesc.inputLayout.elements = inputElementDesc.data();
@@ -155,56 +244,70 @@ void DebugDraw::Setup(SetupContext& context) {
 		m_trianglePSO.reset(context.CreatePSO(psoDesc));
 	}
 
-	m_objects.resize(DebugDrawManager::GetInstance().GetObjects().size());
-
-	for (int c = 0; c < DebugDrawManager::GetInstance().GetObjects().size(); ++c) {
-		const std::shared_ptr<DebugObject>& currObject = DebugDrawManager::GetInstance().GetObjects()[c];
+	CreateShapeMeshes(context);
+	CollectInstances(context);
+}
 
-		//if there's no allocated vertex buffer and the object is alive, then allocate and fill vertex buffer
-		if (currObject && currObject->IsAlive()) {
 
-			// if the vertex buffer for the current object has not been created yet...
-			if (m_objects[c].first.lock() != currObject) {
-				m_objects[c].first = currObject;
-				std::vector<Vec3> vertices;
-				std::vector<uint32_t> indices;
-				currObject->GetMesh(vertices, indices);
-				m_objects[c].second.vertexBuffer = context.CreateVertexBuffer(vertices.size() * sizeof(Vec3));
-				m_objects[c].second.indexBuffer = context.CreateIndexBuffer(indices.size() * sizeof(uint32_t), indices.size());
-				m_objects[c].second.size = 0;
-				m_objects[c].second.stride = 0;
-			}
-		}
-		else {
-			m_objects[c].first.reset();
-			m_objects[c].second.vertexBuffer = {};
-			m_objects[c].second.indexBuffer = {};
+void DebugDraw::CreateShapeMeshes(SetupContext& context) {
+	for (int shape = 0; shape < DEBUG_SHAPE_COUNT; ++shape) {
+		ShapeMesh& mesh = m_shapeMeshes[shape];
+		if (!mesh.vertexBuffer) {
+			GetShapeMesh(eDebugShape(shape), mesh.vertices, mesh.indices);
+			mesh.vertexBuffer = context.CreateVertexBuffer(mesh.vertices.size() * sizeof(Vec3));
+			mesh.indexBuffer = context.CreateIndexBuffer(mesh.indices.size() * sizeof(uint32_t), mesh.indices.size());
 		}
 	}
 }
 
 
+void DebugDraw::CollectInstances(SetupContext& context) {
+	const std::vector<DebugPrimitive>& primitives = DebugDrawManager::GetInstance().Collect();
+
+	// Group instances by shape, so that each shape is drawn with a single call.
+	std::array<unsigned, DEBUG_SHAPE_COUNT> counts = {};
+	for (auto& primitive : primitives) {
+		++counts[(int)primitive.shape];
+	}
+	m_firstInstance[0] = 0;
+	for (int shape = 0; shape < DEBUG_SHAPE_COUNT; ++shape) {
+		m_firstInstance[shape + 1] = m_firstInstance[shape] + counts[shape];
+	}
+
+	std::array<unsigned, DEBUG_SHAPE_COUNT> next;
+	std::copy_n(m_firstInstance.begin(), DEBUG_SHAPE_COUNT, next.begin());
+	m_instances.resize(primitives.size());
+	for (auto& primitive : primitives) {
+		Instance& instance = m_instances[next[(int)primitive.shape]++];
+		instance.transform = primitive.transform;
+		instance.color = Vec4(primitive.color, 1.0f);
+	}
+
+	// The buffer is kept between frames and grows geometrically.
+	const size_t size = m_instances.size() * sizeof(Instance);
+	if (size > 0 && (!m_instanceBuffer || m_instanceBuffer.GetSize() < size)) {
+		m_instanceBuffer = context.CreateVertexBuffer(std::max(size, m_instanceBuffer ? 2 * m_instanceBuffer.GetSize() : size));
+	}
+}
+
+
 void DebugDraw::Execute(RenderContext& context) {
 	GraphicsCommandList& commandList = context.AsGraphics();
 
-
-	// Upload data to vertex and index buffers
-	for (int c = 0; c < DebugDrawManager::GetInstance().GetObjects().size(); ++c) {
-		const std::shared_ptr<DebugObject>& currObject = DebugDrawManager::GetInstance().GetObjects()[c];
-
-		//if there's no allocated vertex buffer and the object is alive, then allocate and fill vertex buffer
-		if (currObject && currObject->IsAlive()) {
-			if (m_objects[c].second.vertexBuffer && m_objects[c].second.size == 0) {
-				std::vector<Vec3> vertices;
-				std::vector<uint32_t> indices;
-				currObject->GetMesh(vertices, indices);
-				context.Upload(m_objects[c].second.vertexBuffer, 0, vertices.data(), vertices.size() * sizeof(Vec3));
-				context.Upload(m_objects[c].second.indexBuffer, 0, indices.data(), indices.size() * sizeof(uint32_t));
-				m_objects[c].second.size = (unsigned)(m_objects[c].second.vertexBuffer.GetSize());
-				m_objects[c].second.stride = currObject->GetStride();
-			}
+	// Upload the unit shapes the first time, and the instances of the frame.
+	for (auto& mesh : m_shapeMeshes) {
+		if (!mesh.vertices.empty()) {
+			context.Upload(mesh.vertexBuffer, 0, mesh.vertices.data(), mesh.vertices.size() * sizeof(Vec3));
+			context.Upload(mesh.indexBuffer, 0, mesh.indices.data(), mesh.indices.size() * sizeof(uint32_t));
+			mesh.vertices = {};
+			mesh.indices = {};
 		}
 	}
+	if (m_instances.empty()) {
+		DebugDrawManager::GetInstance().Update();
+		return;
+	}
+	context.Upload(m_instanceBuffer, 0, m_instances.data(), m_instances.size() * sizeof(Instance));
 
 	// Render things
 	gxapi::Rectangle rect{ 0, (int)m_target.GetResource().GetHeight(), 0, (int)m_target.GetResource().GetWidth() };
@@ -236,26 +339,26 @@ void DebugDraw::Execute(RenderContext& context) {
 	auto viewProjection = view * projection;
 
 	uniformsCBData.vp = viewProjection;
+	commandList.BindGraphics(m_uniformsBindParam, &uniformsCBData, sizeof(uniformsCBData));
 
-	for (auto& currObject : m_objects) {
-		auto& vb = currObject.second.vertexBuffer;
-		auto& ib = currObject.second.indexBuffer;
+	commandList.SetResourceState(m_instanceBuffer, gxapi::eResourceState::VERTEX_AND_CONSTANT_BUFFER);
 
-		if (currObject.first.expired() || !vb.HasObject() || !ib.HasObject()) {
+	for (int shape = 0; shape < DEBUG_SHAPE_COUNT; ++shape) {
+		const unsigned instanceCount = m_firstInstance[shape + 1] - m_firstInstance[shape];
+		if (instanceCount == 0) {
 			continue;
 		}
 
-		commandList.SetResourceState(vb, gxapi::eResourceState::VERTEX_AND_CONSTANT_BUFFER);
-		commandList.SetResourceState(ib, gxapi::eResourceState::INDEX_BUFFER);
-
-		uniformsCBData.color = Vec4(currObject.first.lock()->GetColor(), 1.0f);
-
-		commandList.BindGraphics(m_uniformsBindParam, &uniformsCBData, sizeof(uniformsCBData));
+		ShapeMesh& mesh = m_shapeMeshes[shape];
+		commandList.SetResourceState(mesh.vertexBuffer, gxapi::eResourceState::VERTEX_AND_CONSTANT_BUFFER);
+		commandList.SetResourceState(mesh.indexBuffer, gxapi::eResourceState::INDEX_BUFFER);
 
-		VertexBuffer* vbPtr = &vb;
-		commandList.SetVertexBuffers(0, 1, &vbPtr, &currObject.second.size, &currObject.second.stride);
-		commandList.SetIndexBuffer(&currObject.second.indexBuffer, true);
-		commandList.DrawIndexedInstanced((unsigned)currObject.second.indexBuffer.GetIndexCount());
+		const VertexBuffer* vertexBuffers[] = { &mesh.vertexBuffer, &m_instanceBuffer };
+		unsigned sizes[] = { (unsigned)mesh.vertexBuffer.GetSize(), (unsigned)m_instanceBuffer.GetSize() };
+		unsigned strides[] = { (unsigned)sizeof(Vec3), (unsigned)sizeof(Instance) };
+		commandList.SetVertexBuffers(0, 2, vertexBuffers, sizes, strides);
+		commandList.SetIndexBuffer(&mesh.indexBuffer, true);
+		commandList.DrawIndexedInstanced((unsigned)mesh.indexBuffer.GetIndexCount(), 0, 0, instanceCount, m_firstInstance[shape]);
 	}
 
 	DebugDrawManager::GetInstance().Update();
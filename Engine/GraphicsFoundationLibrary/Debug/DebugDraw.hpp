@@ -1,11 +1,15 @@
 #pragma once
 
+#include "DebugDrawManager.hpp"
+
 #include <GraphicsApi_LL/IPipelineState.hpp>
 #include <GraphicsEngine_LL/BasicCamera.hpp>
 #include <GraphicsEngine_LL/GraphicsNode.hpp>
 
+#include <array>
 #include <memory>
 #include <optional>
+#include <vector>
 
 namespace inl::gxeng::nodes {
 
@@ -39,21 +43,30 @@ protected:
 	std::unique_ptr<gxapi::IPipelineState> m_trianglePSO;
 
 private:
-	void BuildVertexBuffers();
+	void CreateShapeMeshes(SetupContext& context);
+	void CollectInstances(SetupContext& context);
 
 private:
-	struct MeshData {
+	/// <summary> Per-instance vertex data, layout must match DebugDraw.hlsl. </summary>
+	struct Instance {
+		Mat44_Packed transform;
+		Vec4_Packed color;
+	};
+	static_assert(sizeof(Instance) == 80);
+
+	struct ShapeMesh {
 		gxeng::VertexBuffer vertexBuffer;
 		gxeng::IndexBuffer indexBuffer;
-		unsigned size;
-		unsigned stride;
+		std::vector<Vec3> vertices; // Uploaded on first use, then cleared.
+		std::vector<uint32_t> indices;
 	};
 
-	std::vector<std::pair<std::weak_ptr<DebugObject>, MeshData>> m_objects;
-	//std::vector<gxeng::VertexBuffer> m_vertexBuffers;
-	//std::vector<gxeng::IndexBuffer> m_indexBuffers;
-	//std::vector<unsigned> m_sizes;
-	//std::vector<unsigned> m_strides;
+	std::array<ShapeMesh, DEBUG_SHAPE_COUNT> m_shapeMeshes;
+
+	// Instances of the frame, grouped by shape.
+	std::vector<Instance> m_instances;
+	std::array<unsigned, DEBUG_SHAPE_COUNT + 1> m_firstInstance = {};
+	gxeng::VertexBuffer m_instanceBuffer;
 
 private: // render context
 	RenderTargetView2D m_target;
@@ -1,5 +1,7 @@
 #include "DepthPrepass.hpp"
 
+#include "../Helpers/DynamicPipelineSetup.hpp"
+
 #include <GraphicsEngine_LL/AutoRegisterNode.hpp>
 #include <GraphicsEngine_LL/GraphicsCommandList.hpp>
 #include <GraphicsEngine_LL/Mesh.hpp>
@@ -14,20 +16,18 @@ namespace inl::gxeng::nodes {
 INL_REGISTER_GRAPHICS_NODE(DepthPrepass)
 
 
+// Only positions are read, in whatever format the mesh stores them.
 static bool CheckMeshFormat(const Mesh& mesh) {
 	for (size_t i = 0; i < mesh.GetNumStreams(); i++) {
-		auto& elements = mesh.GetLayout()[0];
-		if (elements.size() != 3)
-			return false;
-		if (elements[0].semantic != eVertexElementSemantic::POSITION)
-			return false;
-		if (elements[1].semantic != eVertexElementSemantic::NORMAL)
-			return false;
-		if (elements[2].semantic != eVertexElementSemantic::TEX_COORD)
-			return false;
+		auto& elements = mesh.GetLayout()[i];
+		for (auto& element : elements) {
+			if (element.semantic == eVertexElementSemantic::POSITION && element.index == 0) {
+				return true;
+			}
+		}
 	}
 
-	return true;
+	return false;
 }
 
 
@@ -121,14 +121,17 @@ void DepthPrepass::Setup(SetupContext& context) {
 		m_shader = context.CreateShader("DepthPrepass", shaderParts, "");
 	}
 
-	if (m_PSO == nullptr || m_depthStencilFormat != currDepthStencilFormat) {
+	if (m_depthStencilFormat != currDepthStencilFormat) {
 		m_depthStencilFormat = currDepthStencilFormat;
+		m_PSOs.clear();
+	}
+}
 
-		std::vector<gxapi::InputElementDesc> inputElementDesc = {
-			gxapi::InputElementDesc{ .semanticName = "POSITION", .semanticIndex = 0, .format = gxapi::eFormat::R32G32B32_FLOAT, .inputSlot = 0, .offset = 0 },
-			gxapi::InputElementDesc{ .semanticName = "NORMAL", .semanticIndex = 0, .format = gxapi::eFormat::R32G32B32_FLOAT, .inputSlot = 0, .offset = 12 },
-			gxapi::InputElementDesc{ .semanticName = "TEX_COORD", .semanticIndex = 0, .format = gxapi::eFormat::R32G32_FLOAT, .inputSlot = 0, .offset = 24 },
-		};
+
+gxapi::IPipelineState* DepthPrepass::GetPSO(RenderContext& context, const Mesh::Layout& layout) {
+	auto psoIt = m_PSOs.find(layout);
+	if (psoIt == m_PSOs.end()) {
+		std::vector<gxapi::InputElementDesc> inputElementDesc = MeshInputElements(layout);
 
 		gxapi::GraphicsPipelineStateDesc psoDesc;
 		psoDesc.inputLayout.elements = inputElementDesc.data();
@@ -144,8 +147,9 @@ void DepthPrepass::Setup(SetupContext& context) {
 
 		psoDesc.numRenderTargets = 0;
 
-		m_PSO.reset(context.CreatePSO(psoDesc));
+		psoIt = m_PSOs.insert({ layout, std::unique_ptr<gxapi::IPipelineState>(context.CreatePSO(psoDesc)) }).first;
 	}
+	return psoIt->second.get();
 }
 
 
@@ -177,7 +181,6 @@ void DepthPrepass::Execute(RenderContext& context) {
 	commandList.SetResourceState(m_targetDsv.GetResource(), gxapi::eResourceState::DEPTH_WRITE);
 	commandList.ClearDepthStencil(m_targetDsv, 1, 0, 0, nullptr, true, true);
 
-	commandList.SetPipelineState(m_PSO.get());
 	commandList.SetGraphicsBinder(&m_binder);
 	commandList.SetPrimitiveTopology(gxapi::ePrimitiveTopology::TRIANGLELIST);
 
@@ -196,7 +199,10 @@ void DepthPrepass::Execute(RenderContext& context) {
 		if (!entity->GetMesh()) {
 			continue;
 		}
-		Mesh* mesh = entity->GetMeshNative().get();
+		Mesh* mesh = entity->SelectLodNative(view, projection);
+		if (!mesh->IsUploaded()) {
+			continue;
+		}
 		auto position = entity->Transform().GetPosition();
 
 		// Draw mesh
@@ -206,8 +212,9 @@ void DepthPrepass::Execute(RenderContext& context) {
 		}
 
 		ConvertToSubmittable(mesh, vertexBuffers, sizes, strides);
+		commandList.SetPipelineState(GetPSO(context, mesh->GetLayout()));
 
-		auto MVP = entity->Transform().GetMatrix() * viewProjection;
+		auto MVP = mesh->GetPositionDequantization() * entity->Transform().GetMatrix() * viewProjection;
 
 		Mat44_Packed transformCBData;
 		transformCBData = MVP;
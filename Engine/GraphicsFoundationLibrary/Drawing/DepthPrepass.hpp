@@ -3,6 +3,9 @@
 #include <GraphicsApi_LL/IPipelineState.hpp>
 #include <GraphicsEngine_LL/BasicCamera.hpp>
 #include <GraphicsEngine_LL/GraphicsNode.hpp>
+#include <GraphicsEngine_LL/Mesh.hpp>
+
+#include <unordered_map>
 
 namespace inl::gxeng::nodes {
 
@@ -28,12 +31,15 @@ public:
 	const std::string& GetInputName(size_t index) const override;
 	const std::string& GetOutputName(size_t index) const override;
 
+private:
+	gxapi::IPipelineState* GetPSO(RenderContext& context, const Mesh::Layout& layout);
+
 private:
 	BindParameter m_transformBindParam;
 	gxapi::eFormat m_depthStencilFormat = gxapi::eFormat::UNKNOWN;
 
 	Binder m_binder;
-	std::unique_ptr<gxapi::IPipelineState> m_PSO;
+	std::unordered_map<Mesh::Layout, std::unique_ptr<gxapi::IPipelineState>, Mesh::Layout::HashLayout, Mesh::Layout::EqualToLayout> m_PSOs; // One for each vertex layout.
 	ShaderProgram m_shader;
 	DepthStencilView2D m_targetDsv;
 };
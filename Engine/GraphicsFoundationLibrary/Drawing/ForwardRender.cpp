@@ -1,5 +1,7 @@
 #include "ForwardRender.hpp"
 
+#include "../Helpers/DynamicPipelineSetup.hpp"
+
 #include <BaseLibrary/Range.hpp>
 #include <GraphicsEngine_LL/AutoRegisterNode.hpp>
 #include <GraphicsEngine_LL/GraphicsCommandList.hpp>
@@ -8,7 +10,10 @@
 #include <GraphicsEngine_LL/MaterialShader.hpp>
 #include <GraphicsEngine_LL/MeshEntity.hpp>
 #include <GraphicsEngine_LL/Nodes/NodeUtility.hpp>
+#include <GraphicsEngine_LL/VertexCompressor.hpp>
 
+#include <algorithm>
+#include <cmath>
 #include <regex>
 
 
@@ -56,6 +61,15 @@ static void SetWorkgroupSize(unsigned w, unsigned h, unsigned groupSizeW, unsign
 	dispatchH = unsigned(float(gh) / groupSizeH);
 }
 
+// Estimates which mip level of streaming textures the entity needs at the given distance.
+static unsigned EstimateMipLevel(float distance) {
+	constexpr float fullDetailDistance = 8.0f;
+	if (distance <= fullDetailDistance) {
+		return 0;
+	}
+	return (unsigned)std::log2(distance / fullDetailDistance);
+}
+
 static bool CheckMeshFormat(const Mesh& mesh) {
 	for (size_t i = 0; i < mesh.GetNumStreams(); i++) {
 		auto& elements = mesh.GetLayout()[0];
@@ -305,12 +319,17 @@ void ForwardRender::Execute(RenderContext& context) {
 	// Iterate over all entities
 	for (const MeshEntity* entity : *m_entities) {
 		// Get entity parameters
-		Mesh* mesh = entity->GetMeshNative().get();
+		Mesh* mesh = entity->SelectLodNative(view, projection);
 		Material* material = entity->GetMaterialNative().get();
 
 		assert(mesh != nullptr);
 		assert(material != nullptr);
 
+		// Assets still being uploaded on the copy queue appear when ready.
+		if (!mesh->IsUploaded() || !material->IsUploaded()) {
+			continue;
+		}
+
 		// Set pipeline state & binder
 		const Mesh::Layout& layout = mesh->GetLayout();
 		const MaterialShader* materialShader = material->GetShader();
@@ -338,6 +357,7 @@ void ForwardRender::Execute(RenderContext& context) {
 		commandList.BindGraphics(BindParameter(eBindParameterType::TEXTURE, 602), m_layeredShadowTexView);
 
 		// Set material parameters
+		const unsigned mipLevel = EstimateMipLevel(Length(entity->Transform().GetPosition() - m_camera->GetPosition()));
 		std::vector<uint8_t> materialConstants(scenario.constantsSize);
 		for (size_t paramIdx = 0; paramIdx < material->GetParameterCount(); ++paramIdx) {
 			const Material::Parameter& param = (*material)[paramIdx];
@@ -345,6 +365,7 @@ void ForwardRender::Execute(RenderContext& context) {
 				case eMaterialShaderParamType::BITMAP_COLOR_2D:
 				case eMaterialShaderParamType::BITMAP_VALUE_2D: {
 					BindParameter bindSlot(eBindParameterType::TEXTURE, scenario.offsets[paramIdx]);
+					((Image*)param)->RequestMip(mipLevel);
 					commandList.SetResourceState(((Image*)param)->GetSrv().GetResource(), { gxapi::eResourceState::PIXEL_SHADER_RESOURCE, gxapi::eResourceState::NON_PIXEL_SHADER_RESOURCE });
 					commandList.BindGraphics(bindSlot, ((Image*)param)->GetSrv());
 					break;
@@ -377,6 +398,7 @@ void ForwardRender::Execute(RenderContext& context) {
 		vsConstants.v = view;
 		vsConstants.p = projection;
 		vsConstants.prevMVP = vsConstants.mvp; // entity->GetPrevTransform() * prevViewProjection;
+		vsConstants.positionDequantization = mesh->GetPositionDequantization();
 		if (sun) {
 			Vec4 vsLightDir = Vec4(sun->GetDirection(), 0.0f) * view;
 			lightConstants.direction = Normalize(Vec3(vsLightDir.xyz));
@@ -470,7 +492,7 @@ ForwardRender::ScenarioData& ForwardRender::GetScenario(
 		Binder binder;
 
 		binder = GenerateBinder(context, material, offsets, constantsSize);
-		pso = CreatePso(context, binder, vsIt->second.vs, psIt->second.ps, renderTargetFormat, depthStencilFormat);
+		pso = CreatePso(context, binder, layout, vsIt->second.vs, psIt->second.ps, renderTargetFormat, depthStencilFormat);
 
 		auto res = m_scenarios.insert({ key, ScenarioData() });
 		scenarioIt = res.first;
@@ -486,7 +508,7 @@ ForwardRender::ScenarioData& ForwardRender::GetScenario(
 		auto& vs = m_vertexShaders.at(layout).vs;
 		auto& ps = m_materialShaders.at(shaderCode).ps;
 
-		auto newPso = CreatePso(context, scenarioIt->second.binder, vs, ps, renderTargetFormat, depthStencilFormat);
+		auto newPso = CreatePso(context, scenarioIt->second.binder, layout, vs, ps, renderTargetFormat, depthStencilFormat);
 
 		scenarioIt->second.pso = std::move(newPso);
 		scenarioIt->second.renderTargetFormat = renderTargetFormat;
@@ -504,16 +526,36 @@ std::string ForwardRender::GenerateVertexShader(const Mesh::Layout& layout) {
 		throw InvalidArgumentException("Meshes must have a single interleaved buffer.");
 	}
 
+	// Further elements, like tangents of cooked meshes, are left out of the input layout.
 	auto& elements = layout[0];
-	if (elements.size() != 3
-		|| elements[0].semantic != eVertexElementSemantic::POSITION
-		|| elements[1].semantic != eVertexElementSemantic::NORMAL
-		|| elements[2].semantic != eVertexElementSemantic::TEX_COORD) {
+	auto& formats = layout.GetFormats(0);
+	auto FindElement = [&elements](eVertexElementSemantic semantic) {
+		return std::find_if(elements.begin(), elements.end(), [semantic](const Mesh::Element& element) {
+			return element.semantic == semantic && element.index == 0;
+		});
+	};
+	auto normalIt = FindElement(eVertexElementSemantic::NORMAL);
+	if (FindElement(eVertexElementSemantic::POSITION) == elements.end()
+		|| normalIt == elements.end()
+		|| FindElement(eVertexElementSemantic::TEX_COORD) == elements.end()) {
 		throw InvalidArgumentException("Mesh must have 3 attributes: position, normal, texcoord.");
 	}
 
+	// Quantized positions go through the dequantization matrix, octahedral normals are decoded.
+	std::string normalDecode;
+	std::string decodeFunctions;
+	const gxapi::eFormat normalFormat = formats[normalIt - elements.begin()];
+	if (normalFormat == gxapi::eFormat::R8G8_SNORM || normalFormat == gxapi::eFormat::R16G16_SNORM) {
+		const eDirectionEncoding encoding = normalFormat == gxapi::eFormat::R8G8_SNORM ? eDirectionEncoding::OCTAHEDRAL16 : eDirectionEncoding::OCTAHEDRAL32;
+		for (auto& function : OctahedralNormalCompressor{ encoding }.GetDecodeFunctions()) {
+			decodeFunctions += function;
+		}
+		normalDecode = "	normal.xyz = DecodeOctahedral(normal.xy);\n";
+	}
+
 	std::string vertexShader =
-		"Texture2D<float4> lightMVPTex : register(t503);"
+		decodeFunctions
+		+ "Texture2D<float4> lightMVPTex : register(t503);"
 		"struct VsConstants \n"
 		"{\n"
 		"	float4x4 MVP;\n"
@@ -522,6 +564,7 @@ std::string ForwardRender::GenerateVertexShader(const Mesh::Layout& layout) {
 		"	float4x4 M;\n"
 		"	float4x4 V;\n"
 		"	float4x4 P;\n"
+		"	float4x4 positionDequantization;\n"
 		"};\n"
 		"ConstantBuffer<VsConstants> vsConstants : register(b0);\n"
 
@@ -539,6 +582,8 @@ std::string ForwardRender::GenerateVertexShader(const Mesh::Layout& layout) {
 		"PS_Input VSMain(float4 position : POSITION, float4 normal : NORMAL, float4 texCoord : TEX_COORD)\n"
 		"{\n"
 		"	PS_Input result;\n"
+		"	position = mul(position, vsConstants.positionDequantization);\n"
+		+ normalDecode +
 		//"	normal.xyz = normalize(normal.xyz);\n"
 		"	float3 viewNormal = mul(normal.xyz, (float3x3)vsConstants.MV);\n"
 
@@ -905,17 +950,14 @@ Binder ForwardRender::GenerateBinder(RenderContext& context, const Material& mat
 std::unique_ptr<gxapi::IPipelineState> ForwardRender::CreatePso(
 	RenderContext& context,
 	Binder& binder,
+	const Mesh::Layout& layout,
 	ShaderStage& vs,
 	ShaderStage& ps,
 	gxapi::eFormat renderTargetFormat,
 	gxapi::eFormat depthStencilFormat) {
 	std::unique_ptr<gxapi::IPipelineState> result;
 
-	std::vector<gxapi::InputElementDesc> inputElementDesc = {
-		gxapi::InputElementDesc{ .semanticName = "POSITION", .semanticIndex = 0, .format = gxapi::eFormat::R32G32B32_FLOAT, .inputSlot = 0, .offset = 0 },
-		gxapi::InputElementDesc{ .semanticName = "NORMAL", .semanticIndex = 0, .format = gxapi::eFormat::R32G32B32_FLOAT, .inputSlot = 0, .offset = 12 },
-		gxapi::InputElementDesc{ .semanticName = "TEX_COORD", .semanticIndex = 0, .format = gxapi::eFormat::R32G32_FLOAT, .inputSlot = 0, .offset = 24 },
-	};
+	std::vector<gxapi::InputElementDesc> inputElementDesc = MeshInputElements(layout);
 
 	gxapi::GraphicsPipelineStateDesc psoDesc;
 	psoDesc.inputLayout.elements = inputElementDesc.data();
@@ -47,6 +47,7 @@ private:
 		Mat44_Packed m;
 		Mat44_Packed v;
 		Mat44_Packed p;
+		Mat44_Packed positionDequantization;
 	};
 	struct LightConstants {
 		alignas(16) Vec3_Packed direction;
@@ -74,6 +75,7 @@ private:
 	std::unique_ptr<gxapi::IPipelineState> CreatePso(
 		RenderContext& context,
 		Binder& binder,
+		const Mesh::Layout& layout,
 		ShaderStage& vs,
 		ShaderStage& ps,
 		gxapi::eFormat renderTargetFormat,
@@ -231,7 +231,9 @@ void RenderForwardHeightmaps::RenderEntities(RenderContext& context, GraphicsCom
 		const Mesh& mesh = static_cast<const Mesh&>(*entity->GetMesh());
 		const Material& material = static_cast<const Material&>(*entity->GetMaterial());
 		const Image& heightmap = static_cast<const Image&>(*entity->GetHeightmap());
-
+		if (!mesh.IsUploaded() || !material.IsUploaded() || !heightmap.IsUploaded()) {
+			continue;
+		}
 
 		const PipelineStateConfig& stateDesc = m_psoCache.GetConfig(context, mesh, material);
 
@@ -19,6 +19,7 @@ struct VsConstants {
 	Mat44_Packed world;
 	Mat44_Packed viewProj;
 	Mat44_Packed worldViewProjDer;
+	Mat44_Packed positionDequantization;
 };
 
 struct PsConstants {
@@ -198,8 +199,11 @@ void RenderForwardSimple::RenderEntities(RenderContext& context, GraphicsCommand
 		}
 
 		VsConstants vsConstants;
-		const Mesh& mesh = static_cast<const Mesh&>(*entity->GetMesh());
+		const Mesh& mesh = static_cast<const Mesh&>(*entity->SelectLod(view, proj));
 		const Material& material = static_cast<const Material&>(*entity->GetMaterial());
+		if (!mesh.IsUploaded() || !material.IsUploaded()) {
+			continue;
+		}
 
 		const PipelineStateConfig& stateDesc = m_psoCache.GetConfig(context, mesh, material);
 
@@ -207,6 +211,7 @@ void RenderForwardSimple::RenderEntities(RenderContext& context, GraphicsCommand
 		vsConstants.world = world;
 		vsConstants.viewProj = world * viewProj;
 		vsConstants.worldViewProjDer = Zero(); // TODO
+		vsConstants.positionDequantization = mesh.GetPositionDequantization();
 
 		stateDesc.BindPipeline(commandList);
 		commandList.BindGraphics(vsConstantsBind.parameter, &vsConstants, sizeof(vsConstants));
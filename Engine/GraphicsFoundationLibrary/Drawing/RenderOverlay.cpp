@@ -11,6 +11,7 @@
 #include <GraphicsEngine_LL/OverlayEntity.hpp>
 #include <GraphicsEngine_LL/TextEntity.hpp>
 
+#include <algorithm>
 #include <locale>
 
 namespace inl::gxeng::nodes {
@@ -32,19 +33,6 @@ struct CbufferOverlay {
 	uint32_t enableDiscard;
 };
 
-struct CbufferTextTransform {
-	Mat34_Packed worldViewProj;
-	float z;
-};
-
-struct CbufferTextRender {
-	Vec2i_Packed atlasAccessTopleft;
-	Vec2i_Packed atlasAccessSize;
-	Vec4_Packed color;
-	Mat34_Packed discardTransform;
-	uint32_t enableDiscard;
-};
-
 
 
 void RenderOverlay::Reset() {
@@ -59,6 +47,14 @@ void RenderOverlay::Reset() {
 	// Release binders.
 	m_overlayBinder = {};
 	m_textBinder = {};
+
+	// Forget entities, the scene may be replaced.
+	m_retained.clear();
+	m_drawOrder.clear();
+	m_overlayCollection = nullptr;
+	m_textCollection = nullptr;
+	m_fontsToUpload.clear();
+	m_batchesDirty = true;
 }
 
 
@@ -74,57 +70,30 @@ void RenderOverlay::Setup(SetupContext& context) {
 
 
 void RenderOverlay::Execute(RenderContext& context) {
-	// Get list of entities to render.
-	const EntityCollection<IOverlayEntity>* overlays = GetInput<2>().Get();
-	const EntityCollection<ITextEntity>* texts = GetInput<3>().Get();
-
-
-	// Sort entities by z-order and get Z limits.
-	float minZ = std::numeric_limits<float>::max(), maxZ = std::numeric_limits<float>::lowest();
-	std::vector<const OverlayEntity*> overlayList;
-	std::vector<const TextEntity*> textList;
-
-	if (overlays) {
-		for (auto& entity : *overlays) {
-			float z = entity->GetZDepth();
-			minZ = std::min(minZ, z);
-			maxZ = std::max(maxZ, z);
-			overlayList.push_back(static_cast<const OverlayEntity*>(entity));
-		}
+	const Camera2D* camera = GetInput<1>().Get();
+	if (!camera) {
+		throw InvalidArgumentException("You must supply a non-null camera.");
 	}
 
-	if (texts) {
-		for (auto& entity : *texts) {
-			float z = entity->GetZDepth();
-			minZ = std::min(minZ, z);
-			maxZ = std::max(maxZ, z);
-			textList.push_back(static_cast<const TextEntity*>(entity));
-		}
+	// Only entities that changed since the last frame are processed.
+	UpdateMembership(GetInput<2>().Get(), GetInput<3>().Get());
+	UpdateRetainedEntities(camera->GetViewMatrix() * camera->GetProjectionMatrix());
+	if (m_batchesDirty) {
+		RebuildBatches();
 	}
 
-	auto Pred = [](auto lhs, auto rhs) {
-		return lhs->GetZDepth() < rhs->GetZDepth();
-	};
-	std::sort(overlayList.begin(), overlayList.end(), Pred);
-	std::sort(textList.begin(), textList.end(), Pred);
-
-	// If one of them was INF.
-	if (minZ > maxZ) {
-		minZ = 0;
-		maxZ = 1;
-	}
+	// Render entities
+	GraphicsCommandList& commandList = context.AsGraphics();
 
-	// If they are equal.
-	if (minZ == maxZ) {
-		minZ -= 1;
-		maxZ += 1;
+	// Glyphs rasterized while rebuilding are copied on this command list, so that their text is not held back a frame.
+	for (const Font* font : m_fontsToUpload) {
+		font->UploadGlyphs(context);
 	}
+	m_fontsToUpload.clear();
 
-	// Render entities
-	GraphicsCommandList& commandList = context.AsGraphics();
 	commandList.SetResourceState(m_rtv.GetResource(), gxapi::eResourceState::RENDER_TARGET);
 	//commandList.ClearRenderTarget(m_rtv, ColorRGBA(0, 0, 0, 0));
-	RenderEntities(commandList, overlayList, textList, minZ, maxZ);
+	RenderBatches(commandList);
 }
 
 
@@ -199,6 +168,15 @@ void RenderOverlay::CreateBinders(SetupContext& context) {
 		parameters.push_back(p);
 		m_bindOverlayCb = p.parameter;
 
+		// quad batch
+		p.parameter.reg = 1;
+		p.parameter.space = 0;
+		p.parameter.type = eBindParameterType::CONSTANT;
+		p.constantSize = sizeof(QuadInstance) * maxBatchSize;
+		p.shaderVisibility = eShaderVisiblity::VERTEX;
+		parameters.push_back(p);
+		m_bindOverlayBatch = p.parameter;
+
 		// texture
 		p.parameter.reg = 0;
 		p.parameter.space = 0;
@@ -223,23 +201,14 @@ void RenderOverlay::CreateBinders(SetupContext& context) {
 		p.relativeAccessFrequency = 1;
 		p.relativeChangeFrequency = 1;
 
-		// vs cbuffer
+		// quad batch
 		p.parameter.reg = 0;
 		p.parameter.space = 0;
 		p.parameter.type = eBindParameterType::CONSTANT;
-		p.constantSize = sizeof(CbufferTextTransform);
+		p.constantSize = sizeof(QuadInstance) * maxBatchSize;
 		p.shaderVisibility = eShaderVisiblity::VERTEX;
 		parameters.push_back(p);
-		m_bindTextTransform = p.parameter;
-
-		// ps cbuffer
-		p.parameter.reg = 7;
-		p.parameter.space = 0;
-		p.parameter.type = eBindParameterType::CONSTANT;
-		p.constantSize = sizeof(CbufferTextRender);
-		p.shaderVisibility = eShaderVisiblity::PIXEL;
-		parameters.push_back(p);
-		m_bindTextRender = p.parameter;
+		m_bindTextBatch = p.parameter;
 
 		// texture
 		p.parameter.reg = 0;
@@ -331,21 +300,162 @@ void RenderOverlay::CreatePipelineStates(SetupContext& context) {
 }
 
 
-void RenderOverlay::RenderEntities(GraphicsCommandList& commandList,
-								   const std::vector<const OverlayEntity*>& overlayList,
-								   const std::vector<const TextEntity*>& textList,
-								   float minZ,
-								   float maxZ) {
-	// Z-recalculation to fit in between 0 and 1
-	auto RecalcZ = [minZ, maxZ](float z) {
-		return (z - minZ) / (maxZ - minZ) * 0.98f + 0.01f;
-	};
+void RenderOverlay::UpdateMembership(const EntityCollection<IOverlayEntity>* overlays, const EntityCollection<ITextEntity>* texts) {
+	const bool overlaysChanged = overlays != m_overlayCollection || (overlays && overlays->GetRevision() != m_overlayCollectionRevision);
+	const bool textsChanged = texts != m_textCollection || (texts && texts->GetRevision() != m_textCollectionRevision);
+	if (!overlaysChanged && !textsChanged) {
+		return;
+	}
+	m_overlayCollection = overlays;
+	m_textCollection = texts;
+	m_overlayCollectionRevision = overlays ? overlays->GetRevision() : 0;
+	m_textCollectionRevision = texts ? texts->GetRevision() : 0;
+
+	// The type is set again in case an entity was replaced by another at the same address,
+	// its revision differs for sure so it'll be rebuilt.
+	++m_membership;
+	if (overlays) {
+		for (auto& entity : *overlays) {
+			RetainedEntity& retained = m_retained[entity];
+			retained.overlay = static_cast<const OverlayEntity*>(entity);
+			retained.text = nullptr;
+			retained.membership = m_membership;
+		}
+	}
+	if (texts) {
+		for (auto& entity : *texts) {
+			RetainedEntity& retained = m_retained[entity];
+			retained.overlay = nullptr;
+			retained.text = static_cast<const TextEntity*>(entity);
+			retained.membership = m_membership;
+		}
+	}
+	std::erase_if(m_retained, [this](const auto& item) { return item.second.membership != m_membership; });
 
-	const Camera2D* camera = GetInput<1>().Get();
-	if (!camera) {
-		throw InvalidArgumentException("You must supply a non-null camera.");
+	m_drawOrder.clear();
+	for (auto& [entity, retained] : m_retained) {
+		m_drawOrder.push_back(&retained);
+	}
+	m_membershipChanged = true;
+}
+
+
+void RenderOverlay::UpdateRetainedEntities(const Mat33& viewProj) {
+	// Find changed entities, the font of consecutive texts is mostly the same.
+	const Font* lastFont = nullptr;
+	uint64_t lastFontRevision = 0;
+	bool reorder = m_membershipChanged;
+	m_changed.clear();
+	for (RetainedEntity* retained : m_drawOrder) {
+		const Entity* entity = retained->overlay ? static_cast<const Entity*>(retained->overlay) : retained->text;
+		uint64_t fontRevision = 0;
+		if (retained->text) {
+			const Font* font = retained->text->GetFontNative().get();
+			if (font && font != lastFont) {
+				lastFont = font;
+				lastFontRevision = font->GetRevision();
+			}
+			fontRevision = font ? lastFontRevision : 0;
+		}
+		if (retained->revision != entity->GetRevision() || retained->fontRevision != fontRevision) {
+			const float z = retained->overlay ? retained->overlay->GetZDepth() : retained->text->GetZDepth();
+			retained->reinsert = z != retained->z;
+			reorder = reorder || retained->reinsert;
+			retained->z = z;
+			m_changed.push_back(retained);
+		}
+	}
+
+	// Restore Z order, moving only the entities whose Z changed when there are just a few.
+	if (m_membershipChanged || m_changed.size() > m_drawOrder.size() / 4) {
+		std::sort(m_drawOrder.begin(), m_drawOrder.end(), DrawsBefore);
+	}
+	else if (reorder) {
+		std::erase_if(m_drawOrder, [](const RetainedEntity* retained) { return retained->reinsert; });
+		for (RetainedEntity* retained : m_changed) {
+			if (retained->reinsert) {
+				m_drawOrder.insert(std::upper_bound(m_drawOrder.begin(), m_drawOrder.end(), retained, DrawsBefore), retained);
+			}
+		}
+	}
+	m_membershipChanged = false;
+
+	// Z is remapped between 0 and 1 using the full range.
+	float minZ = m_drawOrder.empty() ? 0.0f : m_drawOrder.front()->z;
+	float maxZ = m_drawOrder.empty() ? 1.0f : m_drawOrder.back()->z;
+	if (minZ == maxZ) {
+		minZ -= 1;
+		maxZ += 1;
+	}
+
+	if (viewProj != m_viewProj || minZ != m_minZ || maxZ != m_maxZ) {
+		m_viewProj = viewProj;
+		m_minZ = minZ;
+		m_maxZ = maxZ;
+		for (RetainedEntity* retained : m_drawOrder) {
+			RebuildEntity(*retained);
+		}
+		m_batchesDirty = true;
+	}
+	else {
+		for (RetainedEntity* retained : m_changed) {
+			RebuildEntity(*retained);
+		}
+		m_batchesDirty = m_batchesDirty || reorder || !m_changed.empty();
+	}
+}
+
+
+void RenderOverlay::RebuildEntity(RetainedEntity& retained) {
+	retained.quads.clear();
+
+	if (const OverlayEntity* entity = retained.overlay) {
+		retained.revision = entity->GetRevision();
+		retained.fontRevision = 0;
+
+		auto [shouldDraw, discardTransform] = CullEntity(*entity, m_viewProj);
+		if (shouldDraw) {
+			Mat33 world = entity->Transform().GetMatrix();
+			retained.quads.push_back({ MakeInstance(world * m_viewProj, discardTransform, entity->GetZDepth(), entity->GetColor()), entity->GetTextureNative().get() });
+		}
+	}
+	else {
+		const TextEntity* entity = retained.text;
+		const Font* font = entity->GetFontNative().get();
+		retained.revision = entity->GetRevision();
+		retained.fontRevision = font ? font->GetRevision() : 0;
+
+		auto [shouldDraw, discardTransform] = CullEntity(*entity, m_viewProj);
+		if (shouldDraw && font) {
+			Mat33 worldViewProj = entity->Transform().GetMatrix() * m_viewProj;
+			AppendLetters(*entity, worldViewProj, MakeInstance(worldViewProj, discardTransform, entity->GetZDepth(), entity->GetColor()), retained.quads);
+		}
 	}
+}
+
+
+void RenderOverlay::RebuildBatches() {
+	// Consecutive quads of the same type and texture are collected into a batch and drawn instanced.
+	// Entities are drawn strictly in Z order, so a batch ends whenever the other type comes next.
+	m_instances.clear();
+	m_batches.clear();
+	for (const RetainedEntity* retained : m_drawOrder) {
+		const bool text = retained->text != nullptr;
+		const OverlayEntity* mesh = retained->overlay && retained->overlay->GetMeshNative() ? retained->overlay : nullptr;
+		for (auto& quad : retained->quads) {
+			const Batch* last = m_batches.empty() ? nullptr : &m_batches.back();
+			if (mesh || !last || last->mesh || last->text != text || last->texture != quad.texture || last->instanceCount == maxBatchSize) {
+				m_batches.push_back({ text, quad.texture, m_instances.size(), 0, mesh });
+			}
+			m_instances.push_back(quad.instance);
+			++m_batches.back().instanceCount;
+		}
+	}
+	m_batchesDirty = false;
+}
+
 
+void RenderOverlay::RenderBatches(GraphicsCommandList& commandList) {
 	// Set up pipeline.
 	const RenderTargetView2D* rtvs[] = { &m_rtv };
 	commandList.SetResourceState(m_rtv.GetResource(), eResourceState::RENDER_TARGET);
@@ -363,159 +473,134 @@ void RenderOverlay::RenderEntities(GraphicsCommandList& commandList,
 	commandList.SetScissorRects(1, &rect);
 	commandList.SetViewports(1, &viewport);
 
-	auto itOverlay = overlayList.begin();
-	auto itText = textList.begin();
-
-	Mat33 view = camera->GetViewMatrix();
-	Mat33 proj = camera->GetProjectionMatrix();
-
-	enum {
-		UNKNOWN,
-		OVERLAY,
-		TEXT
-	} lastType = UNKNOWN;
-
-	while (itOverlay != overlayList.end() || itText != textList.end()) {
-
-
-		float zOverlay = (itOverlay != overlayList.end() ? (*itOverlay)->GetZDepth() : std::numeric_limits<float>::max());
-		float zText = (itText != textList.end() ? (*itText)->GetZDepth() : std::numeric_limits<float>::max());
-
-		if (zOverlay < zText) {
-			// Render the overlay.
-			const OverlayEntity* entity = *itOverlay;
-			const Mesh* mesh = entity->GetMeshNative().get();
-			const Image* texture = entity->GetTextureNative().get();
+	std::optional<bool> boundText;
+	for (const Batch& batch : m_batches) {
+		// Glyph pages and streamed images may not have been uploaded yet.
+		const bool hasTexture = batch.texture != nullptr && batch.texture->GetSrv();
+		if (batch.text && !hasTexture) {
+			continue;
+		}
+		// Skipped until the copy queue has finished uploading them.
+		if ((hasTexture && !batch.texture->IsUploaded()) || (batch.mesh && !batch.mesh->GetMeshNative()->IsUploaded())) {
+			continue;
+		}
 
-			// Cancel the overlay early if possible/needed.
-			auto [shouldDraw, discardTransform] = CullEntity(*entity, view * proj);
-			if (!shouldDraw) {
-				++itOverlay;
-				continue;
-			}
+		if (boundText != batch.text) {
+			commandList.SetPipelineState(batch.text ? m_textPso.get() : m_overlayPso.get());
+			commandList.SetGraphicsBinder(batch.text ? &m_textBinder : &m_overlayBinder);
+			boundText = batch.text;
+		}
 
-			if (lastType != OVERLAY) {
-				commandList.SetPipelineState(m_overlayPso.get());
-				commandList.SetGraphicsBinder(&m_overlayBinder);
-			}
+		if (batch.mesh) {
+			RenderMesh(commandList, *batch.mesh, m_instances[batch.firstInstance], hasTexture ? batch.texture : nullptr);
+			continue;
+		}
 
+		if (!batch.text) {
 			CbufferOverlay cbuffer;
-
-			Mat33 world = entity->Transform().GetMatrix();
-
-			cbuffer.worldViewProj.Submatrix<3, 3>(0, 0) = world * view * proj;
-			cbuffer.hasTexture = (uint32_t)(texture != nullptr && texture->GetSrv());
-			cbuffer.hasMesh = bool(mesh);
-			cbuffer.color = entity->GetColor();
-			cbuffer.z = RecalcZ(entity->GetZDepth());
-
-			cbuffer.enableDiscard = (bool)discardTransform;
-			if (discardTransform) {
-				cbuffer.discardTransform.Submatrix<3, 3>(0, 0) = discardTransform.value();
-			}
-
+			cbuffer.hasTexture = hasTexture;
+			cbuffer.hasMesh = false;
+			cbuffer.enableDiscard = false;
 			commandList.BindGraphics(m_bindOverlayCb, &cbuffer, sizeof(cbuffer));
-			if (cbuffer.hasTexture) {
-				commandList.SetResourceState(texture->GetSrv().GetResource(), { eResourceState::PIXEL_SHADER_RESOURCE, eResourceState::NON_PIXEL_SHADER_RESOURCE });
-				commandList.BindGraphics(m_bindOverlayTexture, texture->GetSrv());
-			}
-
-			if (cbuffer.hasMesh) {
-				auto numStreams = mesh->GetNumStreams();
-				std::vector<const VertexBuffer*> vbs(numStreams);
-				std::vector<unsigned> vbsizes(numStreams), vbstrides(numStreams);
-				for (auto stream : Range(mesh->GetNumStreams())) {
-					const VertexBuffer& vb = mesh->GetVertexBuffer(stream);
-					vbs[stream] = &vb;
-					vbsizes[stream] = (unsigned)vb.GetSize();
-					vbstrides[stream] = (unsigned)mesh->GetVertexBufferStride(stream);
-					commandList.SetResourceState(vb, eResourceState::VERTEX_AND_CONSTANT_BUFFER);
-				}
-				commandList.SetPrimitiveTopology(ePrimitiveTopology::TRIANGLELIST);
-				commandList.SetResourceState(mesh->GetIndexBuffer(), eResourceState::INDEX_BUFFER);
-				commandList.SetVertexBuffers(0, (unsigned)vbs.size(), vbs.data(), vbsizes.data(), vbstrides.data());
-				commandList.SetIndexBuffer(&mesh->GetIndexBuffer(), mesh->IsIndexBuffer32Bit());
-				commandList.DrawIndexedInstanced((unsigned)mesh->GetIndexBuffer().GetIndexCount());
-			}
-			else {
-				commandList.SetPrimitiveTopology(ePrimitiveTopology::TRIANGLESTRIP);
-				commandList.DrawInstanced(4);
-			}
-
-			++itOverlay;
-			lastType = OVERLAY;
 		}
-		else {
-			// Render the text.
-
-			// Cancel entity early if possible/needed.
-			const TextEntity* entity = *itText;
-			const Font* font = entity->GetFontNative().get();
-			auto [shouldDraw, discardTransform] = CullEntity(*entity, view * proj);
-			if (!shouldDraw || !font || !font->GetGlyphAtlas().GetSrv()) {
-				++itText;
-				continue;
-			}
-
-
-			if (lastType != TEXT) {
-				commandList.SetPipelineState(m_textPso.get());
-				commandList.SetGraphicsBinder(&m_textBinder);
-				commandList.SetPrimitiveTopology(ePrimitiveTopology::TRIANGLESTRIP);
-				commandList.SetResourceState(font->GetGlyphAtlas().GetSrv().GetResource(), { eResourceState::PIXEL_SHADER_RESOURCE, eResourceState::NON_PIXEL_SHADER_RESOURCE });
-				commandList.BindGraphics(m_bindTextTexture, font->GetGlyphAtlas().GetSrv());
-			}
-
-			// Set cbuffer constants unchanging over letters.
-			CbufferTextTransform cbufferTransform;
-			CbufferTextRender cbufferRender;
-
-			Mat33 world = entity->Transform().GetMatrix();
-			Mat33 worldViewProj = world * view * proj;
+		if (hasTexture) {
+			commandList.SetResourceState(batch.texture->GetSrv().GetResource(), { eResourceState::PIXEL_SHADER_RESOURCE, eResourceState::NON_PIXEL_SHADER_RESOURCE });
+			commandList.BindGraphics(batch.text ? m_bindTextTexture : m_bindOverlayTexture, batch.texture->GetSrv());
+		}
+		commandList.SetPrimitiveTopology(ePrimitiveTopology::TRIANGLESTRIP);
 
+		// Only the used part of the batch is uploaded, the shaders don't read beyond the instance count.
+		commandList.BindGraphics(batch.text ? m_bindTextBatch : m_bindOverlayBatch, m_instances.data() + batch.firstInstance, int(batch.instanceCount * sizeof(QuadInstance)));
+		commandList.DrawInstanced(4, 0, (unsigned)batch.instanceCount);
+	}
+}
 
-			cbufferTransform.z = RecalcZ(entity->GetZDepth());
-			cbufferRender.color = entity->GetColor();
 
-			cbufferRender.enableDiscard = (bool)discardTransform;
-			if (discardTransform) {
-				cbufferRender.discardTransform.Submatrix<3, 3>(0, 0) = discardTransform.value();
-			}
+void RenderOverlay::RenderMesh(GraphicsCommandList& commandList, const OverlayEntity& entity, const QuadInstance& instance, const Image* texture) {
+	const Mesh* mesh = entity.GetMeshNative().get();
 
-			// Position of the first letter.
-			float textHeight = font->CalculateTextHeight(entity->GetFontSize());
-			RectF letterRect = AlignFirstLetter(entity);
+	CbufferOverlay cbuffer;
+	cbuffer.worldViewProj = instance.worldViewProj;
+	cbuffer.hasTexture = texture != nullptr;
+	cbuffer.hasMesh = true;
+	cbuffer.color = instance.color;
+	cbuffer.z = instance.z;
+	cbuffer.enableDiscard = instance.enableDiscard;
+	cbuffer.discardTransform = instance.discardTransform;
 
-			// Letters can be drawn only inside the limits on the X axis.
-			Vec2 limits = Vec2(-0.5f, 0.5f) * entity->GetSize().xx;
+	commandList.BindGraphics(m_bindOverlayCb, &cbuffer, sizeof(cbuffer));
+	if (texture) {
+		commandList.SetResourceState(texture->GetSrv().GetResource(), { eResourceState::PIXEL_SHADER_RESOURCE, eResourceState::NON_PIXEL_SHADER_RESOURCE });
+		commandList.BindGraphics(m_bindOverlayTexture, texture->GetSrv());
+	}
 
+	auto numStreams = mesh->GetNumStreams();
+	std::vector<const VertexBuffer*> vbs(numStreams);
+	std::vector<unsigned> vbsizes(numStreams), vbstrides(numStreams);
+	for (auto stream : Range(mesh->GetNumStreams())) {
+		const VertexBuffer& vb = mesh->GetVertexBuffer(stream);
+		vbs[stream] = &vb;
+		vbsizes[stream] = (unsigned)vb.GetSize();
+		vbstrides[stream] = (unsigned)mesh->GetVertexBufferStride(stream);
+		commandList.SetResourceState(vb, eResourceState::VERTEX_AND_CONSTANT_BUFFER);
+	}
+	commandList.SetPrimitiveTopology(ePrimitiveTopology::TRIANGLELIST);
+	commandList.SetResourceState(mesh->GetIndexBuffer(), eResourceState::INDEX_BUFFER);
+	commandList.SetVertexBuffers(0, (unsigned)vbs.size(), vbs.data(), vbsizes.data(), vbstrides.data());
+	commandList.SetIndexBuffer(&mesh->GetIndexBuffer(), mesh->IsIndexBuffer32Bit());
+	commandList.DrawIndexedInstanced((unsigned)mesh->GetIndexBuffer().GetIndexCount());
+}
 
-			// Draw letters one-by-one.
-			for (auto& character : entity->GetText()) {
-				bool supported = font->IsCharacterSupported(character);
-				if (!supported) {
-					continue;
-				}
-				Font::GlyphInfo charInfo = font->GetGlyphInfo(character);
-				letterRect.right = letterRect.left + charInfo.advance * entity->GetFontSize();
-				cbufferRender.atlasAccessTopleft = charInfo.atlasPos;
-				cbufferRender.atlasAccessSize = { charInfo.atlasSize.x, font->GetGlyphAtlas().GetHeight() };
 
-				Mat33 letterTransform = Mat33(Scale(letterRect.GetSize() / 2.f)) * Mat33(Translation(letterRect.GetCenter()));
-				cbufferTransform.worldViewProj.Submatrix<3, 3>(0, 0) = letterTransform * worldViewProj;
+RenderOverlay::QuadInstance RenderOverlay::MakeInstance(const Mat33& worldViewProj, const std::optional<Mat33>& discardTransform, float z, const Vec4& color) const {
+	QuadInstance instance;
+	instance.worldViewProj.Submatrix<3, 3>(0, 0) = worldViewProj;
+	instance.discardTransform.Submatrix<3, 3>(0, 0) = discardTransform.value_or(Mat33(Identity()));
+	instance.enableDiscard = (bool)discardTransform;
+	instance.z = (z - m_minZ) / (m_maxZ - m_minZ) * 0.98f + 0.01f; // Fit in between 0 and 1.
+	instance.texRect = Vec4(0, 0, 1, 1);
+	instance.color = color;
+	return instance;
+}
 
 
-				if (limits[0] <= letterRect.left && letterRect.right <= limits[1]) {
-					commandList.BindGraphics(m_bindTextTransform, &cbufferTransform, sizeof(cbufferTransform));
-					commandList.BindGraphics(m_bindTextRender, &cbufferRender, sizeof(cbufferRender));
+void RenderOverlay::AppendLetters(const TextEntity& entity, const Mat33& worldViewProj, const QuadInstance& entityInstance, std::vector<RetainedQuad>& quads) {
+	const Font* font = entity.GetFontNative().get();
 
-					commandList.DrawInstanced(4);
-				}
+	// Rasterize missing glyphs up front so that the atlas pages are not changed mid-text.
+	font->PrepareGlyphs(entity.GetText());
+	if (std::find(m_fontsToUpload.begin(), m_fontsToUpload.end(), font) == m_fontsToUpload.end()) {
+		m_fontsToUpload.push_back(font);
+	}
 
-				letterRect.left = letterRect.right;
-			}
-			++itText;
-			lastType = TEXT;
+	// Position of the first letter.
+	RectF letterRect = AlignFirstLetter(&entity);
+
+	// Letters can be drawn only inside the limits on the X axis.
+	Vec2 limits = Vec2(-0.5f, 0.5f) * entity.GetSize().xx;
+
+	// Glyph positions come from the entity's cached layout, only the atlas placement is looked up.
+	const Font::ShapedText& shapedText = entity.GetShapedText();
+	const float origin = letterRect.left;
+	const float fontSize = entity.GetFontSize();
+
+	QuadInstance instance = entityInstance;
+	for (auto& glyph : shapedText.glyphs) {
+		Font::GlyphInfo charInfo = font->GetGlyphInfo(glyph.character);
+		letterRect.left = origin + glyph.offset * fontSize;
+		letterRect.right = letterRect.left + glyph.advance * fontSize;
+
+		if (limits[0] <= letterRect.left && letterRect.right <= limits[1]) {
+			Mat33 letterTransform = Mat33(Scale(letterRect.GetSize() / 2.f)) * Mat33(Translation(letterRect.GetCenter()));
+			instance.worldViewProj.Submatrix<3, 3>(0, 0) = letterTransform * worldViewProj;
+
+			const Image& atlas = font->GetGlyphAtlas(charInfo.page);
+			const Vec2 atlasSize = { (float)atlas.GetWidth(), (float)atlas.GetHeight() };
+			instance.texRect = Vec4{ float(charInfo.atlasPos.x) / atlasSize.x,
+									 float(charInfo.atlasPos.y) / atlasSize.y,
+									 float(charInfo.atlasPos.x + charInfo.atlasSize.x) / atlasSize.x,
+									 float(charInfo.atlasPos.y + charInfo.atlasSize.y) / atlasSize.y };
+			quads.push_back({ instance, &atlas });
 		}
 	}
 }
@@ -572,5 +657,13 @@ std::tuple<bool, std::optional<Mat33>> RenderOverlay::CullEntity(const TextEntit
 }
 
 
+bool RenderOverlay::DrawsBefore(const RetainedEntity* lhs, const RetainedEntity* rhs) {
+	if (lhs->z != rhs->z) {
+		return lhs->z < rhs->z;
+	}
+	return lhs->text != nullptr && rhs->text == nullptr;
+}
+
+
 
 } // namespace inl::gxeng::nodes
\ No newline at end of file
@@ -9,7 +9,10 @@
 #include <GraphicsEngine_LL/Scene.hpp>
 #include <GraphicsEngine_LL/TextEntity.hpp>
 
+#include <InlineMath.hpp>
 #include <optional>
+#include <unordered_map>
+#include <vector>
 
 
 namespace inl::gxeng::nodes {
@@ -46,15 +49,64 @@ public:
 	const std::string& GetOutputName(size_t index) const override;
 
 private:
+	/// <summary> Per-instance data of quads drawn in batches, layout must match RenderOverlay_Quads.hlsl. </summary>
+	struct QuadInstance {
+		Mat34_Packed worldViewProj;
+		Mat34_Packed discardTransform;
+		float z;
+		uint32_t enableDiscard;
+		uint32_t padding[2];
+		Vec4_Packed texRect; // Left, top, right, bottom in texture coordinates.
+		Vec4_Packed color;
+	};
+	static_assert(sizeof(QuadInstance) == 144);
+	static constexpr size_t maxBatchSize = 256; // Instances in a batch, at most 64 kiB are addressable in a cbuffer.
+
+	/// <summary> A quad of an entity, kept between frames. </summary>
+	struct RetainedQuad {
+		QuadInstance instance;
+		const Image* texture;
+	};
+
+	/// <summary> The quads of an entity, rebuilt only when the entity, the camera or the range of Z depths change. </summary>
+	struct RetainedEntity {
+		const OverlayEntity* overlay = nullptr; // Either the overlay or the text is set.
+		const TextEntity* text = nullptr;
+		float z = 0.0f;
+		uint64_t revision = 0; // Revision of the entity the quads were made of.
+		uint64_t fontRevision = 0;
+		uint64_t membership = 0; // Last membership update that found the entity in the scene.
+		bool reinsert = false;
+		std::vector<RetainedQuad> quads; // An overlay with a mesh has a single quad holding its transform.
+	};
+
+	/// <summary> Consecutive quads drawn by a single instanced draw call, or an overlay mesh drawn on its own. </summary>
+	struct Batch {
+		bool text;
+		const Image* texture;
+		size_t firstInstance;
+		size_t instanceCount;
+		const OverlayEntity* mesh;
+	};
+
 	void ValidateInput();
 	void CreateRtv(SetupContext& context);
 	void CreateBinders(SetupContext& context);
 	void CreatePipelineStates(SetupContext& context);
-	void RenderEntities(GraphicsCommandList& commandList,
-						const std::vector<const OverlayEntity*>& overlayList,
-						const std::vector<const TextEntity*>& textList,
-						float minZ,
-						float maxZ);
+
+	// Add and remove retained entities when the collections change.
+	void UpdateMembership(const EntityCollection<IOverlayEntity>* overlays, const EntityCollection<ITextEntity>* texts);
+	// Rebuild the quads of changed entities and restore the Z order.
+	void UpdateRetainedEntities(const Mat33& viewProj);
+	void RebuildEntity(RetainedEntity& retained);
+	void RebuildBatches();
+	void RenderBatches(GraphicsCommandList& commandList);
+	void RenderMesh(GraphicsCommandList& commandList, const OverlayEntity& entity, const QuadInstance& instance, const Image* texture);
+
+	QuadInstance MakeInstance(const Mat33& worldViewProj, const std::optional<Mat33>& discardTransform, float z, const Vec4& color) const;
+
+	// Append the visible letters of the entity to the quads.
+	void AppendLetters(const TextEntity& entity, const Mat33& worldViewProj, const QuadInstance& entityInstance, std::vector<RetainedQuad>& quads);
 
 	// Return the position of the first letter in entity's local space, entity size included.
 	static RectF AlignFirstLetter(const TextEntity*);
@@ -63,20 +115,44 @@ private:
 	static std::tuple<bool, std::optional<Mat33>> CullEntity(const OverlayEntity& entity, const Mat33& viewProj);
 	static std::tuple<bool, std::optional<Mat33>> CullEntity(const TextEntity& entity, const Mat33& viewProj);
 
+	// Entities of lower Z are drawn first, text goes before overlays of the same Z.
+	static bool DrawsBefore(const RetainedEntity* lhs, const RetainedEntity* rhs);
+
 
 private:
 	Binder m_overlayBinder;
 	Binder m_textBinder;
 	BindParameter m_bindOverlayCb;
 	BindParameter m_bindOverlayTexture;
-	BindParameter m_bindTextTransform;
-	BindParameter m_bindTextRender;
+	BindParameter m_bindOverlayBatch;
+	BindParameter m_bindTextBatch;
 	BindParameter m_bindTextTexture;
 	std::unique_ptr<gxapi::IPipelineState> m_overlayPso;
 	std::unique_ptr<gxapi::IPipelineState> m_textPso;
 
 	RenderTargetView2D m_rtv;
 	gxapi::eFormat m_currentFormat = gxapi::eFormat::UNKNOWN;
+
+	// Entities are tracked between frames, so only the ones that changed are processed again.
+	std::unordered_map<const Entity*, RetainedEntity> m_retained;
+	std::vector<RetainedEntity*> m_drawOrder; // Points into m_retained, sorted by DrawsBefore.
+	std::vector<RetainedEntity*> m_changed;
+	const EntityCollection<IOverlayEntity>* m_overlayCollection = nullptr;
+	const EntityCollection<ITextEntity>* m_textCollection = nullptr;
+	uint64_t m_overlayCollectionRevision = 0;
+	uint64_t m_textCollectionRevision = 0;
+	uint64_t m_membership = 0;
+	bool m_membershipChanged = false;
+	std::vector<const Font*> m_fontsToUpload; // Fonts of the texts rebuilt this frame, their new glyphs are uploaded before drawing.
+
+	// The quads depend on these as well.
+	Mat33 m_viewProj = Identity();
+	float m_minZ = 0.0f;
+	float m_maxZ = 1.0f;
+
+	std::vector<QuadInstance> m_instances; // Instances of all batches in drawing order.
+	std::vector<Batch> m_batches;
+	bool m_batchesDirty = true;
 };
 
 
@@ -85,35 +85,32 @@ std::vector<BindParameterDesc> MaterialTextureBinding(const Material& material,
 }
 
 
-std::vector<gxapi::InputElementDesc> MeshInputElements(const Mesh& mesh) {
-	const Mesh::Layout& layout = mesh.GetLayout();
+static const char* SemanticName(eVertexElementSemantic semantic) {
+	switch (semantic) {
+		case eVertexElementSemantic::POSITION: return "POSITION";
+		case eVertexElementSemantic::NORMAL: return "NORMAL";
+		case eVertexElementSemantic::COLOR: return "COLOR";
+		case eVertexElementSemantic::TEX_COORD: return "TEX_COORD";
+		case eVertexElementSemantic::TANGENT: return "TANGENT";
+		case eVertexElementSemantic::BITANGENT: return "BITANGENT";
+		default: return nullptr;
+	}
+}
+
+
+std::vector<gxapi::InputElementDesc> MeshInputElements(const Mesh::Layout& layout) {
 	std::vector<gxapi::InputElementDesc> inputElements;
 
 	for (auto streamIdx : Range(layout.GetStreamCount())) {
-		for (const auto& element : layout[streamIdx]) {
-			if (element.index != 0) {
+		const auto& elements = layout[streamIdx];
+		const auto& formats = layout.GetFormats(streamIdx);
+		for (auto elementIdx : Range(elements.size())) {
+			const auto& element = elements[elementIdx];
+			const char* semanticName = SemanticName(element.semantic);
+			if (element.index != 0 || semanticName == nullptr) {
 				continue;
 			}
-			switch (element.semantic) {
-				case eVertexElementSemantic::POSITION:
-					inputElements.push_back({ "POSITION", 0, gxapi::eFormat::R32G32B32_FLOAT, unsigned(streamIdx), unsigned(element.offset) });
-					break;
-				case eVertexElementSemantic::NORMAL:
-					inputElements.push_back({ "NORMAL", 0, gxapi::eFormat::R32G32B32_FLOAT, unsigned(streamIdx), unsigned(element.offset) });
-					break;
-				case eVertexElementSemantic::COLOR:
-					inputElements.push_back({ "COLOR", 0, gxapi::eFormat::R32G32B32A32_FLOAT, unsigned(streamIdx), unsigned(element.offset) });
-					break;
-				case eVertexElementSemantic::TEX_COORD:
-					inputElements.push_back({ "TEX_COORD", 0, gxapi::eFormat::R32G32_FLOAT, unsigned(streamIdx), unsigned(element.offset) });
-					break;
-				case eVertexElementSemantic::TANGENT:
-					inputElements.push_back({ "TANGENT", 0, gxapi::eFormat::R32G32B32_FLOAT, unsigned(streamIdx), unsigned(element.offset) });
-					break;
-				case eVertexElementSemantic::BITANGENT:
-					inputElements.push_back({ "BITANGENT", 0, gxapi::eFormat::R32G32B32_FLOAT, unsigned(streamIdx), unsigned(element.offset) });
-					break;
-			}
+			inputElements.push_back({ semanticName, 0, formats[elementIdx], unsigned(streamIdx), unsigned(element.offset) });
 		}
 	}
 
@@ -143,6 +140,15 @@ std::vector<std::string> MeshLayoutMacros(const Mesh& mesh) {
 			}
 		}
 	}
+
+	// Octahedral directions are stored in signed normalized formats, the floats are 3 component.
+	const VertexQuantization& quantization = mesh.GetQuantization();
+	if (quantization.normal != eDirectionEncoding::FLOAT32) {
+		macros.push_back("NORMAL_OCTAHEDRAL=1");
+	}
+	if (quantization.tangent != eDirectionEncoding::FLOAT32) {
+		macros.push_back("TANGENT_OCTAHEDRAL=1");
+	}
 	return macros;
 }
 
@@ -376,7 +382,7 @@ PipelineSetupDesc PipelineSetup(PipelineSetupTemplate base, const Mesh& mesh, co
 
 	desc.materialConstantParams = MaterialConstantBinding(material, baseConstantReg);
 	desc.materialTextureParams = MaterialTextureBinding(material, baseTextureReg);
-	desc.inputLayout = MeshInputElements(mesh);
+	desc.inputLayout = MeshInputElements(mesh.GetLayout());
 	desc.materialCode = MaterialCode(material, base.materialMainName, baseConstantReg, baseTextureReg, base.materialSamplerName);
 
 	auto [_size, elements] = MaterialCbuffer(material);
@@ -2,10 +2,10 @@
 
 #include <GraphicsApi_LL/IPipelineState.hpp>
 #include <GraphicsEngine_LL/Binder.hpp>
+#include <GraphicsEngine_LL/Mesh.hpp>
 
 
 namespace inl::gxeng {
-class Mesh;
 class Material;
 } // namespace inl::gxeng
 
@@ -48,6 +48,9 @@ struct PipelineSetupDesc {
 
 PipelineSetupDesc PipelineSetup(PipelineSetupTemplate base, const Mesh& mesh, const Material& material);
 
+/// <summary> Input layout of the first element of each semantic, in the formats the mesh stores them. </summary>
+std::vector<gxapi::InputElementDesc> MeshInputElements(const Mesh::Layout& layout);
+
 
 
 class PipelineSetup {
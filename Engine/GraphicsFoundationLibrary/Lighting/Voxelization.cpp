@@ -69,6 +69,13 @@ static bool CheckMeshFormat(const Mesh& mesh) {
 			return false;
 	}
 
+	// The input layout reads floats.
+	const VertexQuantization& quantization = mesh.GetQuantization();
+	if (quantization.position != ePositionEncoding::FLOAT32
+		|| quantization.normal != eDirectionEncoding::FLOAT32
+		|| quantization.texCoord != eTexCoordEncoding::FLOAT32)
+		return false;
+
 	return true;
 }
 
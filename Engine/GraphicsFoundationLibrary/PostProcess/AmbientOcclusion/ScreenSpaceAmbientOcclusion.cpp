@@ -408,7 +408,7 @@ void ScreenSpaceAmbientOcclusion::InitRenderTarget(SetupContext& context) {
 			formatSSAO
 		};
 
-		Texture2D ssaoTex = context.CreateTexture2D(desc, { true, true, false, false });
+		Texture2D ssaoTex = context.CreateTransientTexture2D(desc, { true, true, false, false }, eTransientLifetime::TASK);
 		ssaoTex.SetName("Screen space ambient occlusion tex");
 		m_ssaoRtv = context.CreateRtv(ssaoTex, formatSSAO, rtvDesc);
 		m_ssaoSrv = context.CreateSrv(ssaoTex, formatSSAO, srvDesc);
@@ -423,7 +423,7 @@ void ScreenSpaceAmbientOcclusion::InitRenderTarget(SetupContext& context) {
 		m_blurVertical0Rtv = context.CreateRtv(blurVertical0Tex, formatSSAO, rtvDesc);
 		m_blurVertical0Srv = context.CreateSrv(blurVertical0Tex, formatSSAO, srvDesc);
 
-		Texture2D blurHorizontalTex = context.CreateTexture2D(desc, { true, true, false, false });
+		Texture2D blurHorizontalTex = context.CreateTransientTexture2D(desc, { true, true, false, false }, eTransientLifetime::TASK);
 		blurHorizontalTex.SetName("Screen space ambient occlusion horizontal blur tex");
 		m_blurHorizontalRtv = context.CreateRtv(blurHorizontalTex, formatSSAO, rtvDesc);
 		m_blurHorizontalSrv = context.CreateSrv(blurHorizontalTex, formatSSAO, srvDesc);
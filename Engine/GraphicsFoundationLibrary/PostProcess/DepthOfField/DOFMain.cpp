@@ -403,7 +403,7 @@ void DOFMain::InitRenderTarget(SetupContext& context) {
 			format,
 		};
 
-		Texture2D mainTex = context.CreateTexture2D(desc, { true, true, false, false });
+		Texture2D mainTex = context.CreateTransientTexture2D(desc, { true, true, false, false }, eTransientLifetime::TASK);
 		mainTex.SetName("DOF main tex");
 		m_mainRTV = context.CreateRtv(mainTex, format, rtvDesc);
 
@@ -423,7 +423,7 @@ void DOFMain::InitRenderTarget(SetupContext& context) {
 			format
 		};
 
-		Texture2D upsampleTex = context.CreateTexture2D(desc, { true, true, false, false });
+		Texture2D upsampleTex = context.CreateTransientTexture2D(desc, { true, true, false, false }, eTransientLifetime::TASK);
 		upsampleTex.SetName("DOF upsample tex");
 		m_upsampleRTV = context.CreateRtv(upsampleTex, format, rtvDesc);
 	}
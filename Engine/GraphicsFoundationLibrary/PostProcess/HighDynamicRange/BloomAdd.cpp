@@ -224,7 +224,7 @@ void BloomAdd::InitRenderTarget(SetupContext& context) {
 			formatAdd
 		};
 
-		Texture2D outputTex = context.CreateTexture2D(desc, { 1, 1, 0, 0 });
+		Texture2D outputTex = context.CreateTransientTexture2D(desc, { 1, 1, 0, 0 }, eTransientLifetime::OUTPUT);
 		outputTex.SetName("Bloom add tex");
 		m_outputRtv = context.CreateRtv(outputTex, formatAdd, rtvDesc);
 	}
@@ -218,7 +218,7 @@ void BloomBlur::InitRenderTarget(SetupContext& context) {
 			formatBlur
 		};
 
-		Texture2D blurTex = context.CreateTexture2D(desc, { true, true, false, false });
+		Texture2D blurTex = context.CreateTransientTexture2D(desc, { true, true, false, false }, eTransientLifetime::OUTPUT);
 		blurTex.SetName("Bloom blur tex");
 		m_blurRtv = context.CreateRtv(blurTex, formatBlur, rtvDesc);
 	}
@@ -207,7 +207,7 @@ void BloomDownsample::InitRenderTarget(SetupContext& context) {
 			formatDownsample
 		};
 
-		Texture2D downsampleTex = context.CreateTexture2D(desc, { 1, 1, 0, 0 });
+		Texture2D downsampleTex = context.CreateTransientTexture2D(desc, { 1, 1, 0, 0 }, eTransientLifetime::OUTPUT);
 		downsampleTex.SetName("Bloom Downsample tex");
 		m_downsampleRtv = context.CreateRtv(downsampleTex, formatDownsample, rtvDesc);
 	}
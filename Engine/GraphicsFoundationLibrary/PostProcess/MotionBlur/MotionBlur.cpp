@@ -271,7 +271,7 @@ void MotionBlur::InitRenderTarget(SetupContext& context) {
 			formatMotionBlur
 		};
 
-		Texture2D motionblurTex = context.CreateTexture2D(desc, { true, true, false, false });
+		Texture2D motionblurTex = context.CreateTransientTexture2D(desc, { true, true, false, false }, eTransientLifetime::OUTPUT);
 		motionblurTex.SetName("Motion blur tex");
 		m_motionblurRtv = context.CreateRtv(motionblurTex, formatMotionBlur, rtvDesc);
 	}
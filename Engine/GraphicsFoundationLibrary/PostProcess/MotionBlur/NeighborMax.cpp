@@ -208,7 +208,7 @@ void NeighborMax::InitRenderTarget(SetupContext& context) {
 			formatNeighborMax
 		};
 
-		Texture2D neighbormaxTex = context.CreateTexture2D(desc, { true, true, false, false });
+		Texture2D neighbormaxTex = context.CreateTransientTexture2D(desc, { true, true, false, false }, eTransientLifetime::OUTPUT);
 		neighbormaxTex.SetName("Motion blur neighbormax tex");
 		m_neighbormaxRtv = context.CreateRtv(neighbormaxTex, formatNeighborMax, rtvDesc);
 	}
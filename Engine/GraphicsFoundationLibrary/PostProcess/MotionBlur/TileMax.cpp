@@ -210,7 +210,7 @@ void TileMax::InitRenderTarget(SetupContext& context) {
 			formatTileMax
 		};
 
-		Texture2D tilemaxTex = context.CreateTexture2D(desc, { true, true, false, false });
+		Texture2D tilemaxTex = context.CreateTransientTexture2D(desc, { true, true, false, false }, eTransientLifetime::OUTPUT);
 		tilemaxTex.SetName("Motion blur tilemax tex");
 		m_tilemaxRtv = context.CreateRtv(tilemaxTex, formatTileMax, rtvDesc);
 	}
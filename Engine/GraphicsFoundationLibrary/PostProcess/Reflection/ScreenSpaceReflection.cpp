@@ -412,7 +412,7 @@ void ScreenSpaceReflection::InitRenderTarget(SetupContext& context) {
 			formatSSR
 		};
 
-		Texture2D ssrTex = context.CreateTexture2D(desc, { true, true, false, false });
+		Texture2D ssrTex = context.CreateTransientTexture2D(desc, { true, true, false, false }, eTransientLifetime::OUTPUT);
 		ssrTex.SetName("Screen space reflection tex");
 		m_ssrRtv = context.CreateRtv(ssrTex, formatSSR, rtvDesc);
 
@@ -425,7 +425,7 @@ void ScreenSpaceReflection::InitRenderTarget(SetupContext& context) {
 		mipDesc.width = m_inputTexSrv.GetResource().GetWidth();
 		mipDesc.height = m_inputTexSrv.GetResource().GetHeight();
 		mipDesc.mipLevels = numMips;
-		Texture2D blurTex = context.CreateTexture2D(mipDesc, { true, true, false, false });
+		Texture2D blurTex = context.CreateTransientTexture2D(mipDesc, { true, true, false, false }, eTransientLifetime::TASK);
 		blurTex.SetName("Screen space reflection blur tex");
 
 		for (unsigned c = 0; c < numMips; ++c) {
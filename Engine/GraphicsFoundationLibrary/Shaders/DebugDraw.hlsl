@@ -4,26 +4,36 @@
 
 struct Uniforms {
 	float4x4 vp;
-	float4 color;
 };
 
 ConstantBuffer<Uniforms> uniforms : register(b0);
 
+struct VS_Input {
+	float3 position : POSITION; // Unit shape.
+	float4 transform0 : TRANSFORM0; // Rows of the instance's world transform.
+	float4 transform1 : TRANSFORM1;
+	float4 transform2 : TRANSFORM2;
+	float4 transform3 : TRANSFORM3;
+	float4 color : COLOR;
+};
+
 struct PS_Input {
 	float4 position : SV_POSITION;
+	float4 color : COLOR;
 };
 
 
-PS_Input VSMain(float4 position
-				: POSITION) {
+PS_Input VSMain(VS_Input input) {
 	PS_Input result;
 
-	result.position = mul(position, uniforms.vp);
+	float4x4 world = float4x4(input.transform0, input.transform1, input.transform2, input.transform3);
+	result.position = mul(mul(float4(input.position, 1.0f), world), uniforms.vp);
+	result.color = input.color;
 
 	return result;
 }
 
 
 float4 PSMain(PS_Input input) : SV_TARGET {
-	return uniforms.color;
+	return input.color;
 }
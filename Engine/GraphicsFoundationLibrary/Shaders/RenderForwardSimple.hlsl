@@ -2,6 +2,7 @@ struct VsConstants {
 	float4x4 world;
 	float4x4 worldViewProj;
 	float4x4 worldViewProjDer;
+	float4x4 positionDequantization;
 };
 ConstantBuffer<VsConstants> vsConstants : register(b0);
 
@@ -25,11 +26,27 @@ struct PsInput {
 };
 
 
+#if defined(NORMAL_OCTAHEDRAL) || defined(TANGENT_OCTAHEDRAL)
+// Same as the decoder of the vertex compressor.
+float3 DecodeOctahedral(float2 encoded) {
+	float3 n = float3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+	float t = saturate(-n.z);
+	n.xy += float2(n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t);
+	return normalize(n);
+}
+
+void DecodeTangentFrame(float4 encoded, float3 normal, out float3 tangent, out float3 bitangent) {
+	tangent = DecodeOctahedral(encoded.xy);
+	bitangent = cross(normal, tangent) * (encoded.w < 0.0 ? -1.0 : 1.0);
+}
+#endif
+
+
 PsInput VSMain(float4 lPos
 			   : POSITION
 #ifdef HAS_NORMAL
 				 ,
-				 float3 lNormal
+				 float4 lNormal
 			   : NORMAL
 #endif
 #ifdef HAS_COLOR
@@ -44,7 +61,7 @@ PsInput VSMain(float4 lPos
 #endif
 #ifdef HAS_TANGENT
 				 ,
-				 float3 lTangent
+				 float4 lTangent
 			   : TANGENT
 #endif
 #ifdef HAS_BITANGENT
@@ -55,13 +72,18 @@ PsInput VSMain(float4 lPos
 ) {
 	PsInput output;
 
+	lPos = mul(lPos, vsConstants.positionDequantization);
+#ifdef NORMAL_OCTAHEDRAL
+	lNormal.xyz = DecodeOctahedral(lNormal.xy);
+#endif
+
 	output.hPos = mul(lPos, vsConstants.worldViewProj);
 	output.sVelocity = mul(lPos, vsConstants.worldViewProjDer).xy;
 	output.wPos = mul(lPos, vsConstants.world);
 
 #ifdef HAS_NORMAL
 	float3x3 worldRotation = (float3x3)vsConstants.world;
-	output.wNormal = mul(lNormal, worldRotation);
+	output.wNormal = mul(lNormal.xyz, worldRotation);
 #endif
 #ifdef HAS_COLOR
 	output.color = color;
@@ -70,9 +92,15 @@ PsInput VSMain(float4 lPos
 	output.texCoord = texCoord;
 #endif
 #ifdef HAS_TANGENT
-	output.wTangent = mul(lTangent, worldRotation);
+#ifdef TANGENT_OCTAHEDRAL
+	float3 lDecodedBitangent;
+	DecodeTangentFrame(lTangent, lNormal.xyz, lTangent.xyz, lDecodedBitangent);
+#endif
+	output.wTangent = mul(lTangent.xyz, worldRotation);
 #if HAS_BITANGENT
 	output.wBitangent = mul(lBitangent, worldRotation);
+#elif defined(TANGENT_OCTAHEDRAL)
+	output.wBitangent = mul(lDecodedBitangent, worldRotation);
 #else
 	output.wBitangent = cross(output.wNormal, output.wTangent);
 #endif
@@ -1,3 +1,5 @@
+#include "RenderOverlay_Quads.hlsl"
+
 // Shader constants
 struct Constants {
 	float3x3 worldViewProj;
@@ -10,6 +12,7 @@ struct Constants {
 	bool enableDiscard;
 };
 ConstantBuffer<Constants> constants : register(b0);
+ConstantBuffer<QuadBatch> batch : register(b1); // Instances when drawing quads instead of a mesh.
 
 
 // Texture inputs
@@ -24,60 +27,50 @@ void VSMain(float2 posL
 			: TEXCOORD0,
 			  uint vertexId
 			: SV_VertexID,
+			  uint instanceId
+			: SV_InstanceID,
 			  out float4 posHOut
 			: SV_Position,
 			  out float2 texCoordOut
 			: TEXCOORD0,
-			  out float2 posNdcOut
-			: TEXCOORD1) {
+			  out float3 discardPosOut
+			: TEXCOORD1,
+			  out nointerpolation float4 colorOut
+			: COLOR0) {
 	if (constants.hasMesh) {
 		float3 posH = mul(float3(posL, 1), constants.worldViewProj);
 		posHOut = float4(posH.xy, constants.z * posH.z, posH.z);
 		texCoordOut = texCoord;
+		discardPosOut = DiscardPosition(posH.xy / posH.z, constants.discardTransform, constants.enableDiscard);
+		colorOut = constants.color;
 	}
 	else {
-		// Triangle strip based on vertex id
-		// 3-----2
-		// |   / |
-		// | /   |
-		// 1-----0
-		// 0: (1, 0)
-		// 1: (0, 0)
-		// 2: (1, 1)
-		// 3: (0, 1)
-
-		texCoordOut.x = (vertexId & 1) ^ 1; // 1 if bit0 is 0.
-		texCoordOut.y = vertexId >> 1; // 1 if bit1 is 1.
+		Quad quad = batch.quads[instanceId];
+		texCoordOut = QuadCorner(vertexId);
 
 		float2 posL = (texCoordOut.xy * 2.0f - float2(1, 1)) * 0.5f;
 
-		float3 posH = mul(float3(posL, 1), constants.worldViewProj);
-		posHOut = float4(posH.xy, constants.z * posH.z, posH.z);
-		posNdcOut = posH / posH.z;
+		float3 posH = mul(float3(posL, 1), quad.worldViewProj);
+		posHOut = float4(posH.xy, quad.z * posH.z, posH.z);
+		discardPosOut = DiscardPosition(posH.xy / posH.z, quad.discardTransform, quad.enableDiscard);
+		colorOut = quad.color;
 	}
 }
 
 
 float4 PSMain(float4 posS
 			  : SV_Position, float2 texCoord
-			  : TEXCOORD0, float2 posNdc
-			  : TEXCOORD1) : SV_Target0 {
-	if (constants.enableDiscard) {
-		float3 discardPos = mul(float3(posNdc.xy, 1.0f), constants.discardTransform);
-		discardPos /= discardPos.z;
-		discardPos.z = 0.0f;
-		if (abs(discardPos.x) > 0.5f || abs(discardPos.y) > 0.5f) {
-			discard;
-		}
+			  : TEXCOORD0, float3 discardPos
+			  : TEXCOORD1, nointerpolation float4 color
+			  : COLOR0) : SV_Target0 {
+	if (IsDiscarded(discardPos)) {
+		discard;
 	}
 
-
-	float4 texColor;
 	if (constants.hasTexture) {
-		texColor = colorTexture.Sample(linearSampler, texCoord);
-		return texColor * constants.color;
+		return colorTexture.Sample(linearSampler, texCoord) * color;
 	}
 	else {
-		return constants.color;
+		return color;
 	}
-}
\ No newline at end of file
+}
@@ -0,0 +1,49 @@
+// Quads drawn in batches by RenderOverlay, one instance per quad.
+// Layout must match RenderOverlay::QuadInstance.
+struct Quad {
+	float3x3 worldViewProj;
+	uint __padding0;
+	float3x3 discardTransform;
+	uint __padding1;
+	float z;
+	bool enableDiscard;
+	uint2 __padding2;
+	float4 texRect; // left, top, right, bottom in texture coordinates
+	float4 color;
+};
+
+static const uint maxQuads = 256;
+
+struct QuadBatch {
+	Quad quads[maxQuads];
+};
+
+
+// Triangle strip based on vertex id
+// 3-----2
+// |   / |
+// | /   |
+// 1-----0
+// 0: (1, 0)
+// 1: (0, 0)
+// 2: (1, 1)
+// 3: (0, 1)
+float2 QuadCorner(uint vertexId) {
+	float2 corner;
+	corner.x = (vertexId & 1) ^ 1; // 1 if bit0 is 0.
+	corner.y = vertexId >> 1; // 1 if bit1 is 1.
+	return corner;
+}
+
+
+// Position of the pixel in the clip rect's space, outside if any coordinate is over 0.5.
+// It's linear in the position so it can be interpolated over the quad.
+float3 DiscardPosition(float2 posNdc, float3x3 discardTransform, bool enableDiscard) {
+	return enableDiscard ? mul(float3(posNdc, 1.0f), discardTransform) : float3(0, 0, 1);
+}
+
+
+bool IsDiscarded(float3 discardPos) {
+	discardPos /= discardPos.z;
+	return abs(discardPos.x) > 0.5f || abs(discardPos.y) > 0.5f;
+}
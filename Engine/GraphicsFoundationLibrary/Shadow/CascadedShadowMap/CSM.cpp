@@ -1,5 +1,7 @@
 #include "CSM.hpp"
 
+#include "../../Helpers/DynamicPipelineSetup.hpp"
+
 #include <GraphicsEngine_LL/AutoRegisterNode.hpp>
 #include <GraphicsEngine_LL/GraphicsCommandList.hpp>
 #include <GraphicsEngine_LL/MeshEntity.hpp>
@@ -18,20 +20,18 @@ struct Uniforms {
 	uint32_t cascadeIDX;
 };
 
+// Only positions are read, in whatever format the mesh stores them.
 static bool CheckMeshFormat(const Mesh& mesh) {
 	for (size_t i = 0; i < mesh.GetNumStreams(); i++) {
-		auto& elements = mesh.GetLayout()[0];
-		if (elements.size() != 3)
-			return false;
-		if (elements[0].semantic != eVertexElementSemantic::POSITION)
-			return false;
-		if (elements[1].semantic != eVertexElementSemantic::NORMAL)
-			return false;
-		if (elements[2].semantic != eVertexElementSemantic::TEX_COORD)
-			return false;
+		auto& elements = mesh.GetLayout()[i];
+		for (auto& element : elements) {
+			if (element.semantic == eVertexElementSemantic::POSITION && element.index == 0) {
+				return true;
+			}
+		}
 	}
 
-	return true;
+	return false;
 }
 
 
@@ -69,13 +69,15 @@ void CSM::Reset() {
 	GetInput(0)->Clear();
 	GetInput(1)->Clear();
 	GetInput(2)->Clear();
+	GetInput(3)->Clear();
 }
 
 const std::string& CSM::GetInputName(size_t index) const {
 	static const std::vector<std::string> names = {
 		"depthDSV",
 		"entities",
-		"lightMvpTex"
+		"lightMvpTex",
+		"camera"
 	};
 	return names[index];
 }
@@ -103,6 +105,9 @@ void CSM::Setup(SetupContext& context) {
 	m_entities = this->GetInput<1>().Get();
 	this->GetInput<1>().Clear();
 
+	m_camera = this->GetInput<3>().Get();
+	this->GetInput<3>().Clear();
+
 	Texture2D& lightMVPTex = this->GetInput<2>().Get();
 	gxapi::SrvTexture2DArray srvDesc;
 	srvDesc.activeArraySize = 1;
@@ -156,24 +161,25 @@ void CSM::Setup(SetupContext& context) {
 		m_binder = context.CreateBinder({ uniformsBindParamDesc, lightMVPBindParamDesc, sampBindParamDesc }, { samplerDesc });
 	}
 
-	if (!m_PSO || currDepthStencil != m_depthStencilFormat) {
-		m_depthStencilFormat = currDepthStencil;
-
-		//TODO
-		constexpr unsigned cascadeSize = 1024;
-		constexpr unsigned numCascades = 4;
-
+	if (!m_shader.vs || !m_shader.ps) {
 		ShaderParts shaderParts;
 		shaderParts.vs = true;
 		shaderParts.ps = true;
 
 		m_shader = context.CreateShader("CSM", shaderParts, "");
+	}
+
+	if (currDepthStencil != m_depthStencilFormat) {
+		m_depthStencilFormat = currDepthStencil;
+		m_PSOs.clear();
+	}
+}
 
-		std::vector<gxapi::InputElementDesc> inputElementDesc = {
-			gxapi::InputElementDesc{ "POSITION", 0, gxapi::eFormat::R32G32B32_FLOAT, 0, 0 },
-			gxapi::InputElementDesc{ "NORMAL", 0, gxapi::eFormat::R32G32B32_FLOAT, 0, 12 },
-			gxapi::InputElementDesc{ "TEX_COORD", 0, gxapi::eFormat::R32G32_FLOAT, 0, 24 },
-		};
+
+gxapi::IPipelineState* CSM::GetPSO(RenderContext& context, const Mesh::Layout& layout) {
+	auto psoIt = m_PSOs.find(layout);
+	if (psoIt == m_PSOs.end()) {
+		std::vector<gxapi::InputElementDesc> inputElementDesc = MeshInputElements(layout);
 
 		gxapi::GraphicsPipelineStateDesc psoDesc;
 		psoDesc.inputLayout.elements = inputElementDesc.data();
@@ -189,8 +195,9 @@ void CSM::Setup(SetupContext& context) {
 
 		psoDesc.numRenderTargets = 0;
 
-		m_PSO.reset(context.CreatePSO(psoDesc));
+		psoIt = m_PSOs.insert({ layout, std::unique_ptr<gxapi::IPipelineState>(context.CreatePSO(psoDesc)) }).first;
 	}
+	return psoIt->second.get();
 }
 
 
@@ -207,7 +214,6 @@ void CSM::Execute(RenderContext& context) {
 	gxapi::Rectangle rect{ 0, (int)cascadeTextures.GetHeight(), 0, (int)cascadeTextures.GetWidth() };
 	commandList.SetScissorRects(1, &rect);
 
-	commandList.SetPipelineState(m_PSO.get());
 	commandList.SetGraphicsBinder(&m_binder);
 	commandList.SetPrimitiveTopology(gxapi::ePrimitiveTopology::TRIANGLELIST);
 
@@ -235,7 +241,12 @@ void CSM::Execute(RenderContext& context) {
 		// Iterate over all entities
 		for (const MeshEntity* entity : *m_entities) {
 			// Get entity parameters
-			Mesh* mesh = entity->GetMeshNative().get();
+			// Match the LOD of the main view so shadows agree with the lit geometry.
+			Mesh* mesh = m_camera ? entity->SelectLodNative(m_camera->GetViewMatrix(), m_camera->GetProjectionMatrix())
+								   : entity->GetMeshNative().get();
+			if (!mesh->IsUploaded()) {
+				continue;
+			}
 			auto position = entity->Transform().GetPosition();
 
 			if (mesh->GetIndexBuffer().GetIndexCount() == 3600) {
@@ -249,8 +260,9 @@ void CSM::Execute(RenderContext& context) {
 			}
 
 			ConvertToSubmittable(mesh, vertexBuffers, sizes, strides);
+			commandList.SetPipelineState(GetPSO(context, mesh->GetLayout()));
 
-			Mat44 model = entity->Transform().GetMatrix();
+			Mat44 model = mesh->GetPositionDequantization() * entity->Transform().GetMatrix();
 
 			Uniforms uniformsCBData;
 			uniformsCBData.model = model;
@@ -1,19 +1,22 @@
 #pragma once
 
 #include <GraphicsApi_LL/IPipelineState.hpp>
+#include <GraphicsEngine_LL/BasicCamera.hpp>
 #include <GraphicsEngine_LL/GraphicsNode.hpp>
 #include <GraphicsEngine_LL/Mesh.hpp>
 
+#include <unordered_map>
+
 
 namespace inl::gxeng::nodes {
 
 /// <summary>
-/// Inputs: render target, scene objects, light cascade MVP transform matrices in a texture
+/// Inputs: render target, scene objects, light cascade MVP transform matrices in a texture, optional camera for LOD selection
 /// Output: render target
 /// </summary>
 class CSM : virtual public GraphicsNode,
 			virtual public GraphicsTask,
-			virtual public InputPortConfig<Texture2D, const EntityCollection<MeshEntity>*, Texture2D>,
+			virtual public InputPortConfig<Texture2D, const EntityCollection<MeshEntity>*, Texture2D, const BasicCamera*>,
 			virtual public OutputPortConfig<Texture2D> {
 public:
 	static const char* Info_GetName() { return "CSM"; }
@@ -29,17 +32,21 @@ public:
 	void Setup(SetupContext& context) override;
 	void Execute(RenderContext& context) override;
 
+private:
+	gxapi::IPipelineState* GetPSO(RenderContext& context, const Mesh::Layout& layout);
+
 protected:
 	Binder m_binder;
 	BindParameter m_uniformsBindParam;
 	BindParameter m_lightMVPBindParam;
 	ShaderProgram m_shader;
-	std::unique_ptr<gxapi::IPipelineState> m_PSO;
-	gxapi::eFormat m_depthStencilFormat;
+	std::unordered_map<Mesh::Layout, std::unique_ptr<gxapi::IPipelineState>, Mesh::Layout::HashLayout, Mesh::Layout::EqualToLayout> m_PSOs; // One for each vertex layout.
+	gxapi::eFormat m_depthStencilFormat = gxapi::eFormat::UNKNOWN;
 
 private: // render context
 	std::vector<DepthStencilView2D> m_dsvs;
 	const EntityCollection<MeshEntity>* m_entities;
+	const BasicCamera* m_camera;
 	TextureView2D m_lightMVPTexSrv;
 };
 
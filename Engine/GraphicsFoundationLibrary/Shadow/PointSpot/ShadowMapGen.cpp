@@ -1,5 +1,7 @@
 #include "ShadowMapGen.hpp"
 
+#include "../../Helpers/DynamicPipelineSetup.hpp"
+
 #include <GraphicsEngine_LL/AutoRegisterNode.hpp>
 #include <GraphicsEngine_LL/GraphicsCommandList.hpp>
 #include <GraphicsEngine_LL/Mesh.hpp>
@@ -17,20 +19,18 @@ struct Uniforms {
 	Mat44_Packed mvp;
 };
 
+// Only positions are read, in whatever format the mesh stores them.
 static bool CheckMeshFormat(const Mesh& mesh) {
 	for (size_t i = 0; i < mesh.GetNumStreams(); i++) {
-		auto& elements = mesh.GetLayout()[0];
-		if (elements.size() != 3)
-			return false;
-		if (elements[0].semantic != eVertexElementSemantic::POSITION)
-			return false;
-		if (elements[1].semantic != eVertexElementSemantic::NORMAL)
-			return false;
-		if (elements[2].semantic != eVertexElementSemantic::TEX_COORD)
-			return false;
+		auto& elements = mesh.GetLayout()[i];
+		for (auto& element : elements) {
+			if (element.semantic == eVertexElementSemantic::POSITION && element.index == 0) {
+				return true;
+			}
+		}
 	}
 
-	return true;
+	return false;
 }
 
 
@@ -66,12 +66,14 @@ void ShadowMapGen::Reset() {
 	m_pointLightDsvs.clear();
 	GetInput(0)->Clear();
 	GetInput(1)->Clear();
+	GetInput(2)->Clear();
 }
 
 const std::string& ShadowMapGen::GetInputName(size_t index) const {
 	static const std::vector<std::string> names = {
 		"cubemapDSVs",
-		"entities"
+		"entities",
+		"camera"
 	};
 	return names[index];
 }
@@ -99,6 +101,9 @@ void ShadowMapGen::Setup(SetupContext& context) {
 	m_entities = this->GetInput<1>().Get();
 	this->GetInput<1>().Clear();
 
+	m_camera = this->GetInput<2>().Get();
+	this->GetInput<2>().Clear();
+
 	this->GetOutput<0>().Set(pointLightCubemaps);
 
 	if (!m_binder) {
@@ -132,43 +137,43 @@ void ShadowMapGen::Setup(SetupContext& context) {
 		m_binder = context.CreateBinder({ uniformsBindParamDesc, sampBindParamDesc }, { samplerDesc });
 	}
 
-	if (!m_shadowGenPSO || pointLightDepthStencilFormat != m_depthStencilFormat) {
-		m_depthStencilFormat = pointLightDepthStencilFormat;
-
-		//TODO
-		constexpr unsigned cascadeSize = 1024;
-		constexpr unsigned numCascades = 4;
-
+	if (!m_shadowGenShader.vs || !m_shadowGenShader.ps) {
 		ShaderParts shaderParts;
 		shaderParts.vs = true;
 		shaderParts.ps = true;
 
-		std::vector<gxapi::InputElementDesc> inputElementDesc = {
-			gxapi::InputElementDesc{ "POSITION", 0, gxapi::eFormat::R32G32B32_FLOAT, 0, 0 },
-			gxapi::InputElementDesc{ "NORMAL", 0, gxapi::eFormat::R32G32B32_FLOAT, 0, 12 },
-			gxapi::InputElementDesc{ "TEX_COORD", 0, gxapi::eFormat::R32G32_FLOAT, 0, 24 },
-		};
+		m_shadowGenShader = context.CreateShader("ShadowGen", shaderParts, "");
+	}
+
+	if (pointLightDepthStencilFormat != m_depthStencilFormat) {
+		m_depthStencilFormat = pointLightDepthStencilFormat;
+		m_shadowGenPSOs.clear();
+	}
+}
+
 
-		{
-			m_shadowGenShader = context.CreateShader("ShadowGen", shaderParts, "");
+gxapi::IPipelineState* ShadowMapGen::GetShadowGenPSO(RenderContext& context, const Mesh::Layout& layout) {
+	auto psoIt = m_shadowGenPSOs.find(layout);
+	if (psoIt == m_shadowGenPSOs.end()) {
+		std::vector<gxapi::InputElementDesc> inputElementDesc = MeshInputElements(layout);
 
-			gxapi::GraphicsPipelineStateDesc psoDesc;
-			psoDesc.inputLayout.elements = inputElementDesc.data();
-			psoDesc.inputLayout.numElements = (unsigned)inputElementDesc.size();
-			psoDesc.rootSignature = m_binder.GetRootSignature();
-			psoDesc.vs = m_shadowGenShader.vs;
-			psoDesc.ps = m_shadowGenShader.ps;
-			psoDesc.rasterization = gxapi::RasterizerState{ gxapi::eFillMode::SOLID, gxapi::eCullMode::DRAW_CCW };
-			psoDesc.primitiveTopologyType = gxapi::ePrimitiveTopologyType::TRIANGLE;
+		gxapi::GraphicsPipelineStateDesc psoDesc;
+		psoDesc.inputLayout.elements = inputElementDesc.data();
+		psoDesc.inputLayout.numElements = (unsigned)inputElementDesc.size();
+		psoDesc.rootSignature = m_binder.GetRootSignature();
+		psoDesc.vs = m_shadowGenShader.vs;
+		psoDesc.ps = m_shadowGenShader.ps;
+		psoDesc.rasterization = gxapi::RasterizerState{ gxapi::eFillMode::SOLID, gxapi::eCullMode::DRAW_CCW };
+		psoDesc.primitiveTopologyType = gxapi::ePrimitiveTopologyType::TRIANGLE;
 
-			psoDesc.depthStencilState = gxapi::DepthStencilState{ true, true };
-			psoDesc.depthStencilFormat = m_depthStencilFormat;
+		psoDesc.depthStencilState = gxapi::DepthStencilState{ true, true };
+		psoDesc.depthStencilFormat = m_depthStencilFormat;
 
-			psoDesc.numRenderTargets = 0;
+		psoDesc.numRenderTargets = 0;
 
-			m_shadowGenPSO.reset(context.CreatePSO(psoDesc));
-		}
+		psoIt = m_shadowGenPSOs.insert({ layout, std::unique_ptr<gxapi::IPipelineState>(context.CreatePSO(psoDesc)) }).first;
 	}
+	return psoIt->second.get();
 }
 
 
@@ -234,7 +239,6 @@ void ShadowMapGen::Execute(RenderContext& context) {
 		gxapi::Rectangle rect{ 0, (int)pointLightShadowMaps.GetHeight(), 0, (int)pointLightShadowMaps.GetWidth() };
 		commandList.SetScissorRects(1, &rect);
 
-		commandList.SetPipelineState(m_shadowGenPSO.get());
 		commandList.SetGraphicsBinder(&m_binder);
 		commandList.SetPrimitiveTopology(gxapi::ePrimitiveTopology::TRIANGLELIST);
 
@@ -259,7 +263,12 @@ void ShadowMapGen::Execute(RenderContext& context) {
 			// Iterate over all entities
 			for (const MeshEntity* entity : *m_entities) {
 				// Get entity parameters
-				Mesh* mesh = entity->GetMeshNative().get();
+				// Match the LOD of the main view so shadows agree with the lit geometry.
+				Mesh* mesh = m_camera ? entity->SelectLodNative(m_camera->GetViewMatrix(), m_camera->GetProjectionMatrix())
+									   : entity->GetMeshNative().get();
+				if (!mesh->IsUploaded()) {
+					continue;
+				}
 				auto position = entity->Transform().GetPosition();
 
 				if (mesh->GetIndexBuffer().GetIndexCount() == 3600) {
@@ -273,8 +282,9 @@ void ShadowMapGen::Execute(RenderContext& context) {
 				}
 
 				ConvertToSubmittable(mesh, vertexBuffers, sizes, strides);
+				commandList.SetPipelineState(GetShadowGenPSO(context, mesh->GetLayout()));
 
-				Mat44 model = entity->Transform().GetMatrix();
+				Mat44 model = mesh->GetPositionDequantization() * entity->Transform().GetMatrix();
 
 				Uniforms uniformsCBData;
 				uniformsCBData.mvp = model * pointLightMVPs[shadowMapIdx % 6];
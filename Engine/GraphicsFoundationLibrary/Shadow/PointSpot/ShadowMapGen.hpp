@@ -1,19 +1,22 @@
 #pragma once
 
 #include <GraphicsApi_LL/IPipelineState.hpp>
+#include <GraphicsEngine_LL/BasicCamera.hpp>
 #include <GraphicsEngine_LL/GraphicsNode.hpp>
+#include <GraphicsEngine_LL/Mesh.hpp>
 
 #include <optional>
+#include <unordered_map>
 
 namespace inl::gxeng::nodes {
 
 /// <summary>
-/// Inputs: render target, scene objects, light cascade MVP transform matrices in a texture
+/// Inputs: render target, scene objects, optional camera for LOD selection
 /// Output: render target
 /// </summary>
 class ShadowMapGen : virtual public GraphicsNode,
 					 virtual public GraphicsTask,
-					 virtual public InputPortConfig<Texture2D, const EntityCollection<MeshEntity>*>,
+					 virtual public InputPortConfig<Texture2D, const EntityCollection<MeshEntity>*, const BasicCamera*>,
 					 virtual public OutputPortConfig<Texture2D> {
 public:
 	static const char* Info_GetName() { return "ShadowMapGen"; }
@@ -29,16 +32,20 @@ public:
 	void Setup(SetupContext& context) override;
 	void Execute(RenderContext& context) override;
 
+private:
+	gxapi::IPipelineState* GetShadowGenPSO(RenderContext& context, const Mesh::Layout& layout);
+
 protected:
 	Binder m_binder;
 	BindParameter m_uniformsBindParam;
 	ShaderProgram m_shadowGenShader;
-	std::unique_ptr<gxapi::IPipelineState> m_shadowGenPSO;
-	gxapi::eFormat m_depthStencilFormat;
+	std::unordered_map<Mesh::Layout, std::unique_ptr<gxapi::IPipelineState>, Mesh::Layout::HashLayout, Mesh::Layout::EqualToLayout> m_shadowGenPSOs; // One for each vertex layout.
+	gxapi::eFormat m_depthStencilFormat = gxapi::eFormat::UNKNOWN;
 
 private: // render context
 	std::vector<DepthStencilView2D> m_pointLightDsvs;
 	const EntityCollection<MeshEntity>* m_entities;
+	const BasicCamera* m_camera;
 };
 
 
@@ -33,8 +33,12 @@ const AbsoluteLayout::Binding& AbsoluteLayout::operator[](const Control* child)
 //------------------------------------------------------------------------------
 
 void AbsoluteLayout::SetSize(const Vec2& size) {
+	if (m_size == size) {
+		return;
+	}
 	m_size = size;
 	m_dirty = true;
+	Invalidate(eInvalidation::PLACEMENT | eInvalidation::LAYOUT);
 }
 
 
@@ -79,8 +83,12 @@ Vec2 AbsoluteLayout::GetMinimumSize() const {
 //------------------------------------------------------------------------------
 
 void AbsoluteLayout::SetPosition(const Vec2& position) {
+	if (m_position == position) {
+		return;
+	}
 	m_position = position;
 	m_dirty = true;
+	Invalidate(eInvalidation::PLACEMENT | eInvalidation::LAYOUT);
 }
 
 
@@ -109,6 +117,10 @@ float AbsoluteLayout::GetDepth() const {
 //------------------------------------------------------------------------------
 
 void AbsoluteLayout::UpdateLayout() {
+	if (!m_dirty && !m_bindingsDirty) {
+		return;
+	}
+
 	const auto& children = GetChildren();
 
 	for (auto& child : children) {
@@ -122,6 +134,7 @@ void AbsoluteLayout::UpdateLayout() {
 	SetDepth(m_depth);
 
 	m_dirty = false;
+	m_bindingsDirty = false;
 }
 
 
@@ -131,6 +144,7 @@ void AbsoluteLayout::UpdateLayout() {
 
 void AbsoluteLayout::SetReferencePoint(eRefPoint point) {
 	m_refPoint = point;
+	SetDirty();
 }
 
 AbsoluteLayout::eRefPoint AbsoluteLayout::GetReferencePoint() const {
@@ -139,6 +153,7 @@ AbsoluteLayout::eRefPoint AbsoluteLayout::GetReferencePoint() const {
 
 void AbsoluteLayout::SetYDown(bool enabled) {
 	m_yDown = enabled;
+	SetDirty();
 }
 
 bool AbsoluteLayout::GetYDown() const {
@@ -181,19 +196,35 @@ Vec2 AbsoluteLayout::CalculateChildPosition(const Binding& binding) const {
 void AbsoluteLayout::ChildAddedHandler(Control& child) {
 	m_childrenOrder.push_back(&child);
 	auto orderIt = --m_childrenOrder.end();
-	SetLayoutPosition(child, Binding(&m_childrenOrder, orderIt));
+	SetLayoutPosition(child, Binding(this, &m_childrenOrder, orderIt));
+	m_bindingsDirty = true;
 }
 
 
 void AbsoluteLayout::ChildRemovedHandler(Control& child) {
 	Binding& binding = GetLayoutPosition<Binding>(child);
 	m_childrenOrder.erase(binding.orderIter);
+	m_bindingsDirty = true;
+}
+
+
+void AbsoluteLayout::SetDirty() {
+	m_dirty = true;
+	Invalidate(eInvalidation::LAYOUT);
+}
+
+
+void AbsoluteLayout::SetBindingsDirty() {
+	// The preferred size is the bounding box of the children, so it changes with the bindings.
+	m_bindingsDirty = true;
+	Invalidate(eInvalidation::LAYOUT | eInvalidation::PREFERRED_SIZE);
 }
 
 
 AbsoluteLayout::Binding& AbsoluteLayout::Binding::SetPosition(Vec2 position) {
 	this->position = position;
 	m_dirty = true;
+	layout->SetBindingsDirty();
 	return *this;
 }
 
@@ -210,6 +241,7 @@ auto AbsoluteLayout::Binding::MoveForward() -> Binding& {
 		orderList->splice(prevIt, *orderList, orderIter);
 	}
 
+	layout->SetBindingsDirty();
 	return *this;
 }
 
@@ -222,6 +254,7 @@ auto AbsoluteLayout::Binding::MoveBackward() -> Binding& {
 		orderList->splice(++nextIt, *orderList, orderIter);
 	}
 
+	layout->SetBindingsDirty();
 	return *this;
 }
 
@@ -233,6 +266,7 @@ auto AbsoluteLayout::Binding::MoveToFront() -> Binding& {
 		orderList->splice(firstIt, *orderList, orderIter);
 	}
 
+	layout->SetBindingsDirty();
 	return *this;
 }
 
@@ -244,6 +278,7 @@ auto AbsoluteLayout::Binding::MoveToBack() -> Binding& {
 		orderList->splice(endIt, *orderList, orderIter);
 	}
 
+	layout->SetBindingsDirty();
 	return *this;
 }
 
@@ -21,8 +21,8 @@ public:
 private:
 	class Binding {
 		friend class AbsoluteLayout;
-		Binding(std::list<Control*>* orderList, std::list<Control*>::iterator orderIter)
-			: orderList(orderList), orderIter(orderIter) {}
+		Binding(AbsoluteLayout* layout, std::list<Control*>* orderList, std::list<Control*>::iterator orderIter)
+			: layout(layout), orderList(orderList), orderIter(orderIter) {}
 
 	public:
 		Binding& SetPosition(Vec2 position);
@@ -35,6 +35,7 @@ private:
 	private:
 		Vec2 position = { 0, 0 };
 		bool m_dirty = true;
+		AbsoluteLayout* layout = nullptr;
 		std::list<Control*>::iterator orderIter;
 		std::list<Control*>* orderList = nullptr;
 	};
@@ -74,6 +75,8 @@ public:
 
 private:
 	Vec2 CalculateChildPosition(const Binding& binding) const;
+	void SetDirty();
+	void SetBindingsDirty();
 
 	void ChildAddedHandler(Control& child) override;
 	void ChildRemovedHandler(Control& child) override;
@@ -88,7 +91,8 @@ private:
 	bool m_yDown = true;
 	float m_depth = 0.0f;
 
-	bool m_dirty = true;
+	bool m_dirty = true; // All children have to be repositioned.
+	bool m_bindingsDirty = true; // Some bindings or their order changed.
 };
 
 
@@ -9,12 +9,23 @@
 namespace inl::gui {
 
 
+namespace {
+	// Flags consumed by the layout pass and by the transform pass, respectively.
+	constexpr eInvalidation layoutMask = eInvalidation::LAYOUT | eInvalidation::PREFERRED_SIZE;
+	constexpr eInvalidation refreshMask = eInvalidation::PLACEMENT | eInvalidation::TRANSFORM | eInvalidation::VISIBILITY | eInvalidation::STYLE;
+} // namespace
+
+
 Board::Board() {
 	OnChildAdded += [this](Control*, Control* child) {
-		SetGraphicsContextRecurse(child);
+		m_traversalDirty = true;
+		if (m_context.engine) {
+			SetGraphicsContextRecurse(child); // Controls keep their placeholders until the board gets a context.
+		}
 		UpdateStyleRecurse(child);
 	};
 	OnChildRemoved += [this](Control*, Control* child) {
+		m_traversalDirty = true;
 		RemoveControlReferences(child);
 		ClearGraphicsContextRecurse(child);
 	};
@@ -36,7 +47,7 @@ void Board::OnMouseButton(MouseButtonEvent evt) {
 	Vec2 point = { evt.x, evt.y };
 	point = point * m_coordinateMapping;
 
-	Control* target = const_cast<Control*>(GetTarget(point));
+	Control* target = GetTarget(point);
 
 	if (target) {
 		switch (evt.state) {
@@ -88,7 +99,7 @@ void Board::OnMouseMove(MouseMoveEvent evt) {
 	// Find Control under the mouse pointer.
 	Vec2 point = Vec2{ evt.absx, evt.absy } * m_coordinateMapping;
 
-	Control* target = const_cast<Control*>(GetTarget(point));
+	Control* target = GetTarget(point);
 
 	// Handle leave area events.
 	if (!target) {
@@ -186,64 +197,78 @@ float Board::GetDepth() const {
 
 
 void Board::Update(float elapsed) {
-	UpdateLayouts(this);
-	UpdateRecurse(this, elapsed);
+	UpdateLayouts();
+	UpdateControls(elapsed);
 	//UpdateClipRecurse(this);
-	UpdateResultantTransformRecurse(this);
-
-	const auto& children = GetChildren();
-	for (auto& child : children) {
-		child->SetDepth(m_depth); // TODO: implement order by focus
-	}
-}
+	UpdateResultantTransforms();
 
-
-void Board::UpdateRecurse(Control* root, float elapsed) {
-	ApplyRecurse(root, [this, elapsed](Control* control) {
-		if (control != this) {
-			control->Update(elapsed);
+	// Layouts reassign depth themselves when their order changes.
+	if (m_fullUpdate) {
+		const auto& children = GetChildren();
+		for (auto& child : children) {
+			child->SetDepth(m_depth); // TODO: implement order by focus
 		}
-	});
+	}
+	m_fullUpdate = false;
 }
 
 
-void Board::UpdateLayouts(Control* subject) {
-	if (subject == nullptr) {
+void Board::UpdateTraversal() const {
+	if (!m_traversalDirty) {
 		return;
 	}
-
-	if (auto* layout = dynamic_cast<Layout*>(subject)) {
-		layout->UpdateLayout();
+	m_traversalDirty = false;
+	m_fullUpdate = true;
+	m_fullRefresh = true;
+
+	m_traversal.clear();
+	m_traversalStack.clear();
+	m_traversalStack.push_back({ const_cast<Board*>(this), 0 });
+	while (!m_traversalStack.empty()) {
+		auto [control, parent] = m_traversalStack.back();
+		m_traversalStack.pop_back();
+
+		const uint32_t index = (uint32_t)m_traversal.size();
+		m_traversal.push_back({ control, parent, index + 1 });
+		auto children = control->GetChildren();
+		for (auto it = children.rbegin(); it != children.rend(); ++it) {
+			m_traversalStack.push_back({ *it, index });
+		}
 	}
 
-	auto children = subject->GetChildren();
-	for (auto& child : children) {
-		UpdateLayouts(const_cast<Control*>(child));
+	// Children come after their parents, so walking backwards finishes each subtree before its parent.
+	for (size_t i = m_traversal.size(); i-- > 1;) {
+		auto& parent = m_traversal[m_traversal[i].parent];
+		parent.subtreeEnd = std::max(parent.subtreeEnd, m_traversal[i].subtreeEnd);
 	}
 }
 
 
-const Control* Board::HitTestRecurse(Vec2 point, const Control* top, const Mat33& preTransform) {
-	const Mat33& topTransform = top->HasIdentityTransform() ? preTransform : preTransform * top->GetTransform();
+void Board::UpdateControls(float elapsed) {
+	ForEachControl([this, elapsed](Control* control) {
+		if (control != this) {
+			control->Update(elapsed);
+		}
+		return true;
+	});
+}
 
-	Vec2 localPoint = DecomposeLUP(Transpose(topTransform)).Solve(point | 1.f).xy;
 
-	if (!top->GetClickThrough() && top->IsShown() && top->HitTest(localPoint)) {
-		auto children = top->GetChildren();
-		float maxDepth = -1e4f;
-		const Control* finalHit = top;
-		for (auto child : children) {
-			const Control* childHit = HitTestRecurse(point, child, topTransform);
-			if (childHit && childHit->GetDepth() > maxDepth) {
-				finalHit = childHit;
-				maxDepth = childHit->GetDepth();
+void Board::UpdateLayouts() {
+	// Layouts mark their subtree as they reposition children, so those are visited in the same pass.
+	ForEachControl([this](Control* control) {
+		const eInvalidation invalidation = control->m_invalidation;
+		if (!m_fullUpdate && invalidation == eInvalidation::NONE && !control->m_descendantInvalidated) {
+			return false;
+		}
+		control->m_invalidation = invalidation & refreshMask;
+		if (m_fullUpdate || (invalidation & eInvalidation::LAYOUT) != eInvalidation::NONE) {
+			if (auto* layout = dynamic_cast<Layout*>(control)) {
+				layout->UpdateLayout();
 			}
 		}
-		return finalHit;
-	}
-	else {
-		return nullptr;
-	}
+		return true;
+	});
 }
 
 void Board::DebugTree() const {
@@ -261,33 +286,70 @@ void Board::DebugTreeRecurse(const Control* control, int level) const {
 	}
 	std::cout << "- " << typeid(*control).name() << " " << control->GetPosition() << ", " << control->GetSize() << ", z=" << control->GetDepth() << "\n";
 
-	auto children = control->GetChildren();
-	for (auto child : children) {
+	for (auto child : control->GetChildren()) {
 		DebugTreeRecurse(child, level + 1);
 	}
 }
 
 
-const Control* Board::GetTarget(Vec2 point) const {
-	const Control* target = nullptr;
-	float topmostDepth = -1e4f;
-
+Control* Board::GetTarget(Vec2 point) {
 #ifdef _WIN32
 	if (m_breakOnTrace && IsDebuggerPresent()) {
 		__debugbreak();
 	}
 #endif
 
-	// TODO: handle depth
-	const auto& children = GetChildren();
-	for (auto child : children) {
-		auto* hit = HitTestRecurse(point, child);
-		if (hit) {
-			target = hit;
+	// Input may arrive between updates, the index has to reflect the changes since the last one.
+	UpdateResultantTransforms();
+
+	// A control can only be hit inside its clip rect, which also contains the clip rects of its children.
+	// Hence the ancestors of every candidate are candidates as well, and come before it in the traversal.
+	m_hitCandidates.clear();
+	m_hitIndex.Query(point, m_hitCandidates);
+	std::sort(m_hitCandidates.begin(), m_hitCandidates.end());
+
+	// Top-down: a control is hit if it is hit in its own space and so is its parent.
+	for (uint32_t index : m_hitCandidates) {
+		const TraversalEntry& entry = m_traversal[index];
+		const Control* control = entry.control;
+		if (index == 0 || (entry.parent != 0 && !m_traversalHits[entry.parent])) {
+			continue;
+		}
+
+		Vec2 localPoint = ((point | 1.f) * m_traversalInverseTransforms[index]).xy;
+
+		if (!control->GetClickThrough() && m_traversalShown[index] && control->HitTest(localPoint)) {
+			m_traversalHits[index] = control;
 		}
 	}
+
+	// Bottom-up: a hit control is replaced by the deepest hit among its children, the first one on ties.
+	// Siblings are visited backwards, hence the >= comparison.
+	// TODO: handle depth among the board's children, the last hit wins for now.
+	const Control* target = nullptr;
+	for (auto it = m_hitCandidates.rbegin(); it != m_hitCandidates.rend(); ++it) {
+		const Control* hit = m_traversalHits[*it];
+		if (!hit) {
+			continue;
+		}
+		const uint32_t parent = m_traversal[*it].parent;
+		if (parent == 0) {
+			target = target ? target : hit;
+			continue;
+		}
+		const Control*& parentHit = m_traversalHits[parent];
+		const bool parentHitItself = parentHit == m_traversal[parent].control;
+		if (parentHitItself ? hit->GetDepth() > -1e4f : hit->GetDepth() >= parentHit->GetDepth()) {
+			parentHit = hit;
+		}
+	}
+
+	for (uint32_t index : m_hitCandidates) {
+		m_traversalHits[index] = nullptr;
+	}
+
 	m_breakOnTrace = false;
-	return target;
+	return const_cast<Control*>(target);
 }
 
 
@@ -309,33 +371,108 @@ void Board::ClearGraphicsContextRecurse(Control* root) {
 }
 
 
-void Board::UpdateResultantTransformRecurse(Control* root, const Mat33& preTransform, RectF clip) {
-	const Mat33& topTransform = root->HasIdentityTransform() ? preTransform : preTransform * root->GetTransform();
+void Board::UpdateResultantTransforms() {
+	UpdateTraversal();
+	const size_t count = m_traversal.size();
+	m_traversalTransforms.resize(count);
+	m_traversalInverseTransforms.resize(count);
+	m_traversalClips.resize(count);
+	m_traversalShown.resize(count);
+	m_traversalHits.resize(count, nullptr);
+	m_refreshedEntries.clear();
+
+	// Results of clean entries are kept from the previous update. Entries before refreshEnd are recomputed
+	// from their parents, which are either clean or recomputed earlier, as they precede their children.
+	const bool fullRefresh = m_fullRefresh;
+	size_t refreshEnd = fullRefresh ? count : 0;
+	size_t shownEnd = refreshEnd;
+	m_fullRefresh = false;
+
+	size_t index = 0;
+	while (index < count) {
+		const TraversalEntry& entry = m_traversal[index];
+		Control* root = entry.control;
+		const eInvalidation invalidation = root->m_invalidation;
+
+		if ((invalidation & refreshMask) != eInvalidation::NONE) {
+			refreshEnd = std::max<size_t>(refreshEnd, entry.subtreeEnd);
+		}
+		else if (index >= refreshEnd && !root->m_descendantInvalidated) {
+			if (invalidation != eInvalidation::NONE) {
+				root->Invalidate(eInvalidation::NONE); // Re-mark the ancestors cleared above, for the next layout pass.
+			}
+			index = entry.subtreeEnd;
+			continue;
+		}
+		root->m_descendantInvalidated = false;
+		if ((invalidation & eInvalidation::VISIBILITY) != eInvalidation::NONE) {
+			shownEnd = std::max<size_t>(shownEnd, entry.subtreeEnd);
+		}
 
-	if (GraphicalControl* graphical = dynamic_cast<GraphicalControl*>(root)) {
-		graphical->SetPostTransform(topTransform);
-		graphical->SetClipRect(clip, Identity());
-	}
+		if (index < refreshEnd) {
+			const Mat33 preTransform = index == 0 ? Mat33(Identity()) : m_traversalTransforms[entry.parent];
+			const RectF clip = index == 0 ? RectF::FromCenter(0, 0, 100000, 100000) : m_traversalClips[entry.parent];
+			const Mat33 topTransform = root->HasIdentityTransform() ? preTransform : preTransform * root->GetTransform();
+			const bool shown = root->GetVisible() && (index == 0 || m_traversalShown[entry.parent]);
+
+			if (GraphicalControl* graphical = dynamic_cast<GraphicalControl*>(root)) {
+				graphical->SetPostTransform(topTransform);
+				graphical->SetClipRect(clip, Identity());
+				if (index < shownEnd) {
+					graphical->SetShown(shown);
+				}
+			}
 
-	RectF rootClip = RectF::FromCenter(root->GetPosition(), root->GetSize());
-	std::array<Vec2, 4> points{ rootClip.GetTopLeft(), rootClip.GetTopRight(), rootClip.GetBottomLeft(), rootClip.GetBottomRight() };
-	std::array<float, 4> boundaryXs;
-	std::array<float, 4> boundaryYs;
-	for (int i = 0; i < 4; ++i) {
-		Vec2 boundaryPoint = points[i] * topTransform;
-		boundaryXs[i] = boundaryPoint.x;
-		boundaryYs[i] = boundaryPoint.y;
-	}
-	rootClip.left = *std::min_element(boundaryXs.begin(), boundaryXs.end());
-	rootClip.right = *std::max_element(boundaryXs.begin(), boundaryXs.end());
-	rootClip.bottom = *std::min_element(boundaryYs.begin(), boundaryYs.end());
-	rootClip.top = *std::max_element(boundaryYs.begin(), boundaryYs.end());
+			RectF rootClip = RectF::FromCenter(root->GetPosition(), root->GetSize());
+			std::array<Vec2, 4> points{ rootClip.GetTopLeft(), rootClip.GetTopRight(), rootClip.GetBottomLeft(), rootClip.GetBottomRight() };
+			std::array<float, 4> boundaryXs;
+			std::array<float, 4> boundaryYs;
+			for (int i = 0; i < 4; ++i) {
+				Vec2 boundaryPoint = points[i] * topTransform;
+				boundaryXs[i] = boundaryPoint.x;
+				boundaryYs[i] = boundaryPoint.y;
+			}
+			rootClip.left = *std::min_element(boundaryXs.begin(), boundaryXs.end());
+			rootClip.right = *std::max_element(boundaryXs.begin(), boundaryXs.end());
+			rootClip.bottom = *std::min_element(boundaryYs.begin(), boundaryYs.end());
+			rootClip.top = *std::max_element(boundaryYs.begin(), boundaryYs.end());
+
+			RectF combinedClip = RectF::Intersection(rootClip, clip);
+
+			m_traversalTransforms[index] = topTransform;
+			m_traversalInverseTransforms[index] = Inverse(topTransform);
+			m_traversalClips[index] = combinedClip;
+			m_traversalShown[index] = shown;
+			m_refreshedEntries.push_back((uint32_t)index);
+
+			// Children using the default style are visited later in this loop, keep them from marking the ancestors.
+			if ((invalidation & eInvalidation::STYLE) != eInvalidation::NONE) {
+				root->m_descendantInvalidated = true;
+				for (auto child : root->GetChildren()) {
+					if (child->GetUsingDefaultStyle()) {
+						child->SetStyle(root->GetStyle(), true);
+					}
+				}
+				root->m_descendantInvalidated = false;
+			}
+		}
 
-	RectF combinedClip = RectF::Intersection(rootClip, clip);
+		// Layout flags raised since the layout pass are kept for the next update.
+		root->m_invalidation = root->m_invalidation & layoutMask;
+		if (root->m_invalidation != eInvalidation::NONE) {
+			root->Invalidate(eInvalidation::NONE);
+		}
+		++index;
+	}
 
-	auto children = root->GetChildren();
-	for (auto child : children) {
-		UpdateResultantTransformRecurse(child, topTransform, combinedClip);
+	// Refitting is cheaper for a few moving controls, but degrades the tree when most of them move.
+	if (fullRefresh || m_hitIndex.GetItemCount() != count || m_refreshedEntries.size() > count / 4) {
+		m_hitIndex.Build(m_traversalClips);
+	}
+	else {
+		for (uint32_t index : m_refreshedEntries) {
+			m_hitIndex.Update(index, m_traversalClips[index]);
+		}
 	}
 }
 
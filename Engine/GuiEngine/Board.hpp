@@ -2,10 +2,14 @@
 
 #include "Control.hpp"
 #include "GraphicsContext.hpp"
+#include "RectTree.hpp"
 
 #include <BaseLibrary/Platform/Input.hpp>
 #include <BaseLibrary/Rect.hpp>
 
+#include <algorithm>
+#include <vector>
+
 
 namespace inl::gui {
 
@@ -38,18 +42,35 @@ public:
 	void Update(float elapsed) override;
 
 private:
-	void UpdateLayouts(Control* subject);
+	struct TraversalEntry {
+		Control* control;
+		uint32_t parent; // Index of the parent entry, the root's is its own.
+		uint32_t subtreeEnd; // One past the last entry of the control's subtree.
+	};
+
+	/// <summary> Rebuilds the pre-order list of all controls if the hierarchy changed since the last call. </summary>
+	void UpdateTraversal() const;
+
+	/// <summary> Calls <paramref name="func"/> for every control in pre-order, the board included.
+	///		The subtree of a control is skipped if <paramref name="func"/> returns false for it.
+	///		If <paramref name="func"/> changes the hierarchy, the traversal continues after the same control
+	///		in the new order. </summary>
+	template <class Func>
+	void ForEachControl(Func func);
 
 	template <class Func>
 	static void ApplyRecurse(Control* root, Func func);
 
-	static const Control* HitTestRecurse(Vec2 point, const Control* top, const Mat33& preTransform = Identity());
-	const Control* GetTarget(Vec2 point) const;
+	/// <summary> Finds the control that receives mouse events at <paramref name="point"/>. </summary>
+	/// <remarks> Controls are only hit within the rectangle given by their position and size,
+	///		the spatial index is built over those. <see cref="Control::HitTest"/> may narrow the area further. </remarks>
+	Control* GetTarget(Vec2 point);
 
-	void UpdateRecurse(Control* root, float elapsed);
+	void UpdateLayouts();
+	void UpdateControls(float elapsed);
 	void SetGraphicsContextRecurse(Control* root);
 	void ClearGraphicsContextRecurse(Control* root);
-	void UpdateResultantTransformRecurse(Control* root, const Mat33& preTransform = Identity(), RectF clip = RectF::FromCenter(0, 0, 100000, 100000));
+	void UpdateResultantTransforms();
 
 	/// <summary> If a Control is removed, but focus, drag or similar operations are in progress on it, the Board
 	/// keeps a reference to it, which might in turn become dangling. This function removes references to
@@ -84,6 +105,20 @@ private:
 	Vec2 m_dragPointOrigin;
 	bool m_firstDrag = true;
 
+	mutable std::vector<TraversalEntry> m_traversal;
+	mutable std::vector<std::pair<Control*, uint32_t>> m_traversalStack;
+	mutable bool m_traversalDirty = true;
+	mutable bool m_fullUpdate = true; // Set when the traversal is rebuilt, invalidation flags are ignored until the next update.
+	mutable bool m_fullRefresh = true; // Same for the resultant transforms, which are also refreshed for hit testing.
+	std::vector<Mat33> m_traversalTransforms;
+	std::vector<Mat33> m_traversalInverseTransforms;
+	std::vector<RectF> m_traversalClips;
+	std::vector<bool> m_traversalShown;
+	std::vector<uint32_t> m_refreshedEntries;
+	RectTree m_hitIndex; // Over m_traversalClips, items are traversal indices.
+	std::vector<uint32_t> m_hitCandidates;
+	std::vector<const Control*> m_traversalHits;
+
 	Mat33 m_coordinateMapping = Identity();
 	mutable bool m_breakOnTrace = false;
 	float m_depth = 0.0f;
@@ -91,11 +126,32 @@ private:
 };
 
 
+template <class Func>
+void Board::ForEachControl(Func func) {
+	UpdateTraversal();
+	size_t i = 0;
+	while (i < m_traversal.size()) {
+		Control* control = m_traversal[i].control;
+		const bool descend = func(control);
+		if (m_traversalDirty) {
+			UpdateTraversal();
+			auto it = std::find_if(m_traversal.begin(), m_traversal.end(), [control](const TraversalEntry& entry) {
+				return entry.control == control;
+			});
+			if (it == m_traversal.end()) {
+				break; // The control removed itself, the rest is updated next time.
+			}
+			i = it - m_traversal.begin();
+		}
+		i = descend ? i + 1 : m_traversal[i].subtreeEnd;
+	}
+}
+
+
 template <class Func>
 void Board::ApplyRecurse(Control* root, Func func) {
 	func(root);
-	auto children = root->GetChildren();
-	for (auto child : children) {
+	for (auto child : root->GetChildren()) {
 		ApplyRecurse(child, func);
 	}
 }
@@ -2,6 +2,8 @@
 
 #include <BaseLibrary/Rect.hpp>
 
+#include <algorithm>
+
 
 namespace inl::gui {
 
@@ -14,6 +16,7 @@ void ControlTransform::SetTransform(const Mat33& transform) {
 		m_transform.emplace();
 		m_transform.value().SetMatrix(transform);
 	}
+	UpdateTransform();
 }
 
 
@@ -34,15 +37,17 @@ bool ControlTransform::IsIdentity(const Mat33& transform) {
 
 
 void Control::AddChild(std::shared_ptr<Control> child) {
-	assert(child->m_parent == nullptr);
-
-	auto [it, isNew] = m_children.insert(child);
-	if (!isNew) {
+	if (child->m_parent == this) {
 		throw InvalidArgumentException("Specified control already a child of *this.");
 	}
+	assert(child->m_parent == nullptr);
+
+	m_children.push_back(child);
+	m_childPointers.push_back(child.get());
 	child->m_parent = this;
 	ChildAddedHandler(*child);
 	child->AttachedHandler(*this);
+	Invalidate(eInvalidation::LAYOUT | eInvalidation::PREFERRED_SIZE);
 	CallEventUpstream(&Control::OnChildAdded, this, child.get());
 }
 
@@ -50,13 +55,17 @@ void Control::AddChild(std::shared_ptr<Control> child) {
 void Control::RemoveChild(const Control* child) {
 	assert(child->m_parent == this);
 
-	auto it = m_children.find(child);
-	if (it != m_children.end()) {
-		CallEventUpstream(&Control::OnChildRemoved, this, it->get());
-		(*it)->DetachedHandler();
-		ChildRemovedHandler(**it);
-		(*it)->m_parent = nullptr;
-		m_children.erase(it);
+	auto it = std::find(m_childPointers.begin(), m_childPointers.end(), child);
+	if (it != m_childPointers.end()) {
+		const size_t index = it - m_childPointers.begin();
+		std::shared_ptr<Control> removed = m_children[index]; // Keep alive until the handlers are done.
+		CallEventUpstream(&Control::OnChildRemoved, this, removed.get());
+		removed->DetachedHandler();
+		ChildRemovedHandler(*removed);
+		removed->m_parent = nullptr;
+		m_children.erase(m_children.begin() + index);
+		m_childPointers.erase(m_childPointers.begin() + index);
+		Invalidate(eInvalidation::LAYOUT | eInvalidation::PREFERRED_SIZE);
 	}
 	else {
 		throw InvalidArgumentException("Specified control not a child of *this.");
@@ -65,12 +74,18 @@ void Control::RemoveChild(const Control* child) {
 
 
 void Control::ClearChildren() {
-	for (const auto& child : m_children) {
+	auto children = std::move(m_children);
+	m_children.clear();
+	m_childPointers.clear();
+	for (const auto& child : children) {
+		CallEventUpstream(&Control::OnChildRemoved, this, child.get());
 		child->DetachedHandler();
 		ChildRemovedHandler(*child);
 		child->m_parent = nullptr;
 	}
-	m_children.clear();
+	if (!children.empty()) {
+		Invalidate(eInvalidation::LAYOUT | eInvalidation::PREFERRED_SIZE);
+	}
 }
 
 
@@ -83,6 +98,7 @@ void Control::SetStyle(const ControlStyle& style, bool useDefault) {
 	m_style = style;
 	m_usingDefaultStyle = useDefault;
 	UpdateStyle();
+	Invalidate(eInvalidation::STYLE);
 }
 
 
@@ -101,17 +117,16 @@ bool Control::GetUsingDefaultStyle() const {
 }
 
 
-std::set<Control*> Control::GetChildren() const {
-	std::set<Control*> children;
-	for (const auto& child : m_children) {
-		children.insert(child.get());
-	}
-	return children;
+std::span<Control* const> Control::GetChildren() const {
+	return m_childPointers;
 }
 
 
 void Control::SetVisible(bool visible) {
-	m_visible = visible;
+	if (m_visible != visible) {
+		m_visible = visible;
+		Invalidate(eInvalidation::VISIBILITY);
+	}
 }
 
 
@@ -136,6 +151,28 @@ bool Control::GetClickThrough() const {
 }
 
 
+void Control::Invalidate(eInvalidation what) {
+	m_invalidation = m_invalidation | what;
+	// Ancestors above an already marked one are marked as well.
+	for (Control* ancestor = m_parent; ancestor && !ancestor->m_descendantInvalidated; ancestor = ancestor->m_parent) {
+		ancestor->m_descendantInvalidated = true;
+	}
+	if (m_parent && (what & eInvalidation::PREFERRED_SIZE) != eInvalidation::NONE) {
+		m_parent->ChildInvalidatedHandler(*this, what);
+	}
+}
+
+
+void Control::UpdateTransform() {
+	Invalidate(eInvalidation::TRANSFORM);
+}
+
+
+void Control::ChildInvalidatedHandler(Control& child, eInvalidation what) {
+	Invalidate(eInvalidation::PREFERRED_SIZE);
+}
+
+
 bool Control::HitTest(const Vec2& point) const {
 	Vec2 pos = GetPosition();
 	Vec2 size = GetSize();
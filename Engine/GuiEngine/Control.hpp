@@ -2,7 +2,6 @@
 
 #include "BlankShared.hpp"
 #include "ControlStyle.hpp"
-#include "SharedPtrLess.hpp"
 
 #include <BaseLibrary/Event.hpp>
 #include <BaseLibrary/Exception/Exception.hpp>
@@ -13,12 +12,33 @@
 #include <any>
 #include <memory>
 #include <optional>
-#include <set>
+#include <span>
+#include <vector>
 
 
 namespace inl::gui {
 
 
+/// <summary> What has changed about a control since the board last processed it. </summary>
+enum class eInvalidation : uint8_t {
+	NONE = 0,
+	PREFERRED_SIZE = 1 << 0, // Preferred or minimum size changed, the nearest layout has to rearrange.
+	PLACEMENT = 1 << 1, // Position or size changed, the clip rects of the subtree are stale.
+	TRANSFORM = 1 << 2, // The transform changed, the resultant transforms of the subtree are stale.
+	VISIBILITY = 1 << 3, // Shown state of the subtree might have changed.
+	STYLE = 1 << 4, // Style has to be propagated to children that use the default style.
+	LAYOUT = 1 << 5, // The control's own layout has to be recomputed.
+};
+
+constexpr eInvalidation operator|(eInvalidation lhs, eInvalidation rhs) {
+	return eInvalidation(uint8_t(lhs) | uint8_t(rhs));
+}
+
+constexpr eInvalidation operator&(eInvalidation lhs, eInvalidation rhs) {
+	return eInvalidation(uint8_t(lhs) & uint8_t(rhs));
+}
+
+
 class ControlTransform {
 public:
 	void SetTransform(const Mat33& transform);
@@ -37,6 +57,8 @@ private:
 
 
 class Control : public ControlTransform {
+	friend class Board;
+
 public:
 	virtual ~Control() = default;
 
@@ -47,7 +69,9 @@ public:
 	void ClearChildren();
 
 	const Control* GetParent() const;
-	std::set<Control*> GetChildren() const;
+	/// <summary> Children in the order they were added. </summary>
+	/// <remarks> The view is invalidated when children are added or removed. </remarks>
+	std::span<Control* const> GetChildren() const;
 
 	// Sizing
 	virtual void SetSize(const Vec2& size) = 0;
@@ -79,6 +103,14 @@ public:
 	bool GetUsingDefaultStyle() const;
 	virtual void UpdateStyle() {}
 
+	// Invalidation
+	/// <summary> Marks the control so that the board reprocesses it on the next update.
+	///		Ancestors are notified so that the board can skip all subtrees that have not changed. </summary>
+	void Invalidate(eInvalidation what);
+	eInvalidation GetInvalidation() const { return m_invalidation; }
+
+	void UpdateTransform() override;
+
 	// Events
 	Event<Control*, Control*> OnChildAdded; // subject, child
 	Event<Control*, Control*> OnChildRemoved; // subject, child
@@ -111,6 +143,9 @@ protected:
 	virtual void ChildRemovedHandler(Control& child) {}
 	virtual void AttachedHandler(Control& parent) {}
 	virtual void DetachedHandler() {}
+	/// <summary> Called when the preferred size of a child changed.
+	///		By default, the control assumes its own preferred size changed as well. </summary>
+	virtual void ChildInvalidatedHandler(Control& child, eInvalidation what);
 
 	template <class T>
 	static void SetLayoutPosition(Control& control, T data);
@@ -119,14 +154,18 @@ protected:
 	static T& GetLayoutPosition(const Control& control);
 
 private:
-	const Control* m_parent = nullptr;
-	std::set<std::shared_ptr<Control>, SharedPtrLess<Control>> m_children;
+	Control* m_parent = nullptr;
+	std::vector<std::shared_ptr<Control>> m_children;
+	std::vector<Control*> m_childPointers; // Same as m_children, GetChildren returns a view of it.
 	mutable std::any m_layoutPosition;
 
 	bool m_usingDefaultStyle = true;
 	ControlStyle m_style;
 	bool m_visible = true;
 	bool m_clickThrough = false;
+
+	eInvalidation m_invalidation = eInvalidation::NONE;
+	bool m_descendantInvalidated = false; // A control in the subtree, not this one, is invalidated.
 };
 
 
@@ -148,10 +187,9 @@ T& Control::GetLayoutPosition(const Control& control) {
 
 template <class EventT, class... Args>
 void Control::CallEventUpstream(EventT event, const Args&... args) const {
-	(this->*event)(args...);
-	const Control* parent = GetParent();
-	if (parent) {
-		parent->CallEventUpstream(event, args...);
+	// Walked iteratively, mouse moves fire this for every ancestor of the hovered control.
+	for (const Control* control = this; control != nullptr; control = control->GetParent()) {
+		(control->*event)(args...);
 	}
 }
 
@@ -24,6 +24,10 @@ public:
 
 	/// <summary> Set a transformation on the shown entities. </summary>
 	virtual void SetPostTransform(const Mat33& transform) = 0;
+
+	/// <summary> Adds the entities to or removes them from the scene of the context. </summary>
+	/// <param name="shown"> True if the control and all its ancestors are visible. </param>
+	virtual void SetShown(bool shown) = 0;
 };
 
 
@@ -11,22 +11,26 @@ namespace inl::gui {
 LinearLayout::CellSize& LinearLayout::CellSize::SetWidth(float width) {
 	type = eCellType::ABSOLUTE;
 	value = width;
+	layout->SetDirty();
 	return *this;
 }
 
 LinearLayout::CellSize& LinearLayout::CellSize::SetWeight(float weight) {
 	type = eCellType::WEIGHT;
 	value = std::max(0.0f, weight);
+	layout->SetDirty();
 	return *this;
 }
 
 LinearLayout::CellSize& LinearLayout::CellSize::SetAuto() {
 	type = eCellType::AUTO;
+	layout->SetDirty();
 	return *this;
 }
 
 LinearLayout::CellSize& LinearLayout::CellSize::SetMargin(Rect<float, false, false> margin) {
 	this->margin = margin;
+	layout->SetDirty();
 	return *this;
 }
 
@@ -47,6 +51,7 @@ auto LinearLayout::CellSize::MoveForward() -> CellSize& {
 		orderList->splice(prevIt, *orderList, orderIter);
 	}
 
+	layout->SetDirty();
 	return *this;
 }
 
@@ -59,6 +64,7 @@ auto LinearLayout::CellSize::MoveBackward() -> CellSize& {
 		orderList->splice(++nextIt, *orderList, orderIter);
 	}
 
+	layout->SetDirty();
 	return *this;
 }
 
@@ -70,6 +76,7 @@ auto LinearLayout::CellSize::MoveToFront() -> CellSize& {
 		orderList->splice(firstIt, *orderList, orderIter);
 	}
 
+	layout->SetDirty();
 	return *this;
 }
 
@@ -81,6 +88,7 @@ auto LinearLayout::CellSize::MoveToBack() -> CellSize& {
 		orderList->splice(endIt, *orderList, orderIter);
 	}
 
+	layout->SetDirty();
 	return *this;
 }
 
@@ -111,8 +119,12 @@ const LinearLayout::CellSize& LinearLayout::operator[](const Control* child) con
 
 
 void LinearLayout::SetSize(const Vec2& size) {
+	if (m_size == size) {
+		return;
+	}
 	m_size = size;
 	m_dirty = true;
+	Invalidate(eInvalidation::PLACEMENT | eInvalidation::LAYOUT);
 }
 
 
@@ -238,9 +250,12 @@ Vec2 LinearLayout::GetMinimumSize() const {
 
 
 void LinearLayout::SetPosition(const Vec2& position) {
+	if (m_position == position) {
+		return;
+	}
 	m_position = position;
-
 	m_dirty = true;
+	Invalidate(eInvalidation::PLACEMENT | eInvalidation::LAYOUT);
 }
 
 
@@ -331,6 +346,13 @@ void LinearLayout::UpdateLayout() {
 
 void LinearLayout::SetDirection(eDirection direction) {
 	m_direction = direction;
+	SetDirty();
+}
+
+
+void LinearLayout::SetInverted(bool inversion) {
+	m_inverted = inversion;
+	SetDirty();
 }
 
 
@@ -360,13 +382,27 @@ float LinearLayout::GetDepth() const {
 void LinearLayout::ChildAddedHandler(Control& child) {
 	m_childrenOrder.push_back(&child);
 	auto orderIt = --m_childrenOrder.end();
-	SetLayoutPosition(child, CellSize(&m_childrenOrder, orderIt));
+	SetLayoutPosition(child, CellSize(this, &m_childrenOrder, orderIt));
+	m_dirty = true;
 }
 
 
 void LinearLayout::ChildRemovedHandler(Control& child) {
 	CellSize& binding = GetLayoutPosition<CellSize>(child);
 	m_childrenOrder.erase(binding.orderIter);
+	m_dirty = true;
+}
+
+
+void LinearLayout::ChildInvalidatedHandler(Control& child, eInvalidation what) {
+	SetDirty();
+}
+
+
+void LinearLayout::SetDirty() {
+	// The preferred size is computed from the cells, so it changes with them.
+	m_dirty = true;
+	Invalidate(eInvalidation::LAYOUT | eInvalidation::PREFERRED_SIZE);
 }
 
 
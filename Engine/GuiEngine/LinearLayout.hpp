@@ -27,8 +27,8 @@ public:
 
 	struct CellSize {
 		friend class LinearLayout;
-		CellSize(std::list<Control*>* orderList, std::list<Control*>::iterator orderIter)
-			: orderList(orderList), orderIter(orderIter) {}
+		CellSize(LinearLayout* layout, std::list<Control*>* orderList, std::list<Control*>::iterator orderIter)
+			: layout(layout), orderList(orderList), orderIter(orderIter) {}
 
 	public:
 		CellSize& SetWidth(float width);
@@ -47,6 +47,7 @@ public:
 		eCellType type = eCellType::WEIGHT;
 		float value = 1.0f;
 		Rect<float, false, false> margin = { 3, 3, 3, 3 };
+		LinearLayout* layout = nullptr;
 		std::list<Control*>::iterator orderIter;
 		std::list<Control*>* orderList = nullptr;
 	};
@@ -77,7 +78,7 @@ public:
 	void SetDirection(eDirection direction);
 	eDirection GetDirection();
 
-	void SetInverted(bool inversion) { m_inverted = inversion; }
+	void SetInverted(bool inversion);
 	bool IsInverted() const { return m_inverted; }
 
 private:
@@ -93,10 +94,11 @@ private:
 	};
 	SizingMeasurement CalcMeasures() const;
 	void PositionChild(Control& child, Vec2 childSize, float primaryOffset, Vec2 budgetSize);
-
+	void SetDirty();
 
 	void ChildAddedHandler(Control& child) override;
 	void ChildRemovedHandler(Control& child) override;
+	void ChildInvalidatedHandler(Control& child, eInvalidation what) override;
 
 private:
 	std::list<Control*> m_childrenOrder;
@@ -0,0 +1,240 @@
+#include "ListViewV.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+
+namespace inl::gui {
+
+
+ListViewV::ListViewV() {
+	AddChild(m_scrollBar);
+	m_scrollBar.SetDirection(ScrollBar::VERTICAL);
+	m_scrollBar.SetInverted(true);
+
+	m_scrollBar.OnChanged += [this](float) {
+		const float position = m_scrollBar.GetVisiblePosition();
+		if (position != m_scrollPosition) {
+			m_scrollPosition = position;
+			Invalidate(eInvalidation::LAYOUT);
+		}
+	};
+
+	OnMouseWheel += [this](Control*, Vec2, float amount) {
+		SetScrollPosition(m_scrollPosition - 3.0f * m_rowHeight * amount);
+	};
+}
+
+
+void ListViewV::SetSize(const Vec2& size) {
+	if (m_size == size) {
+		return;
+	}
+	m_size = size;
+	UpdateScrollBar();
+	Invalidate(eInvalidation::PLACEMENT | eInvalidation::LAYOUT);
+}
+
+
+Vec2 ListViewV::GetSize() const {
+	return m_size;
+}
+
+
+Vec2 ListViewV::GetPreferredSize() const {
+	return GetMinimumSize();
+}
+
+
+Vec2 ListViewV::GetMinimumSize() const {
+	return { m_scrollBarWidth, m_rowHeight };
+}
+
+
+void ListViewV::SetPosition(const Vec2& position) {
+	if (m_position == position) {
+		return;
+	}
+	m_position = position;
+	Invalidate(eInvalidation::PLACEMENT | eInvalidation::LAYOUT);
+}
+
+
+Vec2 ListViewV::GetPosition() const {
+	return m_position;
+}
+
+
+float ListViewV::SetDepth(float depth) {
+	m_depth = depth;
+	float maxSpan = 0.0f;
+	for (auto& child : GetChildren()) {
+		maxSpan = std::max(maxSpan, child->SetDepth(depth + 1.0f));
+	}
+	return maxSpan + 1.0f;
+}
+
+
+float ListViewV::GetDepth() const {
+	return m_depth;
+}
+
+
+void ListViewV::UpdateLayout() {
+	const float contentWidth = std::max(0.0f, m_size.x - m_scrollBarWidth);
+	m_scrollBar.SetSize({ m_scrollBarWidth, m_size.y });
+	m_scrollBar.SetPosition({ m_position.x + contentWidth / 2.0f, m_position.y });
+
+	// Enough rows to cover the view at any scroll offset, plus the overscan on both sides.
+	const size_t requiredRows = m_factory ? size_t(std::ceil(m_size.y / m_rowHeight)) + 1 + 2 * m_overscan : 0;
+	if (m_rows.size() < requiredRows) {
+		for (auto& row : m_rows) {
+			row.item = noItem; // Items map to different rows from now on.
+		}
+		while (m_rows.size() < requiredRows) {
+			auto control = m_factory();
+			m_rows.push_back({ control, noItem });
+			AddChild(control);
+			control->SetDepth(m_depth + 1.0f);
+		}
+	}
+	if (m_rows.empty()) {
+		return;
+	}
+
+	const size_t rowCount = m_rows.size();
+	const size_t firstVisible = size_t(m_scrollPosition / m_rowHeight);
+	const size_t first = std::min(firstVisible - std::min(firstVisible, m_overscan), m_itemCount);
+	const size_t end = std::min(first + rowCount, m_itemCount);
+	const float top = m_position.y + m_size.y / 2.0f + m_scrollPosition;
+	const float centerX = m_position.x - m_size.x / 2.0f + contentWidth / 2.0f;
+
+	for (size_t index = 0; index < rowCount; ++index) {
+		Row& row = m_rows[index];
+		const size_t item = first + (index + rowCount - first % rowCount) % rowCount;
+		if (item >= end) {
+			row.item = noItem;
+			row.control->SetVisible(false);
+			continue;
+		}
+		if (row.item != item) {
+			row.item = item;
+			if (m_binder) {
+				m_binder(*row.control, item);
+			}
+		}
+		row.control->SetVisible(true);
+		row.control->SetSize({ contentWidth, m_rowHeight });
+		row.control->SetPosition({ centerX, top - (float(item) + 0.5f) * m_rowHeight });
+	}
+}
+
+
+void ListViewV::SetRowFactory(RowFactory factory) {
+	for (auto& row : m_rows) {
+		RemoveChild(row.control.get());
+	}
+	m_rows.clear();
+	m_factory = std::move(factory);
+	Invalidate(eInvalidation::LAYOUT);
+}
+
+
+void ListViewV::SetRowBinder(RowBinder binder) {
+	m_binder = std::move(binder);
+	RefreshItems();
+}
+
+
+void ListViewV::SetItemCount(size_t count) {
+	m_itemCount = count;
+	UpdateScrollBar();
+	RefreshItems();
+}
+
+
+size_t ListViewV::GetItemCount() const {
+	return m_itemCount;
+}
+
+
+void ListViewV::SetRowHeight(float height) {
+	if (height <= 0.0f) {
+		throw InvalidArgumentException("Row height must be positive.");
+	}
+	m_rowHeight = height;
+	UpdateScrollBar();
+	Invalidate(eInvalidation::LAYOUT);
+}
+
+
+float ListViewV::GetRowHeight() const {
+	return m_rowHeight;
+}
+
+
+void ListViewV::SetOverscan(size_t rows) {
+	m_overscan = rows;
+	Invalidate(eInvalidation::LAYOUT);
+}
+
+
+void ListViewV::SetScrollPosition(float position) {
+	m_scrollBar.SetVisiblePosition(position);
+}
+
+
+float ListViewV::GetScrollPosition() const {
+	return m_scrollPosition;
+}
+
+
+void ListViewV::ScrollToItem(size_t item) {
+	const float itemTop = float(item) * m_rowHeight;
+	const float itemBottom = itemTop + m_rowHeight;
+	if (itemTop < m_scrollPosition) {
+		SetScrollPosition(itemTop);
+	}
+	else if (itemBottom > m_scrollPosition + m_size.y) {
+		SetScrollPosition(itemBottom - m_size.y);
+	}
+}
+
+
+void ListViewV::RefreshItems() {
+	for (auto& row : m_rows) {
+		row.item = noItem;
+	}
+	Invalidate(eInvalidation::LAYOUT);
+}
+
+
+void ListViewV::RefreshItem(size_t item) {
+	if (!m_rows.empty() && m_rows[item % m_rows.size()].item == item) {
+		m_rows[item % m_rows.size()].item = noItem;
+		Invalidate(eInvalidation::LAYOUT);
+	}
+}
+
+
+Control* ListViewV::GetRow(size_t item) const {
+	if (m_rows.empty() || m_rows[item % m_rows.size()].item != item) {
+		return nullptr;
+	}
+	return m_rows[item % m_rows.size()].control.get();
+}
+
+
+void ListViewV::UpdateScrollBar() {
+	m_scrollBar.SetTotalLength(float(m_itemCount) * m_rowHeight);
+	m_scrollBar.SetVisibleLength(m_size.y);
+	m_scrollBar.SetVisiblePosition(m_scrollPosition); // Clamps to the new lengths.
+}
+
+
+void ListViewV::ChildInvalidatedHandler(Control& child, eInvalidation what) {
+	// Rows have a fixed height, their contents don't affect the list's size.
+}
+
+
+} // namespace inl::gui
@@ -0,0 +1,93 @@
+#pragma once
+
+
+#include "Layout.hpp"
+#include "ScrollBar.hpp"
+
+#include <functional>
+#include <limits>
+#include <vector>
+
+
+namespace inl::gui {
+
+
+/// <summary> Vertical list of uniformly tall rows that only instantiates the rows in view. </summary>
+/// <remarks> Rows are created by the factory and stay children of the list, along with their graphics entities.
+///		As the list scrolls, rows that leave the view are rebound to the items entering it.
+///		The number of rows depends on the height of the list, not on the number of items. </remarks>
+class ListViewV : public Layout {
+public:
+	/// <summary> Creates the control of a row, called when more rows are needed to fill the view. </summary>
+	using RowFactory = std::function<std::shared_ptr<Control>()>;
+	/// <summary> Shows an item in a row. The row might have shown another item before. </summary>
+	using RowBinder = std::function<void(Control& row, size_t item)>;
+
+public:
+	ListViewV();
+
+	// Sizing
+	void SetSize(const Vec2& size) override;
+	Vec2 GetSize() const override;
+	Vec2 GetPreferredSize() const override;
+	Vec2 GetMinimumSize() const override;
+
+	// Position & depth
+	void SetPosition(const Vec2& position) override;
+	Vec2 GetPosition() const override;
+	float SetDepth(float depth) override;
+	float GetDepth() const override;
+
+	// Layout update
+	void UpdateLayout() override;
+
+	// List specific properties
+	void SetRowFactory(RowFactory factory);
+	void SetRowBinder(RowBinder binder);
+	void SetItemCount(size_t count);
+	size_t GetItemCount() const;
+	void SetRowHeight(float height);
+	float GetRowHeight() const;
+	/// <summary> Number of rows kept bound above and below the view. </summary>
+	void SetOverscan(size_t rows);
+
+	void SetScrollPosition(float position);
+	float GetScrollPosition() const;
+	void ScrollToItem(size_t item);
+
+	/// <summary> Binds the rows in view again, call when the items changed. </summary>
+	void RefreshItems();
+	void RefreshItem(size_t item);
+	/// <summary> The row showing <paramref name="item"/>, or null if it's out of view. </summary>
+	Control* GetRow(size_t item) const;
+
+private:
+	void UpdateScrollBar();
+	void ChildInvalidatedHandler(Control& child, eInvalidation what) override;
+
+private:
+	static constexpr size_t noItem = std::numeric_limits<size_t>::max();
+
+	struct Row {
+		std::shared_ptr<Control> control;
+		size_t item = noItem;
+	};
+
+	ScrollBar m_scrollBar;
+	RowFactory m_factory;
+	RowBinder m_binder;
+	std::vector<Row> m_rows; // Item i is shown by row i % m_rows.size(), so a scroll by one row rebinds only one.
+
+	size_t m_itemCount = 0;
+	float m_rowHeight = 20.0f;
+	size_t m_overscan = 4;
+	float m_scrollPosition = 0.0f;
+	float m_scrollBarWidth = 14.f;
+
+	Vec2 m_position = { 0, 0 };
+	Vec2 m_size = { 10, 10 };
+	float m_depth = 0.0f;
+};
+
+
+} // namespace inl::gui
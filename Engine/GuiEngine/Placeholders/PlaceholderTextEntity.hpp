@@ -39,6 +39,8 @@ public:
 
 	float CalculateTextWidth() const override { return 0.0f; }
 	float CalculateTextHeight() const override { return 0.0f; }
+	intptr_t FindCharacter(float coordinate) const override { return coordinate < 0 ? -1 : (intptr_t)m_text.size(); }
+	std::pair<float, float> FindCoordinates(size_t index) const override { return { 0.0f, 0.0f }; }
 
 	void SetZDepth(float z) override { m_depth = z; }
 	float GetZDepth() const override { return m_depth; }
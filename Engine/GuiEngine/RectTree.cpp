@@ -0,0 +1,166 @@
+#include "RectTree.hpp"
+
+#include <algorithm>
+#include <limits>
+
+
+namespace inl::gui {
+
+
+namespace {
+	constexpr uint32_t maxLeafSize = 4;
+	constexpr uint32_t noParent = std::numeric_limits<uint32_t>::max();
+
+	bool IsEmpty(const RectF& rect) {
+		return rect.right < rect.left || rect.top < rect.bottom;
+	}
+
+	RectF EmptyRect() {
+		constexpr float inf = std::numeric_limits<float>::infinity();
+		RectF rect;
+		rect.left = inf;
+		rect.right = -inf;
+		rect.bottom = inf;
+		rect.top = -inf;
+		return rect;
+	}
+
+	void Extend(RectF& bounds, const RectF& rect) {
+		if (!IsEmpty(rect)) {
+			bounds.left = std::min(bounds.left, rect.left);
+			bounds.right = std::max(bounds.right, rect.right);
+			bounds.bottom = std::min(bounds.bottom, rect.bottom);
+			bounds.top = std::max(bounds.top, rect.top);
+		}
+	}
+
+	bool Contains(const RectF& rect, Vec2 point) {
+		return rect.left <= point.x && point.x <= rect.right && rect.bottom <= point.y && point.y <= rect.top;
+	}
+
+	bool Equal(const RectF& lhs, const RectF& rhs) {
+		return lhs.left == rhs.left && lhs.right == rhs.right && lhs.bottom == rhs.bottom && lhs.top == rhs.top;
+	}
+} // namespace
+
+
+void RectTree::Build(std::span<const RectF> rects) {
+	m_rects.assign(rects.begin(), rects.end());
+	m_items.resize(m_rects.size());
+	m_leaves.resize(m_rects.size());
+	for (uint32_t i = 0; i < m_items.size(); ++i) {
+		m_items[i] = i;
+	}
+	m_nodes.clear();
+	if (!m_rects.empty()) {
+		m_nodes.reserve(2 * (m_rects.size() / maxLeafSize + 1));
+		m_nodes.push_back({ EmptyRect(), noParent, 0, (uint32_t)m_items.size() });
+		BuildRecurse(0);
+	}
+}
+
+
+void RectTree::BuildRecurse(uint32_t index) {
+	const uint32_t begin = m_nodes[index].first;
+	const uint32_t end = begin + m_nodes[index].count;
+
+	if (end - begin <= maxLeafSize) {
+		for (uint32_t i = begin; i < end; ++i) {
+			m_leaves[m_items[i]] = index;
+		}
+		m_nodes[index].bounds = LeafBounds(m_nodes[index]);
+		return;
+	}
+
+	// Split at the median of the centers along the longer side of the centers' bounds.
+	Vec2 minCenter = { std::numeric_limits<float>::max(), std::numeric_limits<float>::max() };
+	Vec2 maxCenter = { std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest() };
+	for (uint32_t i = begin; i < end; ++i) {
+		const Vec2 center = m_rects[m_items[i]].GetCenter();
+		minCenter = Min(minCenter, center);
+		maxCenter = Max(maxCenter, center);
+	}
+	const int axis = maxCenter.x - minCenter.x >= maxCenter.y - minCenter.y ? 0 : 1;
+	const uint32_t middle = begin + (end - begin) / 2;
+	std::nth_element(m_items.begin() + begin, m_items.begin() + middle, m_items.begin() + end, [this, axis](uint32_t lhs, uint32_t rhs) {
+		return m_rects[lhs].GetCenter()[axis] < m_rects[rhs].GetCenter()[axis];
+	});
+
+	// Children are allocated together so that the right one is always next to the left one.
+	const uint32_t left = (uint32_t)m_nodes.size();
+	m_nodes.push_back({ EmptyRect(), index, begin, middle - begin });
+	m_nodes.push_back({ EmptyRect(), index, middle, end - middle });
+	BuildRecurse(left);
+	BuildRecurse(left + 1);
+
+	Node& node = m_nodes[index];
+	node.first = left;
+	node.count = 0;
+	node.bounds = ChildBounds(node);
+}
+
+
+void RectTree::Update(uint32_t item, const RectF& rect) {
+	if (Equal(m_rects[item], rect)) {
+		return;
+	}
+	m_rects[item] = rect;
+
+	uint32_t index = m_leaves[item];
+	RectF bounds = LeafBounds(m_nodes[index]);
+	while (!Equal(bounds, m_nodes[index].bounds)) {
+		m_nodes[index].bounds = bounds;
+		index = m_nodes[index].parent;
+		if (index == noParent) {
+			break;
+		}
+		bounds = ChildBounds(m_nodes[index]);
+	}
+}
+
+
+void RectTree::Query(Vec2 point, std::vector<uint32_t>& items) const {
+	if (m_nodes.empty()) {
+		return;
+	}
+
+	m_stack.clear();
+	m_stack.push_back(0);
+	while (!m_stack.empty()) {
+		const Node& node = m_nodes[m_stack.back()];
+		m_stack.pop_back();
+		if (!Contains(node.bounds, point)) {
+			continue;
+		}
+		if (node.count == 0) {
+			m_stack.push_back(node.first);
+			m_stack.push_back(node.first + 1);
+		}
+		else {
+			for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+				if (Contains(m_rects[m_items[i]], point)) {
+					items.push_back(m_items[i]);
+				}
+			}
+		}
+	}
+}
+
+
+RectF RectTree::ChildBounds(const Node& node) const {
+	RectF bounds = m_nodes[node.first].bounds;
+	Extend(bounds, m_nodes[node.first + 1].bounds);
+	return bounds;
+}
+
+
+RectF RectTree::LeafBounds(const Node& node) const {
+	RectF bounds = EmptyRect();
+	for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+		Extend(bounds, m_rects[m_items[i]]);
+	}
+	return bounds;
+}
+
+
+} // namespace inl::gui
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <BaseLibrary/Rect.hpp>
+
+#include <InlineMath.hpp>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+
+namespace inl::gui {
+
+
+/// <summary> Bounding volume hierarchy over a set of rectangles to find those containing a point. </summary>
+/// <remarks> Items are identified by their index in the span passed to <see cref="Build"/>.
+///		Rectangles with negative width or height contain no points. </remarks>
+class RectTree {
+public:
+	/// <summary> Discards the current tree and builds a new one over <paramref name="rects"/>. </summary>
+	void Build(std::span<const RectF> rects);
+
+	/// <summary> Changes the rectangle of an item and refits the bounds of the nodes above it. </summary>
+	/// <remarks> The tree's quality degrades with many moving items, rebuild it once they are a large share. </remarks>
+	void Update(uint32_t item, const RectF& rect);
+
+	/// <summary> Appends the items whose rectangle contains <paramref name="point"/> to <paramref name="items"/>, in no particular order. </summary>
+	void Query(Vec2 point, std::vector<uint32_t>& items) const;
+
+	size_t GetItemCount() const { return m_rects.size(); }
+
+private:
+	struct Node {
+		RectF bounds;
+		uint32_t parent;
+		uint32_t first; // Left child for inner nodes, the right one follows it. First item in m_items for leaves.
+		uint32_t count; // Number of items for leaves, zero for inner nodes.
+	};
+
+	void BuildRecurse(uint32_t index);
+	RectF ChildBounds(const Node& node) const;
+	RectF LeafBounds(const Node& node) const;
+
+private:
+	std::vector<RectF> m_rects;
+	std::vector<uint32_t> m_items; // Items of each leaf are consecutive.
+	std::vector<uint32_t> m_leaves; // The leaf containing each item.
+	std::vector<Node> m_nodes;
+	mutable std::vector<uint32_t> m_stack;
+};
+
+
+} // namespace inl::gui
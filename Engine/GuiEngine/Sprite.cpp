@@ -69,6 +69,20 @@ void Sprite::SetPostTransform(const Mat33& transform) {
 }
 
 
+void Sprite::SetShown(bool shown) {
+	if (m_context.scene) {
+		auto& entitySet = m_context.scene->GetEntities<gxeng::IOverlayEntity>();
+		bool contained = entitySet.Contains(m_entity.get());
+		if (contained && !shown) {
+			entitySet.Remove(m_entity.get());
+		}
+		if (!contained && shown) {
+			entitySet.Add(m_entity.get());
+		}
+	}
+}
+
+
 Sprite::~Sprite() {
 	if (m_context.scene) {
 		m_context.scene->GetEntities<gxeng::IOverlayEntity>().Remove(m_entity.get());
@@ -81,8 +95,12 @@ Sprite::~Sprite() {
 //-------------------------------------
 
 void Sprite::SetSize(const Vec2& size) {
+	if (m_size == size) {
+		return;
+	}
 	m_size = size;
 	SetResultantTransform();
+	Invalidate(eInvalidation::PLACEMENT);
 }
 
 
@@ -102,8 +120,12 @@ Vec2 Sprite::GetMinimumSize() const {
 
 
 void Sprite::SetPosition(const Vec2& position) {
+	if (m_position == position) {
+		return;
+	}
 	m_position = position;
 	SetResultantTransform();
+	Invalidate(eInvalidation::PLACEMENT);
 }
 
 
@@ -138,20 +160,6 @@ bool Sprite::HitTest(const Vec2& point) const {
 	return false;
 }
 
-void Sprite::Update(float elapsed) {
-	bool shown = IsShown();
-	if (m_context.scene) {
-		auto& entitySet = m_context.scene->GetEntities<gxeng::IOverlayEntity>();
-		bool contained = entitySet.Contains(m_entity.get());
-		if (contained && !shown) {
-			entitySet.Remove(m_entity.get());
-		}
-		if (!contained && shown) {
-			entitySet.Add(m_entity.get());
-		}
-	}
-}
-
 
 //-------------------------------------
 // OverlayEntity
@@ -30,6 +30,7 @@ public:
 	void ClearContext() override;
 	void SetClipRect(const RectF& rect, const Mat33& transform) override;
 	void SetPostTransform(const Mat33& transform) override;
+	void SetShown(bool shown) override;
 
 	~Sprite();
 
@@ -56,8 +57,6 @@ public:
 
 	bool HitTest(const Vec2& point) const override;
 
-	void Update(float elapsed) override;
-
 	//-------------------------------------
 	// OverlayEntity
 	//-------------------------------------
@@ -78,12 +78,30 @@ void Text::SetPostTransform(const Mat33& transform) {
 }
 
 
+void Text::SetShown(bool shown) {
+	if (m_context.scene) {
+		auto& entitySet = m_context.scene->GetEntities<gxeng::ITextEntity>();
+		bool contained = entitySet.Contains(m_entity.get());
+		if (contained && !shown) {
+			entitySet.Remove(m_entity.get());
+		}
+		if (!contained && shown) {
+			entitySet.Add(m_entity.get());
+		}
+	}
+}
+
+
 //-------------------------------------
 // Control
 //-------------------------------------
 
 void Text::SetSize(const Vec2& size) {
+	if (m_entity->GetSize() == size) {
+		return;
+	}
 	m_entity->SetSize(size);
+	Invalidate(eInvalidation::PLACEMENT);
 }
 
 Vec2 Text::GetSize() const {
@@ -99,8 +117,12 @@ Vec2 Text::GetMinimumSize() const {
 }
 
 void Text::SetPosition(const Vec2& position) {
+	if (m_position == position) {
+		return;
+	}
 	m_position = position;
 	SetResultantTransform();
+	Invalidate(eInvalidation::PLACEMENT);
 }
 
 Vec2 Text::GetPosition() const {
@@ -121,22 +143,31 @@ bool Text::HitTest(const Vec2& point) const {
 }
 
 void Text::UpdateStyle() {
-	m_entity->SetFont(GetStyle().font);
+	if (m_entity->GetFont() != GetStyle().font) {
+		m_entity->SetFont(GetStyle().font);
+		Invalidate(eInvalidation::PREFERRED_SIZE);
+	}
 	m_entity->SetColor(GetStyle().text.v);
 }
 
-void Text::Update(float elapsed) {
-	bool shown = IsShown();
-	if (m_context.scene) {
-		auto& entitySet = m_context.scene->GetEntities<gxeng::ITextEntity>();
-		bool contained = entitySet.Contains(m_entity.get());
-		if (contained && !shown) {
-			entitySet.Remove(m_entity.get());
-		}
-		if (!contained && shown) {
-			entitySet.Add(m_entity.get());
-		}
-	}
+
+//-------------------------------------
+// TextEntity
+//-------------------------------------
+
+void Text::SetFont(std::shared_ptr<const gxeng::IFont> font) {
+	m_entity->SetFont(std::move(font));
+	Invalidate(eInvalidation::PREFERRED_SIZE);
+}
+
+void Text::SetFontSize(float size) {
+	m_entity->SetFontSize(size);
+	Invalidate(eInvalidation::PREFERRED_SIZE);
+}
+
+void Text::SetText(std::u32string text) {
+	m_entity->SetText(std::move(text));
+	Invalidate(eInvalidation::PREFERRED_SIZE);
 }
 
 
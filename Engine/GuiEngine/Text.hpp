@@ -28,6 +28,7 @@ public:
 	void ClearContext() override;
 	void SetClipRect(const RectF& rect, const Mat33& transform) override;
 	void SetPostTransform(const Mat33& transform) override;
+	void SetShown(bool shown) override;
 
 
 	//-------------------------------------
@@ -49,18 +50,17 @@ public:
 	bool HitTest(const Vec2& point) const override;
 	void UpdateStyle() override;
 
-	void Update(float elapsed) override;
 
 	//-------------------------------------
 	// TextEntity
 	//-------------------------------------
-	void SetFont(std::shared_ptr<const gxeng::IFont> font) { m_entity->SetFont(font); }
+	void SetFont(std::shared_ptr<const gxeng::IFont> font);
 	std::shared_ptr<const gxeng::IFont> GetFont() const { return m_entity->GetFont(); }
 
-	void SetFontSize(float size) { m_entity->SetFontSize(size); }
+	void SetFontSize(float size);
 	float GetFontSize() const { return m_entity->GetFontSize(); }
 
-	void SetText(std::u32string text) { m_entity->SetText(text); }
+	void SetText(std::u32string text);
 	const std::u32string& GetText() const { return m_entity->GetText(); }
 
 	void SetColor(Vec4 color) { m_entity->SetColor(color); }
@@ -78,6 +78,8 @@ public:
 
 	float CalculateTextWidth() const { return m_entity->CalculateTextWidth(); }
 	float CalculateTextHeight() const { return m_entity->CalculateTextHeight(); }
+	intptr_t FindCharacter(float coordinate) const { return m_entity->FindCharacter(coordinate); }
+	std::pair<float, float> FindCoordinates(size_t index) const { return m_entity->FindCoordinates(index); }
 
 private:
 	static void CopyProperties(const gxeng::ITextEntity& source, gxeng::ITextEntity& target);
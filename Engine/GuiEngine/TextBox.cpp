@@ -72,12 +72,10 @@ void TextBox::Update(float elapsed) {
 	m_cursor.SetColor(currentColor.xyz | alpha);
 
 	// Calculate cursor position.
-	auto font = GetStyle().font;
-	auto fontSize = m_text.GetFontSize();
-	if (font) {
-		std::u32string u32text = EncodeString<char32_t>(GetText()) + U"_";
-		auto [left, right] = font->FindCoordinates(u32text, m_cursorPosition, fontSize);
-		m_cursor.SetSize({ 2, fontSize });
+	if (m_text.GetFont()) {
+		// The layout of the text is cached, it's only reshaped when the text changes.
+		auto [left, right] = m_text.FindCoordinates(m_cursorPosition);
+		m_cursor.SetSize({ 2, m_text.GetFontSize() });
 		m_cursor.SetPosition({ m_text.GetPosition().x + left - m_text.CalculateTextWidth() / 2, m_text.GetPosition().y });
 	}
 }
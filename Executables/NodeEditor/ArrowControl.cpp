@@ -56,6 +56,8 @@ void ArrowControl::SetEndPoints(Vec2 p1, Vec2 p2) {
 		float angle = atan2(diff.y, diff.x);
 		m_bezierSections[i].SetRotation(angle);
 	}
+
+	Invalidate(gui::eInvalidation::PLACEMENT); // Position and size are derived from the end points.
 }
 
 
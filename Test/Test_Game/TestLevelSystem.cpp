@@ -86,7 +86,9 @@ void TestLevelSystem::Load(inl::game::Scene& scene, inl::game::ComponentFactory&
 	treeComponent.meshPath = "Models/Vegetation/Trees/chestnut.fbx";
 	treeComponent.materialPath = "Models/Vegetation/Trees/chestnut.mtl";
 	treeComponent.entity = graphicsModule.CreateMeshEntity();
-	treeComponent.entity->SetMesh(graphicsModule.LoadMesh(treeComponent.meshPath));
+	std::shared_ptr<gxeng::IMesh> treeMesh = graphicsModule.LoadMesh(treeComponent.meshPath);
+	treeComponent.entity->SetMesh(treeMesh);
+	treeComponent.entity->SetLods(graphicsModule.GetMeshLods(treeMesh));
 	treeComponent.entity->SetMaterial(graphicsModule.LoadMaterial(treeComponent.materialPath));
 	graphicsScene.GetEntities<gxeng::IMeshEntity>().Add(treeComponent.entity.get());
 
@@ -37,6 +37,7 @@ const WindowLayout::Binding& WindowLayout::operator[](const Control* child) cons
 void WindowLayout::SetSize(const Vec2& size) {
 	m_size = size;
 	m_dirty = true;
+	Invalidate(inl::gui::eInvalidation::PLACEMENT | inl::gui::eInvalidation::LAYOUT);
 }
 
 
@@ -72,6 +73,7 @@ Vec2 WindowLayout::GetMinimumSize() const {
 void WindowLayout::SetPosition(const Vec2& position) {
 	m_position = position;
 	m_dirty = true;
+	Invalidate(inl::gui::eInvalidation::PLACEMENT | inl::gui::eInvalidation::LAYOUT);
 }
 
 
@@ -0,0 +1,118 @@
+#include "Test.hpp"
+
+#include "GraphicsApi_D3D12/GxapiManager.hpp"
+#include "GraphicsApi_LL/IGraphicsApi.hpp"
+#include "GraphicsEngine_LL/ConstBufferHeap.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using std::cout;
+using std::endl;
+
+
+//------------------------------------------------------------------------------
+// Test class
+//------------------------------------------------------------------------------
+
+
+class TestConstBufferHeap : public AutoRegisterTest<TestConstBufferHeap> {
+public:
+	TestConstBufferHeap() {}
+
+	static std::string Name() {
+		return "Const Buffer Heap";
+	}
+	virtual int Run() override;
+
+private:
+	static int a;
+};
+
+
+//------------------------------------------------------------------------------
+// Test definition
+//------------------------------------------------------------------------------
+
+
+int TestConstBufferHeap::Run() {
+	constexpr int NumThreads = 16;
+	constexpr int AllocsPerFrame = 100'000;
+	constexpr int NumFrames = 20;
+	constexpr int WarmupFrames = 2; // Pages are created in these, measured frames reuse them.
+
+	cout << "Creating stuff..." << endl;
+	std::unique_ptr<inl::gxapi::IGxapiManager> gxapiManager(new inl::gxapi_dx12::GxapiManager());
+	std::unique_ptr<inl::gxapi::IGraphicsApi> graphicsApi(gxapiManager->CreateGraphicsApi(0));
+	inl::gxeng::ConstantBufferHeap heap(graphicsApi.get());
+
+	struct {
+		float matrix[16];
+	} constants = {};
+
+	cout << NumThreads << " threads, " << AllocsPerFrame << " allocations per frame, " << NumFrames << " frames" << endl;
+
+	// The workers live through all frames, so their thread local page cursors are reused as in the engine.
+	// Each worker times only its own allocations, starting and waiting for the workers is not measured.
+	std::mutex mutex;
+	std::condition_variable frameStarted;
+	std::condition_variable frameFinished;
+	int startedFrame = 0;
+	int finishedWorkers = 0;
+	std::vector<double> workerMs(NumThreads, 0.0);
+
+	std::vector<std::thread> workers;
+	for (int t = 0; t < NumThreads; ++t) {
+		workers.emplace_back([&, t] {
+			for (int frame = 1; frame <= WarmupFrames + NumFrames; ++frame) {
+				{
+					std::unique_lock<std::mutex> lock(mutex);
+					frameStarted.wait(lock, [&] { return startedFrame >= frame; });
+				}
+
+				auto startTime = std::chrono::high_resolution_clock::now();
+				for (int i = 0; i < AllocsPerFrame / NumThreads; ++i) {
+					heap.CreateVolatileConstBuffer(&constants, sizeof(constants));
+				}
+				auto endTime = std::chrono::high_resolution_clock::now();
+
+				std::lock_guard<std::mutex> lock(mutex);
+				workerMs[t] = std::chrono::duration_cast<std::chrono::nanoseconds>(endTime - startTime).count() / 1e6;
+				++finishedWorkers;
+				frameFinished.notify_one();
+			}
+		});
+	}
+
+	double totalMs = 0;
+	for (int frame = 1; frame <= WarmupFrames + NumFrames; ++frame) {
+		std::unique_lock<std::mutex> lock(mutex);
+		finishedWorkers = 0;
+		startedFrame = frame;
+		frameStarted.notify_all();
+		frameFinished.wait(lock, [&] { return finishedWorkers == NumThreads; });
+
+		// The slowest worker decides how long the frame took.
+		if (frame > WarmupFrames) {
+			totalMs += *std::max_element(workerMs.begin(), workerMs.end());
+		}
+		lock.unlock();
+
+		// Pretend the GPU finished the frame right away so pages are recycled.
+		heap.OnFrameCompleteHost(frame);
+		heap.OnFrameCompleteDevice(frame);
+	}
+	for (auto& worker : workers) {
+		worker.join();
+	}
+
+	cout << "Time per frame = " << totalMs / NumFrames << " ms" << endl;
+	cout << "Time per allocation = " << totalMs / NumFrames / AllocsPerFrame * 1e6 << " ns" << endl;
+
+	return 0;
+}
@@ -0,0 +1,155 @@
+#include "Test.hpp"
+
+#include "GuiEngine/Board.hpp"
+#include "GuiEngine/Label.hpp"
+#include "GuiEngine/LinearLayout.hpp"
+#include "GuiEngine/ListViewV.hpp"
+#include "GuiEngine/ScrollFrameV.hpp"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using std::cout;
+using std::endl;
+using namespace inl;
+using namespace inl::gui;
+
+
+//------------------------------------------------------------------------------
+// Test class
+//------------------------------------------------------------------------------
+
+
+class TestGuiUpdate : public AutoRegisterTest<TestGuiUpdate> {
+public:
+	TestGuiUpdate() {}
+
+	static std::string Name() {
+		return "GUI Update";
+	}
+	virtual int Run() override;
+
+private:
+	static constexpr int rowCount = 10000;
+	static constexpr int virtualRowCount = 100000;
+	static constexpr float rowHeight = 20.0f;
+};
+
+
+//------------------------------------------------------------------------------
+// Test definition
+//------------------------------------------------------------------------------
+
+
+int TestGuiUpdate::Run() {
+	auto Elapsed = [](auto startTime) {
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now() - startTime).count() / 1e6;
+	};
+	auto Print = [](const char* stage, double ms) {
+		cout << "    " << std::left << std::setw(16) << stage << std::right << std::fixed << std::setprecision(3) << std::setw(10) << ms << " ms" << endl;
+	};
+
+	// A scroll frame with a long list of labels, no graphics context is needed for the update.
+	Board board;
+	ScrollFrameV frame;
+	auto list = std::make_shared<LinearLayout>(LinearLayout::VERTICAL);
+	std::vector<std::unique_ptr<Label>> labels;
+	for (int i = 0; i < rowCount; ++i) {
+		auto& label = labels.emplace_back(std::make_unique<Label>());
+		std::u32string text = U"Row ";
+		for (char digit : std::to_string(i)) {
+			text += char32_t(digit);
+		}
+		label->SetText(std::move(text));
+		list->AddChild(*label);
+		(*list)[label.get()].SetWidth(rowHeight);
+	}
+	frame.SetContent(list);
+	frame.SetContentHeight(rowCount * rowHeight);
+	frame.SetSize({ 800, 600 });
+	board.AddChild(frame);
+
+	cout << rowCount << " labels in a scroll frame" << endl;
+
+	auto startTime = std::chrono::high_resolution_clock::now();
+	board.Update(0.016f);
+	Print("first frame", Elapsed(startTime));
+
+	constexpr int idleFrames = 100;
+	startTime = std::chrono::high_resolution_clock::now();
+	for (int i = 0; i < idleFrames; ++i) {
+		board.Update(0.016f);
+	}
+	Print("idle frame", Elapsed(startTime) / idleFrames);
+
+	labels[rowCount / 2]->SetVisible(false);
+	startTime = std::chrono::high_resolution_clock::now();
+	board.Update(0.016f);
+	Print("one hidden", Elapsed(startTime));
+
+	labels[rowCount / 2]->SetText(U"Changed");
+	startTime = std::chrono::high_resolution_clock::now();
+	board.Update(0.016f);
+	Print("one relabeled", Elapsed(startTime));
+
+	frame.OnMouseWheel(&frame, Vec2{ 0, 0 }, -1.0f);
+	startTime = std::chrono::high_resolution_clock::now();
+	board.Update(0.016f);
+	Print("scrolled", Elapsed(startTime));
+
+	constexpr int hoverCount = 1000; // Printed in total, a single hit test is below the resolution.
+	startTime = std::chrono::high_resolution_clock::now();
+	for (int i = 0; i < hoverCount; ++i) {
+		MouseMoveEvent evt;
+		evt.absx = float(i % 400 - 200);
+		evt.absy = float(i % 300 - 150);
+		evt.relx = 1.0f;
+		evt.rely = 1.0f;
+		board.OnMouseMove(evt);
+	}
+	Print("1000 hovers", Elapsed(startTime));
+
+	board.RemoveChild(&frame);
+
+	// The same with a virtualized list, which only instantiates the rows in view.
+	ListViewV listView;
+	listView.SetRowFactory([] { return std::make_shared<Label>(); });
+	listView.SetRowBinder([](Control& row, size_t item) {
+		std::u32string text = U"Row ";
+		for (char digit : std::to_string(item)) {
+			text += char32_t(digit);
+		}
+		static_cast<Label&>(row).SetText(std::move(text));
+	});
+	listView.SetRowHeight(rowHeight);
+	listView.SetItemCount(virtualRowCount);
+	listView.SetSize({ 800, 600 });
+	board.AddChild(listView);
+
+	cout << virtualRowCount << " items in a list view" << endl;
+
+	startTime = std::chrono::high_resolution_clock::now();
+	board.Update(0.016f);
+	Print("first frame", Elapsed(startTime));
+
+	startTime = std::chrono::high_resolution_clock::now();
+	for (int i = 0; i < idleFrames; ++i) {
+		board.Update(0.016f);
+	}
+	Print("idle frame", Elapsed(startTime) / idleFrames);
+
+	constexpr int scrollFrames = 100;
+	startTime = std::chrono::high_resolution_clock::now();
+	for (int i = 0; i < scrollFrames; ++i) {
+		listView.OnMouseWheel(&listView, Vec2{ 0, 0 }, -1.0f);
+		board.Update(0.016f);
+	}
+	Print("scrolled", Elapsed(startTime) / scrollFrames);
+
+	board.RemoveChild(&listView);
+	return 0;
+}
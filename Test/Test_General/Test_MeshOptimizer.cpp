@@ -0,0 +1,121 @@
+#include "Test.hpp"
+
+#include "AssetLibrary/Model.hpp"
+#include "GraphicsEngine_LL/MeshOptimizer.hpp"
+
+#include <chrono>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+using std::cout;
+using std::endl;
+using namespace inl;
+using namespace inl::gxeng;
+
+
+//------------------------------------------------------------------------------
+// Test class
+//------------------------------------------------------------------------------
+
+
+class TestMeshOptimizer : public AutoRegisterTest<TestMeshOptimizer> {
+public:
+	TestMeshOptimizer() {}
+
+	static std::string Name() {
+		return "Mesh Optimizer";
+	}
+	virtual int Run() override;
+
+private:
+	static std::filesystem::path FindModelDirectory();
+	static void PrintStatistics(const char* stage, const std::vector<uint32_t>& indices, size_t vertexCount, double ms);
+};
+
+
+//------------------------------------------------------------------------------
+// Test definition
+//------------------------------------------------------------------------------
+
+
+std::filesystem::path TestMeshOptimizer::FindModelDirectory() {
+	for (const char* candidate : { "GameData/Models", "../GameData/Models", "../../GameData/Models", "../../../GameData/Models" }) {
+		if (std::filesystem::is_directory(candidate)) {
+			return candidate;
+		}
+	}
+	return {};
+}
+
+
+void TestMeshOptimizer::PrintStatistics(const char* stage, const std::vector<uint32_t>& indices, size_t vertexCount, double ms) {
+	VertexCacheStatistics fifo16 = AnalyzeVertexCache(indices.data(), indices.size(), vertexCount, 16);
+	VertexCacheStatistics fifo32 = AnalyzeVertexCache(indices.data(), indices.size(), vertexCount, 32);
+	cout << "    " << std::left << std::setw(12) << stage << std::right << std::fixed << std::setprecision(3)
+		 << "ACMR " << fifo16.acmr << " / " << fifo32.acmr
+		 << "   ATVR " << fifo16.atvr << " / " << fifo32.atvr;
+	if (ms >= 0.0) {
+		cout << "   " << std::setprecision(2) << std::setw(8) << ms << " ms";
+	}
+	cout << endl;
+}
+
+
+int TestMeshOptimizer::Run() {
+	std::filesystem::path directory = FindModelDirectory();
+	if (directory.empty()) {
+		cout << "GameData/Models was not found relative to the working directory." << endl;
+		return 1;
+	}
+
+	auto Elapsed = [](auto startTime) {
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now() - startTime).count() / 1e6;
+	};
+
+	cout << "Cache statistics are given for a FIFO of 16 / 32 entries." << endl;
+	for (const auto& entry : std::filesystem::recursive_directory_iterator(directory)) {
+		const auto extension = entry.path().extension();
+		if (extension != ".fbx" && extension != ".obj" && extension != ".dae") {
+			continue;
+		}
+
+		asset::Model model{ entry.path() };
+		for (unsigned submeshId = 0; submeshId < model.SubmeshCount(); ++submeshId) {
+			auto vertices = model.GetVertices<Position<0>>(submeshId);
+			auto sourceIndices = model.GetIndices(submeshId);
+			std::vector<uint32_t> indices(sourceIndices.begin(), sourceIndices.end());
+			std::vector<Vec3> positions;
+			for (const auto& vertex : vertices) {
+				positions.push_back(vertex.position);
+			}
+
+			cout << entry.path().lexically_relative(directory).generic_u8string() << " #" << submeshId << ": "
+				 << vertices.size() << " vertices, " << indices.size() / 3 << " triangles" << endl;
+			PrintStatistics("source", indices, vertices.size(), -1.0);
+
+			auto startTime = std::chrono::high_resolution_clock::now();
+			OptimizeVertexCache(indices.data(), indices.size(), vertices.size());
+			PrintStatistics("cache", indices, vertices.size(), Elapsed(startTime));
+
+			startTime = std::chrono::high_resolution_clock::now();
+			OptimizeOverdraw(indices.data(), indices.size(), positions.data(), positions.size());
+			PrintStatistics("overdraw", indices, vertices.size(), Elapsed(startTime));
+
+			startTime = std::chrono::high_resolution_clock::now();
+			OptimizeVertexFetch(indices.data(), indices.size(), vertices.size());
+			PrintStatistics("fetch", indices, vertices.size(), Elapsed(startTime));
+
+			startTime = std::chrono::high_resolution_clock::now();
+			MeshletBuffers meshlets = BuildMeshlets(indices.data(), indices.size(), positions.data(), positions.size());
+			const double meshletMs = Elapsed(startTime);
+			cout << "    meshlets    " << meshlets.meshlets.size() << ", "
+				 << std::setprecision(1) << double(meshlets.vertices.size()) / std::max<size_t>(1, meshlets.meshlets.size()) << " vertices and "
+				 << double(indices.size() / 3) / std::max<size_t>(1, meshlets.meshlets.size()) << " triangles each"
+				 << "   " << std::setprecision(2) << std::setw(8) << meshletMs << " ms" << endl;
+		}
+	}
+
+	return 0;
+}
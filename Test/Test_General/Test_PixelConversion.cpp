@@ -0,0 +1,130 @@
+#include "Test.hpp"
+
+#include "GraphicsEngine_LL/PixelConversion.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using std::cout;
+using std::endl;
+using namespace inl::gxeng;
+
+
+//------------------------------------------------------------------------------
+// Test class
+//------------------------------------------------------------------------------
+
+
+class TestPixelConversion : public AutoRegisterTest<TestPixelConversion> {
+public:
+	TestPixelConversion() {}
+
+	static std::string Name() {
+		return "Pixel Conversion";
+	}
+	virtual int Run() override;
+
+private:
+	// Runs the conversion a few times and returns the best time in milliseconds.
+	static double Measure(const std::function<void()>& conversion);
+};
+
+
+//------------------------------------------------------------------------------
+// Test definition
+//------------------------------------------------------------------------------
+
+
+double TestPixelConversion::Measure(const std::function<void()>& conversion) {
+	constexpr int NumRuns = 5;
+
+	conversion(); // Warm up caches and page in the destination.
+	double bestMs = 1e30;
+	for (int run = 0; run < NumRuns; ++run) {
+		auto startTime = std::chrono::high_resolution_clock::now();
+		conversion();
+		auto endTime = std::chrono::high_resolution_clock::now();
+		bestMs = std::min(bestMs, std::chrono::duration_cast<std::chrono::nanoseconds>(endTime - startTime).count() / 1e6);
+	}
+	return bestMs;
+}
+
+
+int TestPixelConversion::Run() {
+	struct Resolution {
+		const char* name;
+		size_t width, height;
+	};
+	const Resolution resolutions[] = {
+		{ "4K", 3840, 2160 },
+		{ "8K", 7680, 4320 },
+	};
+	const std::pair<eSimdLevel, const char*> levels[] = {
+		{ eSimdLevel::SCALAR, "scalar" },
+		{ eSimdLevel::SSE2, "SSE2" },
+		{ eSimdLevel::AVX2, "AVX2" },
+	};
+
+	const eSimdLevel originalLevel = GetPixelConversionLevel();
+
+	for (const auto& resolution : resolutions) {
+		const size_t pixelCount = resolution.width * resolution.height;
+		const size_t valueCount = pixelCount * 4;
+		cout << resolution.name << " (" << resolution.width << "x" << resolution.height << "):" << endl;
+
+		std::mt19937 rne;
+		std::uniform_int_distribution<int> byteDistribution(0, 255);
+		std::uniform_real_distribution<float> floatDistribution(0.0f, 1.0f);
+
+		std::vector<uint8_t> bytes(valueCount);
+		std::vector<uint16_t> words(valueCount);
+		std::vector<float> floats(valueCount);
+		for (size_t i = 0; i < valueCount; ++i) {
+			bytes[i] = uint8_t(byteDistribution(rne));
+			floats[i] = floatDistribution(rne);
+		}
+		std::vector<uint8_t> bytesOut(valueCount);
+		std::vector<uint16_t> wordsOut(valueCount);
+		std::vector<float> floatsOut(valueCount);
+		FloatToHalf(floats.data(), words.data(), valueCount);
+
+		// Each conversion with the number of source bytes it reads.
+		const std::tuple<const char*, size_t, std::function<void()>> conversions[] = {
+			{ "RGB8 -> RGBA8", pixelCount * 3, [&] { ExpandRgbToRgba(bytes.data(), bytesOut.data(), pixelCount, 1, 255); } },
+			{ "RGB16 -> RGBA16", pixelCount * 6, [&] { ExpandRgbToRgba(words.data(), wordsOut.data(), pixelCount, 2, 65535); } },
+			{ "RGB32 -> RGBA32", pixelCount * 12, [&] { ExpandRgbToRgba(floats.data(), floatsOut.data(), pixelCount, 4); } },
+			{ "BGRA8 -> RGBA8", pixelCount * 4, [&] { SwizzleRgba8(bytes.data(), bytesOut.data(), pixelCount, { 2, 1, 0, 3 }); } },
+			{ "unorm8 -> float", valueCount, [&] { UnormToFloat(bytes.data(), floatsOut.data(), valueCount); } },
+			{ "unorm16 -> float", valueCount * 2, [&] { UnormToFloat(words.data(), floatsOut.data(), valueCount); } },
+			{ "float -> unorm8", valueCount * 4, [&] { FloatToUnorm(floats.data(), bytesOut.data(), valueCount); } },
+			{ "float -> unorm16", valueCount * 4, [&] { FloatToUnorm(floats.data(), wordsOut.data(), valueCount); } },
+			{ "float -> half", valueCount * 4, [&] { FloatToHalf(floats.data(), wordsOut.data(), valueCount); } },
+			{ "half -> float", valueCount * 2, [&] { HalfToFloat(words.data(), floatsOut.data(), valueCount); } },
+			{ "sRGB -> linear", valueCount * 4, [&] { SrgbToLinear(floats.data(), floatsOut.data(), valueCount); } },
+			{ "linear -> sRGB", valueCount * 4, [&] { LinearToSrgb(floats.data(), floatsOut.data(), valueCount); } },
+			{ "sRGB8 -> linear", valueCount, [&] { SrgbToLinear(bytes.data(), floatsOut.data(), valueCount); } },
+		};
+
+		for (const auto& [name, sourceBytes, conversion] : conversions) {
+			cout << "  " << std::left << std::setw(18) << name << std::right;
+			for (const auto& [level, levelName] : levels) {
+				if (SetPixelConversionLevel(level) != level) {
+					continue;
+				}
+				double ms = Measure(conversion);
+				cout << "  " << levelName << ": " << std::fixed << std::setprecision(2) << std::setw(7) << ms << " ms"
+					 << " (" << std::setw(5) << sourceBytes / ms / 1e6 << " GB/s)";
+			}
+			cout << endl;
+		}
+	}
+
+	SetPixelConversionLevel(originalLevel);
+
+	return 0;
+}
@@ -0,0 +1,94 @@
+#include <AssetLibrary/AssetCache.hpp>
+
+#include <BaseLibrary/JobSystem/ThreadpoolScheduler.hpp>
+
+#include <Catch2/catch.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <thread>
+
+using namespace inl;
+using namespace inl::asset;
+
+
+namespace {
+
+class TestAsset {
+public:
+	std::string content;
+};
+
+
+class TestAssetCache : public AssetCache<TestAsset> {
+public:
+	std::atomic_int createCount = 0;
+
+protected:
+	std::shared_ptr<TestAsset> Create(const std::filesystem::path& path) override {
+		++createCount;
+		std::this_thread::sleep_for(std::chrono::milliseconds(20)); // Let the other requests arrive.
+		auto asset = std::make_shared<TestAsset>();
+		Reload(*asset, path);
+		return asset;
+	}
+	void Reload(TestAsset& asset, const std::filesystem::path& path) override {
+		std::ifstream file(path);
+		std::getline(file, asset.content);
+	}
+};
+
+
+struct TestDirectory {
+	TestDirectory() {
+		path = std::filesystem::temp_directory_path() / "inl_test_asset_cache";
+		std::filesystem::create_directories(path);
+		std::ofstream(path / "a.txt") << "a";
+		std::ofstream(path / "b.txt") << "b";
+	}
+	~TestDirectory() {
+		std::filesystem::remove_all(path);
+	}
+	std::filesystem::path path;
+};
+
+} // namespace
+
+
+TEST_CASE("Concurrent loads of the same path share one load", "[AssetCache]") {
+	TestDirectory directory;
+	jobs::ThreadpoolScheduler scheduler(4);
+	TestAssetCache cache;
+	cache.SetSearchDirectories({ directory.path });
+	cache.SetScheduler(scheduler);
+
+	std::vector<TestAssetCache::AssetFuture> futures;
+	for (int i = 0; i < 8; ++i) {
+		futures.push_back(cache.LoadAsync(i % 2 == 0 ? "a.txt" : "b.txt"));
+	}
+
+	std::shared_ptr<TestAsset> a = futures[0].get();
+	std::shared_ptr<TestAsset> b = futures[1].get();
+	for (size_t i = 0; i < futures.size(); ++i) {
+		REQUIRE(futures[i].get() == (i % 2 == 0 ? a : b));
+	}
+	REQUIRE(a->content == "a");
+	REQUIRE(b->content == "b");
+	REQUIRE(cache.createCount == 2);
+
+	REQUIRE(cache.Load("a.txt") == a);
+	REQUIRE(cache.createCount == 2);
+}
+
+
+TEST_CASE("Failed loads can be retried", "[AssetCache]") {
+	TestDirectory directory;
+	TestAssetCache cache;
+	cache.SetSearchDirectories({ directory.path });
+
+	REQUIRE_THROWS_AS(cache.LoadAsync("c.txt").get(), FileNotFoundException);
+
+	std::ofstream(directory.path / "c.txt") << "c";
+	REQUIRE(cache.Load("c.txt")->content == "c");
+}
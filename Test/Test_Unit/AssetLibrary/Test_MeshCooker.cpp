@@ -0,0 +1,118 @@
+#include <AssetLibrary/MeshCooker.hpp>
+
+#include <Catch2/catch.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+using namespace inl;
+using namespace inl::asset;
+
+
+static std::vector<CookedMesh::Vertex> MakeQuad(float z) {
+	std::vector<CookedMesh::Vertex> vertices(4);
+	for (int i = 0; i < 4; ++i) {
+		vertices[i].position = { float(i % 2), float(i / 2), z };
+		vertices[i].normal = { 0, 0, 1 };
+		vertices[i].texCoord = { float(i % 2), float(i / 2) };
+		vertices[i].tangent = { 1, 0, 0 };
+	}
+	return vertices;
+}
+
+
+static void MakeGrid(uint32_t size, std::vector<CookedMesh::Vertex>& vertices, std::vector<unsigned>& indices) {
+	for (uint32_t y = 0; y <= size; ++y) {
+		for (uint32_t x = 0; x <= size; ++x) {
+			CookedMesh::Vertex vertex;
+			vertex.position = { float(x), float(y), 0.2f * std::sin(float(x)) * std::cos(float(y)) };
+			vertex.normal = { 0, 0, 1 };
+			vertex.texCoord = { float(x) / size, float(y) / size };
+			vertex.tangent = { 1, 0, 0 };
+			vertices.push_back(vertex);
+		}
+	}
+	for (uint32_t y = 0; y < size; ++y) {
+		for (uint32_t x = 0; x < size; ++x) {
+			unsigned v = y * (size + 1) + x;
+			indices.insert(indices.end(), { v, v + 1, v + size + 1, v + 1, v + size + 2, v + size + 1 });
+		}
+	}
+}
+
+
+TEST_CASE("Cooked mesh survives a save and load", "[MeshCooker]") {
+	MeshCookOptions options;
+	options.optimize = false;
+	options.generateMeshlets = true;
+	CookedMesh cooked = CookedMesh::Cook({ MakeQuad(0), MakeQuad(2) }, { { 0, 1, 2, 2, 1, 3 }, { 0, 1, 3 } }, options);
+
+	REQUIRE(cooked.GetSubmeshCount() == 2);
+	REQUIRE(cooked.GetVertexCount() == 8);
+	REQUIRE(cooked.GetIndexCount() == 9);
+	REQUIRE(!cooked.IsIndex32Bit());
+	REQUIRE(cooked.GetSubmesh(1).firstIndex == 6);
+	REQUIRE(cooked.GetSubmesh(1).baseVertex == 4);
+	REQUIRE(static_cast<const uint16_t*>(cooked.GetIndexData())[8] == 7);
+	REQUIRE(cooked.GetSubmesh(1).boundsMin.z == 2);
+	REQUIRE(cooked.GetBoundsMax().z == 2);
+	REQUIRE(cooked.GetMeshletCount() == 2);
+	REQUIRE(cooked.GetSubmesh(1).firstMeshlet == 1);
+	REQUIRE(cooked.GetMeshletVertices()[cooked.GetMeshlet(1).vertexOffset] == 4);
+	// Quantized position, octahedral normal, half texture coordinates and tangent frame.
+	REQUIRE(cooked.GetVertexStride() == 8 + 4 + 4 + 8);
+
+	auto path = std::filesystem::temp_directory_path() / "inl_test_mesh.cmesh";
+	cooked.Save(path);
+	{
+		CookedMesh loaded;
+		loaded.Load(path);
+		REQUIRE(loaded.GetVertexStride() == cooked.GetVertexStride());
+		REQUIRE(loaded.GetVertexCount() == cooked.GetVertexCount());
+		REQUIRE(loaded.GetIndexCount() == cooked.GetIndexCount());
+		REQUIRE(loaded.GetElements().size() == cooked.GetElements().size());
+		REQUIRE(loaded.GetQuantization().position == gxeng::ePositionEncoding::UNORM16);
+		REQUIRE(loaded.GetQuantization().boundsMax.z == 2);
+		REQUIRE(loaded.GetSubmesh(0).indexCount == 6);
+		REQUIRE(loaded.GetMeshletCount() == 2);
+		REQUIRE(loaded.GetMeshlet(1).triangleCount == 1);
+		REQUIRE(std::memcmp(loaded.GetVertexData(), cooked.GetVertexData(), cooked.GetVertexCount() * cooked.GetVertexStride()) == 0);
+		REQUIRE(std::memcmp(loaded.GetIndexData(), cooked.GetIndexData(), cooked.GetIndexCount() * sizeof(uint16_t)) == 0);
+	}
+	std::filesystem::remove(path);
+}
+
+
+TEST_CASE("Cooking rejects out of range indices", "[MeshCooker]") {
+	REQUIRE_THROWS_AS(CookedMesh::Cook({ MakeQuad(0) }, { { 0, 1, 4 } }), InvalidArgumentException);
+}
+
+
+TEST_CASE("Cooked mesh keeps its levels of detail", "[MeshCooker]") {
+	std::vector<CookedMesh::Vertex> vertices;
+	std::vector<unsigned> indices;
+	MakeGrid(32, vertices, indices);
+	CookedMesh cooked = CookedMesh::Cook({ vertices }, { indices });
+
+	REQUIRE(cooked.GetLodCount() > 0);
+	for (size_t i = 0; i < cooked.GetLodCount(); ++i) {
+		const CookedLod& lod = cooked.GetLod(i);
+		REQUIRE(lod.vertexCount < cooked.GetVertexCount());
+		REQUIRE(lod.indexCount < cooked.GetIndexCount());
+		const uint16_t* lodIndices = static_cast<const uint16_t*>(cooked.GetLodIndexData(i));
+		REQUIRE(*std::max_element(lodIndices, lodIndices + lod.indexCount) < lod.vertexCount);
+	}
+
+	auto path = std::filesystem::temp_directory_path() / "inl_test_mesh_lods.cmesh";
+	cooked.Save(path);
+	{
+		CookedMesh loaded;
+		loaded.Load(path);
+		REQUIRE(loaded.GetLodCount() == cooked.GetLodCount());
+		const CookedLod& last = loaded.GetLod(loaded.GetLodCount() - 1);
+		REQUIRE(last.screenSize == cooked.GetLod(cooked.GetLodCount() - 1).screenSize);
+		REQUIRE(std::memcmp(loaded.GetLodVertexData(0), cooked.GetLodVertexData(0), cooked.GetLod(0).vertexCount * cooked.GetVertexStride()) == 0);
+	}
+	std::filesystem::remove(path);
+}
@@ -0,0 +1,94 @@
+#include <AssetLibrary/MeshSimplifier.hpp>
+
+#include <Catch2/catch.hpp>
+
+#include <cmath>
+
+using namespace inl;
+using namespace inl::asset;
+
+
+namespace {
+
+struct Grid {
+	std::vector<Vec3> positions;
+	std::vector<uint32_t> indices;
+};
+
+Grid MakeGrid(uint32_t size, float bumpiness) {
+	Grid grid;
+	for (uint32_t y = 0; y <= size; ++y) {
+		for (uint32_t x = 0; x <= size; ++x) {
+			float height = bumpiness * std::sin(float(x) * 0.4f) * std::cos(float(y) * 0.3f);
+			grid.positions.push_back({ float(x) / size, float(y) / size, height });
+		}
+	}
+	for (uint32_t y = 0; y < size; ++y) {
+		for (uint32_t x = 0; x < size; ++x) {
+			uint32_t v = y * (size + 1) + x;
+			grid.indices.insert(grid.indices.end(), { v, v + 1, v + size + 1, v + 1, v + size + 2, v + size + 1 });
+		}
+	}
+	return grid;
+}
+
+} // namespace
+
+
+TEST_CASE("Flat surfaces simplify without error", "[MeshSimplifier]") {
+	Grid grid = MakeGrid(32, 0.0f);
+	std::vector<uint32_t> indices = grid.indices;
+
+	SimplifyOptions options;
+	options.targetIndexCount = grid.indices.size() / 10;
+	options.maxError = 1e-4f;
+	float error = SimplifyMesh(indices, grid.positions, options);
+
+	REQUIRE(indices.size() <= grid.indices.size() / 10);
+	REQUIRE(error <= 1e-4f);
+	// Corners of the border must stay.
+	for (uint32_t corner : { 0u, 32u, 33u * 32u, 33u * 33u - 1u }) {
+		REQUIRE(std::find(indices.begin(), indices.end(), corner) != indices.end());
+	}
+}
+
+
+TEST_CASE("LOD chain gets coarser within the error limit", "[MeshSimplifier]") {
+	Grid grid = MakeGrid(48, 0.05f);
+
+	LodChainOptions options;
+	options.levelCount = 4;
+	options.maxError = 0.05f;
+	auto levels = GenerateLodChain(grid.positions, grid.indices, options);
+
+	REQUIRE(!levels.empty());
+	size_t previousCount = grid.indices.size();
+	float previousScreenSize = std::numeric_limits<float>::infinity();
+	for (const auto& level : levels) {
+		REQUIRE(level.indices.size() < previousCount);
+		REQUIRE(level.error <= options.maxError);
+		REQUIRE(level.screenSize < previousScreenSize);
+		previousCount = level.indices.size();
+		previousScreenSize = level.screenSize;
+
+		std::vector<uint32_t> indices = level.indices;
+		auto vertices = CompactVertices(grid.positions, indices);
+		REQUIRE(*std::max_element(indices.begin(), indices.end()) < vertices.size());
+	}
+}
+
+
+TEST_CASE("LOD chain merges levels that add no error", "[MeshSimplifier]") {
+	Grid grid = MakeGrid(32, 0.0f);
+
+	LodChainOptions options;
+	options.levelCount = 6;
+	auto levels = GenerateLodChain(grid.positions, grid.indices, options);
+
+	// Only the first level can be lossless, otherwise entities would reject the equal screen sizes.
+	REQUIRE(!levels.empty());
+	for (size_t i = 1; i < levels.size(); ++i) {
+		REQUIRE(levels[i].error > levels[i - 1].error);
+		REQUIRE(levels[i].screenSize < levels[i - 1].screenSize);
+	}
+}
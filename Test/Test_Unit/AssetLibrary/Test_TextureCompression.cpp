@@ -0,0 +1,68 @@
+#include <AssetLibrary/TextureCompression.hpp>
+
+#include <Catch2/catch.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+
+using namespace inl::asset;
+
+
+static void MakeGradientBlock(uint8_t* pixels) {
+	for (int i = 0; i < 16; ++i) {
+		pixels[4 * i + 0] = uint8_t(40 + 8 * i);
+		pixels[4 * i + 1] = uint8_t(200 - 6 * i);
+		pixels[4 * i + 2] = uint8_t(100 + 2 * (i % 4));
+		pixels[4 * i + 3] = uint8_t(255 - 10 * (i / 4));
+	}
+}
+
+
+static int MaxError(const uint8_t* a, const uint8_t* b, int channels) {
+	int maxError = 0;
+	for (int i = 0; i < 16; ++i) {
+		for (int c = 0; c < channels; ++c) {
+			maxError = std::max(maxError, std::abs(int(a[4 * i + c]) - int(b[4 * i + c])));
+		}
+	}
+	return maxError;
+}
+
+
+TEST_CASE("BC1 round trip", "[TextureCompression]") {
+	uint8_t pixels[64], decoded[64], block[8];
+	MakeGradientBlock(pixels);
+	EncodeBC1(pixels, block);
+	DecodeBC1(block, decoded);
+	REQUIRE(MaxError(pixels, decoded, 3) <= 16);
+	for (int i = 0; i < 16; ++i) {
+		REQUIRE(decoded[4 * i + 3] == 255);
+	}
+}
+
+
+TEST_CASE("BC4 round trip", "[TextureCompression]") {
+	uint8_t pixels[64], decoded[64], block[8];
+	MakeGradientBlock(pixels);
+	EncodeBC4(pixels, 4, block);
+	DecodeBC4(block, decoded, 4);
+	for (int i = 0; i < 16; ++i) {
+		REQUIRE(std::abs(int(pixels[4 * i]) - int(decoded[4 * i])) <= 9);
+	}
+}
+
+
+TEST_CASE("BC7 round trip", "[TextureCompression]") {
+	uint8_t pixels[64], decoded[64], block[16];
+	MakeGradientBlock(pixels);
+	EncodeBC7(pixels, block);
+	DecodeBC7(block, decoded);
+	REQUIRE(MaxError(pixels, decoded, 4) <= 12);
+}
+
+
+TEST_CASE("Compressed image size", "[TextureCompression]") {
+	REQUIRE(GetCompressedSize(inl::gxeng::eBlockCompression::BC1, 16, 8) == 8 * 8);
+	REQUIRE(GetCompressedSize(inl::gxeng::eBlockCompression::BC7, 2, 1) == 16);
+	REQUIRE(GetCompressedSize(inl::gxeng::eBlockCompression::BC5, 5, 5) == 4 * 16);
+}
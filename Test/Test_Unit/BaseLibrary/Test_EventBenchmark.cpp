@@ -0,0 +1,74 @@
+#include <BaseLibrary/Event.hpp>
+
+#include <Catch2/catch.hpp>
+
+using namespace inl;
+
+
+namespace {
+
+class Counter {
+public:
+	void Count(int value) {
+		m_sum += value;
+	}
+	int m_sum = 0;
+};
+
+void Ignore(int) {}
+
+constexpr int Iterations = 100000;
+
+} // namespace
+
+
+// GUI controls typically have zero to two subscribers per event, these are the cases that matter.
+
+TEST_CASE("Fire cost", "[Event][Benchmark]") {
+	Counter counter1;
+	Counter counter2;
+
+	Event<int> empty;
+	Event<int> single;
+	single += Delegate<void(int)>{ &Counter::Count, &counter1 };
+	Event<int> pair;
+	pair += Delegate<void(int)>{ &Counter::Count, &counter1 };
+	pair += Delegate<void(int)>{ &Counter::Count, &counter2 };
+
+	BENCHMARK("Fire with no subscribers") {
+		for (int i = 0; i < Iterations; ++i) {
+			empty(i);
+		}
+	}
+	BENCHMARK("Fire with one subscriber") {
+		for (int i = 0; i < Iterations; ++i) {
+			single(1);
+		}
+	}
+	BENCHMARK("Fire with two subscribers") {
+		for (int i = 0; i < Iterations; ++i) {
+			pair(1);
+		}
+	}
+
+	REQUIRE(counter1.m_sum > 0);
+	REQUIRE(counter1.m_sum > counter2.m_sum);
+}
+
+
+TEST_CASE("Subscribe cost", "[Event][Benchmark]") {
+	Counter counter;
+	Event<int> evt;
+	evt += Ignore;
+
+	// Same pattern as ControlStateTracker: a member delegate added and removed again.
+	BENCHMARK("Subscribe and unsubscribe") {
+		for (int i = 0; i < Iterations; ++i) {
+			evt += Delegate<void(int)>{ &Counter::Count, &counter };
+			evt -= Delegate<void(int)>{ &Counter::Count, &counter };
+		}
+	}
+
+	evt(1);
+	REQUIRE(counter.m_sum == 0);
+}
@@ -0,0 +1,52 @@
+#include <GraphicsEngine_LL/BuddyAllocator.hpp>
+
+#include <Catch2/catch.hpp>
+
+using namespace inl::gxeng;
+
+
+TEST_CASE("Blocks are split and rounded up", "[BuddyAllocator]") {
+	impl::BuddyAllocator allocator(1024, 64);
+	auto first = allocator.Allocate(100);
+	auto second = allocator.Allocate(64);
+	REQUIRE(first);
+	REQUIRE(second);
+	REQUIRE(*first == 0);
+	REQUIRE(*second == 128);
+	REQUIRE(allocator.GetUsedSize() == 128 + 64);
+	REQUIRE(allocator.GetRequestedSize() == 100 + 64);
+	REQUIRE(allocator.GetLargestFreeBlock() == 512);
+}
+
+
+TEST_CASE("Buddies merge on deallocation", "[BuddyAllocator]") {
+	impl::BuddyAllocator allocator(1024, 64);
+	auto first = allocator.Allocate(64);
+	auto second = allocator.Allocate(64);
+	auto third = allocator.Allocate(512);
+	REQUIRE(third);
+	REQUIRE(!allocator.Allocate(512));
+	allocator.Deallocate(*first);
+	allocator.Deallocate(*second);
+	allocator.Deallocate(*third);
+	REQUIRE(allocator.IsEmpty());
+	REQUIRE(allocator.GetLargestFreeBlock() == 1024);
+	REQUIRE(allocator.Allocate(1024));
+}
+
+
+TEST_CASE("Alignment is respected", "[BuddyAllocator]") {
+	impl::BuddyAllocator allocator(1024, 64);
+	REQUIRE(allocator.Allocate(64));
+	auto aligned = allocator.Allocate(64, 256);
+	REQUIRE(aligned);
+	REQUIRE(*aligned % 256 == 0);
+}
+
+
+TEST_CASE("Oversized requests fail", "[BuddyAllocator]") {
+	impl::BuddyAllocator allocator(1024, 64);
+	REQUIRE(!allocator.Allocate(2048));
+	REQUIRE(!allocator.Allocate(0));
+	REQUIRE(allocator.IsEmpty());
+}
@@ -0,0 +1,110 @@
+#include <GraphicsEngine_LL/MeshOptimizer.hpp>
+
+#include <Catch2/catch.hpp>
+
+#include <algorithm>
+#include <array>
+#include <random>
+
+using namespace inl;
+using namespace inl::gxeng;
+
+
+namespace {
+
+struct Grid {
+	std::vector<Vec3> positions;
+	std::vector<uint32_t> indices;
+};
+
+// A grid of quads with its triangles in random order, the worst case for the cache.
+Grid MakeShuffledGrid(uint32_t size) {
+	Grid grid;
+	for (uint32_t y = 0; y <= size; ++y) {
+		for (uint32_t x = 0; x <= size; ++x) {
+			grid.positions.push_back({ float(x), float(y), 0.0f });
+		}
+	}
+	std::vector<std::array<uint32_t, 3>> triangles;
+	for (uint32_t y = 0; y < size; ++y) {
+		for (uint32_t x = 0; x < size; ++x) {
+			uint32_t v = y * (size + 1) + x;
+			triangles.push_back({ v, v + 1, v + size + 1 });
+			triangles.push_back({ v + 1, v + size + 2, v + size + 1 });
+		}
+	}
+	std::shuffle(triangles.begin(), triangles.end(), std::mt19937{});
+	for (const auto& triangle : triangles) {
+		grid.indices.insert(grid.indices.end(), triangle.begin(), triangle.end());
+	}
+	return grid;
+}
+
+// Triangles as rotation independent, sorted list for comparing index buffers.
+std::vector<std::array<uint32_t, 3>> SortedTriangles(const std::vector<uint32_t>& indices) {
+	std::vector<std::array<uint32_t, 3>> triangles;
+	for (size_t i = 0; i < indices.size(); i += 3) {
+		std::array<uint32_t, 3> triangle = { indices[i], indices[i + 1], indices[i + 2] };
+		std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+		triangles.push_back(triangle);
+	}
+	std::sort(triangles.begin(), triangles.end());
+	return triangles;
+}
+
+} // namespace
+
+
+TEST_CASE("Cache and overdraw optimization keep the triangles", "[MeshOptimizer]") {
+	Grid grid = MakeShuffledGrid(64);
+	const auto original = SortedTriangles(grid.indices);
+	const auto before = AnalyzeVertexCache(grid.indices.data(), grid.indices.size(), grid.positions.size());
+
+	OptimizeVertexCache(grid.indices.data(), grid.indices.size(), grid.positions.size());
+	const auto after = AnalyzeVertexCache(grid.indices.data(), grid.indices.size(), grid.positions.size());
+	REQUIRE(SortedTriangles(grid.indices) == original);
+	REQUIRE(after.acmr < 0.5f * before.acmr);
+	REQUIRE(after.acmr < 1.0f);
+
+	OptimizeOverdraw(grid.indices.data(), grid.indices.size(), grid.positions.data(), grid.positions.size(), 1.05f);
+	const auto afterOverdraw = AnalyzeVertexCache(grid.indices.data(), grid.indices.size(), grid.positions.size());
+	REQUIRE(SortedTriangles(grid.indices) == original);
+	REQUIRE(afterOverdraw.acmr <= 1.1f * after.acmr);
+}
+
+
+TEST_CASE("Vertex fetch order follows first use", "[MeshOptimizer]") {
+	std::vector<uint32_t> indices = { 3, 1, 4, 4, 1, 0 };
+	std::vector<uint32_t> remap = OptimizeVertexFetch(indices.data(), indices.size(), 6);
+	REQUIRE(indices == std::vector<uint32_t>{ 0, 1, 2, 2, 1, 3 });
+	REQUIRE(remap == std::vector<uint32_t>{ 3, 1, 4, 0, 2, 5 });
+
+	const std::vector<int> vertices = { 10, 11, 12, 13, 14, 15 };
+	std::vector<int> remapped(vertices.size());
+	RemapVertices(vertices.data(), remapped.data(), vertices.size(), sizeof(int), remap);
+	REQUIRE(remapped == std::vector<int>{ 13, 11, 14, 10, 12, 15 });
+}
+
+
+TEST_CASE("Meshlets respect limits and cover the mesh", "[MeshOptimizer]") {
+	Grid grid = MakeShuffledGrid(32);
+	OptimizeVertexCache(grid.indices.data(), grid.indices.size(), grid.positions.size());
+	MeshletBuffers buffers = BuildMeshlets(grid.indices.data(), grid.indices.size(), grid.positions.data(), grid.positions.size(), 64, 124);
+
+	std::vector<uint32_t> rebuilt;
+	for (const auto& meshlet : buffers.meshlets) {
+		REQUIRE(meshlet.vertexCount <= 64);
+		REQUIRE(meshlet.triangleCount <= 124);
+		for (uint32_t i = 0; i < meshlet.triangleCount * 3; ++i) {
+			uint8_t local = buffers.triangles[meshlet.triangleOffset * 3 + i];
+			REQUIRE(local < meshlet.vertexCount);
+			uint32_t vertex = buffers.vertices[meshlet.vertexOffset + local];
+			REQUIRE(Length(grid.positions[vertex] - Vec3(meshlet.center)) <= meshlet.radius + 1e-4f);
+			rebuilt.push_back(vertex);
+		}
+		// The grid is flat, so every cone is a single direction.
+		REQUIRE(std::abs(meshlet.coneAxis.z) == Approx(1.0f));
+		REQUIRE(meshlet.coneCutoff == Approx(0.0f).margin(1e-3f));
+	}
+	REQUIRE(rebuilt == grid.indices);
+}
@@ -0,0 +1,118 @@
+#include <GraphicsEngine_LL/PixelConversion.hpp>
+
+#include <Catch2/catch.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace inl::gxeng;
+
+
+// Odd sizes so that the SIMD paths also hand a remainder to the scalar code.
+static constexpr size_t Count = 1031;
+
+
+static std::vector<eSimdLevel> SupportedLevels() {
+	const eSimdLevel original = GetPixelConversionLevel();
+	std::vector<eSimdLevel> levels;
+	for (eSimdLevel level : { eSimdLevel::SCALAR, eSimdLevel::SSE2, eSimdLevel::AVX2 }) {
+		if (SetPixelConversionLevel(level) == level) {
+			levels.push_back(level);
+		}
+	}
+	SetPixelConversionLevel(original);
+	return levels;
+}
+
+
+TEST_CASE("RGB to RGBA matches scalar", "[PixelConversion]") {
+	std::vector<uint8_t> source(Count * 3 * 4);
+	for (size_t i = 0; i < source.size(); ++i) {
+		source[i] = uint8_t(i * 7 + 3);
+	}
+
+	const eSimdLevel original = GetPixelConversionLevel();
+	for (size_t channelSize : { 1, 2, 4 }) {
+		std::vector<uint8_t> expected(Count * 4 * channelSize);
+		SetPixelConversionLevel(eSimdLevel::SCALAR);
+		ExpandRgbToRgba(source.data(), expected.data(), Count, channelSize, 0xA1B2C3D4);
+
+		for (eSimdLevel level : SupportedLevels()) {
+			std::vector<uint8_t> result(expected.size());
+			SetPixelConversionLevel(level);
+			ExpandRgbToRgba(source.data(), result.data(), Count, channelSize, 0xA1B2C3D4);
+			REQUIRE(result == expected);
+		}
+	}
+	SetPixelConversionLevel(original);
+}
+
+
+TEST_CASE("Swizzle reorders channels", "[PixelConversion]") {
+	std::vector<uint8_t> source(Count * 4);
+	for (size_t i = 0; i < source.size(); ++i) {
+		source[i] = uint8_t(i);
+	}
+
+	const eSimdLevel original = GetPixelConversionLevel();
+	for (eSimdLevel level : SupportedLevels()) {
+		std::vector<uint8_t> result(source.size());
+		SetPixelConversionLevel(level);
+		SwizzleRgba8(source.data(), result.data(), Count, { 2, 1, 0, 3 });
+		for (size_t i = 0; i < Count; ++i) {
+			REQUIRE(result[4 * i + 0] == source[4 * i + 2]);
+			REQUIRE(result[4 * i + 1] == source[4 * i + 1]);
+			REQUIRE(result[4 * i + 2] == source[4 * i + 0]);
+			REQUIRE(result[4 * i + 3] == source[4 * i + 3]);
+		}
+	}
+	SetPixelConversionLevel(original);
+}
+
+
+TEST_CASE("Float conversions match scalar", "[PixelConversion]") {
+	std::vector<float> source(Count);
+	for (size_t i = 0; i < Count; ++i) {
+		source[i] = float(i) / float(Count - 100) - 0.05f; // Slightly out of [0, 1] at both ends.
+	}
+	source[10] = 1e-6f; // Half denormal.
+	source[20] = 1e6f; // Half infinity.
+
+	const eSimdLevel original = GetPixelConversionLevel();
+	SetPixelConversionLevel(eSimdLevel::SCALAR);
+	std::vector<uint8_t> unorm8(Count);
+	std::vector<uint16_t> unorm16(Count), half(Count);
+	std::vector<float> srgb(Count), linear(Count), halfFloat(Count);
+	FloatToUnorm(source.data(), unorm8.data(), Count);
+	FloatToUnorm(source.data(), unorm16.data(), Count);
+	FloatToHalf(source.data(), half.data(), Count);
+	HalfToFloat(half.data(), halfFloat.data(), Count);
+	LinearToSrgb(source.data(), srgb.data(), Count);
+	SrgbToLinear(source.data(), linear.data(), Count);
+
+	for (eSimdLevel level : SupportedLevels()) {
+		SetPixelConversionLevel(level);
+		std::vector<uint8_t> unorm8Result(Count);
+		std::vector<uint16_t> unorm16Result(Count), halfResult(Count);
+		std::vector<float> srgbResult(Count), linearResult(Count), halfFloatResult(Count);
+		FloatToUnorm(source.data(), unorm8Result.data(), Count);
+		FloatToUnorm(source.data(), unorm16Result.data(), Count);
+		FloatToHalf(source.data(), halfResult.data(), Count);
+		HalfToFloat(half.data(), halfFloatResult.data(), Count);
+		LinearToSrgb(source.data(), srgbResult.data(), Count);
+		SrgbToLinear(source.data(), linearResult.data(), Count);
+
+		REQUIRE(unorm8Result == unorm8);
+		REQUIRE(unorm16Result == unorm16);
+		REQUIRE(halfResult == half);
+		REQUIRE(halfFloatResult == halfFloat);
+		for (size_t i = 0; i < Count; ++i) {
+			if (source[i] >= 0.0f) { // The curve is not defined for negative values.
+				REQUIRE(std::abs(srgbResult[i] - srgb[i]) <= 1e-5f * std::max(1.0f, srgb[i]));
+				REQUIRE(std::abs(linearResult[i] - linear[i]) <= 1e-5f * std::max(1.0f, linear[i]));
+			}
+		}
+	}
+	SetPixelConversionLevel(original);
+}
@@ -0,0 +1,213 @@
+#include <GraphicsEngine_LL/ResidencyManager.hpp>
+
+#include <GraphicsApi_LL/IHeap.hpp>
+#include <GraphicsApi_LL/IResource.hpp>
+#include <GraphicsEngine_LL/CriticalBufferHeap.hpp>
+
+#include <Catch2/catch.hpp>
+
+using namespace inl::gxeng;
+namespace gxapi = inl::gxapi;
+
+
+static const void* Key(uintptr_t id) {
+	return reinterpret_cast<const void*>(id);
+}
+
+
+TEST_CASE("Least recently used is evicted first", "[ResidencyManager]") {
+	impl::ResidencyTracker tracker(300);
+	for (uintptr_t id = 1; id <= 3; ++id) {
+		tracker.Lock(Key(id), 100, id);
+	}
+	tracker.Unlock(Key(2), 5);
+	tracker.Unlock(Key(1), 6);
+	tracker.Unlock(Key(3), 7);
+
+	auto victims = tracker.EvictForBudget(100);
+	REQUIRE(victims.size() == 1);
+	REQUIRE(victims[0] == Key(2));
+	REQUIRE(tracker.GetResidentSize() == 200);
+	REQUIRE(!tracker.IsTracked(Key(2)));
+	REQUIRE(*tracker.GetLastUsedFrame(Key(3)) == 7);
+}
+
+
+TEST_CASE("Only as much is evicted as needed", "[ResidencyManager]") {
+	impl::ResidencyTracker tracker;
+	for (uintptr_t id = 1; id <= 4; ++id) {
+		tracker.Lock(Key(id), 100, 0);
+		tracker.Unlock(Key(id), 0);
+	}
+	auto victims = tracker.EvictAtLeast(150);
+	REQUIRE(victims.size() == 2);
+	REQUIRE(tracker.GetResidentSize() == 200);
+}
+
+
+TEST_CASE("Locked resources are never evicted", "[ResidencyManager]") {
+	impl::ResidencyTracker tracker(100);
+	tracker.Lock(Key(1), 100, 0);
+	tracker.Lock(Key(1), 0, 1);
+	tracker.Unlock(Key(1), 1);
+	REQUIRE(tracker.IsLocked(Key(1)));
+	REQUIRE(tracker.EvictForBudget(100).empty());
+
+	tracker.Unlock(Key(1), 2);
+	REQUIRE(!tracker.IsLocked(Key(1)));
+	REQUIRE(tracker.EvictForBudget(100).size() == 1);
+	REQUIRE(tracker.GetResidentSize() == 0);
+}
+
+
+namespace {
+
+class FakeResource : public gxapi::IResource {
+public:
+	FakeResource(gxapi::ResourceDesc desc, bool placed) : m_desc(desc), m_placed(placed) {}
+	gxapi::ResourceDesc GetDesc() const override { return m_desc; }
+	void* Map(unsigned, const gxapi::MemoryRange*) override { return nullptr; }
+	void Unmap(unsigned, const gxapi::MemoryRange*) override {}
+	void* GetGPUAddress() const override { return nullptr; }
+	unsigned GetNumMipLevels() const override { return 1; }
+	unsigned GetNumTexturePlanes() const override { return 1; }
+	unsigned GetNumArrayLevels() const override { return 1; }
+	unsigned GetNumSubresources() const override { return 1; }
+	unsigned GetSubresourceIndex(unsigned, unsigned, unsigned) const override { return 0; }
+	inl::Vec3u64 GetSize(unsigned) const override { return { m_desc.bufferDesc.sizeInBytes, 1, 1 }; }
+	bool IsPlaced() const override { return m_placed; }
+	void SetName(const char*) override {}
+
+private:
+	gxapi::ResourceDesc m_desc;
+	bool m_placed;
+};
+
+
+class FakeHeap : public gxapi::IHeap {
+public:
+	FakeHeap(gxapi::HeapDesc desc) : m_desc(desc) {}
+	gxapi::HeapDesc GetDesc() const override { return m_desc; }
+	void SetName(const char*) override {}
+
+private:
+	gxapi::HeapDesc m_desc;
+};
+
+
+/// <summary> Creates buffers without a device and records residency changes. </summary>
+class FakeGraphicsApi : public gxapi::IGraphicsApi {
+public:
+	gxapi::ICommandQueue* CreateCommandQueue(gxapi::CommandQueueDesc) override { return nullptr; }
+	gxapi::ICommandAllocator* CreateCommandAllocator(gxapi::eCommandListType) override { return nullptr; }
+	gxapi::IGraphicsCommandList* CreateGraphicsCommandList(gxapi::CommandListDesc) override { return nullptr; }
+	gxapi::IComputeCommandList* CreateComputeCommandList(gxapi::CommandListDesc) override { return nullptr; }
+	gxapi::ICopyCommandList* CreateCopyCommandList(gxapi::CommandListDesc) override { return nullptr; }
+	gxapi::ICommandList* CreateCommandList(gxapi::eCommandListType, gxapi::CommandListDesc) override { return nullptr; }
+
+	gxapi::IResource* CreateCommittedResource(gxapi::HeapProperties, gxapi::eHeapFlags, gxapi::ResourceDesc desc, gxapi::eResourceState, gxapi::ClearValue*) override {
+		return new FakeResource(desc, false);
+	}
+	gxapi::IHeap* CreateHeap(gxapi::HeapDesc desc) override { return new FakeHeap(desc); }
+	gxapi::IResource* CreatePlacedResource(gxapi::IHeap*, uint64_t, gxapi::ResourceDesc desc, gxapi::eResourceState, gxapi::ClearValue*) override {
+		return new FakeResource(desc, true);
+	}
+	gxapi::ResourceAllocationInfo GetResourceAllocationInfo(const gxapi::ResourceDesc& desc) const override {
+		return { desc.bufferDesc.sizeInBytes, 64 * 1024 };
+	}
+
+	gxapi::IRootSignature* CreateRootSignature(gxapi::RootSignatureDesc) override { return nullptr; }
+	gxapi::IPipelineState* CreateGraphicsPipelineState(const gxapi::GraphicsPipelineStateDesc&) override { return nullptr; }
+	gxapi::IPipelineState* CreateComputePipelineState(const gxapi::ComputePipelineStateDesc&) override { return nullptr; }
+	gxapi::IDescriptorHeap* CreateDescriptorHeap(gxapi::DescriptorHeapDesc) override { return nullptr; }
+
+	void CreateConstantBufferView(gxapi::ConstantBufferViewDesc, gxapi::DescriptorHandle) override {}
+	void CreateDepthStencilView(gxapi::DepthStencilViewDesc, gxapi::DescriptorHandle) override {}
+	void CreateDepthStencilView(const gxapi::IResource*, gxapi::DescriptorHandle) override {}
+	void CreateDepthStencilView(const gxapi::IResource*, gxapi::DepthStencilViewDesc, gxapi::DescriptorHandle) override {}
+	void CreateRenderTargetView(const gxapi::IResource*, gxapi::DescriptorHandle) override {}
+	void CreateRenderTargetView(const gxapi::IResource*, gxapi::RenderTargetViewDesc, gxapi::DescriptorHandle) override {}
+	void CreateShaderResourceView(gxapi::ShaderResourceViewDesc, gxapi::DescriptorHandle) override {}
+	void CreateShaderResourceView(const gxapi::IResource*, gxapi::DescriptorHandle) override {}
+	void CreateShaderResourceView(const gxapi::IResource*, gxapi::ShaderResourceViewDesc, gxapi::DescriptorHandle) override {}
+	void CreateUnorderedAccessView(gxapi::UnorderedAccessViewDesc, gxapi::DescriptorHandle) override {}
+	void CreateUnorderedAccessView(const gxapi::IResource*, gxapi::DescriptorHandle) override {}
+	void CreateUnorderedAccessView(const gxapi::IResource*, gxapi::UnorderedAccessViewDesc, gxapi::DescriptorHandle) override {}
+	void CopyDescriptors(size_t, gxapi::DescriptorHandle*, size_t, gxapi::DescriptorHandle*, uint32_t*, gxapi::eDescriptorHeapType) override {}
+	void CopyDescriptors(size_t, gxapi::DescriptorHandle*, uint32_t*, size_t, gxapi::DescriptorHandle*, uint32_t*, gxapi::eDescriptorHeapType) override {}
+	void CopyDescriptors(gxapi::DescriptorHandle, gxapi::DescriptorHandle, size_t, gxapi::eDescriptorHeapType) override {}
+
+	gxapi::IFence* CreateFence(uint64_t) override { return nullptr; }
+
+	void MakeResident(const std::vector<gxapi::IResource*>& objects) override {}
+	void Evict(const std::vector<gxapi::IResource*>& objects) override {}
+	void MakeResident(const std::vector<gxapi::IHeap*>& heaps) override { residentHeaps += heaps.size(); }
+	void Evict(const std::vector<gxapi::IHeap*>& heaps) override { evictedHeaps += heaps.size(); }
+
+	void ReportLiveObjects() const override {}
+	gxapi::ICapabilityQuery* GetCapabilityQuery() const override { return nullptr; }
+
+	size_t residentHeaps = 0;
+	size_t evictedHeaps = 0;
+};
+
+constexpr uint64_t MiB = 1024 * 1024;
+
+} // namespace
+
+
+TEST_CASE("Placed resources are evicted with their heap", "[ResidencyManager]") {
+	FakeGraphicsApi graphicsApi;
+	impl::CriticalBufferHeap criticalHeap(&graphicsApi);
+	ResidencyManager residencyManager(&graphicsApi);
+
+	VertexBuffer first = criticalHeap.CreateVertexBuffer(MiB);
+	VertexBuffer second = criticalHeap.CreateVertexBuffer(MiB);
+	VertexBuffer committed = criticalHeap.CreateVertexBuffer(32 * MiB);
+	REQUIRE(first._GetPlacement());
+	REQUIRE(first._GetPlacement() == second._GetPlacement());
+	REQUIRE(!committed._GetPlacement());
+
+	residencyManager.SetBudget(64 * MiB);
+	residencyManager.LockResident({ first });
+	residencyManager.UnlockResident({ first });
+	REQUIRE(residencyManager.GetResidentSize() == 64 * MiB);
+
+	residencyManager.LockResident({ committed });
+	REQUIRE(graphicsApi.evictedHeaps == 1);
+	REQUIRE(!first._GetResident());
+	REQUIRE(!second._GetResident());
+	REQUIRE(residencyManager.GetResidentSize() == 32 * MiB);
+	residencyManager.UnlockResident({ committed });
+
+	// Any resource of the heap brings the whole heap back.
+	residencyManager.LockResident({ second });
+	REQUIRE(graphicsApi.residentHeaps == 1);
+	REQUIRE(first._GetResident());
+	REQUIRE(residencyManager.GetResidentSize() == 64 * MiB);
+	residencyManager.UnlockResident({ second });
+}
+
+
+TEST_CASE("A heap stays resident while any of its resources is locked", "[ResidencyManager]") {
+	FakeGraphicsApi graphicsApi;
+	impl::CriticalBufferHeap criticalHeap(&graphicsApi);
+	ResidencyManager residencyManager(&graphicsApi);
+
+	VertexBuffer first = criticalHeap.CreateVertexBuffer(MiB);
+	VertexBuffer second = criticalHeap.CreateVertexBuffer(MiB);
+	VertexBuffer committed = criticalHeap.CreateVertexBuffer(32 * MiB);
+
+	residencyManager.SetBudget(64 * MiB);
+	residencyManager.LockResident({ first, second });
+	residencyManager.UnlockResident({ first });
+	residencyManager.LockResident({ committed });
+	REQUIRE(graphicsApi.evictedHeaps == 0);
+	REQUIRE(first._GetResident());
+
+	residencyManager.UnlockResident({ second });
+	residencyManager.UnlockResident({ committed });
+	residencyManager.SetBudget(32 * MiB);
+	REQUIRE(graphicsApi.evictedHeaps == 1);
+	REQUIRE(!first._GetResident());
+}
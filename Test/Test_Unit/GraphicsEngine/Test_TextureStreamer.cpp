@@ -0,0 +1,36 @@
+#include <GraphicsEngine_LL/TextureStreamer.hpp>
+
+#include <Catch2/catch.hpp>
+
+using namespace inl::gxeng;
+
+
+TEST_CASE("Streaming budget drops detail from least recently requested", "[TextureStreamer]") {
+	// Mip chain sizes of a 4 mip texture, each mip a quarter of the previous.
+	const std::vector<uint64_t> chainSizes = { 85, 21, 5, 1, 0 };
+
+	std::vector<impl::StreamingCandidate> candidates = {
+		{ 0, 3, 10, &chainSizes },
+		{ 0, 3, 20, &chainSizes },
+	};
+
+	uint64_t size = impl::FitStreamingBudget(candidates, 110);
+	REQUIRE(candidates[0].desiredMip == 1);
+	REQUIRE(candidates[1].desiredMip == 0);
+	REQUIRE(size == 106);
+}
+
+
+TEST_CASE("Streaming budget keeps tail mips", "[TextureStreamer]") {
+	const std::vector<uint64_t> chainSizes = { 85, 21, 5, 1, 0 };
+
+	std::vector<impl::StreamingCandidate> candidates = {
+		{ 0, 2, 10, &chainSizes },
+		{ 5, 2, 20, &chainSizes },
+	};
+
+	uint64_t size = impl::FitStreamingBudget(candidates, 0);
+	REQUIRE(candidates[0].desiredMip == 2);
+	REQUIRE(candidates[1].desiredMip == 2);
+	REQUIRE(size == 10);
+}
@@ -0,0 +1,47 @@
+#include <GraphicsEngine_LL/TransientResourceHeap.hpp>
+
+#include <Catch2/catch.hpp>
+
+using namespace inl::gxeng;
+
+
+TEST_CASE("Disjoint lifetimes alias", "[TransientResourceHeap]") {
+	impl::AliasingPage page(1024);
+	auto first = page.Allocate(512, 1, { 0, 2 });
+	auto second = page.Allocate(512, 1, { 3, 5 });
+	REQUIRE(first);
+	REQUIRE(second);
+	REQUIRE(*first == *second);
+}
+
+
+TEST_CASE("Overlapping lifetimes do not alias", "[TransientResourceHeap]") {
+	impl::AliasingPage page(1024);
+	auto first = page.Allocate(512, 1, { 0, 3 });
+	auto second = page.Allocate(512, 1, { 3, 5 });
+	REQUIRE(first);
+	REQUIRE(second);
+	REQUIRE(*first != *second);
+	REQUIRE(!page.Allocate(1, 1, { 2, 4 }));
+}
+
+
+TEST_CASE("Alignment is respected", "[TransientResourceHeap]") {
+	impl::AliasingPage page(1024);
+	auto first = page.Allocate(100, 1, { 0, 1 });
+	auto second = page.Allocate(100, 256, { 0, 1 });
+	REQUIRE(first);
+	REQUIRE(second);
+	REQUIRE(*second == 256);
+}
+
+
+TEST_CASE("Deallocation frees memory", "[TransientResourceHeap]") {
+	impl::AliasingPage page(1024);
+	auto first = page.Allocate(1024, 1, { 0, 1 });
+	REQUIRE(first);
+	REQUIRE(!page.Allocate(1024, 1, { 1, 2 }));
+	page.Deallocate(*first, { 0, 1 });
+	REQUIRE(page.IsEmpty());
+	REQUIRE(page.Allocate(1024, 1, { 1, 2 }));
+}
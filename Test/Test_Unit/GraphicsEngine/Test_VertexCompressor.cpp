@@ -0,0 +1,116 @@
+#include <GraphicsEngine_LL/VertexCompressor.hpp>
+
+#include <Catch2/catch.hpp>
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+using namespace inl;
+using namespace inl::gxeng;
+
+
+namespace {
+
+using TestVertex = Vertex<Position<0>, Normal<0>, TexCoord<0>, Tangent<0>, Bitangent<0>>;
+
+
+// Mirrors DecodeOctahedral of the shader snippet.
+Vec3 DecodeOctahedral(float x, float y) {
+	Vec3 n = { x, y, 1.0f - std::abs(x) - std::abs(y) };
+	float t = std::max(-n.z, 0.0f);
+	n.x += n.x >= 0.0f ? -t : t;
+	n.y += n.y >= 0.0f ? -t : t;
+	return Normalize(n);
+}
+
+
+std::vector<TestVertex> MakeVertices() {
+	std::vector<TestVertex> vertices;
+	for (int i = 0; i < 64; ++i) {
+		const float phi = 0.7f * i;
+		const float z = 1.0f - 2.0f * (i + 0.5f) / 64.0f;
+		const float r = std::sqrt(1.0f - z * z);
+		const Vec3 normal = { std::cos(phi) * r, std::sin(phi) * r, z };
+		Vec3 tangent = Normalize(Cross(Vec3{ 0, 0, 1 }, normal) + Vec3{ 0.001f, 0, 0 });
+		tangent = Normalize(tangent - normal * Dot(tangent, normal));
+
+		TestVertex v;
+		v.position = normal * 3.0f + Vec3{ 1, 2, 3 };
+		v.normal = normal;
+		v.texCoord = Vec2{ float(i) / 63.0f, 1.0f - float(i) / 63.0f };
+		v.tangent = tangent;
+		v.bitangent = Cross(normal, tangent) * (i % 2 == 0 ? 1.0f : -1.0f);
+		vertices.push_back(v);
+	}
+	return vertices;
+}
+
+} // namespace
+
+
+TEST_CASE("Default compression keeps floats", "[VertexCompressor]") {
+	VertexReader<Position<0>, Normal<0>, TexCoord<0>, Tangent<0>, Bitangent<0>> reader;
+	VertexCompressor compressor{ &reader, std::vector<bool>(reader.GetElements().size(), true) };
+
+	REQUIRE(compressor.GetCompressedStride() == 56);
+	REQUIRE(compressor.GetDecodeCode().empty());
+}
+
+
+TEST_CASE("Quantized vertices decode within tolerance", "[VertexCompressor]") {
+	VertexReader<Position<0>, Normal<0>, TexCoord<0>, Tangent<0>, Bitangent<0>> reader;
+	const std::vector<TestVertex> vertices = MakeVertices();
+
+	VertexQuantization quantization;
+	quantization.position = ePositionEncoding::UNORM16;
+	quantization.normal = eDirectionEncoding::OCTAHEDRAL32;
+	quantization.tangent = eDirectionEncoding::OCTAHEDRAL16;
+	quantization.texCoord = eTexCoordEncoding::UNORM16;
+	quantization.boundsMin = { -2, -1, 0 };
+	quantization.boundsMax = { 4, 5, 6 };
+	VertexCompressor compressor{ &reader, std::vector<bool>(reader.GetElements().size(), true), quantization };
+
+	REQUIRE(compressor.GetCompressedStride() == 20);
+	const std::vector<int> offsets = compressor.GetCompressedOffsets();
+	REQUIRE(offsets == std::vector<int>{ 0, 8, 12, 16, -1 });
+	const std::vector<gxapi::eFormat> formats = compressor.GetCompressedFormats();
+	REQUIRE(formats[4] == gxapi::eFormat::UNKNOWN);
+	REQUIRE(formats[1] == gxapi::eFormat::R16G16_SNORM);
+	// Cooked meshes only keep the offsets, formats are restored from the quantization.
+	REQUIRE(VertexCompressor::GetCompressedFormat(eVertexElementSemantic::POSITION, 8, quantization) == formats[0]);
+	REQUIRE(VertexCompressor::GetCompressedFormat(eVertexElementSemantic::NORMAL, 4, quantization) == formats[1]);
+	REQUIRE(VertexCompressor::GetCompressedFormat(eVertexElementSemantic::TANGENT, 4, quantization) == formats[3]);
+	REQUIRE(VertexCompressor::GetCompressedFormat(eVertexElementSemantic::POSITION, 12, {}) == gxapi::eFormat::R32G32B32_FLOAT);
+
+	const std::string code = compressor.GetDecodeCode();
+	REQUIRE(code.find("float3 DecodeOctahedral") == code.rfind("float3 DecodeOctahedral")); // Shared by normals and tangents, emitted once.
+	REQUIRE(code.find("DecodeTangentFrame") != std::string::npos);
+	REQUIRE(code.find("DecodePosition") != std::string::npos);
+
+	const std::vector<uint8_t> stream = compressor.GetCompressedStream(vertices.data(), vertices.size());
+	REQUIRE(stream.size() == vertices.size() * 20);
+	for (size_t i = 0; i < vertices.size(); ++i) {
+		const uint8_t* vertex = stream.data() + i * 20;
+		uint16_t position[4];
+		int16_t normal[2];
+		int8_t tangent[4];
+		uint16_t texCoord[2];
+		std::memcpy(position, vertex + offsets[0], sizeof(position));
+		std::memcpy(normal, vertex + offsets[1], sizeof(normal));
+		std::memcpy(texCoord, vertex + offsets[2], sizeof(texCoord));
+		std::memcpy(tangent, vertex + offsets[3], sizeof(tangent));
+
+		const Vec3 decodedPosition = quantization.boundsMin + Vec3{ position[0], position[1], position[2] } / 65535.0f * (quantization.boundsMax - quantization.boundsMin);
+		REQUIRE(Length(decodedPosition - Vec3(vertices[i].position)) < 1e-3f);
+
+		const Vec3 decodedNormal = DecodeOctahedral(normal[0] / 32767.0f, normal[1] / 32767.0f);
+		REQUIRE(Dot(decodedNormal, Vec3(vertices[i].normal)) > 0.99999f);
+
+		const Vec3 decodedTangent = DecodeOctahedral(tangent[0] / 127.0f, tangent[1] / 127.0f);
+		REQUIRE(Dot(decodedTangent, Vec3(vertices[i].tangent)) > 0.999f);
+		REQUIRE((tangent[3] > 0) == (i % 2 == 0));
+
+		REQUIRE(std::abs(texCoord[0] / 65535.0f - vertices[i].texCoord.x) < 1e-4f);
+	}
+}
@@ -0,0 +1,162 @@
+#include <GuiEngine/Board.hpp>
+#include <GuiEngine/LinearLayout.hpp>
+
+#include <Catch2/catch.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <vector>
+
+
+using namespace inl;
+using namespace inl::gui;
+
+
+namespace {
+
+class TestControl : public Control {
+public:
+	TestControl(Vec2 position, Vec2 size, std::vector<Control*>* updateLog = nullptr)
+		: m_position(position), m_size(size), m_updateLog(updateLog) {}
+
+	void SetSize(const Vec2& size) override { m_size = size; }
+	Vec2 GetSize() const override { return m_size; }
+	Vec2 GetPreferredSize() const override { return m_size; }
+	Vec2 GetMinimumSize() const override { return m_size; }
+
+	void SetPosition(const Vec2& position) override {
+		m_position = position;
+		++positionCount;
+	}
+	Vec2 GetPosition() const override { return m_position; }
+	float SetDepth(float depth) override {
+		m_depth = depth;
+		float span = 0.0f;
+		for (auto child : GetChildren()) {
+			span = std::max(span, child->SetDepth(depth + 1.0f));
+		}
+		return span + 1.0f;
+	}
+	float GetDepth() const override { return m_depth; }
+
+	void Update(float) override {
+		if (m_updateLog) {
+			m_updateLog->push_back(this);
+		}
+		if (onUpdate) {
+			onUpdate();
+		}
+	}
+
+	void SetPreferredSize(const Vec2& size) {
+		m_size = size;
+		Invalidate(eInvalidation::PREFERRED_SIZE);
+	}
+
+	std::function<void()> onUpdate;
+	int positionCount = 0;
+
+private:
+	Vec2 m_position;
+	Vec2 m_size;
+	float m_depth = 0.0f;
+	std::vector<Control*>* m_updateLog;
+};
+
+
+void MouseDown(Board& board, float x, float y) {
+	MouseButtonEvent evt;
+	evt.x = x;
+	evt.y = y;
+	evt.button = eMouseButton::LEFT;
+	evt.state = eKeyState::DOWN;
+	board.OnMouseButton(evt);
+}
+
+} // namespace
+
+
+TEST_CASE("Children keep insertion order", "[GUI]") {
+	TestControl parent{ { 0, 0 }, { 10, 10 } };
+	TestControl a{ { 0, 0 }, { 1, 1 } }, b{ { 0, 0 }, { 1, 1 } }, c{ { 0, 0 }, { 1, 1 } };
+	parent.AddChild(c);
+	parent.AddChild(a);
+	parent.AddChild(b);
+	parent.RemoveChild(&a);
+
+	auto children = parent.GetChildren();
+	REQUIRE(children.size() == 2);
+	REQUIRE(children[0] == &c);
+	REQUIRE(children[1] == &b);
+	REQUIRE_THROWS_AS(parent.AddChild(b), InvalidArgumentException);
+}
+
+
+TEST_CASE("Board updates controls in pre-order", "[GUI]") {
+	std::vector<Control*> log;
+	Board board;
+	TestControl a{ { 0, 0 }, { 10, 10 }, &log }, a1{ { 0, 0 }, { 1, 1 }, &log }, b{ { 0, 0 }, { 1, 1 }, &log };
+	TestControl added{ { 0, 0 }, { 1, 1 }, &log };
+	a.AddChild(a1);
+	board.AddChild(a);
+	board.AddChild(b);
+
+	board.Update(0.0f);
+	REQUIRE(log == std::vector<Control*>{ &a, &a1, &b });
+
+	// Children added during the update are visited in the same pass.
+	log.clear();
+	a.onUpdate = [&] {
+		a.AddChild(added);
+		a.onUpdate = nullptr;
+	};
+	board.Update(0.0f);
+	REQUIRE(log == std::vector<Control*>{ &a, &a1, &added, &b });
+}
+
+
+TEST_CASE("Board hit test finds the deepest control", "[GUI]") {
+	Board board;
+	TestControl outer{ { 0, 0 }, { 100, 100 } };
+	TestControl inner{ { 10, 10 }, { 20, 20 } };
+	TestControl sibling{ { -30, -30 }, { 20, 20 } };
+	outer.AddChild(inner);
+	outer.AddChild(sibling);
+	board.AddChild(outer);
+	board.Update(0.0f);
+
+	std::vector<Control*> targets;
+	outer.OnMouseDown += [&](Control* target, Vec2, eMouseButton) { targets.push_back(target); };
+
+	MouseDown(board, 12, 12);
+	MouseDown(board, -30, -30);
+	MouseDown(board, 45, -45);
+
+	REQUIRE(targets == std::vector<Control*>{ &inner, &sibling, &outer });
+}
+
+
+TEST_CASE("Board lays out invalidated subtrees only", "[GUI]") {
+	Board board;
+	LinearLayout layout{ LinearLayout::VERTICAL };
+	TestControl a{ { 0, 0 }, { 10, 10 } }, b{ { 0, 0 }, { 10, 10 } };
+	layout.SetSize({ 100, 100 });
+	layout.AddChild(a);
+	layout.AddChild(b);
+	layout[&a].SetAuto();
+	layout[&b].SetAuto();
+	board.AddChild(layout);
+
+	board.Update(0.0f);
+	const Vec2 bPosition = b.GetPosition();
+	const int positionCount = b.positionCount;
+
+	board.Update(0.0f);
+	REQUIRE(b.positionCount == positionCount);
+
+	a.SetPreferredSize({ 10, 30 });
+	board.Update(0.0f);
+	REQUIRE(b.positionCount > positionCount);
+	REQUIRE(std::abs(b.GetPosition().y - bPosition.y) == Approx(20.0f));
+}
@@ -0,0 +1,60 @@
+#include <GuiEngine/Board.hpp>
+#include <GuiEngine/Label.hpp>
+#include <GuiEngine/ListViewV.hpp>
+
+#include <Catch2/catch.hpp>
+
+#include <string>
+
+
+using namespace inl;
+using namespace inl::gui;
+
+
+TEST_CASE("ListViewV recycles rows as it scrolls", "[GUI]") {
+	Board board;
+	ListViewV list;
+	int created = 0;
+	int bound = 0;
+	list.SetRowFactory([&] {
+		++created;
+		return std::make_shared<Label>();
+	});
+	list.SetRowBinder([&](Control& row, size_t item) {
+		++bound;
+		std::u32string text;
+		for (char digit : std::to_string(item)) {
+			text += char32_t(digit);
+		}
+		static_cast<Label&>(row).SetText(std::move(text));
+	});
+	list.SetRowHeight(20.0f);
+	list.SetOverscan(2);
+	list.SetItemCount(100000);
+	list.SetSize({ 200, 100 });
+	board.AddChild(list);
+	board.Update(0.0f);
+
+	// 5 rows in view, one more for partial rows, 2 above and below.
+	REQUIRE(created == 10);
+	REQUIRE(bound == 10);
+	REQUIRE(list.GetRow(0));
+	REQUIRE(list.GetRow(10) == nullptr);
+	REQUIRE(static_cast<Label*>(list.GetRow(3))->GetText() == U"3");
+
+	// Scrolling by one row rebinds a single row.
+	list.SetScrollPosition(60.0f);
+	board.Update(0.0f);
+	REQUIRE(created == 10);
+	REQUIRE(bound == 11);
+	REQUIRE(list.GetRow(0) == nullptr);
+	REQUIRE(static_cast<Label*>(list.GetRow(10))->GetText() == U"10");
+
+	list.ScrollToItem(99999);
+	board.Update(0.0f);
+	REQUIRE(created == 10);
+	REQUIRE(list.GetScrollPosition() == Approx(100000 * 20.0f - 100.0f));
+	REQUIRE(static_cast<Label*>(list.GetRow(99999))->GetText() == U"99999");
+
+	board.RemoveChild(&list);
+}
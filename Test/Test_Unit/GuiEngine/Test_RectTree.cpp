@@ -0,0 +1,63 @@
+#include <GuiEngine/RectTree.hpp>
+
+#include <Catch2/catch.hpp>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+
+using namespace inl;
+using namespace inl::gui;
+
+
+namespace {
+
+std::vector<uint32_t> BruteForce(const std::vector<RectF>& rects, Vec2 point) {
+	std::vector<uint32_t> items;
+	for (uint32_t i = 0; i < rects.size(); ++i) {
+		if (rects[i].left <= point.x && point.x <= rects[i].right && rects[i].bottom <= point.y && point.y <= rects[i].top) {
+			items.push_back(i);
+		}
+	}
+	return items;
+}
+
+
+std::vector<uint32_t> Query(const RectTree& tree, Vec2 point) {
+	std::vector<uint32_t> items;
+	tree.Query(point, items);
+	std::sort(items.begin(), items.end());
+	return items;
+}
+
+} // namespace
+
+
+TEST_CASE("RectTree finds the same rects as brute force", "[GUI]") {
+	std::mt19937 rne(726);
+	std::uniform_real_distribution<float> position(0.0f, 1000.0f);
+	std::uniform_real_distribution<float> size(1.0f, 100.0f);
+	auto RandomRect = [&] {
+		return RectF::FromCenter(position(rne), position(rne), size(rne), size(rne));
+	};
+
+	std::vector<RectF> rects(500);
+	std::generate(rects.begin(), rects.end(), RandomRect);
+	RectTree tree;
+	tree.Build(rects);
+
+	std::vector<Vec2> points(200);
+	std::generate(points.begin(), points.end(), [&] { return Vec2{ position(rne), position(rne) }; });
+	for (auto& point : points) {
+		REQUIRE(Query(tree, point) == BruteForce(rects, point));
+	}
+
+	for (uint32_t i = 0; i < rects.size(); i += 7) {
+		rects[i] = RandomRect();
+		tree.Update(i, rects[i]);
+	}
+	for (auto& point : points) {
+		REQUIRE(Query(tree, point) == BruteForce(rects, point));
+	}
+}